@@ -20,59 +20,6 @@ using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE ("TestMeshScript");
 
-double
-calcPl(double tx, double ty, double rx, double ry, int A1, int B1, int A2, int B2, double *wall_loss)
-{
-	double wall[15][4] = {0, 0, 0, 21.6, 3.6, 0, 3.6, 10.8, 3.6, 13.7, 3.6, 21.6, 9, 5.4, 9, 10.8, 9, 13.7, 9, 21.6, 11.7, 0, 11.7, 5.4, 19.8, 0, 19.8, 10.8, 19.8, 13.7, 19.8, 21.6, 3.6, 0, 19.8, 0, 3.6, 5.4, 19.8, 5.4, 3.6, 10.8, 19.8, 10.8, 3.6, 13.7, 19.8, 13.7, 0, 13.7, 3.6, 13.7, 0, 17.3, 3.6, 17.3, 0, 21.6, 19.8, 21.6};
-	double its[15] = {0};
-
-	double m_referenceDistance = 1, m_referenceFrequency = 2.4;
-	double distance = std::sqrt(std::pow(tx-rx, 2) + std::pow(ty-ry, 2));
-	if (distance <= 1)
-	{
-		return 0;
-	}
-	double w1x, w1y, w2x, w2y, compare1, compare2, coeff; //for inclination
-	double openpl, wallpl;
-	int num_wall = 15, num_intersect = 0;
-	for (int i=0; i<num_wall; i++)
-	{
-		w1x = wall[i][0];
-		w1y = wall[i][1];
-		w2x = wall[i][2];
-		w2y = wall[i][3];
-		compare1 = std::abs((w2x - w1x) * (ry - ty) * tx - (w2y - w1y) * (rx - tx) * w1x + (rx - tx) * (w2x - w1x) * (w1y - ty));
-		compare2 = std::abs((ry - ty) * (w2x - w1x) * w1y - (rx - tx) * (w2y - w1y) * ty + (ry - ty) * (w2y - w1y) * (tx - w1x));
-		coeff =std::abs((ry - ty)*(w2x - w1x) - (w2y - w1y)*(rx - tx));
-		if ((coeff * std::min(tx, rx) <= compare1) && (compare1 <= coeff * std::max(tx, rx))) {
-			if ((coeff * std::min(w1x, w2x) <= compare1) && (compare1 <= coeff * std::max(w1x, w2x))){
-				if ((coeff * std::min(ty, ry) <= compare2) && (compare2 <= coeff * std::max(ty, ry))) {
-					if ((coeff * std::min(w1y, w2y) <= compare2) && (compare2 <= coeff * std::max(w1y, w2y))) {
-						num_intersect++;
-						its[i] = 1;
-					}
-				}
-			}
-		}
-	}
-
-	if (num_intersect == 0)
-	{
-		openpl = A1 + B1 * std::log10(distance / m_referenceDistance) + 20 * std::log10(m_referenceFrequency / 5);
-	} else {
-		openpl = A2 + B2 * std::log10(distance / m_referenceDistance) + 20 * std::log10(m_referenceFrequency / 5);
-	}
-
-	wallpl = 0;
-	for (int i=0; i<num_wall; i++) {
-		if (its[i] == 1)
-			wallpl += wall_loss[i];
-	}
-	double pathLossDb = openpl + wallpl;
-	return pathLossDb;
-}
-
-
 int
 main (int argc, char *argv[])
 {
@@ -116,8 +63,6 @@ main (int argc, char *argv[])
   uint32_t seed = 10;
 	int nsta = 2;
 	int mnss = 2;
-	double A1, B1, A2, B2;
-	double wall_loss[15] = {0};
 
 	int dr[nsta] = {8, 10};
 	std::string dataStr;
@@ -135,34 +80,15 @@ main (int argc, char *argv[])
 	cmd.AddValue ("coeff_str", "Coefficient string", coeff_str);
 	cmd.Parse (argc, argv);
 
-  std::ifstream File;
-	double inputFromFile;
-	//fileStr = "./rssi_cal/Result-" + coeff_str + ".txt"; 
-	char fileStr[100] = "./rssi_cal/coef_results/Result-";
-	strcat(fileStr, coeff_str);
-	strcat(fileStr, ".txt");
-	File.open(fileStr);
-
-	File >> inputFromFile;
-	Winner2PropagationLossModel::A1 = inputFromFile;
-	A1 = inputFromFile;
-	File >> inputFromFile;
-	Winner2PropagationLossModel::B1 = inputFromFile;
-	B1 = inputFromFile;
-	File >> inputFromFile;
-	Winner2PropagationLossModel::A2 = inputFromFile;
-	A2 = inputFromFile;
-	File >> inputFromFile;
-	Winner2PropagationLossModel::B2 = inputFromFile;
-	B2 = inputFromFile;
-
-	int j = 0;
-	while(File >> inputFromFile) {
-		Winner2PropagationLossModel::wall_loss[j] = inputFromFile;
-		wall_loss[j] = inputFromFile;
-		j++;
-	}
-	File.close();
+	std::string coefFile = std::string ("./rssi_cal/coef_results/Result-") + coeff_str + ".txt";
+	Ptr<Winner2PropagationLossModel> winner2 = CreateObject<Winner2PropagationLossModel> ();
+	winner2->SetAttribute ("Frequency", DoubleValue (2.4));
+	winner2->SetAttribute ("CoefficientFile", StringValue (coefFile));
+	// the STA association compares losses with the coefficients truncated
+	// to int, as calcPl did; the channel keeps the calibrated ones
+	Ptr<Floorplan> assocFloorplan = winner2->GetFloorplan ();
+	assocFloorplan->SetLosCoefficients ((int) assocFloorplan->GetA1 (), (int) assocFloorplan->GetB1 ());
+	assocFloorplan->SetNlosCoefficients ((int) assocFloorplan->GetA2 (), (int) assocFloorplan->GetB2 ());
 
 	double map1_x = outlet[map1_pos][0], map1_y = outlet[map1_pos][1];
 	double map2_x = outlet[map2_pos][0], map2_y = outlet[map2_pos][1];
@@ -191,7 +117,7 @@ main (int argc, char *argv[])
   YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default();
 	
   wifiChannel.SetPropagationDelay("ns3::ConstantSpeedPropagationDelayModel");
-	wifiChannel.AddPropagationLoss("ns3::Winner2PropagationLossModel", "Frequency", DoubleValue(5.15));
+	wifiChannel.AddPropagationLoss("ns3::Winner2PropagationLossModel", "Frequency", DoubleValue(5.15), "CoefficientFile", StringValue(coefFile));
 	wifiChannel.AddPropagationLoss("ns3::JakesPropagationLossModel");
 
   int bandwidth = 20;
@@ -251,7 +177,7 @@ main (int argc, char *argv[])
  }
 
 	wifiChannel.ClearPropagationLoss();
-	wifiChannel.AddPropagationLoss("ns3::Winner2PropagationLossModel", "Frequency", DoubleValue(2.4));
+	wifiChannel.AddPropagationLoss("ns3::Winner2PropagationLossModel", "Frequency", DoubleValue(2.4), "CoefficientFile", StringValue(coefFile));
 	wifiChannel.AddPropagationLoss("ns3::JakesPropagationLossModel");
 
 	wifiPhy.SetChannel(wifiChannel.Create());
@@ -276,9 +202,9 @@ main (int argc, char *argv[])
 	//if station is close from MPP, set ssid ssid1, MAP, set ssid ssid2
 	for (int i = 0; i < nsta; i++)
 	{
-		double pl_mpp = calcPl(mesh_pos[0][0], mesh_pos[0][1], sta_pos[i][0], sta_pos[i][1], A1, B1, A2, B2, wall_loss);
-		double pl_map1 = calcPl(mesh_pos[1][0], mesh_pos[1][1], sta_pos[i][0], sta_pos[i][1], A1, B1, A2, B2, wall_loss);
-		double pl_map2 = calcPl(mesh_pos[2][0], mesh_pos[2][1], sta_pos[i][0], sta_pos[i][1], A1, B1, A2, B2, wall_loss);
+		double pl_mpp = winner2->CalcPathLoss(Vector(mesh_pos[0][0], mesh_pos[0][1], 0), Vector(sta_pos[i][0], sta_pos[i][1], 0));
+		double pl_map1 = winner2->CalcPathLoss(Vector(mesh_pos[1][0], mesh_pos[1][1], 0), Vector(sta_pos[i][0], sta_pos[i][1], 0));
+		double pl_map2 = winner2->CalcPathLoss(Vector(mesh_pos[2][0], mesh_pos[2][1], 0), Vector(sta_pos[i][0], sta_pos[i][1], 0));
 
 		if (pl_mpp < pl_map1) {
 			if (pl_mpp < pl_map2) {
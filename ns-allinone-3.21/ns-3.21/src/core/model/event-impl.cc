@@ -25,6 +25,69 @@ NS_LOG_COMPONENT_DEFINE ("EventImpl");
 
 namespace ns3 {
 
+namespace {
+
+/// the sizes of the events are rounded up to a multiple of this
+const size_t EVENT_POOL_GRANULARITY = 16;
+/// the number of size classes; larger events come from the heap
+const size_t EVENT_POOL_CLASSES = 16;
+/// the number of events allocated at once when a free list is empty
+const uint32_t EVENT_POOL_CHUNK = 64;
+
+/// the memory of an event in a free list
+struct FreeEvent
+{
+  FreeEvent *next; //!< the next free event of the same size class
+};
+
+/// the free lists of the current thread, by size class
+__thread FreeEvent *g_freeEvents[EVENT_POOL_CLASSES];
+
+} // anonymous namespace
+
+void *
+EventImpl::operator new (size_t size)
+{
+  size_t sizeClass = (size + EVENT_POOL_GRANULARITY - 1) / EVENT_POOL_GRANULARITY - 1;
+  if (sizeClass >= EVENT_POOL_CLASSES)
+    {
+      return ::operator new (size);
+    }
+  FreeEvent *event = g_freeEvents[sizeClass];
+  if (event == 0)
+    {
+      // carve a chunk of events of this size class, never given back
+      size_t eventSize = (sizeClass + 1) * EVENT_POOL_GRANULARITY;
+      char *chunk = static_cast<char *> (::operator new (eventSize * EVENT_POOL_CHUNK));
+      for (uint32_t i = 0; i < EVENT_POOL_CHUNK; i++)
+        {
+          FreeEvent *slot = reinterpret_cast<FreeEvent *> (chunk + i * eventSize);
+          slot->next = event;
+          event = slot;
+        }
+    }
+  g_freeEvents[sizeClass] = event->next;
+  return event;
+}
+
+void
+EventImpl::operator delete (void *p, size_t size)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  size_t sizeClass = (size + EVENT_POOL_GRANULARITY - 1) / EVENT_POOL_GRANULARITY - 1;
+  if (sizeClass >= EVENT_POOL_CLASSES)
+    {
+      ::operator delete (p);
+      return;
+    }
+  FreeEvent *event = static_cast<FreeEvent *> (p);
+  event->next = g_freeEvents[sizeClass];
+  g_freeEvents[sizeClass] = event;
+}
+
 EventImpl::~EventImpl ()
 {
   NS_LOG_FUNCTION (this);
@@ -60,4 +123,11 @@ EventImpl::IsCancelled (void)
   return m_cancel;
 }
 
+void
+EventImpl::Renew (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_cancel = false;
+}
+
 } // namespace ns3
@@ -21,6 +21,7 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
 
 namespace ns3 {
@@ -35,6 +36,11 @@ namespace ns3 {
  * obviously (there are Ref and Unref methods) reference-counted and
  * most subclasses are usually created by one of the many Simulator::Schedule
  * methods.
+ *
+ * Events are allocated from per-thread free lists, one per size class,
+ * instead of the heap: the memory of an event which has been invoked is
+ * handed to the next event of the same size, so that scheduling an event
+ * does not go through the allocator in the steady state.
  */
 class EventImpl : public SimpleRefCount<EventImpl>
 {
@@ -57,6 +63,24 @@ public:
    * Invoked by the simulation engine before calling Invoke.
    */
   bool IsCancelled (void);
+  /**
+   * Clears the 'canceled' mark of an event which is no longer in the
+   * event list, so that the same event can be scheduled again.
+   */
+  void Renew (void);
+
+  /**
+   * \param size the size of the event
+   * \returns memory for an event, from the free list of its size class
+   */
+  static void *operator new (size_t size);
+  /**
+   * \param p the memory of an event
+   * \param size the size of the event
+   *
+   * Gives the memory back to the free list of its size class.
+   */
+  static void operator delete (void *p, size_t size);
 
 protected:
   virtual void Notify (void) = 0;
@@ -0,0 +1,325 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ladder-scheduler.h"
+#include "event-impl.h"
+#include "uinteger.h"
+#include "assert.h"
+#include "log.h"
+#include <algorithm>
+
+NS_LOG_COMPONENT_DEFINE ("LadderScheduler");
+
+namespace ns3 {
+
+NS_OBJECT_ENSURE_REGISTERED (LadderScheduler);
+
+TypeId
+LadderScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::LadderScheduler")
+    .SetParent<Scheduler> ()
+    .AddConstructor<LadderScheduler> ()
+    .AddAttribute ("Buckets",
+                   "The number of buckets of the near future, rounded up to a power of two.",
+                   UintegerValue (8192),
+                   MakeUintegerAccessor (&LadderScheduler::SetBuckets,
+                                         &LadderScheduler::GetBuckets),
+                   MakeUintegerChecker<uint32_t> (1))
+    .AddAttribute ("BucketWidth",
+                   "The duration of a bucket of the near future.",
+                   TimeValue (MicroSeconds (1)),
+                   MakeTimeAccessor (&LadderScheduler::SetBucketWidth,
+                                     &LadderScheduler::GetBucketWidth),
+                   MakeTimeChecker ())
+  ;
+  return tid;
+}
+
+LadderScheduler::LadderScheduler ()
+  : m_mask (0),
+    m_width (1),
+    m_start (0),
+    m_nearEvents (0)
+{
+  NS_LOG_FUNCTION (this);
+  Init (8192, MicroSeconds (1).GetTimeStep ());
+}
+LadderScheduler::~LadderScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+LadderScheduler::SetBuckets (uint32_t nBuckets)
+{
+  NS_LOG_FUNCTION (this << nBuckets);
+  // at least a word of the bitmap
+  uint32_t n = 64;
+  while (n < nBuckets)
+    {
+      n <<= 1;
+    }
+  Init (n, m_width);
+}
+uint32_t
+LadderScheduler::GetBuckets (void) const
+{
+  return m_mask + 1;
+}
+void
+LadderScheduler::SetBucketWidth (Time width)
+{
+  NS_LOG_FUNCTION (this << width);
+  NS_ASSERT (width.IsStrictlyPositive ());
+  Init (m_mask + 1, width.GetTimeStep ());
+}
+Time
+LadderScheduler::GetBucketWidth (void) const
+{
+  return TimeStep (m_width);
+}
+
+void
+LadderScheduler::Init (uint32_t nBuckets, uint64_t width)
+{
+  NS_LOG_FUNCTION (this << nBuckets << width);
+  std::vector<Event> events;
+  for (std::vector<Bucket>::const_iterator i = m_buckets.begin (); i != m_buckets.end (); i++)
+    {
+      events.insert (events.end (), i->begin (), i->end ());
+    }
+  m_buckets.clear ();
+  m_buckets.resize (nBuckets);
+  m_bitmap.assign (nBuckets / 64, 0);
+  m_mask = nBuckets - 1;
+  m_width = width;
+  m_nearEvents = 0;
+  for (std::vector<Event>::const_iterator i = events.begin (); i != events.end (); i++)
+    {
+      m_far.insert (std::make_pair (i->key, i->impl));
+    }
+  if (!m_far.empty ())
+    {
+      uint64_t ts = m_far.begin ()->first.m_ts;
+      m_start = ts - ts % m_width;
+      Migrate ();
+    }
+}
+
+bool
+LadderScheduler::IsLater (const Event &a, const Event &b)
+{
+  return a.key > b.key;
+}
+
+uint64_t
+LadderScheduler::GetHorizon (void) const
+{
+  return m_start + (m_mask + 1) * m_width;
+}
+
+void
+LadderScheduler::InsertNear (const Event &ev)
+{
+  uint32_t index = (ev.key.m_ts / m_width) & m_mask;
+  Bucket &bucket = m_buckets[index];
+  bucket.push_back (ev);
+  std::push_heap (bucket.begin (), bucket.end (), &LadderScheduler::IsLater);
+  m_bitmap[index >> 6] |= (uint64_t)1 << (index & 63);
+  m_nearEvents++;
+}
+
+void
+LadderScheduler::Migrate (void)
+{
+  uint64_t horizon = GetHorizon ();
+  while (!m_far.empty () && m_far.begin ()->first.m_ts < horizon)
+    {
+      Event ev;
+      ev.key = m_far.begin ()->first;
+      ev.impl = m_far.begin ()->second;
+      m_far.erase (m_far.begin ());
+      InsertNear (ev);
+    }
+}
+
+void
+LadderScheduler::Rewind (uint64_t ts)
+{
+  NS_LOG_FUNCTION (this << ts);
+  m_start = ts - ts % m_width;
+  uint64_t horizon = GetHorizon ();
+  for (uint32_t index = 0; index <= m_mask; index++)
+    {
+      Bucket &bucket = m_buckets[index];
+      Bucket::iterator last = bucket.begin ();
+      for (Bucket::iterator i = bucket.begin (); i != bucket.end (); i++)
+        {
+          if (i->key.m_ts >= horizon)
+            {
+              m_far.insert (std::make_pair (i->key, i->impl));
+              m_nearEvents--;
+            }
+          else
+            {
+              *last++ = *i;
+            }
+        }
+      bucket.erase (last, bucket.end ());
+      std::make_heap (bucket.begin (), bucket.end (), &LadderScheduler::IsLater);
+      if (bucket.empty ())
+        {
+          m_bitmap[index >> 6] &= ~((uint64_t)1 << (index & 63));
+        }
+    }
+}
+
+uint32_t
+LadderScheduler::FindNext (void) const
+{
+  NS_ASSERT (m_nearEvents > 0);
+  uint32_t first = (m_start / m_width) & m_mask;
+  uint32_t nWords = m_bitmap.size ();
+  uint32_t word = first >> 6;
+  uint64_t bits = m_bitmap[word] & (~(uint64_t)0 << (first & 63));
+  // the last iteration looks at the start of the first word again
+  for (uint32_t n = 0; n <= nWords; n++)
+    {
+      if (bits != 0)
+        {
+          return (word << 6) + __builtin_ctzll (bits);
+        }
+      word = (word + 1) % nWords;
+      bits = m_bitmap[word];
+    }
+  NS_ASSERT_MSG (false, "no bucket holds an event");
+  return 0;
+}
+
+void
+LadderScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  uint64_t ts = ev.key.m_ts;
+  if (IsEmpty ())
+    {
+      m_start = ts - ts % m_width;
+    }
+  else if (ts < m_start)
+    {
+      // an event before the first one, as when the events are scheduled before Run
+      Rewind (ts);
+    }
+  if (ts < GetHorizon ())
+    {
+      InsertNear (ev);
+    }
+  else
+    {
+      std::pair<EventMap::iterator,bool> result;
+      result = m_far.insert (std::make_pair (ev.key, ev.impl));
+      NS_ASSERT (result.second);
+    }
+}
+
+bool
+LadderScheduler::IsEmpty (void) const
+{
+  return m_nearEvents == 0 && m_far.empty ();
+}
+
+Scheduler::Event
+LadderScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  if (m_nearEvents == 0)
+    {
+      Event ev;
+      ev.key = m_far.begin ()->first;
+      ev.impl = m_far.begin ()->second;
+      return ev;
+    }
+  return m_buckets[FindNext ()].front ();
+}
+
+Scheduler::Event
+LadderScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  if (m_nearEvents == 0)
+    {
+      // jump over the empty near future
+      uint64_t ts = m_far.begin ()->first.m_ts;
+      m_start = ts - ts % m_width;
+      Migrate ();
+    }
+  uint32_t first = (m_start / m_width) & m_mask;
+  uint32_t index = FindNext ();
+  if (index != first)
+    {
+      m_start += ((index - first) & m_mask) * m_width;
+      Migrate ();
+    }
+  Bucket &bucket = m_buckets[index];
+  Event ev = bucket.front ();
+  std::pop_heap (bucket.begin (), bucket.end (), &LadderScheduler::IsLater);
+  bucket.pop_back ();
+  if (bucket.empty ())
+    {
+      m_bitmap[index >> 6] &= ~((uint64_t)1 << (index & 63));
+    }
+  m_nearEvents--;
+  NS_LOG_DEBUG (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  return ev;
+}
+
+void
+LadderScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << ev.impl << ev.key.m_ts << ev.key.m_uid);
+  if (ev.key.m_ts < GetHorizon ())
+    {
+      uint32_t index = (ev.key.m_ts / m_width) & m_mask;
+      Bucket &bucket = m_buckets[index];
+      for (Bucket::iterator i = bucket.begin (); i != bucket.end (); i++)
+        {
+          if (i->key.m_uid == ev.key.m_uid)
+            {
+              NS_ASSERT (i->impl == ev.impl);
+              bucket.erase (i);
+              std::make_heap (bucket.begin (), bucket.end (), &LadderScheduler::IsLater);
+              if (bucket.empty ())
+                {
+                  m_bitmap[index >> 6] &= ~((uint64_t)1 << (index & 63));
+                }
+              m_nearEvents--;
+              return;
+            }
+        }
+      NS_ASSERT_MSG (false, "the event is not in its bucket");
+    }
+  else
+    {
+      EventMap::iterator i = m_far.find (ev.key);
+      NS_ASSERT (i != m_far.end () && i->second == ev.impl);
+      m_far.erase (i);
+    }
+}
+
+} // namespace ns3
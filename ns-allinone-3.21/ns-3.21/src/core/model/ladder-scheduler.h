@@ -0,0 +1,136 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef LADDER_SCHEDULER_H
+#define LADDER_SCHEDULER_H
+
+#include "scheduler.h"
+#include "nstime.h"
+#include <stdint.h>
+#include <vector>
+#include <map>
+
+namespace ns3 {
+
+class EventImpl;
+
+/**
+ * \ingroup scheduler
+ * \brief a two-rung ladder queue event scheduler
+ *
+ * This event scheduler is tuned for simulations where most events are
+ * scheduled a few microseconds to a few milliseconds ahead (slots, SIFS,
+ * propagation delays, frame durations) and a few are scheduled far
+ * ahead (beacons, routing and rate control timers).
+ *
+ * The near future, from the bucket of the last event removed and over
+ * Buckets times BucketWidth, is a circular array of buckets of
+ * BucketWidth each. Each bucket is a binary heap of its events, and the
+ * next event is at the top of the first non-empty bucket, found with a
+ * bitmap of the non-empty buckets. The events beyond the near future are
+ * kept in a std::map, as with the MapScheduler, and move to their bucket
+ * when the near future reaches them. Inserting and removing an event of the near future is thus done
+ * in constant time as long as the buckets hold a few events each, and in
+ * logarithmic time, as with the HeapScheduler, when they crowd in a few
+ * buckets.
+ */
+class LadderScheduler : public Scheduler
+{
+public:
+  static TypeId GetTypeId (void);
+
+  LadderScheduler ();
+  virtual ~LadderScheduler ();
+
+  virtual void Insert (const Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Event PeekNext (void) const;
+  virtual Event RemoveNext (void);
+  virtual void Remove (const Event &ev);
+
+private:
+  /**
+   * \param nBuckets the number of buckets of the near future, rounded up
+   *        to a power of two
+   */
+  void SetBuckets (uint32_t nBuckets);
+  /**
+   * \return the number of buckets of the near future
+   */
+  uint32_t GetBuckets (void) const;
+  /**
+   * \param width the duration of a bucket
+   */
+  void SetBucketWidth (Time width);
+  /**
+   * \return the duration of a bucket
+   */
+  Time GetBucketWidth (void) const;
+  /**
+   * Resize the buckets, with the events in the scheduler.
+   *
+   * \param nBuckets the number of buckets, a power of two
+   * \param width the duration of a bucket in time steps
+   */
+  void Init (uint32_t nBuckets, uint64_t width);
+  /**
+   * Move the start of the near future to the bucket of a timestamp, and
+   * the events which are then beyond it to the far future.
+   *
+   * \param ts the timestamp
+   */
+  void Rewind (uint64_t ts);
+  /**
+   * Move the events of the far future which are now in the near future
+   * to their bucket.
+   */
+  void Migrate (void);
+  /**
+   * \param ev the event, in the near future
+   */
+  void InsertNear (const Event &ev);
+  /**
+   * \return the index of the first non-empty bucket from the start of
+   *         the near future, which must hold an event
+   */
+  uint32_t FindNext (void) const;
+  /**
+   * \param a an event
+   * \param b another event
+   * \return true if a is after b, to keep the first event at the top of a bucket
+   */
+  static bool IsLater (const Event &a, const Event &b);
+  /**
+   * \return the end of the near future
+   */
+  uint64_t GetHorizon (void) const;
+
+  /// the events of a bucket, a binary heap with the first one at the top
+  typedef std::vector<Scheduler::Event> Bucket;
+  typedef std::map<Scheduler::EventKey, EventImpl*> EventMap;
+
+  std::vector<Bucket> m_buckets;  //!< the buckets of the near future
+  std::vector<uint64_t> m_bitmap; //!< one bit per bucket, set when the bucket holds an event
+  uint32_t m_mask;                //!< the number of buckets minus one
+  uint64_t m_width;               //!< the duration of a bucket in time steps
+  uint64_t m_start;               //!< the start of the first bucket of the near future
+  uint32_t m_nearEvents;          //!< the number of events in the buckets
+  EventMap m_far;                 //!< the events beyond the near future
+};
+
+} // namespace ns3
+
+#endif /* LADDER_SCHEDULER_H */
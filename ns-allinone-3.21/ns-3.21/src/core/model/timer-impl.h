@@ -50,8 +50,27 @@ public:
             typename T4, typename T5, typename T6>
   void SetArgs (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6);
 
-  virtual EventId Schedule (const Time &delay) = 0;
+  /**
+   * Schedule the function of the timer with its arguments. The event
+   * of the previous expiry is scheduled again when nothing else refers
+   * to it any more and the arguments have not changed since, so that a
+   * recurring timer does not allocate an event every time.
+   *
+   * \param delay the delay before the function is invoked
+   * \return the id of the event
+   */
+  EventId Schedule (const Time &delay);
   virtual void Invoke (void) = 0;
+
+protected:
+  /**
+   * \return a new event which invokes the function of the timer with
+   *          the current arguments
+   */
+  virtual EventImpl *CreateEvent (void) = 0;
+
+private:
+  Ptr<EventImpl> m_event; //!< the event of the last Schedule
 };
 
 
@@ -113,9 +132,9 @@ MakeTimerImpl (IntToType<0>, FN fn)
       : m_fn (fn)
     {
     }
-    virtual EventId Schedule (const Time &delay)
+    virtual EventImpl *CreateEvent (void)
     {
-      return Simulator::Schedule (delay, m_fn);
+      return MakeEvent (m_fn);
     }
     virtual void Invoke (void)
     {
@@ -144,9 +163,9 @@ MakeTimerImpl (IntToType<1>, FN fn)
     {
       m_a1 = a1;
     }
-    virtual EventId Schedule (const Time &delay)
+    virtual EventImpl *CreateEvent (void)
     {
-      return Simulator::Schedule (delay, m_fn, m_a1);
+      return MakeEvent (m_fn, m_a1);
     }
     virtual void Invoke (void)
     {
@@ -180,9 +199,9 @@ MakeTimerImpl (IntToType<2>, FN fn)
       m_a1 = a1;
       m_a2 = a2;
     }
-    virtual EventId Schedule (const Time &delay)
+    virtual EventImpl *CreateEvent (void)
     {
-      return Simulator::Schedule (delay, m_fn, m_a1, m_a2);
+      return MakeEvent (m_fn, m_a1, m_a2);
     }
     virtual void Invoke (void)
     {
@@ -221,9 +240,9 @@ MakeTimerImpl (IntToType<3>, FN fn)
       m_a2 = a2;
       m_a3 = a3;
     }
-    virtual EventId Schedule (const Time &delay)
+    virtual EventImpl *CreateEvent (void)
     {
-      return Simulator::Schedule (delay, m_fn, m_a1, m_a2, m_a3);
+      return MakeEvent (m_fn, m_a1, m_a2, m_a3);
     }
     virtual void Invoke (void)
     {
@@ -267,9 +286,9 @@ MakeTimerImpl (IntToType<4>, FN fn)
       m_a3 = a3;
       m_a4 = a4;
     }
-    virtual EventId Schedule (const Time &delay)
+    virtual EventImpl *CreateEvent (void)
     {
-      return Simulator::Schedule (delay, m_fn, m_a1, m_a2, m_a3, m_a4);
+      return MakeEvent (m_fn, m_a1, m_a2, m_a3, m_a4);
     }
     virtual void Invoke (void)
     {
@@ -318,9 +337,9 @@ MakeTimerImpl (IntToType<5>, FN fn)
       m_a4 = a4;
       m_a5 = a5;
     }
-    virtual EventId Schedule (const Time &delay)
+    virtual EventImpl *CreateEvent (void)
     {
-      return Simulator::Schedule (delay, m_fn, m_a1, m_a2, m_a3, m_a4, m_a5);
+      return MakeEvent (m_fn, m_a1, m_a2, m_a3, m_a4, m_a5);
     }
     virtual void Invoke (void)
     {
@@ -374,9 +393,9 @@ MakeTimerImpl (IntToType<6>, FN fn)
       m_a5 = a5;
       m_a6 = a6;
     }
-    virtual EventId Schedule (const Time &delay)
+    virtual EventImpl *CreateEvent (void)
     {
-      return Simulator::Schedule (delay, m_fn, m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
+      return MakeEvent (m_fn, m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
     }
     virtual void Invoke (void)
     {
@@ -426,9 +445,9 @@ MakeTimerImpl (IntToType<0>, MEM_PTR memPtr, OBJ_PTR objPtr)
         m_objPtr (objPtr)
     {
     }
-    virtual EventId Schedule (const Time &delay)
+    virtual EventImpl *CreateEvent (void)
     {
-      return Simulator::Schedule (delay, m_memPtr, m_objPtr);
+      return MakeEvent (m_memPtr, m_objPtr);
     }
     virtual void Invoke (void)
     {
@@ -459,9 +478,9 @@ MakeTimerImpl (IntToType<1>, MEM_PTR memPtr, OBJ_PTR objPtr)
     {
       m_a1 = a1;
     }
-    virtual EventId Schedule (const Time &delay)
+    virtual EventImpl *CreateEvent (void)
     {
-      return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1);
+      return MakeEvent (m_memPtr, m_objPtr, m_a1);
     }
     virtual void Invoke (void)
     {
@@ -497,9 +516,9 @@ MakeTimerImpl (IntToType<2>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a1 = a1;
       m_a2 = a2;
     }
-    virtual EventId Schedule (const Time &delay)
+    virtual EventImpl *CreateEvent (void)
     {
-      return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2);
+      return MakeEvent (m_memPtr, m_objPtr, m_a1, m_a2);
     }
     virtual void Invoke (void)
     {
@@ -540,9 +559,9 @@ MakeTimerImpl (IntToType<3>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a2 = a2;
       m_a3 = a3;
     }
-    virtual EventId Schedule (const Time &delay)
+    virtual EventImpl *CreateEvent (void)
     {
-      return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3);
+      return MakeEvent (m_memPtr, m_objPtr, m_a1, m_a2, m_a3);
     }
     virtual void Invoke (void)
     {
@@ -588,9 +607,9 @@ MakeTimerImpl (IntToType<4>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a3 = a3;
       m_a4 = a4;
     }
-    virtual EventId Schedule (const Time &delay)
+    virtual EventImpl *CreateEvent (void)
     {
-      return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4);
+      return MakeEvent (m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4);
     }
     virtual void Invoke (void)
     {
@@ -641,9 +660,9 @@ MakeTimerImpl (IntToType<5>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a4 = a4;
       m_a5 = a5;
     }
-    virtual EventId Schedule (const Time &delay)
+    virtual EventImpl *CreateEvent (void)
     {
-      return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4, m_a5);
+      return MakeEvent (m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4, m_a5);
     }
     virtual void Invoke (void)
     {
@@ -699,9 +718,9 @@ MakeTimerImpl (IntToType<6>, MEM_PTR memPtr, OBJ_PTR objPtr)
       m_a5 = a5;
       m_a6 = a6;
     }
-    virtual EventId Schedule (const Time &delay)
+    virtual EventImpl *CreateEvent (void)
     {
-      return Simulator::Schedule (delay, m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
+      return MakeEvent (m_memPtr, m_objPtr, m_a1, m_a2, m_a3, m_a4, m_a5, m_a6);
     }
     virtual void Invoke (void)
     {
@@ -720,10 +739,25 @@ MakeTimerImpl (IntToType<6>, MEM_PTR memPtr, OBJ_PTR objPtr)
 }
 
 
+inline EventId
+TimerImpl::Schedule (const Time &delay)
+{
+  if (m_event == 0 || m_event->GetReferenceCount () > 1)
+    {
+      m_event = Ptr<EventImpl> (CreateEvent (), false);
+    }
+  else
+    {
+      m_event->Renew ();
+    }
+  return Simulator::Schedule (delay, m_event);
+}
+
 template <typename T1>
 void
 TimerImpl::SetArgs (T1 a1)
 {
+  m_event = 0;
   typedef struct TimerImplOne<
     typename TimerTraits<T1>::ParameterType
     > TimerImplBase;
@@ -740,6 +774,7 @@ template <typename T1, typename T2>
 void
 TimerImpl::SetArgs (T1 a1, T2 a2)
 {
+  m_event = 0;
   typedef struct TimerImplTwo<
     typename TimerTraits<T1>::ParameterType,
     typename TimerTraits<T2>::ParameterType
@@ -757,6 +792,7 @@ template <typename T1, typename T2, typename T3>
 void
 TimerImpl::SetArgs (T1 a1, T2 a2, T3 a3)
 {
+  m_event = 0;
   typedef struct TimerImplThree<
     typename TimerTraits<T1>::ParameterType,
     typename TimerTraits<T2>::ParameterType,
@@ -775,6 +811,7 @@ template <typename T1, typename T2, typename T3, typename T4>
 void
 TimerImpl::SetArgs (T1 a1, T2 a2, T3 a3, T4 a4)
 {
+  m_event = 0;
   typedef struct TimerImplFour<
     typename TimerTraits<T1>::ParameterType,
     typename TimerTraits<T2>::ParameterType,
@@ -794,6 +831,7 @@ template <typename T1, typename T2, typename T3, typename T4, typename T5>
 void
 TimerImpl::SetArgs (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5)
 {
+  m_event = 0;
   typedef struct TimerImplFive<
     typename TimerTraits<T1>::ParameterType,
     typename TimerTraits<T2>::ParameterType,
@@ -814,6 +852,7 @@ template <typename T1, typename T2, typename T3, typename T4, typename T5, typen
 void
 TimerImpl::SetArgs (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6)
 {
+  m_event = 0;
   typedef struct TimerImplSix<
     typename TimerTraits<T1>::ParameterType,
     typename TimerTraits<T2>::ParameterType,
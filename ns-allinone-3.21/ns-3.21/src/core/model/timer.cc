@@ -164,6 +164,8 @@ Timer::Schedule (Time delay)
     {
       NS_FATAL_ERROR ("Event is still running while re-scheduling.");
     }
+  // drop the expired event first, so that the timer can schedule it again
+  m_event = EventId ();
   m_event = m_impl->Schedule (delay);
 }
 
@@ -182,6 +184,7 @@ Timer::Resume (void)
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (m_flags & TIMER_SUSPENDED);
+  m_event = EventId ();
   m_event = m_impl->Schedule (m_delayLeft);
   m_flags &= ~TIMER_SUSPENDED;
 }
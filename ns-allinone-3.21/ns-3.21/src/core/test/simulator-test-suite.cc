@@ -23,6 +23,11 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/ladder-scheduler.h"
+#include "ns3/uinteger.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include <vector>
 
 using namespace ns3;
 
@@ -459,6 +464,89 @@ SimulatorTemplateTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * The LadderScheduler removes the events in the order of the
+ * MapScheduler, with events near and far, inserted in any order, and
+ * removed in between.
+ */
+class LadderSchedulerTestCase : public TestCase
+{
+public:
+  LadderSchedulerTestCase ();
+  virtual void DoRun (void);
+};
+
+LadderSchedulerTestCase::LadderSchedulerTestCase ()
+  : TestCase ("Check the order of the events of the LadderScheduler")
+{
+}
+
+void
+LadderSchedulerTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  ObjectFactory factory;
+  factory.SetTypeId (LadderScheduler::GetTypeId ());
+  factory.Set ("Buckets", UintegerValue (64));
+  factory.Set ("BucketWidth", TimeValue (TimeStep (10)));
+  Ptr<Scheduler> ladder = factory.Create<Scheduler> ();
+  Ptr<Scheduler> map = CreateObject<MapScheduler> ();
+
+  std::vector<Scheduler::Event> events;
+  uint64_t now = 0;
+  uint32_t uid = 0;
+  for (uint32_t n = 0; n < 20000; n++)
+    {
+      uint32_t action = random->GetInteger (0, 9);
+      if (action < 5 || map->IsEmpty ())
+        {
+          Scheduler::Event ev;
+          ev.impl = 0;
+          // mostly within the buckets, sometimes far beyond them
+          uint64_t delay = random->GetInteger (0, 9) < 8 ? random->GetInteger (0, 700) : random->GetInteger (0, 100000);
+          ev.key.m_ts = (n < 100 ? random->GetInteger (0, 1000) : now + delay);
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          ladder->Insert (ev);
+          map->Insert (ev);
+          events.push_back (ev);
+        }
+      else if (action < 7 && !events.empty ())
+        {
+          uint32_t i = random->GetInteger (0, events.size () - 1);
+          ladder->Remove (events[i]);
+          map->Remove (events[i]);
+          events[i] = events.back ();
+          events.pop_back ();
+        }
+      else if (n >= 100)
+        {
+          Scheduler::Event expected = map->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (ladder->PeekNext ().key.m_uid, expected.key.m_uid, "wrong next event");
+          Scheduler::Event ev = ladder->RemoveNext ();
+          NS_TEST_ASSERT_MSG_EQ (ev.key.m_uid, expected.key.m_uid, "wrong event removed at " << now);
+          now = ev.key.m_ts;
+          for (uint32_t i = 0; i < events.size (); i++)
+            {
+              if (events[i].key.m_uid == ev.key.m_uid)
+                {
+                  events[i] = events.back ();
+                  events.pop_back ();
+                  break;
+                }
+            }
+        }
+      NS_TEST_ASSERT_MSG_EQ (ladder->IsEmpty (), map->IsEmpty (), "wrong emptiness");
+    }
+  while (!map->IsEmpty ())
+    {
+      NS_TEST_ASSERT_MSG_EQ (ladder->RemoveNext ().key.m_uid, map->RemoveNext ().key.m_uid, "wrong event removed");
+    }
+  NS_TEST_ASSERT_MSG_EQ (ladder->IsEmpty (), true, "events left in the LadderScheduler");
+}
+
 class SimulatorTestSuite : public TestSuite
 {
 public:
@@ -475,5 +563,8 @@ public:
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (LadderScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new LadderSchedulerTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
@@ -21,6 +21,7 @@
 #include "ns3/test.h"
 #include "ns3/simulator.h"
 #include "ns3/nstime.h"
+#include <vector>
 
 namespace {
 void bari (int)
@@ -208,6 +209,72 @@ TimerTemplateTestCase::DoTeardown (void)
   Simulator::Destroy ();
 }
 
+class TimerRescheduleTestCase : public TestCase
+{
+public:
+  TimerRescheduleTestCase ();
+  virtual void DoRun (void);
+  void Expire (int value);
+
+private:
+  Timer m_timer;
+  std::vector<int> m_values;
+  std::vector<Time> m_times;
+};
+
+TimerRescheduleTestCase::TimerRescheduleTestCase ()
+  : TestCase ("Check that a timer scheduled again invokes the right arguments at the right time"),
+    m_timer (Timer::CANCEL_ON_DESTROY)
+{
+}
+
+void
+TimerRescheduleTestCase::Expire (int value)
+{
+  m_values.push_back (value);
+  m_times.push_back (Simulator::Now ());
+  if (value < 3)
+    {
+      // a recurring timer, scheduled again from its own expiry
+      m_timer.Schedule ();
+    }
+  else if (value == 3)
+    {
+      m_timer.SetArguments (10);
+      m_timer.Schedule ();
+    }
+  else if (value == 10)
+    {
+      m_timer.SetArguments (20);
+      m_timer.Schedule ();
+      m_timer.Cancel ();
+      m_timer.SetArguments (30);
+      m_timer.Schedule (Seconds (5.0));
+    }
+}
+
+void
+TimerRescheduleTestCase::DoRun (void)
+{
+  m_timer.SetFunction (&TimerRescheduleTestCase::Expire, this);
+  m_timer.SetDelay (Seconds (1.0));
+  m_timer.SetArguments (1);
+  m_timer.Schedule ();
+  Simulator::Schedule (Seconds (1.5), &Timer::SetArguments<int>, &m_timer, 3);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  // the arguments of an event are those of its Schedule
+  const int values[] = { 1, 1, 3, 10, 30 };
+  const double times[] = { 1, 2, 3, 4, 9 };
+  NS_TEST_ASSERT_MSG_EQ (m_values.size (), 5, "wrong number of expiries");
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_values[i], values[i], "wrong argument of expiry " << i);
+      NS_TEST_EXPECT_MSG_EQ (m_times[i], Seconds (times[i]), "wrong time of expiry " << i);
+    }
+}
+
 static class TimerTestSuite : public TestSuite
 {
 public:
@@ -216,5 +283,6 @@ public:
   {
     AddTestCase (new TimerStateTestCase (), TestCase::QUICK);
     AddTestCase (new TimerTemplateTestCase (), TestCase::QUICK);
+    AddTestCase (new TimerRescheduleTestCase (), TestCase::QUICK);
   }
 } g_timerTestSuite;
@@ -37,16 +37,20 @@ namespace dot11s {
  * - r  -- the current bitrate of the packet,
  *
  * Final result is expressed in units of 0.01 Time Unit = 10.24 us (as required by 802.11s draft)
+ *
+ * The test frame is sent alone with the mode of the station manager, on
+ * a single stream and with a long preamble. See
+ * AmpduAirtimeLinkMetricCalculator for the links sending A-MPDUs.
  */
 class AirtimeLinkMetricCalculator : public Object
 {
 public:
   AirtimeLinkMetricCalculator ();
   static TypeId GetTypeId ();
-  uint32_t CalculateMetric (Mac48Address peerAddress, Ptr<MeshWifiInterfaceMac> mac);
+  virtual uint32_t CalculateMetric (Mac48Address peerAddress, Ptr<MeshWifiInterfaceMac> mac);
   void SetTestLength (uint16_t testLength);
   void SetHeaderTid (uint8_t tid);
-private:
+protected:
   Ptr<Packet> m_testFrame;
   WifiMacHeader m_testHeader;
 };
@@ -0,0 +1,145 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ampdu-airtime-metric.h"
+#include "ns3/wifi-remote-station-manager.h"
+#include "ns3/wifi-mode.h"
+#include "ns3/wifi-tx-vector.h"
+#include "ns3/simulator.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("AmpduAirtimeLinkMetricCalculator");
+
+namespace ns3 {
+namespace dot11s {
+NS_OBJECT_ENSURE_REGISTERED (AmpduAirtimeLinkMetricCalculator);
+
+TypeId
+AmpduAirtimeLinkMetricCalculator::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::dot11s::AmpduAirtimeLinkMetricCalculator")
+    .SetParent<AirtimeLinkMetricCalculator> ()
+    .AddConstructor<AmpduAirtimeLinkMetricCalculator> ()
+    .AddAttribute ( "RefreshInterval",
+                    "How long the metric of a peer is kept, when the station manager "
+                    "has no UpdateStatistics attribute",
+                    TimeValue (Seconds (0.05)),
+                    MakeTimeAccessor (
+                      &AmpduAirtimeLinkMetricCalculator::m_refreshInterval),
+                    MakeTimeChecker ()
+                    )
+  ;
+  return tid;
+}
+AmpduAirtimeLinkMetricCalculator::AmpduAirtimeLinkMetricCalculator ()
+  : m_nextPurge (Seconds (0))
+{
+}
+WifiPreamble
+AmpduAirtimeLinkMetricCalculator::GetPreamble (WifiMode mode)
+{
+  switch (mode.GetModulationClass ())
+    {
+    case WIFI_MOD_CLASS_VHT:
+      return WIFI_PREAMBLE_VHT;
+    case WIFI_MOD_CLASS_HT:
+      return WIFI_PREAMBLE_HT_MF;
+    default:
+      return WIFI_PREAMBLE_LONG;
+    }
+}
+uint32_t
+AmpduAirtimeLinkMetricCalculator::CalculateMetric (Mac48Address peerAddress, Ptr<MeshWifiInterfaceMac> mac)
+{
+  NS_ASSERT (!peerAddress.IsGroup ());
+  Time now = Simulator::Now ();
+  std::map<Mac48Address, CachedMetric>::const_iterator i = m_metrics.find (peerAddress);
+  if (i != m_metrics.end () && i->second.whenExpire > now)
+    {
+      return i->second.metric;
+    }
+  // refreshed as often as the rate control refreshes its statistics
+  Time interval = m_refreshInterval;
+  TimeValue updateStatistics;
+  if (mac->GetWifiRemoteStationManager ()->GetAttributeFailSafe ("UpdateStatistics", updateStatistics))
+    {
+      interval = updateStatistics.Get ();
+    }
+  if (m_nextPurge <= now)
+    {
+      // forget the peers which are gone with the other expired metrics
+      for (std::map<Mac48Address, CachedMetric>::iterator j = m_metrics.begin (); j != m_metrics.end (); )
+        {
+          if (j->second.whenExpire <= now)
+            {
+              m_metrics.erase (j++);
+            }
+          else
+            {
+              j++;
+            }
+        }
+      m_nextPurge = now + interval;
+    }
+  CachedMetric cached;
+  cached.metric = DoCalculateMetric (peerAddress, mac);
+  cached.whenExpire = now + interval;
+  m_metrics[peerAddress] = cached;
+  NS_LOG_DEBUG ("metric of " << peerAddress << " = " << cached.metric);
+  return cached.metric;
+}
+uint32_t
+AmpduAirtimeLinkMetricCalculator::DoCalculateMetric (Mac48Address peerAddress, Ptr<MeshWifiInterfaceMac> mac)
+{
+  Ptr<WifiRemoteStationManager> manager = mac->GetWifiRemoteStationManager ();
+  //obtain frame error rate:
+  double failAvg = manager->GetInfo (peerAddress).GetFrameErrorRate ();
+  if (failAvg == 1)
+    {
+      // Return max metric value when frame error rate equals to 1
+      return (uint32_t)0xffffffff;
+    }
+  NS_ASSERT (failAvg < 1.0);
+  uint32_t size = m_testFrame->GetSize ();
+  double nMpdus = manager->GetAverageAmpduLength (peerAddress, &m_testHeader);
+  WifiTxVector txVector = manager->GetDataTxVector (peerAddress, &m_testHeader, m_testFrame, size);
+  //DIFS + SIFS + Ack or BlockAck = PIFS + SLOT + SIFS + Ack or BlockAck
+  Time overhead = mac->GetPifs () + mac->GetSlot () + mac->GetSifs ();
+  Time duration;
+  if (nMpdus <= 1)
+    {
+      WifiTxVector ackTxVector = manager->GetAckTxVector (peerAddress, txVector.GetMode ());
+      overhead += mac->GetWifiPhy ()->CalculateTxDuration (14 /*Ack*/, ackTxVector,
+                                                           GetPreamble (ackTxVector.GetMode ()));
+      duration = mac->GetWifiPhy ()->CalculateTxDuration (size, txVector, GetPreamble (txVector.GetMode ()));
+      nMpdus = 1;
+    }
+  else
+    {
+      WifiTxVector blockAckTxVector = manager->GetBlockAckTxVector (peerAddress, txVector.GetMode ());
+      overhead += mac->GetWifiPhy ()->CalculateTxDuration (32 /*compressed BlockAck*/, blockAckTxVector,
+                                                           GetPreamble (blockAckTxVector.GetMode ()));
+      // every MPDU has a 4 bytes delimiter and is padded to a multiple of 4 bytes
+      uint32_t subframeSize = (4 + size + 3) & ~3;
+      duration = mac->GetWifiPhy ()->CalculateTxDuration ((uint32_t)(nMpdus * subframeSize + 0.5), txVector,
+                                                          GetPreamble (txVector.GetMode ()));
+    }
+  //the share of the test frame of the airtime of the A-MPDU, in microseconds
+  double airtime = (overhead + duration).GetSeconds () * 1e6 / nMpdus;
+  return (uint32_t)(airtime / (10.24 * (1.0 - failAvg)));
+}
+} // namespace dot11s
+} // namespace ns3
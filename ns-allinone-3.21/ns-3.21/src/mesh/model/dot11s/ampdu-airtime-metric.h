@@ -0,0 +1,81 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef AMPDU_AIRTIME_METRIC_H
+#define AMPDU_AIRTIME_METRIC_H
+#include <map>
+#include "ns3/nstime.h"
+#include "airtime-metric.h"
+namespace ns3 {
+namespace dot11s {
+/**
+ * \ingroup dot11s
+ *
+ * \brief Airtime link metric calculator for the links sending A-MPDUs
+ *
+ * The test frame is sent as one of the A-MPDUs the station manager sends
+ * to the peer, and its airtime is its share of the airtime of the A-MPDU:
+ *
+ * airtime = (O + T(n)) / n / (1 - frame error rate), where:
+ * - n    -- the average number of MPDUs of the A-MPDUs sent to the peer,
+ *           as kept by the rate control, not rounded, 1 without aggregation,
+ * - T(n) -- the time to send n test frames with their A-MPDU delimiters,
+ *           with the data TX vector of the station manager (mode and
+ *           channel width, number of spatial streams, guard interval,
+ *           STBC) and the preamble of its modulation class,
+ * - O    -- DIFS + SIFS + the BlockAck.
+ *
+ * Without aggregation (n is 1), T(1) is the time to send the test frame
+ * alone, with the same TX vector and preamble, and O ends with the Ack
+ * rather than the BlockAck. This differs from AirtimeLinkMetricCalculator,
+ * which sends the test frame on one stream of 20 MHz with the long
+ * preamble: both metrics only agree on legacy links.
+ *
+ * The metric of a peer is kept for the UpdateStatistics interval of the
+ * station manager, when it has this attribute as the MinstrelWifiManager
+ * does, or for RefreshInterval, rather than worked out again for every
+ * PREQ and PREP. A calculator serves the peers of one interface. The
+ * metrics which have expired, those of the peers which are gone among
+ * them, are removed once per interval.
+ *
+ * It is selected by the LinkMetricCalculator attribute of HwmpProtocol.
+ */
+class AmpduAirtimeLinkMetricCalculator : public AirtimeLinkMetricCalculator
+{
+public:
+  AmpduAirtimeLinkMetricCalculator ();
+  static TypeId GetTypeId ();
+  virtual uint32_t CalculateMetric (Mac48Address peerAddress, Ptr<MeshWifiInterfaceMac> mac);
+private:
+  /// The metric of a peer, until it is worked out again
+  struct CachedMetric
+  {
+    uint32_t metric;
+    Time whenExpire;
+  };
+  /// Work the metric of a peer out, from the station manager
+  uint32_t DoCalculateMetric (Mac48Address peerAddress, Ptr<MeshWifiInterfaceMac> mac);
+  /// \return the preamble of the frames sent with a mode
+  static WifiPreamble GetPreamble (WifiMode mode);
+
+  std::map<Mac48Address, CachedMetric> m_metrics;
+  Time m_refreshInterval;
+  /// When the expired metrics are removed next
+  Time m_nextPurge;
+};
+} // namespace dot11s
+} // namespace ns3
+#endif
@@ -30,6 +30,7 @@
 #include "ns3/mesh-point-device.h"
 #include "ns3/mesh-wifi-interface-mac.h"
 #include "ns3/random-variable-stream.h"
+#include "ns3/object-factory.h"
 #include "airtime-metric.h"
 #include "ie-dot11s-preq.h"
 #include "ie-dot11s-prep.h"
@@ -65,6 +66,21 @@ namespace ns3 {
                                 &HwmpProtocol::m_maxQueueSize),
                             MakeUintegerChecker<uint16_t> (1)
                             )
+                    .AddAttribute ( "MaxQueueTime",
+                            "Maximum time a packet waits for its route, after which it is dropped",
+                            TimeValue (Seconds (3)),
+                            MakeTimeAccessor (
+                                &HwmpProtocol::m_maxQueueTime),
+                            MakeTimeChecker ()
+                            )
+                    .AddAttribute ( "LinkMetricCalculator",
+                            "The type of the airtime link metric calculator of the interfaces, "
+                            "an ns3::dot11s::AirtimeLinkMetricCalculator",
+                            TypeIdValue (AirtimeLinkMetricCalculator::GetTypeId ()),
+                            MakeTypeIdAccessor (
+                                &HwmpProtocol::m_linkMetricCalculator),
+                            MakeTypeIdChecker ()
+                            )
                     .AddAttribute ( "Dot11MeshHWMPmaxPREQretries",
                             "Maximum number of retries before we suppose the destination to be unreachable",
                             UintegerValue (3),
@@ -177,7 +193,10 @@ namespace ns3 {
             m_preqId (0),
             m_rtable (CreateObject<HwmpRtable> ()),
             m_randomStart (Seconds (0.1)),
+            m_rqueueSize (0),
             m_maxQueueSize (255),
+            m_maxQueueTime (Seconds (3)),
+            m_linkMetricCalculator (AirtimeLinkMetricCalculator::GetTypeId ()),
             m_dot11MeshHWMPmaxPREQretries (3),
             m_dot11MeshHWMPnetDiameterTraversalTime (MicroSeconds (1024*100)),
             m_dot11MeshHWMPpreqMinInterval (MicroSeconds (1024*100)),
@@ -227,6 +246,7 @@ namespace ns3 {
                 m_hwmpSeqnoMetricDatabase.clear ();
                 m_interfaces.clear ();
                 m_rqueue.clear ();
+                m_rqueueSize = 0;
                 m_rtable = 0;
                 m_mp = 0;
             }
@@ -277,6 +297,8 @@ namespace ns3 {
                     m_stats.txBytes += packet->GetSize ();
                     //channel IDs where we have already sent broadcast:
                     std::vector<uint16_t> channels;
+                    //the interface and the address of each receiver
+                    std::vector<std::pair<uint32_t, Mac48Address> > receivers;
                     for (HwmpProtocolMacMap::const_iterator plugin = m_interfaces.begin (); plugin != m_interfaces.end (); plugin++)
                     {
                         bool shouldSend = true;
@@ -292,22 +314,28 @@ namespace ns3 {
                             continue;
                         }
                         channels.push_back (plugin->second->GetChannelId ());
-                        std::vector<Mac48Address> receivers = GetBroadcastReceivers (plugin->first);
-                        for (std::vector<Mac48Address>::const_iterator i = receivers.begin (); i != receivers.end (); i++)
+                        std::vector<Mac48Address> addresses = GetBroadcastReceivers (plugin->first);
+                        for (std::vector<Mac48Address>::const_iterator i = addresses.begin (); i != addresses.end (); i++)
                         {
-                            Ptr<Packet> packetCopy = packet->Copy ();
-                            //
-                            // 64-bit Intel valgrind complains about tag.SetAddress (*i).  It
-                            // likes this just fine.
-                            //
-                            Mac48Address address = *i;
-                            tag.SetAddress (address);
-                            packetCopy->AddPacketTag (tag);
-                            ArpHeader arp;
-                            packetCopy->PeekHeader (arp);
-                            routeReply (true, packetCopy, source, destination, protocolType, plugin->first);
+                            receivers.push_back (std::make_pair (plugin->first, *i));
                         }
                     }
+                    //each receiver has its own HwmpTag, so its own copy of
+                    //the packet, but for the last one which takes the packet
+                    for (uint32_t i = 0; i < receivers.size (); i++)
+                    {
+                        Ptr<Packet> packetCopy = (i + 1 < receivers.size ()) ? packet->Copy () : packet;
+                        //
+                        // 64-bit Intel valgrind complains about tag.SetAddress (receivers[i].second).  It
+                        // likes this just fine.
+                        //
+                        Mac48Address address = receivers[i].second;
+                        tag.SetAddress (address);
+                        packetCopy->AddPacketTag (tag);
+                        ArpHeader arp;
+                        packetCopy->PeekHeader (arp);
+                        routeReply (true, packetCopy, source, destination, protocolType, receivers[i].first);
+                    }
                 }
                 else
                 {
@@ -395,6 +423,7 @@ namespace ns3 {
                 pkt.protocol = protocolType;
                 pkt.reply = routeReply;
                 pkt.inInterface = sourceIface;
+                pkt.whenQueued = Simulator::Now ();
                 if (QueuePacket (pkt))
                 {
                     m_stats.totalQueued++;
@@ -721,7 +750,13 @@ namespace ns3 {
                     m_interfaces[wifiNetDev->GetIfIndex ()] = hwmpMac;
                     mac->InstallPlugin (hwmpMac);
                     //Installing airtime link metric:
-                    Ptr<AirtimeLinkMetricCalculator> metric = CreateObject <AirtimeLinkMetricCalculator> ();
+                    ObjectFactory factory;
+                    factory.SetTypeId (m_linkMetricCalculator);
+                    Ptr<AirtimeLinkMetricCalculator> metric = factory.Create<AirtimeLinkMetricCalculator> ();
+                    if (metric == 0)
+                    {
+                        NS_FATAL_ERROR (m_linkMetricCalculator.GetName () << " is not an airtime link metric calculator");
+                    }
                     mac->SetLinkMetricCallback (MakeCallback (&AirtimeLinkMetricCalculator::CalculateMetric, metric));
                 }
                 mp->SetRoutingProtocol (this);
@@ -879,42 +914,82 @@ namespace ns3 {
         bool
             HwmpProtocol::QueuePacket (QueuedPacket packet)
             {
-                if (m_rqueue.size () > m_maxQueueSize)
+                std::map<Mac48Address, PacketQueue>::iterator queue = m_rqueue.find (packet.dst);
+                if (queue != m_rqueue.end ())
+                {
+                    ExpireQueue (queue->second);
+                }
+                if (m_rqueueSize > m_maxQueueSize)
+                {
+                    // the stale packets of the other destinations must not hold the place of this one
+                    for (std::map<Mac48Address, PacketQueue>::iterator i = m_rqueue.begin (); i != m_rqueue.end (); )
+                    {
+                        ExpireQueue (i->second);
+                        if (i->second.empty ())
+                        {
+                            m_rqueue.erase (i++);
+                        }
+                        else
+                        {
+                            i++;
+                        }
+                    }
+                }
+                if (m_rqueueSize > m_maxQueueSize)
                 {
                     return false;
                 }
-                m_rqueue.push_back (packet);
+                m_rqueue[packet.dst].push_back (packet);
+                m_rqueueSize++;
                 return true;
             }
 
-        HwmpProtocol::QueuedPacket
-            HwmpProtocol::DequeueFirstPacketByDst (Mac48Address dst)
+        void
+            HwmpProtocol::ExpireQueue (PacketQueue & queue)
             {
-                QueuedPacket retval;
-                retval.pkt = 0;
-                for (std::vector<QueuedPacket>::iterator i = m_rqueue.begin (); i != m_rqueue.end (); i++)
+                while (!queue.empty () && Simulator::Now () - queue.front ().whenQueued > m_maxQueueTime)
                 {
-                    if ((*i).dst == dst)
-                    {
-                        retval = (*i);
-                        m_rqueue.erase (i);
-                        break;
-                    }
+                    QueuedPacket packet = queue.front ();
+                    queue.pop_front ();
+                    m_rqueueSize--;
+                    m_stats.totalDropped++;
+                    packet.reply (false, packet.pkt, packet.src, packet.dst, packet.protocol, HwmpRtable::MAX_METRIC);
                 }
-                return retval;
             }
 
-        HwmpProtocol::QueuedPacket
-            HwmpProtocol::DequeueFirstPacket ()
+        void
+            HwmpProtocol::SendQueue (PacketQueue & queue, Mac48Address retransmitter, uint32_t interface)
             {
-                QueuedPacket retval;
-                retval.pkt = 0;
-                if (m_rqueue.size () != 0)
+                HwmpProtocolMacMap::const_iterator mac = m_interfaces.find (interface);
+                if (mac != m_interfaces.end ())
                 {
-                    retval = m_rqueue[0];
-                    m_rqueue.erase (m_rqueue.begin ());
+                    mac->second->m_parent->HoldAccess ();
+                }
+                for (PacketQueue::iterator packet = queue.begin (); packet != queue.end (); packet++)
+                {
+                    if (Simulator::Now () - packet->whenQueued > m_maxQueueTime)
+                    {
+                        m_stats.totalDropped++;
+                        packet->reply (false, packet->pkt, packet->src, packet->dst, packet->protocol, HwmpRtable::MAX_METRIC);
+                        continue;
+                    }
+                    //set RA tag for retransmitter:
+                    HwmpTag tag;
+                    if (!packet->pkt->RemovePacketTag (tag))
+                    {
+                        NS_FATAL_ERROR ("HWMP tag must be present at this point");
+                    }
+                    tag.SetAddress (retransmitter);
+                    packet->pkt->AddPacketTag (tag);
+                    m_stats.txUnicast++;
+                    m_stats.txBytes += packet->pkt->GetSize ();
+                    packet->reply (true, packet->pkt, packet->src, packet->dst, packet->protocol, interface);
+                }
+                queue.clear ();
+                if (mac != m_interfaces.end ())
+                {
+                    mac->second->m_parent->ReleaseAccess ();
                 }
-                return retval;
             }
 
         void
@@ -929,20 +1004,16 @@ namespace ns3 {
                 HwmpRtable::LookupResult result = m_rtable->LookupReactive (dst);
                 NS_ASSERT (result.retransmitter != Mac48Address::GetBroadcast ());
                 //Send all packets stored for this destination
-                QueuedPacket packet = DequeueFirstPacketByDst (dst);
-                while (packet.pkt != 0)
+                std::map<Mac48Address, PacketQueue>::iterator queue = m_rqueue.find (dst);
+                if (queue == m_rqueue.end ())
                 {
-                    //set RA tag for retransmitter:
-                    HwmpTag tag;
-                    packet.pkt->RemovePacketTag (tag);
-                    tag.SetAddress (result.retransmitter);
-                    packet.pkt->AddPacketTag (tag);
-                    m_stats.txUnicast++;
-                    m_stats.txBytes += packet.pkt->GetSize ();
-                    packet.reply (true, packet.pkt, packet.src, packet.dst, packet.protocol, result.ifIndex);
-
-                    packet = DequeueFirstPacketByDst (dst);
+                    return;
                 }
+                PacketQueue packets;
+                packets.swap (queue->second);
+                m_rqueue.erase (queue);
+                m_rqueueSize -= packets.size ();
+                SendQueue (packets, result.retransmitter, result.ifIndex);
             }
         void
             HwmpProtocol::ProactivePathResolved ()
@@ -950,23 +1021,14 @@ namespace ns3 {
                 //send all packets to root
                 HwmpRtable::LookupResult result = m_rtable->LookupProactive ();
                 NS_ASSERT (result.retransmitter != Mac48Address::GetBroadcast ());
-                QueuedPacket packet = DequeueFirstPacket ();
-                while (packet.pkt != 0)
+                PacketQueue packets;
+                for (std::map<Mac48Address, PacketQueue>::const_iterator i = m_rqueue.begin (); i != m_rqueue.end (); i++)
                 {
-                    //set RA tag for retransmitter:
-                    HwmpTag tag;
-                    if (!packet.pkt->RemovePacketTag (tag))
-                    {
-                        NS_FATAL_ERROR ("HWMP tag must be present at this point");
-                    }
-                    tag.SetAddress (result.retransmitter);
-                    packet.pkt->AddPacketTag (tag);
-                    m_stats.txUnicast++;
-                    m_stats.txBytes += packet.pkt->GetSize ();
-                    packet.reply (true, packet.pkt, packet.src, packet.dst, packet.protocol, result.ifIndex);
-
-                    packet = DequeueFirstPacket ();
+                    packets.insert (packets.end (), i->second.begin (), i->second.end ());
                 }
+                m_rqueue.clear ();
+                m_rqueueSize = 0;
+                SendQueue (packets, result.retransmitter, result.ifIndex);
             }
 
         bool
@@ -1000,13 +1062,19 @@ namespace ns3 {
                 }
                 if (numOfRetry > m_dot11MeshHWMPmaxPREQretries)
                 {
-                    QueuedPacket packet = DequeueFirstPacketByDst (dst);
                     //purge queue and delete entry from retryDatabase
-                    while (packet.pkt != 0)
+                    std::map<Mac48Address, PacketQueue>::iterator queue = m_rqueue.find (dst);
+                    if (queue != m_rqueue.end ())
                     {
-                        m_stats.totalDropped++;
-                        packet.reply (false, packet.pkt, packet.src, packet.dst, packet.protocol, HwmpRtable::MAX_METRIC);
-                        packet = DequeueFirstPacketByDst (dst);
+                        PacketQueue packets;
+                        packets.swap (queue->second);
+                        m_rqueue.erase (queue);
+                        m_rqueueSize -= packets.size ();
+                        for (PacketQueue::iterator packet = packets.begin (); packet != packets.end (); packet++)
+                        {
+                            m_stats.totalDropped++;
+                            packet->reply (false, packet->pkt, packet->src, packet->dst, packet->protocol, HwmpRtable::MAX_METRIC);
+                        }
                     }
                     std::map<Mac48Address, PreqEvent>::iterator i = m_preqTimeouts.find (dst);
                     NS_ASSERT (i != m_preqTimeouts.end ());
@@ -1143,6 +1211,7 @@ namespace ns3 {
                 os << "<Hwmp "
                     "address=\"" << m_address << "\"" << std::endl <<
                     "maxQueueSize=\"" << m_maxQueueSize << "\"" << std::endl <<
+                    "maxQueueTime=\"" << m_maxQueueTime.GetSeconds () << "\"" << std::endl <<
                     "Dot11MeshHWMPmaxPREQretries=\"" << (uint16_t)m_dot11MeshHWMPmaxPREQretries << "\"" << std::endl <<
                     "Dot11MeshHWMPnetDiameterTraversalTime=\"" << m_dot11MeshHWMPnetDiameterTraversalTime.GetSeconds () << "\"" << std::endl <<
                     "Dot11MeshHWMPpreqMinInterval=\"" << m_dot11MeshHWMPpreqMinInterval.GetSeconds () << "\"" << std::endl <<
@@ -1182,11 +1251,17 @@ namespace ns3 {
                 m_coefficient->SetStream (stream);
                 return 1;
             }
+        Ptr<HwmpRtable>
+            HwmpProtocol::GetRoutingTable () const
+            {
+                return m_rtable;
+            }
 
         HwmpProtocol::QueuedPacket::QueuedPacket () :
             pkt (0),
             protocol (0),
-            inInterface (0)
+            inInterface (0),
+            whenQueued (Seconds (0))
         {
         }
     } // namespace dot11s
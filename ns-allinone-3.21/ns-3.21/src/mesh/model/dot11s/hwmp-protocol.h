@@ -26,6 +26,7 @@
 #include "ns3/event-id.h"
 #include "ns3/traced-value.h"
 #include <vector>
+#include <deque>
 #include <map>
 
 namespace ns3 {
@@ -95,6 +96,14 @@ public:
    * \return the number of stream indices assigned by this model
    */
   int64_t AssignStreams (int64_t stream);
+  /// \return the routing table, for the tests and the benchmarks to fill it
+  Ptr<HwmpRtable> GetRoutingTable () const;
+  /**
+   * \brief Send the packets queued for a destination whose path is resolved, as a PREP does
+   *
+   * The tests call it after adding the path to the routing table.
+   */
+  void ReactivePathResolved (Mac48Address dst);
 
 private:
   friend class HwmpProtocolMac;
@@ -122,9 +131,12 @@ private:
     uint16_t protocol; ///< protocol number
     uint32_t inInterface; ///< incoming device interface ID. (if packet has come from upper layers, this is Mesh point ID)
     RouteReplyCallback reply; ///< how to reply
+    Time whenQueued; ///< when the packet was queued
 
     QueuedPacket ();
   };
+  /// Packets waiting for the path to their destination, in the order they were queued
+  typedef std::deque<QueuedPacket> PacketQueue;
   typedef std::map<uint32_t, Ptr<HwmpProtocolMac> > HwmpProtocolMacMap;
   /// Like RequestRoute, but for unicast packets
   bool ForwardUnicast (uint32_t  sourceIface, const Mac48Address source, const Mac48Address destination,
@@ -175,9 +187,19 @@ private:
   ///\name Methods related to Queue/Dequeue procedures
   ///\{
   bool QueuePacket (QueuedPacket packet);
-  QueuedPacket  DequeueFirstPacketByDst (Mac48Address dst);
-  QueuedPacket  DequeueFirstPacket ();
-  void ReactivePathResolved (Mac48Address dst);
+  /// Drop the packets queued for longer than MaxQueueTime at the head of a queue
+  void ExpireQueue (PacketQueue & queue);
+  /**
+   * \brief Send the packets of a queue to the next hop of their path, as one batch
+   *
+   * \param queue the packets, emptied
+   * \param retransmitter the next hop
+   * \param interface the interface to the next hop
+   *
+   * The MAC of the interface does not request the channel before it has
+   * all of them, so that it can aggregate them.
+   */
+  void SendQueue (PacketQueue & queue, Mac48Address retransmitter, uint32_t interface);
   void ProactivePathResolved ();
   ///\}
   ///\name Methods responsible for path discovery retry procedure:
@@ -259,11 +281,15 @@ private:
   /// Random start in Proactive PREQ propagation
   Time m_randomStart;
   ///\}
-  /// Packet Queue
-  std::vector<QueuedPacket> m_rqueue;
+  /// Packets waiting for a path, by destination
+  std::map<Mac48Address, PacketQueue> m_rqueue;
+  /// Number of packets in all the queues of m_rqueue
+  uint32_t m_rqueueSize;
   ///\name HWMP-protocol parameters (attributes of GetTypeId)
   ///\{
   uint16_t m_maxQueueSize;
+  Time m_maxQueueTime;
+  TypeId m_linkMetricCalculator;
   uint8_t m_dot11MeshHWMPmaxPREQretries;
   Time m_dot11MeshHWMPnetDiameterTraversalTime;
   Time m_dot11MeshHWMPpreqMinInterval;
@@ -25,6 +25,7 @@
 #include "ns3/log.h"
 
 #include "hwmp-rtable.h"
+#include <algorithm>
 
 namespace ns3 {
 namespace dot11s {
@@ -41,8 +42,17 @@ HwmpRtable::GetTypeId ()
     .AddConstructor<HwmpRtable> ();
   return tid;
 }
-HwmpRtable::HwmpRtable ()
+HwmpRtable::HwmpRtable () :
+  m_keys (16, 0),
+  m_routes (16),
+  m_nRoutes (0),
+  m_earliestExpiry (Time::Max ()),
+  m_lastPurge (Seconds (0))
 {
+  for (uint32_t i = 0; i < CACHE_LINES; i++)
+    {
+      m_cache[i].key = 0;
+    }
   DeleteProactivePath ();
 }
 HwmpRtable::~HwmpRtable ()
@@ -51,25 +61,153 @@ HwmpRtable::~HwmpRtable ()
 void
 HwmpRtable::DoDispose ()
 {
-  m_routes.clear ();
+  m_keys.assign (16, 0);
+  m_routes.assign (16, ReactiveRoute ());
+  m_nRoutes = 0;
+  for (uint32_t i = 0; i < CACHE_LINES; i++)
+    {
+      m_cache[i].key = 0;
+    }
+}
+uint64_t
+HwmpRtable::GetKey (Mac48Address destination)
+{
+  uint8_t buffer[6];
+  destination.CopyTo (buffer);
+  uint64_t key = 1;
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      key = (key << 8) | buffer[i];
+    }
+  return key;
+}
+static Mac48Address
+GetAddress (uint64_t key)
+{
+  uint8_t buffer[6];
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      buffer[5 - i] = (key >> (8 * i)) & 0xff;
+    }
+  Mac48Address address;
+  address.CopyFrom (buffer);
+  return address;
+}
+uint64_t
+HwmpRtable::Hash (uint64_t key)
+{
+  // Fibonacci hashing, the high bits are the best mixed
+  return key * 0x9e3779b97f4a7c15ULL;
+}
+uint32_t
+HwmpRtable::GetHome (uint64_t key) const
+{
+  return (Hash (key) >> 32) & (m_keys.size () - 1);
+}
+uint32_t
+HwmpRtable::Find (uint64_t key) const
+{
+  uint32_t mask = m_keys.size () - 1;
+  for (uint32_t i = GetHome (key); m_keys[i] != 0; i = (i + 1) & mask)
+    {
+      if (m_keys[i] == key)
+        {
+          return i;
+        }
+    }
+  return m_keys.size ();
+}
+uint32_t
+HwmpRtable::FindOrInsert (uint64_t key)
+{
+  if ((m_nRoutes + 1) * 2 > m_keys.size ())
+    {
+      Grow ();
+    }
+  uint32_t mask = m_keys.size () - 1;
+  uint32_t i = GetHome (key);
+  for (; m_keys[i] != 0; i = (i + 1) & mask)
+    {
+      if (m_keys[i] == key)
+        {
+          return i;
+        }
+    }
+  m_keys[i] = key;
+  m_routes[i] = ReactiveRoute ();
+  m_nRoutes++;
+  return i;
 }
 void
-HwmpRtable::AddReactivePath (Mac48Address destination, Mac48Address retransmitter, uint32_t interface,
-                             uint32_t metric, Time lifetime, uint32_t seqnum)
+HwmpRtable::Erase (uint32_t slot)
 {
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
-  if (i == m_routes.end ())
+  uint32_t mask = m_keys.size () - 1;
+  uint32_t hole = slot;
+  for (uint32_t i = (slot + 1) & mask; m_keys[i] != 0; i = (i + 1) & mask)
     {
-      ReactiveRoute newroute;
-      m_routes[destination] = newroute;
+      // the route of slot i can fill the hole if its probe sequence goes
+      // through the hole, that is if its home is not in (hole, i]
+      uint32_t home = GetHome (m_keys[i]);
+      if (((i - home) & mask) >= ((i - hole) & mask))
+        {
+          m_keys[hole] = m_keys[i];
+          m_routes[hole] = m_routes[i];
+          hole = i;
+        }
     }
-  i = m_routes.find (destination);
-  NS_ASSERT (i != m_routes.end ());
-  i->second.retransmitter = retransmitter;
-  i->second.interface = interface;
-  i->second.metric = metric;
-  i->second.whenExpire = Simulator::Now () + lifetime;
-  i->second.seqnum = seqnum;
+  m_keys[hole] = 0;
+  m_routes[hole] = ReactiveRoute ();
+  m_nRoutes--;
+}
+void
+HwmpRtable::Grow ()
+{
+  std::vector<uint64_t> keys (m_keys.size () * 2, 0);
+  std::vector<ReactiveRoute> routes (m_keys.size () * 2);
+  keys.swap (m_keys);
+  routes.swap (m_routes);
+  uint32_t mask = m_keys.size () - 1;
+  for (uint32_t j = 0; j < keys.size (); j++)
+    {
+      if (keys[j] == 0)
+        {
+          continue;
+        }
+      uint32_t i = GetHome (keys[j]);
+      while (m_keys[i] != 0)
+        {
+          i = (i + 1) & mask;
+        }
+      m_keys[i] = keys[j];
+      m_routes[i] = routes[j];
+    }
+}
+HwmpRtable::CacheLine &
+HwmpRtable::GetCacheLine (uint64_t key)
+{
+  return m_cache[(Hash (key) >> 40) & (CACHE_LINES - 1)];
+}
+void
+HwmpRtable::Invalidate (uint64_t key)
+{
+  CacheLine & line = GetCacheLine (key);
+  if (line.key == key)
+    {
+      line.key = 0;
+    }
+}
+void
+HwmpRtable::AddReactivePath (Mac48Address destination, Mac48Address retransmitter, uint32_t interface,
+                             uint32_t metric, Time lifetime, uint32_t seqnum)
+{
+  uint64_t key = GetKey (destination);
+  ReactiveRoute & route = m_routes[FindOrInsert (key)];
+  route.retransmitter = retransmitter;
+  route.interface = interface;
+  route.metric = metric;
+  route.whenExpire = Simulator::Now () + lifetime;
+  route.seqnum = seqnum;
+  Invalidate (key);
 }
 void
 HwmpRtable::AddProactivePath (uint32_t metric, Mac48Address root, Mac48Address retransmitter,
@@ -86,28 +224,51 @@ void
 HwmpRtable::AddPrecursor (Mac48Address destination, uint32_t precursorInterface,
                           Mac48Address precursorAddress, Time lifetime)
 {
+  Time now = Simulator::Now ();
   Precursor precursor;
   precursor.interface = precursorInterface;
   precursor.address = precursorAddress;
-  precursor.whenExpire = Simulator::Now () + lifetime;
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
-  if (i != m_routes.end ())
+  precursor.whenExpire = now + lifetime;
+  uint32_t slot = Find (GetKey (destination));
+  if (slot == m_keys.size ())
     {
-      bool should_add = true;
-      for (unsigned int j = 0; j < i->second.precursors.size (); j++)
+      return;
+    }
+  ReactiveRoute & route = m_routes[slot];
+  for (uint32_t j = 0; j < route.nPrecursors; j++)
+    {
+      //NB: Only one active route may exist, so do not check
+      //interface ID, just address
+      if (route.GetPrecursor (j).address == precursorAddress)
         {
-          //NB: Only one active route may exist, so do not check
-          //interface ID, just address
-          if (i->second.precursors[j].address == precursorAddress)
-            {
-              should_add = false;
-              i->second.precursors[j].whenExpire = precursor.whenExpire;
-              break;
-            }
+          route.GetPrecursor (j).whenExpire = precursor.whenExpire;
+          return;
         }
-      if (should_add)
+    }
+  if (now >= m_earliestExpiry && now >= m_lastPurge + Seconds (1))
+    {
+      PurgePrecursors (now);
+    }
+  route.AppendPrecursor (precursor);
+  m_earliestExpiry = std::min (m_earliestExpiry, precursor.whenExpire);
+}
+void
+HwmpRtable::PurgePrecursors (Time now)
+{
+  NS_LOG_FUNCTION (this << now);
+  m_earliestExpiry = Time::Max ();
+  m_lastPurge = now;
+  for (uint32_t i = 0; i < m_keys.size (); i++)
+    {
+      if (m_keys[i] == 0)
+        {
+          continue;
+        }
+      ReactiveRoute & route = m_routes[i];
+      route.PurgePrecursors (now);
+      for (uint32_t j = 0; j < route.nPrecursors; j++)
         {
-          i->second.precursors.push_back (precursor);
+          m_earliestExpiry = std::min (m_earliestExpiry, route.GetPrecursor (j).whenExpire);
         }
     }
 }
@@ -132,37 +293,56 @@ HwmpRtable::DeleteProactivePath (Mac48Address root)
 void
 HwmpRtable::DeleteReactivePath (Mac48Address destination)
 {
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
-  if (i != m_routes.end ())
+  uint64_t key = GetKey (destination);
+  uint32_t slot = Find (key);
+  if (slot != m_keys.size ())
     {
-      m_routes.erase (i);
+      Invalidate (key);
+      Erase (slot);
     }
 }
 HwmpRtable::LookupResult
-HwmpRtable::LookupReactive (Mac48Address destination)
+HwmpRtable::DoLookupReactive (Mac48Address destination, Time now, bool & expired)
 {
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
-  if (i == m_routes.end ())
+  uint64_t key = GetKey (destination);
+  CacheLine & line = GetCacheLine (key);
+  if (line.key != key)
     {
-      return LookupResult ();
+      uint32_t slot = Find (key);
+      if (slot == m_keys.size ())
+        {
+          expired = false;
+          return LookupResult ();
+        }
+      const ReactiveRoute & route = m_routes[slot];
+      line.key = key;
+      line.retransmitter = route.retransmitter;
+      line.interface = route.interface;
+      line.metric = route.metric;
+      line.seqnum = route.seqnum;
+      line.whenExpire = route.whenExpire;
     }
-  if ((i->second.whenExpire < Simulator::Now ()) && (i->second.whenExpire != Seconds (0)))
+  expired = (line.whenExpire < now) && !line.whenExpire.IsZero ();
+  return LookupResult (line.retransmitter, line.interface, line.metric, line.seqnum,
+                       line.whenExpire - now);
+}
+HwmpRtable::LookupResult
+HwmpRtable::LookupReactive (Mac48Address destination)
+{
+  bool expired;
+  LookupResult result = DoLookupReactive (destination, Simulator::Now (), expired);
+  if (expired)
     {
       NS_LOG_DEBUG ("Reactive route has expired, sorry.");
       return LookupResult ();
     }
-  return LookupReactiveExpired (destination);
+  return result;
 }
 HwmpRtable::LookupResult
 HwmpRtable::LookupReactiveExpired (Mac48Address destination)
 {
-  std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.find (destination);
-  if (i == m_routes.end ())
-    {
-      return LookupResult ();
-    }
-  return LookupResult (i->second.retransmitter, i->second.interface, i->second.metric, i->second.seqnum,
-                       i->second.whenExpire - Simulator::Now ());
+  bool expired;
+  return DoLookupReactive (destination, Simulator::Now (), expired);
 }
 HwmpRtable::LookupResult
 HwmpRtable::LookupProactive ()
@@ -180,21 +360,29 @@ HwmpRtable::LookupProactiveExpired ()
   return LookupResult (m_root.retransmitter, m_root.interface, m_root.metric, m_root.seqnum,
                        m_root.whenExpire - Simulator::Now ());
 }
+static bool
+IsBefore (const HwmpProtocol::FailedDestination & a, const HwmpProtocol::FailedDestination & b)
+{
+  return a.destination < b.destination;
+}
 std::vector<HwmpProtocol::FailedDestination>
 HwmpRtable::GetUnreachableDestinations (Mac48Address peerAddress)
 {
   HwmpProtocol::FailedDestination dst;
   std::vector<HwmpProtocol::FailedDestination> retval;
-  for (std::map<Mac48Address, ReactiveRoute>::iterator i = m_routes.begin (); i != m_routes.end (); i++)
+  for (uint32_t i = 0; i < m_keys.size (); i++)
     {
-      if (i->second.retransmitter == peerAddress)
+      if (m_keys[i] != 0 && m_routes[i].retransmitter == peerAddress)
         {
-          dst.destination = i->first;
-          i->second.seqnum++;
-          dst.seqnum = i->second.seqnum;
+          dst.destination = GetAddress (m_keys[i]);
+          m_routes[i].seqnum++;
+          dst.seqnum = m_routes[i].seqnum;
           retval.push_back (dst);
+          Invalidate (m_keys[i]);
         }
     }
+  // in the order of the destinations, whatever their slots
+  std::sort (retval.begin (), retval.end (), &IsBefore);
   //Lookup a path to root
   if (m_root.retransmitter == peerAddress)
     {
@@ -209,20 +397,67 @@ HwmpRtable::GetPrecursors (Mac48Address destination)
 {
   //We suppose that no duplicates here can be
   PrecursorList retval;
-  std::map<Mac48Address, ReactiveRoute>::iterator route = m_routes.find (destination);
-  if (route != m_routes.end ())
+  uint32_t slot = Find (GetKey (destination));
+  if (slot != m_keys.size ())
     {
-      for (std::vector<Precursor>::const_iterator i = route->second.precursors.begin ();
-           i != route->second.precursors.end (); i++)
+      Time now = Simulator::Now ();
+      ReactiveRoute & route = m_routes[slot];
+      for (uint32_t j = 0; j < route.nPrecursors; j++)
         {
-          if (i->whenExpire > Simulator::Now ())
+          const Precursor & precursor = route.GetPrecursor (j);
+          if (precursor.whenExpire > now)
             {
-              retval.push_back (std::make_pair (i->interface, i->address));
+              retval.push_back (std::make_pair (precursor.interface, precursor.address));
             }
         }
     }
   return retval;
 }
+HwmpRtable::ReactiveRoute::ReactiveRoute () :
+  retransmitter (Mac48Address::GetBroadcast ()),
+  interface (INTERFACE_ANY),
+  metric (MAX_METRIC),
+  seqnum (0),
+  nPrecursors (0)
+{
+}
+HwmpRtable::Precursor &
+HwmpRtable::ReactiveRoute::GetPrecursor (uint32_t i)
+{
+  NS_ASSERT (i < nPrecursors);
+  if (i < INLINE_PRECURSORS)
+    {
+      return precursors[i];
+    }
+  return morePrecursors[i - INLINE_PRECURSORS];
+}
+void
+HwmpRtable::ReactiveRoute::AppendPrecursor (const Precursor & precursor)
+{
+  if (nPrecursors < INLINE_PRECURSORS)
+    {
+      precursors[nPrecursors] = precursor;
+    }
+  else
+    {
+      morePrecursors.push_back (precursor);
+    }
+  nPrecursors++;
+}
+void
+HwmpRtable::ReactiveRoute::PurgePrecursors (Time now)
+{
+  uint32_t kept = 0;
+  for (uint32_t i = 0; i < nPrecursors; i++)
+    {
+      if (GetPrecursor (i).whenExpire > now)
+        {
+          GetPrecursor (kept++) = GetPrecursor (i);
+        }
+    }
+  morePrecursors.resize (kept > INLINE_PRECURSORS ? kept - INLINE_PRECURSORS : 0);
+  nPrecursors = kept;
+}
 bool
 HwmpRtable::LookupResult::operator== (const HwmpRtable::LookupResult & o) const
 {
@@ -21,7 +21,7 @@
 #ifndef HWMP_RTABLE_H
 #define HWMP_RTABLE_H
 
-#include <map>
+#include <vector>
 #include "ns3/nstime.h"
 #include "ns3/mac48-address.h"
 #include "ns3/hwmp-protocol.h"
@@ -31,6 +31,14 @@ namespace dot11s {
  * \ingroup dot11s
  *
  * \brief Routing table for HWMP -- 802.11s routing protocol
+ *
+ * The reactive routes are kept in an open addressing hash table keyed by
+ * destination, with linear probing, and the last routes looked up in a
+ * small direct-mapped cache in front of it, so that forwarding a data
+ * frame takes a single lookup of a few words in large meshes. Expired
+ * routes stay in the table, for the path errors and the sequence numbers,
+ * and the expired precursors are purged from all routes in batches, at
+ * most once a second, when a precursor is added after one has expired.
  */
 class HwmpRtable : public Object
 {
@@ -108,13 +116,16 @@ public:
   std::vector<HwmpProtocol::FailedDestination> GetUnreachableDestinations (Mac48Address peerAddress);
 
 private:
-  /// Route found in reactive mode
+  /// Path precursor
   struct Precursor
   {
     Mac48Address address;
     uint32_t interface;
     Time whenExpire;
   };
+  /// The number of precursors stored in a route itself
+  static const uint32_t INLINE_PRECURSORS = 4;
+  /// Route found in reactive mode
   struct ReactiveRoute
   {
     Mac48Address retransmitter;
@@ -122,7 +133,17 @@ private:
     uint32_t metric;
     Time whenExpire;
     uint32_t seqnum;
-    std::vector<Precursor> precursors;
+    uint32_t nPrecursors; ///< the number of precursors
+    Precursor precursors[INLINE_PRECURSORS]; ///< the first precursors
+    std::vector<Precursor> morePrecursors; ///< the precursors beyond the first ones
+
+    ReactiveRoute ();
+    /// \return the precursor of a given index, lower than nPrecursors
+    Precursor & GetPrecursor (uint32_t i);
+    /// Append a precursor
+    void AppendPrecursor (const Precursor & precursor);
+    /// Remove the precursors expired at a given time, keeping the others in order
+    void PurgePrecursors (Time now);
   };
   /// Route fond in proactive mode
   struct ProactiveRoute
@@ -135,9 +156,59 @@ private:
     uint32_t seqnum;
     std::vector<Precursor> precursors;
   };
+  /// A reactive route looked up recently
+  struct CacheLine
+  {
+    uint64_t key; ///< the key of the destination, 0 when the line is empty
+    Mac48Address retransmitter;
+    uint32_t interface;
+    uint32_t metric;
+    uint32_t seqnum;
+    Time whenExpire;
+  };
+  /// The number of lines of the cache, a power of two
+  static const uint32_t CACHE_LINES = 64;
+
+  /// \return the key of a destination in the table, never 0
+  static uint64_t GetKey (Mac48Address destination);
+  /// \return the hash of a key
+  static uint64_t Hash (uint64_t key);
+  /// \return the first slot to probe for a key
+  uint32_t GetHome (uint64_t key) const;
+  /// \return the slot of a destination, or m_keys.size () when it has no route
+  uint32_t Find (uint64_t key) const;
+  /// \return the slot of a destination, inserting a route when it has none
+  uint32_t FindOrInsert (uint64_t key);
+  /// Remove the route of a slot, moving the following routes of its probe sequence back
+  void Erase (uint32_t slot);
+  /// Double the number of slots
+  void Grow ();
+  /// \return the cache line of a destination
+  CacheLine & GetCacheLine (uint64_t key);
+  /// Forget the cached route of a destination
+  void Invalidate (uint64_t key);
+  /**
+   * \param destination the destination
+   * \param now the current time
+   * \return the reactive route to destination, expired or not, and
+   *         whether it has expired, from the cache when it holds it
+   */
+  LookupResult DoLookupReactive (Mac48Address destination, Time now, bool & expired);
+  /// Purge the expired precursors of all routes
+  void PurgePrecursors (Time now);
 
-  /// List of routes
-  std::map<Mac48Address, ReactiveRoute>  m_routes;
+  /// The destination of each slot of the table, 0 when the slot is free
+  std::vector<uint64_t> m_keys;
+  /// The reactive route of each slot of the table
+  std::vector<ReactiveRoute> m_routes;
+  /// The number of reactive routes
+  uint32_t m_nRoutes;
+  /// The last reactive routes looked up, direct-mapped
+  CacheLine m_cache[CACHE_LINES];
+  /// The earliest expiry of the precursors, the purged ones aside
+  Time m_earliestExpiry;
+  /// The time of the last purge of the precursors
+  Time m_lastPurge;
   /// Path to proactive tree root MP
   ProactiveRoute  m_root;
 };
@@ -107,7 +107,10 @@ namespace ns3 {
             }
             if (dst48.IsGroup ())
             {
+                // the routing stuff is removed from a copy, the packet itself is forwarded
                 Ptr<Packet> packet_copy = packet->Copy ();
+                m_rxStats.copies++;
+                m_rxStats.copiedBytes += packet->GetSize ();
                 if (m_routingProtocol->RemoveRoutingStuff (incomingPort->GetIfIndex (), src48, dst48, packet_copy, realProtocol))
                 {
                     m_rxCallback (this, packet_copy, realProtocol, src);
@@ -121,6 +124,8 @@ namespace ns3 {
             if (dst48 == m_address)
             {
                 Ptr<Packet> packet_copy = packet->Copy ();
+                m_rxStats.copies++;
+                m_rxStats.copiedBytes += packet->GetSize ();
                 if (m_routingProtocol->RemoveRoutingStuff (incomingPort->GetIfIndex (), src48, dst48, packet_copy, realProtocol))
                 {
                     m_rxCallback (this, packet_copy, realProtocol, src);
@@ -130,7 +135,10 @@ namespace ns3 {
                 return;
             }
             else
-                Forward (incomingPort, packet->Copy (), protocol, src48, dst48);
+            {
+                // the routing protocol makes its own copy
+                Forward (incomingPort, packet, protocol, src48, dst48);
+            }
         }
 
     void
@@ -438,14 +446,23 @@ namespace ns3 {
             }
             else
             {
+                // the last interface sends the packet itself
                 for (std::vector<Ptr<NetDevice> >::iterator i = m_ifaces.begin (); i != m_ifaces.end (); i++)
                 {
+                    if (i + 1 == m_ifaces.end ())
+                    {
+                        (*i)->SendFrom (packet, src, dst, protocol);
+                        break;
+                    }
+                    stats->copies++;
+                    stats->copiedBytes += packet->GetSize ();
                     (*i)->SendFrom (packet->Copy (), src, dst, protocol);
                 }
             }
         }
     MeshPointDevice::Statistics::Statistics () :
-        unicastData (0), unicastDataBytes (0), broadcastData (0), broadcastDataBytes (0)
+        unicastData (0), unicastDataBytes (0), broadcastData (0), broadcastDataBytes (0),
+        copies (0), copiedBytes (0)
     {
     }
 
@@ -457,14 +474,20 @@ namespace ns3 {
                 "txUnicastDataBytes=\"" << m_txStats.unicastDataBytes << "\"" << std::endl <<
                 "txBroadcastData=\"" << m_txStats.broadcastData << "\"" << std::endl <<
                 "txBroadcastDataBytes=\"" << m_txStats.broadcastDataBytes << "\"" << std::endl <<
+                "txCopies=\"" << m_txStats.copies << "\"" << std::endl <<
+                "txCopiedBytes=\"" << m_txStats.copiedBytes << "\"" << std::endl <<
                 "rxUnicastData=\"" << m_rxStats.unicastData << "\"" << std::endl <<
                 "rxUnicastDataBytes=\"" << m_rxStats.unicastDataBytes << "\"" << std::endl <<
                 "rxBroadcastData=\"" << m_rxStats.broadcastData << "\"" << std::endl <<
                 "rxBroadcastDataBytes=\"" << m_rxStats.broadcastDataBytes << "\"" << std::endl <<
+                "rxCopies=\"" << m_rxStats.copies << "\"" << std::endl <<
+                "rxCopiedBytes=\"" << m_rxStats.copiedBytes << "\"" << std::endl <<
                 "fwdUnicastData=\"" << m_fwdStats.unicastData << "\"" << std::endl <<
                 "fwdUnicastDataBytes=\"" << m_fwdStats.unicastDataBytes << "\"" << std::endl <<
                 "fwdBroadcastData=\"" << m_fwdStats.broadcastData << "\"" << std::endl <<
                 "fwdBroadcastDataBytes=\"" << m_fwdStats.broadcastDataBytes << "\"" << std::endl <<
+                "fwdCopies=\"" << m_fwdStats.copies << "\"" << std::endl <<
+                "fwdCopiedBytes=\"" << m_fwdStats.copiedBytes << "\"" << std::endl <<
                 "/>" << std::endl;
         }
 
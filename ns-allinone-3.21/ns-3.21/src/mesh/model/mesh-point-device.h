@@ -175,6 +175,9 @@ private:
     uint32_t unicastDataBytes;
     uint32_t broadcastData;
     uint32_t broadcastDataBytes;
+    /// Packet copies made by the device, to remove the routing stuff or to send on several interfaces
+    uint32_t copies;
+    uint32_t copiedBytes;
 
     Statistics ();
   };
@@ -109,6 +109,24 @@ namespace ns3 {
         {
             return true;
         }
+    void
+        MeshWifiInterfaceMac::HoldAccess ()
+        {
+            NS_LOG_FUNCTION (this);
+            for (EdcaQueues::const_iterator i = m_edca.begin (); i != m_edca.end (); i++)
+            {
+                i->second->HoldAccess ();
+            }
+        }
+    void
+        MeshWifiInterfaceMac::ReleaseAccess ()
+        {
+            NS_LOG_FUNCTION (this);
+            for (EdcaQueues::const_iterator i = m_edca.begin (); i != m_edca.end (); i++)
+            {
+                i->second->ReleaseAccess ();
+            }
+        }
     void
         MeshWifiInterfaceMac::SetLinkUpCallback (Callback<void> linkUp)
         {
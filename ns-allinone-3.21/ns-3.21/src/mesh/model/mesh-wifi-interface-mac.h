@@ -71,6 +71,16 @@ public:
   virtual bool  SupportsSendFrom () const;
   virtual void  SetLinkUpCallback (Callback<void> linkUp);
   // \}
+  ///\name Batches of frames
+  // \{
+  /**
+   * Hold the channel access of the data queues until ReleaseAccess, so
+   * that the frames enqueued meanwhile are aggregated as a batch.
+   */
+  void HoldAccess ();
+  /// Request the channel for the frames enqueued since HoldAccess
+  void ReleaseAccess ();
+  // \}
   ///\name Each mesh point interfaces must know the mesh point address
   // \{
   void SetMeshPointAddress (Mac48Address);
@@ -25,6 +25,23 @@
 #include "ns3/hwmp-rtable.h"
 #include "ns3/peer-link-frame.h"
 #include "ns3/ie-dot11s-peer-management.h"
+#include "ns3/config.h"
+#include "ns3/string.h"
+#include "ns3/uinteger.h"
+#include "ns3/double.h"
+#include "ns3/node-container.h"
+#include "ns3/mesh-helper.h"
+#include "ns3/mesh-point-device.h"
+#include "ns3/mesh-wifi-interface-mac.h"
+#include "ns3/yans-wifi-helper.h"
+#include "ns3/wifi-net-device.h"
+#include "ns3/constant-rate-wifi-manager.h"
+#include "ns3/hwmp-protocol.h"
+#include "ns3/edca-txop-n.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/pointer.h"
+#include "ns3/node.h"
+#include "ns3/constant-position-mobility-model.h"
 
 using namespace ns3;
 using namespace dot11s;
@@ -107,6 +124,8 @@ private:
   void TestPrecursorAdd ();
   void TestPrecursorFind ();
   ///\}
+  /// Test many paths, deleted or not, and many precursors of a path
+  void TestManyPaths ();
 private:
   Mac48Address dst;
   Mac48Address hop;
@@ -192,12 +211,50 @@ HwmpRtableTest::TestPrecursorFind ()
     }
 }
 
+void
+HwmpRtableTest::TestManyPaths ()
+{
+  Ptr<HwmpRtable> many = CreateObject<HwmpRtable> ();
+  std::vector<Mac48Address> destinations;
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      uint8_t buffer[6] = { 0, 0, 0, 0, (uint8_t)(i >> 8), (uint8_t)i };
+      Mac48Address destination;
+      destination.CopyFrom (buffer);
+      destinations.push_back (destination);
+      many->AddReactivePath (destination, hop, i, metric, expire, seqnum);
+      // looked up before the next ones are added, to fill the cache
+      NS_TEST_EXPECT_MSG_EQ (many->LookupReactive (destination).ifIndex, i, "Reactive lookup works");
+    }
+  for (uint32_t i = 1; i < 1000; i += 2)
+    {
+      many->DeleteReactivePath (destinations[i]);
+    }
+  for (uint32_t i = 0; i < 1000; i++)
+    {
+      HwmpRtable::LookupResult correct (hop, i, metric, seqnum);
+      NS_TEST_EXPECT_MSG_EQ ((many->LookupReactive (destinations[i]) == correct), (i % 2 == 0),
+                             "Reactive lookup works after deletions");
+    }
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      many->AddPrecursor (destinations[0], iface, destinations[i], Seconds (100));
+    }
+  HwmpRtable::PrecursorList precursorList = many->GetPrecursors (destinations[0]);
+  NS_TEST_EXPECT_MSG_EQ (precursorList.size (), 10, "Precursors size works");
+  for (unsigned i = 0; i < precursorList.size (); i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (precursorList[i].second, destinations[i], "Precursors lookup works");
+    }
+}
+
 void
 HwmpRtableTest::DoRun ()
 {
   table = CreateObject<HwmpRtable> ();
 
   Simulator::Schedule (Seconds (0), &HwmpRtableTest::TestLookup, this);
+  Simulator::Schedule (Seconds (0), &HwmpRtableTest::TestManyPaths, this);
   Simulator::Schedule (Seconds (1), &HwmpRtableTest::TestAddPath, this);
   Simulator::Schedule (Seconds (2), &HwmpRtableTest::TestPrecursorAdd, this);
   Simulator::Schedule (expire + Seconds (2), &HwmpRtableTest::TestExpire, this);
@@ -270,6 +327,309 @@ PeerLinkFrameStartTest::DoRun ()
   }
 }
 //-----------------------------------------------------------------------------
+/// Unit test for the queues of the packets waiting for a path in HwmpProtocol
+class HwmpQueueTest : public TestCase
+{
+public:
+  HwmpQueueTest ();
+  virtual void DoRun ();
+
+private:
+  /// Ask a path for the packet of a given id, which is queued
+  void Send (Mac48Address dst, uint32_t id);
+  /// Add the path to a destination and send its queue
+  void Resolve (Mac48Address dst, uint32_t batchSize);
+  /// Route reply: the id of a packet is its size
+  void Reply (bool success, Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol, uint32_t iface);
+
+  Ptr<MeshPointDevice> m_mp;
+  Ptr<HwmpProtocol> m_hwmp;
+  uint32_t m_iface;
+  std::vector<uint32_t> m_sent;
+  std::vector<uint32_t> m_dropped;
+  std::vector<Time> m_dropTimes;
+};
+
+HwmpQueueTest::HwmpQueueTest () :
+  TestCase ("HWMP queues of the packets waiting for a path")
+{
+}
+
+void
+HwmpQueueTest::Send (Mac48Address dst, uint32_t id)
+{
+  Mac48Address src = Mac48Address::ConvertFrom (m_mp->GetAddress ());
+  m_hwmp->RequestRoute (m_mp->GetIfIndex (), src, dst, Create<Packet> (id), 0x0800,
+                        MakeCallback (&HwmpQueueTest::Reply, this));
+}
+
+void
+HwmpQueueTest::Resolve (Mac48Address dst, uint32_t batchSize)
+{
+  m_hwmp->GetRoutingTable ()->AddReactivePath (dst, Mac48Address ("00:00:00:00:01:01"), m_iface, 1, Seconds (100), 1);
+  uint32_t before = m_sent.size ();
+  m_hwmp->ReactivePathResolved (dst);
+  NS_TEST_EXPECT_MSG_EQ (m_sent.size () - before, batchSize, "the queue of " << dst << " is sent at once");
+}
+
+void
+HwmpQueueTest::Reply (bool success, Ptr<Packet> packet, Mac48Address src, Mac48Address dst, uint16_t protocol, uint32_t iface)
+{
+  if (success)
+    {
+      NS_TEST_EXPECT_MSG_EQ (iface, m_iface, "interface of the path");
+      m_sent.push_back (packet->GetSize ());
+    }
+  else
+    {
+      m_dropped.push_back (packet->GetSize ());
+      m_dropTimes.push_back (Simulator::Now ());
+    }
+}
+
+void
+HwmpQueueTest::DoRun ()
+{
+  NodeContainer nodes;
+  nodes.Create (1);
+  nodes.Get (0)->AggregateObject (CreateObject<ConstantPositionMobilityModel> ());
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  NetDeviceContainer devices = mesh.Install (phy, nodes);
+  m_mp = DynamicCast<MeshPointDevice> (devices.Get (0));
+  m_hwmp = m_mp->GetObject<HwmpProtocol> ();
+  m_hwmp->SetAttribute ("MaxQueueTime", TimeValue (Seconds (1)));
+  m_hwmp->SetAttribute ("MaxQueueSize", UintegerValue (8));
+  m_iface = m_mp->GetInterfaces ()[0]->GetIfIndex ();
+
+  // 100 waits too long in the queue and is dropped when 102 is queued,
+  // 101 waits too long and is dropped when the path is resolved
+  Mac48Address expiring ("00:00:00:00:00:01");
+  Simulator::Schedule (Seconds (0), &HwmpQueueTest::Send, this, expiring, 100);
+  Simulator::Schedule (Seconds (0.5), &HwmpQueueTest::Send, this, expiring, 101);
+  Simulator::Schedule (Seconds (1.2), &HwmpQueueTest::Send, this, expiring, 102);
+  Simulator::Schedule (Seconds (1.6), &HwmpQueueTest::Resolve, this, expiring, 1);
+  // a burst to another destination is sent in order, as one batch
+  Mac48Address burst ("00:00:00:00:00:02");
+  for (uint32_t i = 0; i < 5; i++)
+    {
+      Simulator::Schedule (Seconds (1 + 0.01 * i), &HwmpQueueTest::Send, this, burst, 200 + i);
+    }
+  Simulator::Schedule (Seconds (1.3), &HwmpQueueTest::Resolve, this, burst, 5);
+  // 102 finds the queues full but takes the place of 100; 400 finds them
+  // full again and takes the place of the stale packets of another destination
+  Mac48Address stale ("00:00:00:00:00:03");
+  Simulator::Schedule (Seconds (0.1), &HwmpQueueTest::Send, this, stale, 300);
+  Simulator::Schedule (Seconds (0.2), &HwmpQueueTest::Send, this, stale, 301);
+  Mac48Address late ("00:00:00:00:00:04");
+  Simulator::Schedule (Seconds (1.25), &HwmpQueueTest::Send, this, late, 400);
+  Simulator::Stop (Seconds (2));
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  uint32_t sent[] = { 200, 201, 202, 203, 204, 102 };
+  NS_TEST_ASSERT_MSG_EQ (m_sent.size (), 6, "sent packets");
+  for (uint32_t i = 0; i < 6; i++)
+    {
+      NS_TEST_EXPECT_MSG_EQ (m_sent[i], sent[i], "packet " << i << " sent");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_dropped.size (), 4, "dropped packets");
+  NS_TEST_EXPECT_MSG_EQ (m_dropped[0], 100, "first dropped packet");
+  NS_TEST_EXPECT_MSG_EQ (m_dropTimes[0], Seconds (1.2), "dropped when a packet is queued");
+  NS_TEST_EXPECT_MSG_EQ (m_dropped[1], 300, "second dropped packet");
+  NS_TEST_EXPECT_MSG_EQ (m_dropTimes[1], Seconds (1.25), "dropped when the queues are full");
+  NS_TEST_EXPECT_MSG_EQ (m_dropped[2], 301, "third dropped packet");
+  NS_TEST_EXPECT_MSG_EQ (m_dropTimes[2], Seconds (1.25), "dropped when the queues are full");
+  NS_TEST_EXPECT_MSG_EQ (m_dropped[3], 101, "fourth dropped packet");
+  NS_TEST_EXPECT_MSG_EQ (m_dropTimes[3], Seconds (1.6), "dropped when the queue is sent");
+  m_mp = 0;
+  m_hwmp = 0;
+}
+//-----------------------------------------------------------------------------
+/// Unit test for HoldAccess and ReleaseAccess of EdcaTxopN
+class EdcaHoldAccessTest : public TestCase
+{
+public:
+  EdcaHoldAccessTest ();
+  virtual void DoRun ();
+
+private:
+  void PhyTxBegin (Ptr<const Packet> packet);
+  /// Check that no data frame was sent, then release the access
+  void CheckAndRelease ();
+  /// Check that the data frame was sent
+  void CheckSent ();
+
+  Ptr<EdcaTxopN> m_edca;
+  uint32_t m_nData;
+};
+
+EdcaHoldAccessTest::EdcaHoldAccessTest () :
+  TestCase ("EdcaTxopN does not contend while its access is held"),
+  m_nData (0)
+{
+}
+
+void
+EdcaHoldAccessTest::PhyTxBegin (Ptr<const Packet> packet)
+{
+  // the data frame is much longer than the beacons
+  if (packet->GetSize () > 1000)
+    {
+      m_nData++;
+    }
+}
+
+void
+EdcaHoldAccessTest::CheckAndRelease ()
+{
+  NS_TEST_EXPECT_MSG_EQ (m_nData, 0, "data frame sent while held, at " << Simulator::Now ().GetSeconds () << " s");
+  m_edca->ReleaseAccess ();
+}
+
+void
+EdcaHoldAccessTest::CheckSent ()
+{
+  NS_TEST_EXPECT_MSG_GT (m_nData, 0, "data frame not sent after the last release");
+}
+
+void
+EdcaHoldAccessTest::DoRun ()
+{
+  NodeContainer nodes;
+  nodes.Create (1);
+  nodes.Get (0)->AggregateObject (CreateObject<ConstantPositionMobilityModel> ());
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  NetDeviceContainer devices = mesh.Install (phy, nodes);
+  Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (devices.Get (0));
+  Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (mp->GetInterfaces ()[0]);
+  device->GetPhy ()->TraceConnectWithoutContext ("PhyTxBegin", MakeCallback (&EdcaHoldAccessTest::PhyTxBegin, this));
+  PointerValue queue;
+  device->GetMac ()->GetAttribute ("BE_EdcaTxopN", queue);
+  m_edca = queue.Get<EdcaTxopN> ();
+
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_QOSDATA);
+  hdr.SetQosTid (0);
+  hdr.SetAddr1 (Mac48Address ("00:00:00:00:01:01"));
+  hdr.SetAddr2 (device->GetMac ()->GetAddress ());
+  hdr.SetAddr3 (device->GetMac ()->GetAddress ());
+  hdr.SetDsNotFrom ();
+  hdr.SetDsNotTo ();
+  // two nested holds, the frame waits for the second release
+  Simulator::Schedule (Seconds (0.1), &EdcaTxopN::HoldAccess, m_edca);
+  Simulator::Schedule (Seconds (0.1), &EdcaTxopN::HoldAccess, m_edca);
+  Simulator::Schedule (Seconds (0.1), &EdcaTxopN::Queue, m_edca, Create<Packet> (1500), hdr);
+  Simulator::Schedule (Seconds (0.2), &EdcaHoldAccessTest::CheckAndRelease, this);
+  Simulator::Schedule (Seconds (0.3), &EdcaHoldAccessTest::CheckAndRelease, this);
+  Simulator::Schedule (Seconds (0.31), &EdcaHoldAccessTest::CheckSent, this);
+  Simulator::Stop (Seconds (0.31));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_edca = 0;
+}
+//-----------------------------------------------------------------------------
+/// Constant rate manager which reports a fixed average A-MPDU length
+class AmpduLengthTestWifiManager : public ConstantRateWifiManager
+{
+public:
+  static TypeId GetTypeId ();
+  virtual double DoGetAverageAmpduLength (WifiRemoteStation *st);
+private:
+  double m_ampduLength;
+};
+
+NS_OBJECT_ENSURE_REGISTERED (AmpduLengthTestWifiManager);
+
+TypeId
+AmpduLengthTestWifiManager::GetTypeId ()
+{
+  static TypeId tid = TypeId ("ns3::dot11s::AmpduLengthTestWifiManager")
+    .SetParent<ConstantRateWifiManager> ()
+    .AddConstructor<AmpduLengthTestWifiManager> ()
+    .AddAttribute ("AmpduLength", "The average number of MPDUs of the A-MPDUs",
+                   DoubleValue (1),
+                   MakeDoubleAccessor (&AmpduLengthTestWifiManager::m_ampduLength),
+                   MakeDoubleChecker<double> (1))
+  ;
+  return tid;
+}
+
+double
+AmpduLengthTestWifiManager::DoGetAverageAmpduLength (WifiRemoteStation *st)
+{
+  return m_ampduLength;
+}
+
+/// Unit test for the link metric calculators selected by HwmpProtocol
+struct AmpduAirtimeMetricTest : public TestCase
+{
+  AmpduAirtimeMetricTest () :
+    TestCase ("Airtime link metric of aggregated links")
+  {
+  }
+  virtual void DoRun ();
+  /// \return the link metric of a peer on a 802.11a interface at 6 Mbit/s
+  uint32_t GetMetric (std::string calculator, double ampduLength);
+};
+
+uint32_t
+AmpduAirtimeMetricTest::GetMetric (std::string calculator, double ampduLength)
+{
+  Config::SetDefault ("ns3::dot11s::HwmpProtocol::LinkMetricCalculator", StringValue (calculator));
+  NodeContainer nodes;
+  nodes.Create (1);
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (YansWifiChannelHelper::Default ().Create ());
+  MeshHelper mesh = MeshHelper::Default ();
+  mesh.SetStandard (WIFI_PHY_STANDARD_80211a);
+  mesh.SetStackInstaller ("ns3::Dot11sStack");
+  mesh.SetRemoteStationManager ("ns3::dot11s::AmpduLengthTestWifiManager",
+                                "DataMode", StringValue ("OfdmRate6Mbps"),
+                                "AmpduLength", DoubleValue (ampduLength));
+  NetDeviceContainer devices = mesh.Install (phy, nodes);
+  Ptr<MeshPointDevice> mp = DynamicCast<MeshPointDevice> (devices.Get (0));
+  Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (mp->GetInterfaces ()[0]);
+  Ptr<MeshWifiInterfaceMac> mac = DynamicCast<MeshWifiInterfaceMac> (device->GetMac ());
+  uint32_t metric = mac->GetLinkMetric (Mac48Address ("00:00:00:00:00:99"));
+  Simulator::Destroy ();
+  Config::SetDefault ("ns3::dot11s::HwmpProtocol::LinkMetricCalculator",
+                      StringValue ("ns3::dot11s::AirtimeLinkMetricCalculator"));
+  return metric;
+}
+
+void
+AmpduAirtimeMetricTest::DoRun ()
+{
+  uint32_t plain = GetMetric ("ns3::dot11s::AirtimeLinkMetricCalculator", 1);
+  NS_TEST_EXPECT_MSG_EQ (GetMetric ("ns3::dot11s::AirtimeLinkMetricCalculator", 4), plain,
+                         "the airtime metric ignores aggregation");
+  NS_TEST_EXPECT_MSG_EQ (GetMetric ("ns3::dot11s::AmpduAirtimeLinkMetricCalculator", 1), plain,
+                         "no aggregation on a legacy link, the plain airtime metric");
+  /*
+   * 6 Mbit/s OFDM sends 24 bits (after 16 service bits, then 6 tail bits)
+   * per 4 us symbol, after 20 us of preamble and header. The 1066 bytes
+   * test frame (1024 + mesh and 802.11 headers) with its 4 bytes delimiter
+   * is padded to 1072 bytes:
+   *  - A-MPDU of 4 test frames: ceil ((16 + 4 * 1072 * 8 + 6) / 24) = 1431 symbols,
+   *  - compressed BlockAck, at 6 Mbit/s: ceil ((16 + 32 * 8 + 6) / 24) = 12 symbols,
+   *  - DIFS + SIFS = PIFS + SLOT + SIFS = 25 + 9 + 16 us.
+   */
+  double airtime = (25 + 9 + 16 + (20 + 12 * 4) + (20 + 1431 * 4)) / 4.0;
+  uint32_t ampdu = GetMetric ("ns3::dot11s::AmpduAirtimeLinkMetricCalculator", 4);
+  NS_TEST_EXPECT_MSG_EQ (ampdu, (uint32_t)(airtime / 10.24), "share of the airtime of an A-MPDU of 4 MPDUs");
+  NS_TEST_EXPECT_MSG_LT (ampdu, plain, "aggregation lowers the metric");
+  uint32_t fractional = GetMetric ("ns3::dot11s::AmpduAirtimeLinkMetricCalculator", 2.5);
+  NS_TEST_EXPECT_MSG_GT (fractional, ampdu, "shorter A-MPDUs");
+  NS_TEST_EXPECT_MSG_LT (fractional, GetMetric ("ns3::dot11s::AmpduAirtimeLinkMetricCalculator", 2),
+                         "the average length is not rounded down");
+}
+//-----------------------------------------------------------------------------
 class Dot11sTestSuite : public TestSuite
 {
 public:
@@ -281,7 +641,10 @@ Dot11sTestSuite::Dot11sTestSuite ()
 {
   AddTestCase (new MeshHeaderTest, TestCase::QUICK);
   AddTestCase (new HwmpRtableTest, TestCase::QUICK);
+  AddTestCase (new HwmpQueueTest, TestCase::QUICK);
+  AddTestCase (new EdcaHoldAccessTest, TestCase::QUICK);
   AddTestCase (new PeerLinkFrameStartTest, TestCase::QUICK);
+  AddTestCase (new AmpduAirtimeMetricTest, TestCase::QUICK);
 }
 
 static Dot11sTestSuite g_dot11sTestSuite;
@@ -20,7 +20,8 @@
 
 /**
   \file   packet-tag-list.cc
-  \brief  Implements a linked list of Packet tags, including copy-on-write semantics.
+  \brief  Implements the packet tags of a Packet: the tags of the common types
+          inline, the others in a linked list with copy-on-write semantics.
   */
 
 #include "packet-tag-list.h"
@@ -34,6 +35,27 @@ NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
 namespace ns3 {
 
+    namespace {
+
+        /// the dense id plus one of each tag type, by uid, 0 if it has none yet
+        uint8_t g_ids[65536];
+        /// the number of dense ids given
+        uint32_t g_nIds = 0;
+
+    } // anonymous namespace
+
+    uint32_t
+        PacketTagList::GetId (TypeId tid, bool assign)
+        {
+            uint8_t *id = &g_ids[tid.GetUid ()];
+            if (*id == 0 && assign)
+            {
+                *id = g_nIds < INDEXED_TYPES ? ++g_nIds : INDEXED_TYPES + 1;
+                NS_LOG_LOGIC ("dense id of " << tid.GetName () << ": " << (uint32_t)*id - 1);
+            }
+            return (uint32_t)*id - 1;
+        }
+
     bool
         PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
         {
@@ -157,6 +179,26 @@ namespace ns3 {
     bool
         PacketTagList::Remove (Tag & tag)
         {
+            uint32_t id = GetId (tag.GetInstanceTypeId (), false);
+            if (id < INDEXED_TYPES)
+            {
+                uint32_t position = GetPosition (id);
+                if (position != 0)
+                {
+                    NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
+                    struct InlineTag *cur = &m_inline[position - 1];
+                    tag.Deserialize (TagBuffer (cur->data, cur->data + TagData::MAX_SIZE));
+                    SetPosition (id, 0);
+                    m_count--;
+                    if (position - 1 != m_count)
+                    {
+                        // move the last inline tag into the hole
+                        *cur = m_inline[m_count];
+                        SetPosition (cur->id, position);
+                    }
+                    return true;
+                }
+            }
             return COWTraverse (tag, &PacketTagList::RemoveWriter);
         }
 
@@ -196,6 +238,19 @@ namespace ns3 {
     bool
         PacketTagList::Replace (Tag & tag)
         {
+            uint32_t id = GetId (tag.GetInstanceTypeId (), false);
+            if (id < INDEXED_TYPES)
+            {
+                uint32_t position = GetPosition (id);
+                if (position != 0)
+                {
+                    NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
+                    NS_ASSERT (tag.GetSerializedSize () <= TagData::MAX_SIZE);
+                    struct InlineTag *cur = &m_inline[position - 1];
+                    tag.Serialize (TagBuffer (cur->data, cur->data + tag.GetSerializedSize ()));
+                    return true;
+                }
+            }
             bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
             if (!found)
             {
@@ -244,7 +299,10 @@ namespace ns3 {
         PacketTagList::Add (const Tag &tag) const
         {
             NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
+            TypeId tid = tag.GetInstanceTypeId ();
+            uint32_t id = GetId (tid, true);
             // ensure this id was not yet added
+            NS_ASSERT (id >= INDEXED_TYPES || GetPosition (id) == 0);
             for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
             {
                 //JWHUR 
@@ -253,6 +311,18 @@ namespace ns3 {
                 //    return;
                 NS_ASSERT (cur->tid != tag.GetInstanceTypeId ());
             }
+            NS_ASSERT (tag.GetSerializedSize () <= TagData::MAX_SIZE);
+            if (id < INDEXED_TYPES && m_count < INLINE_TAGS)
+            {
+                PacketTagList *self = const_cast<PacketTagList *> (this);
+                struct InlineTag *cur = &self->m_inline[m_count];
+                cur->uid = tid.GetUid ();
+                cur->id = id;
+                tag.Serialize (TagBuffer (cur->data, cur->data + tag.GetSerializedSize ()));
+                self->m_count++;
+                self->SetPosition (id, m_count);
+                return;
+            }
             struct TagData * head = new struct TagData ();
             head->count = 1;
             head->next = 0;
@@ -269,6 +339,17 @@ namespace ns3 {
         {
             NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
             TypeId tid = tag.GetInstanceTypeId ();
+            uint32_t id = GetId (tid, false);
+            if (id < INDEXED_TYPES)
+            {
+                uint32_t position = GetPosition (id);
+                if (position != 0)
+                {
+                    uint8_t *data = const_cast<uint8_t *> (m_inline[position - 1].data);
+                    tag.Deserialize (TagBuffer (data, data + TagData::MAX_SIZE));
+                    return true;
+                }
+            }
             for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
             {
                 if (cur->tid == tid) 
@@ -288,5 +369,17 @@ namespace ns3 {
             return m_next;
         }
 
+    const struct PacketTagList::InlineTag *
+        PacketTagList::Inline (void) const
+        {
+            return m_inline;
+        }
+
+    uint32_t
+        PacketTagList::InlineCount (void) const
+        {
+            return m_count;
+        }
+
 } /* namespace ns3 */
 
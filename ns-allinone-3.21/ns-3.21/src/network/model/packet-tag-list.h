@@ -22,10 +22,12 @@
 
 /**
 \file   packet-tag-list.h
-\brief  Defines a linked list of Packet tags, including copy-on-write semantics.
+\brief  Defines the packet tags of a Packet: the tags of the common types
+        inline, the others in a linked list with copy-on-write semantics.
 */
 
 #include <stdint.h>
+#include <cstring>
 #include <ostream>
 #include "ns3/type-id.h"
 
@@ -43,8 +45,22 @@ class Tag;
  *
  * \internal
  *
- * The implementation of this class is a bit tricky.  Refer to this
- * diagram in the discussion that follows.
+ * \par <b> Inline tags </b>
+ *
+ * The first #INDEXED_TYPES tag types added to a packet of the simulation
+ * are each given a dense id on their first #Add. Up to #INLINE_TAGS tags
+ * of these types are stored in serialized form in the PacketTagList
+ * itself, in an array of InlineTag, and #m_index gives the position in
+ * the array of the tag of each dense id, four bits per id. Finding,
+ * adding, replacing and removing such a tag thus takes constant time and
+ * no allocation, and the copy of a PacketTagList copies its inline tags
+ * only. Removing a tag moves the last inline tag into its position.
+ *
+ * \par <b> Linked list </b>
+ *
+ * The tags of the other types, and those which do not fit in the array,
+ * are kept in a linked list. Its implementation is a bit tricky.  Refer
+ * to this diagram in the discussion that follows.
  *
  * \dot
  *    digraph {
@@ -167,6 +183,23 @@ public:
     uint32_t count;           /**< Number of incoming links */
   };  /* struct TagData */
 
+  /// the sizes of the inline tags
+  enum
+  {
+    INDEXED_TYPES = 16,       /**< Number of tag types with a dense id */
+    INLINE_TAGS = 6           /**< Number of tags stored inline */
+  };
+
+  /**
+   * A tag stored inline.
+   */
+  struct InlineTag
+  {
+    uint8_t data[TagData::MAX_SIZE]; /**< Serialization buffer */
+    uint16_t uid;                     /**< Uid of the type of the tag */
+    uint8_t id;                       /**< Dense id of the type of the tag */
+  };  /* struct InlineTag */
+
   /**
    * Create a new PacketTagList.
    */
@@ -176,8 +209,8 @@ public:
    *
    * \param [in] o The PacketTagList to copy.
    *
-   * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * This copies the inline tags of \pname{o}, then
+   * points to the same \ref TagData as \pname{o}.
    */
   inline PacketTagList (PacketTagList const &o);
   /**
@@ -187,6 +220,7 @@ public:
    * \returns the copied object
    *
    * This makes a light-weight copy by #RemoveAll, then
+   * copying the inline tags of \pname{o} and
    * pointing to the same \ref TagData as \pname{o}.
    */
   inline PacketTagList &operator = (PacketTagList const &o);
@@ -234,9 +268,17 @@ public:
    */
   inline void RemoveAll (void);
   /**
-   * \returns pointer to head of tag list
+   * \returns pointer to head of the list of the tags not stored inline
    */
   const struct PacketTagList::TagData *Head (void) const;
+  /**
+   * \returns the inline tags
+   */
+  const struct PacketTagList::InlineTag *Inline (void) const;
+  /**
+   * \returns the number of inline tags
+   */
+  uint32_t InlineCount (void) const;
 
 private:
   /**
@@ -286,11 +328,40 @@ private:
    * \returns True, since tag value will definitely be replaced.
    */
   bool ReplaceWriter (Tag & tag, bool preMerge, struct TagData * cur, struct TagData ** prevNext);
+  /**
+   * \param [in] tid The type of a tag
+   * \param [in] assign Give a dense id to \pname{tid} if it has none yet
+   * \returns The dense id of the tag type, #INDEXED_TYPES or more if it has none
+   */
+  static uint32_t GetId (TypeId tid, bool assign);
+  /**
+   * \param [in] id The dense id of a tag type
+   * \returns The position plus one of the inline tag of that type, 0 if none
+   */
+  inline uint32_t GetPosition (uint32_t id) const;
+  /**
+   * \param [in] id The dense id of a tag type
+   * \param [in] position The position plus one of its inline tag, 0 if none
+   */
+  inline void SetPosition (uint32_t id, uint32_t position);
 
   /**
    * Pointer to first \ref TagData on the list
    */
   struct TagData *m_next;
+  /**
+   * The position plus one in #m_inline of the tag of each dense id,
+   * four bits per id
+   */
+  uint64_t m_index;
+  /**
+   * The number of tags in #m_inline
+   */
+  uint32_t m_count;
+  /**
+   * The tags stored inline
+   */
+  struct InlineTag m_inline[INLINE_TAGS];
 };
 
 } // namespace ns3
@@ -302,13 +373,18 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_next (),
+    m_index (0),
+    m_count (0)
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_next (o.m_next),
+    m_index (o.m_index),
+    m_count (o.m_count)
 {
+  std::memcpy (m_inline, o.m_inline, m_count * sizeof (struct InlineTag));
   if (m_next != 0)
     {
       m_next->count++;
@@ -319,11 +395,14 @@ PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
-  if (m_next == o.m_next) 
+  if (this == &o) 
     {
       return *this;
     }
   RemoveAll ();
+  m_index = o.m_index;
+  m_count = o.m_count;
+  std::memcpy (m_inline, o.m_inline, m_count * sizeof (struct InlineTag));
   m_next = o.m_next;
   if (m_next != 0) 
     {
@@ -337,9 +416,23 @@ PacketTagList::~PacketTagList ()
   RemoveAll ();
 }
 
+uint32_t
+PacketTagList::GetPosition (uint32_t id) const
+{
+  return (m_index >> (4 * id)) & 0xf;
+}
+
+void
+PacketTagList::SetPosition (uint32_t id, uint32_t position)
+{
+  m_index = (m_index & ~((uint64_t)0xf << (4 * id))) | ((uint64_t)position << (4 * id));
+}
+
 void
 PacketTagList::RemoveAll (void)
 {
+  m_index = 0;
+  m_count = 0;
   struct TagData *prev = 0;
   for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
     {
@@ -81,39 +81,51 @@ ByteTagIterator::ByteTagIterator (ByteTagList::Iterator i)
 }
 
 
-PacketTagIterator::PacketTagIterator (const struct PacketTagList::TagData *head)
-  : m_current (head)
+PacketTagIterator::PacketTagIterator (const PacketTagList &list)
+  : m_inline (list.Inline ()),
+    m_inlineLeft (list.InlineCount ()),
+    m_current (list.Head ())
 {
 }
 bool
 PacketTagIterator::HasNext (void) const
 {
-  return m_current != 0;
+  return m_inlineLeft != 0 || m_current != 0;
 }
 PacketTagIterator::Item
 PacketTagIterator::Next (void)
 {
   NS_ASSERT (HasNext ());
+  if (m_inlineLeft != 0)
+    {
+      const struct PacketTagList::InlineTag *data = m_inline;
+      m_inline++;
+      m_inlineLeft--;
+      TypeId tid;
+      tid.SetUid (data->uid);
+      return PacketTagIterator::Item (tid, data->data);
+    }
   const struct PacketTagList::TagData *prev = m_current;
   m_current = m_current->next;
-  return PacketTagIterator::Item (prev);
+  return PacketTagIterator::Item (prev->tid, prev->data);
 }
 
-PacketTagIterator::Item::Item (const struct PacketTagList::TagData *data)
-  : m_data (data)
+PacketTagIterator::Item::Item (TypeId tid, const uint8_t *data)
+  : m_tid (tid),
+    m_data (data)
 {
 }
 TypeId
 PacketTagIterator::Item::GetTypeId (void) const
 {
-  return m_data->tid;
+  return m_tid;
 }
 void
 PacketTagIterator::Item::GetTag (Tag &tag) const
 {
-  NS_ASSERT (tag.GetInstanceTypeId () == m_data->tid);
-  tag.Deserialize (TagBuffer ((uint8_t*)m_data->data,
-                              (uint8_t*)m_data->data
+  NS_ASSERT (tag.GetInstanceTypeId () == m_tid);
+  tag.Deserialize (TagBuffer ((uint8_t*)m_data,
+                              (uint8_t*)m_data
                               + PacketTagList::TagData::MAX_SIZE));
 }
 
@@ -898,7 +910,7 @@ Packet::PrintPacketTags (std::ostream &os) const
 PacketTagIterator 
 Packet::GetPacketTagIterator (void) const
 {
-  return PacketTagIterator (m_packetTagList.Head ());
+  return PacketTagIterator (m_packetTagList);
 }
 
 std::ostream& operator<< (std::ostream& os, const Packet &packet)
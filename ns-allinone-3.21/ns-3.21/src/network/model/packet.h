@@ -148,10 +148,12 @@ private:
     friend class PacketTagIterator;
     /**
      * Constructor
-     * \param data the data to copy.
+     * \param tid the type of the tag
+     * \param data the serialized tag
      */
-    Item (const struct PacketTagList::TagData *data);
-    const struct PacketTagList::TagData *m_data; //!< the tag data
+    Item (TypeId tid, const uint8_t *data);
+    TypeId m_tid;                //!< the type of the tag
+    const uint8_t *m_data;       //!< the serialized tag
   };
   /**
    * \returns true if calling Next is safe, false otherwise.
@@ -165,10 +167,12 @@ private:
   friend class Packet;
   /**
    * Constructor
-   * \param head head of the items
+   * \param list the tags of the packet
    */
-  PacketTagIterator (const struct PacketTagList::TagData *head);
-  const struct PacketTagList::TagData *m_current;  //!< actual position over the set of tags in a packet
+  PacketTagIterator (const PacketTagList &list);
+  const struct PacketTagList::InlineTag *m_inline; //!< the inline tags not visited yet
+  uint32_t m_inlineLeft;                           //!< the number of inline tags not visited yet
+  const struct PacketTagList::TagData *m_current;  //!< actual position over the tags of the packet not stored inline
 };
 
 /**
@@ -675,6 +675,85 @@ PacketTagListTest::DoRun (void)
     ReplaceCheck (7);
   }
   
+  { // Many tags shared by copies
+    std::cout << GetName () << "check many tags shared by copies" << std::endl;
+    ATestTag<11> u11 (11);
+    ATestTag<12> u12 (12);
+    ATestTag<13> u13 (13);
+    ATestTag<14> u14 (14);
+    ATestTag<15> u15 (15);
+    ATestTag<16> u16 (16);
+    ATestTag<17> u17 (17);
+    ATestTag<18> u18 (18);
+    ATestTag<19> u19 (19);
+    PacketTagList big = ref;
+    big.Add (u11);
+    big.Add (u12);
+    big.Add (u13);
+    big.Add (u14);
+    big.Add (u15);
+    big.Add (u16);
+    big.Add (u17);
+    big.Add (u18);
+    big.Add (u19);
+    CheckRefList (ref, "big, orig");
+    CheckRefList (big, "big, copy");
+    ATestTag<10> t10;
+    NS_TEST_EXPECT_MSG_EQ (ref.Peek (t10), false, "big, orig");
+    NS_TEST_EXPECT_MSG_EQ (big.Peek (t10), false, "big, copy");
+
+    PacketTagList copy = big;
+    ATestTag<19> v19 (1);
+    ATestTag<12> v12 (1);
+    NS_TEST_EXPECT_MSG_EQ (copy.Remove (v19), true, "remove 19");
+    NS_TEST_EXPECT_MSG_EQ ((int)v19.GetData (), 19, "removed 19");
+    NS_TEST_EXPECT_MSG_EQ (copy.Remove (v19), false, "remove 19 again");
+    NS_TEST_EXPECT_MSG_EQ (copy.Replace (v12), true, "replace 12");
+    u11.m_data = 21;
+    NS_TEST_EXPECT_MSG_EQ (copy.Replace (u11), true, "replace 11");
+    CheckRef (big, u19, "big after remove");
+    v12.m_data = 12;
+    CheckRef (big, v12, "big after replace");
+    u11.m_data = 11;
+    CheckRef (big, u11, "big after replace");
+    CheckRef (copy, u19, "copy after remove", true);
+    v12.m_data = 1;
+    CheckRef (copy, v12, "copy after replace");
+    u11.m_data = 21;
+    CheckRef (copy, u11, "copy after replace");
+    CheckRefList (copy, "copy after remove and replace");
+
+    Ptr<Packet> packet = Create<Packet> ();
+    packet->AddPacketTag (u13);
+    packet->AddPacketTag (u19);
+    packet->AddPacketTag (t1);
+    Ptr<Packet> packetCopy = packet->Copy ();
+    packetCopy->RemovePacketTag (u13);
+    packetCopy->AddPacketTag (u14);
+    int count = 0;
+    for (PacketTagIterator i = packet->GetPacketTagIterator (); i.HasNext (); )
+      {
+        PacketTagIterator::Item item = i.Next ();
+        NS_TEST_EXPECT_MSG_EQ ((item.GetTypeId () == u13.GetTypeId ()
+                                || item.GetTypeId () == u19.GetTypeId ()
+                                || item.GetTypeId () == t1.GetTypeId ()), true,
+                               "tags of the packet");
+        count++;
+      }
+    NS_TEST_EXPECT_MSG_EQ (count, 3, "tags of the packet");
+    count = 0;
+    for (PacketTagIterator i = packetCopy->GetPacketTagIterator (); i.HasNext (); )
+      {
+        PacketTagIterator::Item item = i.Next ();
+        NS_TEST_EXPECT_MSG_EQ ((item.GetTypeId () == u14.GetTypeId ()
+                                || item.GetTypeId () == u19.GetTypeId ()
+                                || item.GetTypeId () == t1.GetTypeId ()), true,
+                               "tags of the copy");
+        count++;
+      }
+    NS_TEST_EXPECT_MSG_EQ (count, 3, "tags of the copy");
+  }
+
   { // Timing
     std::cout << GetName () << "add+remove timing" << std::endl;
     int flm = std::numeric_limits<int>::max ();
@@ -0,0 +1,458 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include "floorplan.h"
+#include "ns3/log.h"
+#include "ns3/assert.h"
+#include "ns3/fatal-error.h"
+
+NS_LOG_COMPONENT_DEFINE ("Floorplan");
+
+namespace ns3 {
+
+// upper bound of the number of cells along each axis of the grid
+static const uint32_t FLOORPLAN_MAX_CELLS = 1024;
+
+Floorplan::Floorplan ()
+  : m_a1 (0),
+    m_b1 (0),
+    m_a2 (0),
+    m_b2 (0),
+    m_indexValid (false),
+    m_query (0)
+{
+}
+
+Ptr<Floorplan>
+Floorplan::CreateMediaLab (void)
+{
+  static const double wall[15][4] = {
+    { 0, 0, 0, 21.6 }, { 3.6, 0, 3.6, 10.8 }, { 3.6, 13.7, 3.6, 21.6 },
+    { 9, 5.4, 9, 10.8 }, { 9, 13.7, 9, 21.6 }, { 11.7, 0, 11.7, 5.4 },
+    { 19.8, 0, 19.8, 10.8 }, { 19.8, 13.7, 19.8, 21.6 }, { 3.6, 0, 19.8, 0 },
+    { 3.6, 5.4, 19.8, 5.4 }, { 3.6, 10.8, 19.8, 10.8 }, { 3.6, 13.7, 19.8, 13.7 },
+    { 0, 13.7, 3.6, 13.7 }, { 0, 17.3, 3.6, 17.3 }, { 0, 21.6, 19.8, 21.6 }
+  };
+  Ptr<Floorplan> floorplan = Create<Floorplan> ();
+  for (uint32_t i = 0; i < 15; i++)
+    {
+      floorplan->AddWall (wall[i][0], wall[i][1], wall[i][2], wall[i][3], 0);
+    }
+  return floorplan;
+}
+
+void
+Floorplan::AddWall (double x1, double y1, double x2, double y2, double lossDb)
+{
+  Wall w;
+  w.x1 = x1;
+  w.y1 = y1;
+  w.x2 = x2;
+  w.y2 = y2;
+  w.lossDb = lossDb;
+  m_walls.push_back (w);
+  m_indexValid = false;
+}
+
+void
+Floorplan::Clear (void)
+{
+  m_walls.clear ();
+  m_indexValid = false;
+}
+
+uint32_t
+Floorplan::GetNWalls (void) const
+{
+  return m_walls.size ();
+}
+
+double
+Floorplan::GetWallLoss (uint32_t i) const
+{
+  NS_ASSERT (i < m_walls.size ());
+  return m_walls[i].lossDb;
+}
+
+void
+Floorplan::SetWallLoss (uint32_t i, double lossDb)
+{
+  NS_ASSERT (i < m_walls.size ());
+  m_walls[i].lossDb = lossDb;
+}
+
+void
+Floorplan::SetLosCoefficients (double a, double b)
+{
+  m_a1 = a;
+  m_b1 = b;
+}
+
+void
+Floorplan::SetNlosCoefficients (double a, double b)
+{
+  m_a2 = a;
+  m_b2 = b;
+}
+
+double
+Floorplan::GetA1 (void) const
+{
+  return m_a1;
+}
+
+double
+Floorplan::GetB1 (void) const
+{
+  return m_b1;
+}
+
+double
+Floorplan::GetA2 (void) const
+{
+  return m_a2;
+}
+
+double
+Floorplan::GetB2 (void) const
+{
+  return m_b2;
+}
+
+void
+Floorplan::LoadWalls (std::string filename, double defaultLossDb)
+{
+  std::ifstream file (filename.c_str ());
+  if (!file.is_open ())
+    {
+      NS_FATAL_ERROR ("Can not open wall file " << filename);
+    }
+  Clear ();
+  std::string line;
+  uint32_t lineNumber = 0;
+  while (std::getline (file, line))
+    {
+      lineNumber++;
+      std::string::size_type start = line.find_first_not_of (" \t\r");
+      if (start == std::string::npos || line[start] == '#')
+        {
+          continue;
+        }
+      std::istringstream is (line);
+      double x1, y1, x2, y2;
+      double lossDb = defaultLossDb;
+      if (!(is >> x1 >> y1 >> x2 >> y2))
+        {
+          NS_FATAL_ERROR (filename << ":" << lineNumber << ": expected \"x1 y1 x2 y2 [lossDb]\"");
+        }
+      if (!(is >> lossDb))
+        {
+          lossDb = defaultLossDb;
+        }
+      AddWall (x1, y1, x2, y2, lossDb);
+    }
+  NS_LOG_DEBUG ("loaded " << m_walls.size () << " walls from " << filename);
+}
+
+void
+Floorplan::LoadCoefficients (std::string filename)
+{
+  std::ifstream file (filename.c_str ());
+  if (!file.is_open ())
+    {
+      NS_FATAL_ERROR ("Can not open coefficient file " << filename);
+    }
+  double a1, b1, a2, b2;
+  if (!(file >> a1 >> b1 >> a2 >> b2))
+    {
+      NS_FATAL_ERROR (filename << ": expected \"A1 B1 A2 B2\" followed by the wall losses");
+    }
+  SetLosCoefficients (a1, b1);
+  SetNlosCoefficients (a2, b2);
+  uint32_t i = 0;
+  double lossDb;
+  while (file >> lossDb)
+    {
+      if (i >= m_walls.size ())
+        {
+          NS_FATAL_ERROR (filename << ": more wall losses than the " << m_walls.size () << " walls of the floorplan");
+        }
+      m_walls[i].lossDb = lossDb;
+      i++;
+    }
+  NS_LOG_DEBUG ("A1=" << a1 << " B1=" << b1 << " A2=" << a2 << " B2=" << b2 << ", " << i << " wall losses");
+}
+
+bool
+Floorplan::Crosses (double a_x, double a_y, double b_x, double b_y, const Wall &w)
+{
+  double w1x = w.x1, w1y = w.y1, w2x = w.x2, w2y = w.y2;
+  double compare1 = std::abs ((w2x - w1x) * (b_y - a_y) * a_x - (w2y - w1y) * (b_x - a_x) * w1x + (b_x - a_x) * (w2x - w1x) * (w1y - a_y));
+  double compare2 = std::abs ((b_y - a_y) * (w2x - w1x) * w1y - (b_x - a_x) * (w2y - w1y) * a_y + (b_y - a_y) * (w2y - w1y) * (a_x - w1x));
+  double coeff = std::abs ((b_y - a_y) * (w2x - w1x) - (w2y - w1y) * (b_x - a_x));
+  return (coeff * std::min (a_x, b_x) <= compare1) && (compare1 <= coeff * std::max (a_x, b_x))
+         && (coeff * std::min (w1x, w2x) <= compare1) && (compare1 <= coeff * std::max (w1x, w2x))
+         && (coeff * std::min (a_y, b_y) <= compare2) && (compare2 <= coeff * std::max (a_y, b_y))
+         && (coeff * std::min (w1y, w2y) <= compare2) && (compare2 <= coeff * std::max (w1y, w2y));
+}
+
+uint32_t
+Floorplan::GetCellX (double x) const
+{
+  double c = std::floor ((x - m_minX) / m_cellSize);
+  return (c < 0) ? 0 : std::min (static_cast<uint32_t> (c), m_nx - 1);
+}
+
+uint32_t
+Floorplan::GetCellY (double y) const
+{
+  double c = std::floor ((y - m_minY) / m_cellSize);
+  return (c < 0) ? 0 : std::min (static_cast<uint32_t> (c), m_ny - 1);
+}
+
+void
+Floorplan::BuildIndex (void) const
+{
+  m_minX = m_minY = 1e300;
+  m_maxX = m_maxY = -1e300;
+  for (std::vector<Wall>::const_iterator w = m_walls.begin (); w != m_walls.end (); w++)
+    {
+      m_minX = std::min (m_minX, std::min (w->x1, w->x2));
+      m_minY = std::min (m_minY, std::min (w->y1, w->y2));
+      m_maxX = std::max (m_maxX, std::max (w->x1, w->x2));
+      m_maxY = std::max (m_maxY, std::max (w->y1, w->y2));
+    }
+  // walls are registered in every cell within eps of them, so that a
+  // segment touching a wall on a cell border finds it from either side
+  double eps = 1e-6 * std::max (1.0, std::max (m_maxX - m_minX, m_maxY - m_minY));
+  m_minX -= eps;
+  m_minY -= eps;
+  m_maxX += eps;
+  m_maxY += eps;
+  double width = m_maxX - m_minX;
+  double height = m_maxY - m_minY;
+  // about one wall per cell
+  m_cellSize = std::sqrt (width * height / m_walls.size ());
+  m_cellSize = std::max (m_cellSize, std::max (width, height) / FLOORPLAN_MAX_CELLS);
+  m_nx = std::max (1U, static_cast<uint32_t> (std::ceil (width / m_cellSize)));
+  m_ny = std::max (1U, static_cast<uint32_t> (std::ceil (height / m_cellSize)));
+  m_cells.assign (m_nx * m_ny, std::vector<uint32_t> ());
+  for (uint32_t i = 0; i < m_walls.size (); i++)
+    {
+      const Wall &w = m_walls[i];
+      uint32_t x0 = GetCellX (std::min (w.x1, w.x2) - eps);
+      uint32_t x1 = GetCellX (std::max (w.x1, w.x2) + eps);
+      uint32_t y0 = GetCellY (std::min (w.y1, w.y2) - eps);
+      uint32_t y1 = GetCellY (std::max (w.y1, w.y2) + eps);
+      for (uint32_t y = y0; y <= y1; y++)
+        {
+          for (uint32_t x = x0; x <= x1; x++)
+            {
+              m_cells[y * m_nx + x].push_back (i);
+            }
+        }
+    }
+  m_verticalWalls.clear ();
+  m_horizontalWalls.clear ();
+  m_obliqueWalls.clear ();
+  m_pointWalls.clear ();
+  for (uint32_t i = 0; i < m_walls.size (); i++)
+    {
+      const Wall &w = m_walls[i];
+      if (w.x1 == w.x2 && w.y1 == w.y2)
+        {
+          m_pointWalls.push_back (i);
+        }
+      else if (w.x1 == w.x2)
+        {
+          m_verticalWalls[w.x1].push_back (i);
+        }
+      else if (w.y1 == w.y2)
+        {
+          m_horizontalWalls[w.y1].push_back (i);
+        }
+      else
+        {
+          m_obliqueWalls.push_back (i);
+        }
+    }
+  m_stamp.assign (m_walls.size (), 0);
+  m_query = 0;
+  m_indexValid = true;
+  NS_LOG_DEBUG (m_walls.size () << " walls in a " << m_nx << "x" << m_ny << " grid of " << m_cellSize << "m cells");
+}
+
+void
+Floorplan::VisitWalls (const std::vector<uint32_t> &walls, const Vector &a, const Vector &b) const
+{
+  for (std::vector<uint32_t>::const_iterator i = walls.begin (); i != walls.end (); i++)
+    {
+      if (m_stamp[*i] == m_query)
+        {
+          continue;
+        }
+      m_stamp[*i] = m_query;
+      if (Crosses (a.x, a.y, b.x, b.y, m_walls[*i]))
+        {
+          m_hits.push_back (*i);
+        }
+    }
+}
+
+void
+Floorplan::WalkGrid (const Vector &a, const Vector &b) const
+{
+  // clip the segment to the grid (Liang-Barsky), no wall lies outside
+  double dx = b.x - a.x;
+  double dy = b.y - a.y;
+  double t0 = 0;
+  double t1 = 1;
+  double p[4] = { -dx, dx, -dy, dy };
+  double q[4] = { a.x - m_minX, m_maxX - a.x, a.y - m_minY, m_maxY - a.y };
+  for (uint32_t k = 0; k < 4; k++)
+    {
+      if (p[k] == 0)
+        {
+          if (q[k] < 0)
+            {
+              return;
+            }
+          continue;
+        }
+      double t = q[k] / p[k];
+      if (p[k] < 0)
+        {
+          t0 = std::max (t0, t);
+        }
+      else
+        {
+          t1 = std::min (t1, t);
+        }
+    }
+  if (t0 > t1)
+    {
+      return;
+    }
+  double x0 = a.x + t0 * dx;
+  double y0 = a.y + t0 * dy;
+  double x1 = a.x + t1 * dx;
+  double y1 = a.y + t1 * dy;
+  if (y0 > y1)
+    {
+      std::swap (x0, x1);
+      std::swap (y0, y1);
+    }
+
+  // walk the rows crossed by the segment, and in each row the cells
+  // between the x where the segment enters and leaves the row
+  double eps = 1e-9 * m_cellSize;
+  uint32_t rowEnd = GetCellY (y1 + eps);
+  for (uint32_t row = GetCellY (y0 - eps); row <= rowEnd; row++)
+    {
+      double xa = x0;
+      double xb = x1;
+      if (y1 > y0)
+        {
+          double ya = std::min (std::max (m_minY + row * m_cellSize, y0), y1);
+          double yb = std::min (std::max (m_minY + (row + 1) * m_cellSize, y0), y1);
+          xa = x0 + (x1 - x0) * (ya - y0) / (y1 - y0);
+          xb = x0 + (x1 - x0) * (yb - y0) / (y1 - y0);
+        }
+      uint32_t colEnd = GetCellX (std::max (xa, xb) + eps);
+      for (uint32_t col = GetCellX (std::min (xa, xb) - eps); col <= colEnd; col++)
+        {
+          VisitWalls (m_cells[row * m_nx + col], a, b);
+        }
+    }
+}
+
+void
+Floorplan::VisitParallelWalls (const Vector &a, const Vector &b) const
+{
+  // Crosses holds for any wall parallel to the segment and on its line,
+  // even far from it, and for every wall when the segment or the wall has
+  // a zero length. Only the walls with the same orientation as the
+  // segment can be parallel to it.
+  VisitWalls (m_pointWalls, a, b);
+  if (a.x == b.x && a.y == b.y)
+    {
+      for (uint32_t i = 0; i < m_walls.size (); i++)
+        {
+          if (m_stamp[i] != m_query)
+            {
+              m_stamp[i] = m_query;
+              m_hits.push_back (i);
+            }
+        }
+    }
+  else if (a.x == b.x)
+    {
+      std::map<double, std::vector<uint32_t> >::const_iterator i = m_verticalWalls.find (a.x);
+      if (i != m_verticalWalls.end ())
+        {
+          VisitWalls (i->second, a, b);
+        }
+    }
+  else if (a.y == b.y)
+    {
+      std::map<double, std::vector<uint32_t> >::const_iterator i = m_horizontalWalls.find (a.y);
+      if (i != m_horizontalWalls.end ())
+        {
+          VisitWalls (i->second, a, b);
+        }
+    }
+  else
+    {
+      VisitWalls (m_obliqueWalls, a, b);
+    }
+}
+
+double
+Floorplan::GetWallLoss (const Vector &a, const Vector &b, uint32_t &nWalls) const
+{
+  nWalls = 0;
+  if (m_walls.empty ())
+    {
+      return 0;
+    }
+  if (!m_indexValid)
+    {
+      BuildIndex ();
+    }
+  if (++m_query == 0)
+    {
+      std::fill (m_stamp.begin (), m_stamp.end (), 0);
+      m_query = 1;
+    }
+  m_hits.clear ();
+  WalkGrid (a, b);
+  VisitParallelWalls (a, b);
+
+  // add the losses in wall order, as the exhaustive search did
+  std::sort (m_hits.begin (), m_hits.end ());
+  double lossDb = 0;
+  for (std::vector<uint32_t>::const_iterator i = m_hits.begin (); i != m_hits.end (); i++)
+    {
+      lossDb += m_walls[*i].lossDb;
+    }
+  nWalls = m_hits.size ();
+  return lossDb;
+}
+
+} // namespace ns3
@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef FLOORPLAN_H
+#define FLOORPLAN_H
+
+#include <stdint.h>
+#include <map>
+#include <string>
+#include <vector>
+#include "ns3/simple-ref-count.h"
+#include "ns3/ptr.h"
+#include "ns3/vector.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup propagation
+ * \brief Walls of a single floor and the calibrated WINNER II coefficients.
+ *
+ * Walls are 2D segments (z is ignored), each with its own penetration
+ * loss. They are bucketed in a uniform grid so that finding the walls
+ * crossed by a tx-rx segment only tests the walls of the grid cells the
+ * segment goes through, instead of every wall of the building. The
+ * crossing test also counts the walls lying on the line of the segment,
+ * wherever they are on that line, and every wall for a zero length
+ * segment: those are looked up by line, not in the grid. As in
+ * rssi_cal, the floor is expected to lie in the positive quadrant: the
+ * crossing test compares absolute coordinates.
+ *
+ * Two text formats can be loaded:
+ *  - walls (LoadWalls): one wall per line, "x1 y1 x2 y2 [lossDb]",
+ *    lines starting with '#' are ignored;
+ *  - coefficients (LoadCoefficients): the output of rssi_cal, i.e.
+ *    "A1 B1 A2 B2" followed by one loss per wall, in wall order.
+ */
+class Floorplan : public SimpleRefCount<Floorplan>
+{
+public:
+  Floorplan ();
+
+  /**
+   * \return the floor of the media lab the rssi_cal measurements were
+   *         made in, with zero loss walls and zero coefficients.
+   */
+  static Ptr<Floorplan> CreateMediaLab (void);
+
+  /**
+   * \param x1 x of the first end of the wall
+   * \param y1 y of the first end of the wall
+   * \param x2 x of the second end of the wall
+   * \param y2 y of the second end of the wall
+   * \param lossDb penetration loss of the wall
+   */
+  void AddWall (double x1, double y1, double x2, double y2, double lossDb);
+  /**
+   * Remove all the walls.
+   */
+  void Clear (void);
+  /**
+   * \return the number of walls
+   */
+  uint32_t GetNWalls (void) const;
+  /**
+   * \param i the index of the wall
+   * \return the penetration loss of the wall
+   */
+  double GetWallLoss (uint32_t i) const;
+  /**
+   * \param i the index of the wall
+   * \param lossDb the penetration loss of the wall
+   */
+  void SetWallLoss (uint32_t i, double lossDb);
+
+  /**
+   * \param a intercept of the line of sight path loss
+   * \param b slope of the line of sight path loss
+   */
+  void SetLosCoefficients (double a, double b);
+  /**
+   * \param a intercept of the non line of sight path loss
+   * \param b slope of the non line of sight path loss
+   */
+  void SetNlosCoefficients (double a, double b);
+  double GetA1 (void) const;
+  double GetB1 (void) const;
+  double GetA2 (void) const;
+  double GetB2 (void) const;
+
+  /**
+   * Replace the walls by the ones of a wall file.
+   *
+   * \param filename the wall file
+   * \param defaultLossDb loss of the walls without an explicit loss
+   */
+  void LoadWalls (std::string filename, double defaultLossDb);
+  /**
+   * Read the coefficients and the wall losses of an rssi_cal result file.
+   *
+   * \param filename the coefficient file
+   */
+  void LoadCoefficients (std::string filename);
+
+  /**
+   * \param a one end of the segment
+   * \param b the other end of the segment
+   * \param nWalls the number of crossed walls (output)
+   * \return the sum of the losses of the walls crossed by the segment
+   */
+  double GetWallLoss (const Vector &a, const Vector &b, uint32_t &nWalls) const;
+
+private:
+  struct Wall
+  {
+    double x1;
+    double y1;
+    double x2;
+    double y2;
+    double lossDb;
+  };
+
+  static bool Crosses (double ax, double ay, double bx, double by, const Wall &w);
+  void BuildIndex (void) const;
+  uint32_t GetCellX (double x) const;
+  uint32_t GetCellY (double y) const;
+  void VisitWalls (const std::vector<uint32_t> &walls, const Vector &a, const Vector &b) const;
+  void WalkGrid (const Vector &a, const Vector &b) const;
+  void VisitParallelWalls (const Vector &a, const Vector &b) const;
+
+  std::vector<Wall> m_walls;
+  double m_a1;
+  double m_b1;
+  double m_a2;
+  double m_b2;
+
+  // uniform grid over the bounding box of the walls, built on first use
+  mutable bool m_indexValid;
+  mutable double m_minX;
+  mutable double m_minY;
+  mutable double m_maxX;
+  mutable double m_maxY;
+  mutable double m_cellSize;
+  mutable uint32_t m_nx;
+  mutable uint32_t m_ny;
+  mutable std::vector<std::vector<uint32_t> > m_cells;
+  // walls by line, for the segments parallel to them: vertical walls by
+  // x, horizontal walls by y, then the other walls and zero length walls
+  mutable std::map<double, std::vector<uint32_t> > m_verticalWalls;
+  mutable std::map<double, std::vector<uint32_t> > m_horizontalWalls;
+  mutable std::vector<uint32_t> m_obliqueWalls;
+  mutable std::vector<uint32_t> m_pointWalls;
+  // a wall which spans several cells is tested once per query
+  mutable std::vector<uint32_t> m_stamp;
+  mutable uint32_t m_query;
+  mutable std::vector<uint32_t> m_hits;
+};
+
+} // namespace ns3
+
+#endif /* FLOORPLAN_H */
@@ -0,0 +1,97 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <cmath>
+#include "jakes-fading-link.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+JakesFadingLink::JakesFadingLink ()
+{
+  m_first.push_back (0);
+}
+
+uint32_t
+JakesFadingLink::GetNProcesses (void) const
+{
+  return m_processes.size ();
+}
+
+Ptr<JakesProcess>
+JakesFadingLink::GetProcess (uint32_t i) const
+{
+  NS_ASSERT (i < m_processes.size ());
+  return m_processes[i];
+}
+
+void
+JakesFadingLink::AddProcess (Ptr<JakesProcess> process)
+{
+  uint32_t first = m_first.back ();
+  uint32_t n = process->GetNOscillators ();
+  m_amplitudeRe.resize (first + n);
+  m_amplitudeIm.resize (first + n);
+  m_phase.resize (first + n);
+  m_omega.resize (first + n);
+  if (n > 0)
+    {
+      process->GetOscillators (&m_amplitudeRe[first], &m_amplitudeIm[first],
+                               &m_phase[first], &m_omega[first]);
+    }
+  m_processes.push_back (process);
+  m_first.push_back (first + n);
+}
+
+void
+JakesFadingLink::GetComplexGains (const double *times, uint32_t nTimes, uint32_t nProcesses,
+                                  std::complex<double> *gains) const
+{
+  NS_ASSERT (nProcesses <= m_processes.size ());
+  if (m_re.size () < nTimes)
+    {
+      m_re.resize (nTimes);
+      m_im.resize (nTimes);
+    }
+  double *re = &m_re[0];
+  double *im = &m_im[0];
+  for (uint32_t p = 0; p < nProcesses; p++)
+    {
+      for (uint32_t k = 0; k < nTimes; k++)
+        {
+          re[k] = 0;
+          im[k] = 0;
+        }
+      for (uint32_t n = m_first[p]; n < m_first[p + 1]; n++)
+        {
+          double ampRe = m_amplitudeRe[n];
+          double ampIm = m_amplitudeIm[n];
+          double phase = m_phase[n];
+          double omega = m_omega[n];
+          for (uint32_t k = 0; k < nTimes; k++)
+            {
+              double c = std::cos (times[k] * omega + phase);
+              re[k] += ampRe * c;
+              im[k] += ampIm * c;
+            }
+        }
+      for (uint32_t k = 0; k < nTimes; k++)
+        {
+          gains[k * nProcesses + p] = std::complex<double> (re[k], im[k]);
+        }
+    }
+}
+
+} // namespace ns3
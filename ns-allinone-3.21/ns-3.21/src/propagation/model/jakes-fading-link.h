@@ -0,0 +1,89 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef JAKES_FADING_LINK_H
+#define JAKES_FADING_LINK_H
+
+#include <stdint.h>
+#include <complex>
+#include <vector>
+#include "ns3/simple-ref-count.h"
+#include "ns3/ptr.h"
+#include "ns3/jakes-process.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup fading
+ * \brief The Jakes processes of all the antenna pairs of one link.
+ *
+ * 11ac: multiple_stream_tx + caudal loss. The oscillators of every
+ * process are stored in structure-of-arrays form, process after process,
+ * so that the gains of all the antenna pairs at all the MPDU start times
+ * of an A-MPDU are computed in one pass, without any per pair lookup.
+ * The inner loop runs over the time offsets, each gain is still the sum
+ * of the oscillators in the order of JakesProcess::GetComplexGain, so
+ * both give the same values.
+ */
+class JakesFadingLink : public SimpleRefCount<JakesFadingLink>
+{
+public:
+  JakesFadingLink ();
+
+  /**
+   * \return the number of processes of the link
+   */
+  uint32_t GetNProcesses (void) const;
+  /**
+   * \param i the index of the process
+   * \return the process
+   */
+  Ptr<JakesProcess> GetProcess (uint32_t i) const;
+  /**
+   * Append a process, its oscillators are copied once.
+   *
+   * \param process the process, with its oscillators constructed
+   */
+  void AddProcess (Ptr<JakesProcess> process);
+
+  /**
+   * Compute the complex gains of the first nProcesses processes at
+   * nTimes absolute times. The gain of process p at time k is written
+   * to gains[k * nProcesses + p].
+   *
+   * \param times the times, in seconds
+   * \param nTimes the number of times
+   * \param nProcesses the number of processes to evaluate
+   * \param gains the output array
+   */
+  void GetComplexGains (const double *times, uint32_t nTimes, uint32_t nProcesses,
+                        std::complex<double> *gains) const;
+
+private:
+  std::vector<Ptr<JakesProcess> > m_processes;
+  /// index of the first oscillator of each process, plus the end
+  std::vector<uint32_t> m_first;
+  std::vector<double> m_amplitudeRe;
+  std::vector<double> m_amplitudeIm;
+  std::vector<double> m_phase;
+  std::vector<double> m_omega;
+  /// accumulators, one per time
+  mutable std::vector<double> m_re;
+  mutable std::vector<double> m_im;
+};
+
+} // namespace ns3
+
+#endif /* JAKES_FADING_LINK_H */
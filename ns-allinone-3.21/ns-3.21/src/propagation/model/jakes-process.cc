@@ -195,4 +195,20 @@ JakesProcess::GetDoppler(void)
 {
   return m_omegaDopplerMax;
 }
+uint32_t
+JakesProcess::GetNOscillators () const
+{
+  return m_oscillators.size ();
+}
+void
+JakesProcess::GetOscillators (double *amplitudeRe, double *amplitudeIm, double *phase, double *omega) const
+{
+  for (unsigned int i = 0; i < m_oscillators.size (); i++)
+    {
+      amplitudeRe[i] = m_oscillators[i].m_amplitude.real ();
+      amplitudeIm[i] = m_oscillators[i].m_amplitude.imag ();
+      phase[i] = m_oscillators[i].m_phase;
+      omega[i] = m_oscillators[i].m_omega;
+    }
+}
 } // namespace ns3
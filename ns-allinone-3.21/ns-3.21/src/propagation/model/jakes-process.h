@@ -73,6 +73,19 @@ public:
   //shbyeon multiple streams doppler fix
   double GetDoppler ();
   void SetDopplerFrequencyHzLater (double dopplerFrequencyHz);
+
+  /// Get the number of oscillators of the process
+  uint32_t GetNOscillators () const;
+  /**
+   * Copy the oscillators of the process, in structure-of-arrays form.
+   * Each array must hold GetNOscillators () entries.
+   *
+   * \param amplitudeRe real part of the complex amplitudes
+   * \param amplitudeIm imaginary part of the complex amplitudes
+   * \param phase initial phases
+   * \param omega rotation speeds
+   */
+  void GetOscillators (double *amplitudeRe, double *amplitudeIm, double *phase, double *omega) const;
 private:
   /// Represents a single oscillator
   struct Oscillator
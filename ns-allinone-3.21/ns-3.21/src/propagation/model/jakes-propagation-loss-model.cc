@@ -20,6 +20,7 @@
 
 #include "jakes-propagation-loss-model.h"
 #include "ns3/double.h"
+#include "ns3/simulator.h"
 #include "ns3/log.h"
 
 NS_LOG_COMPONENT_DEFINE ("Jakes");
@@ -77,56 +78,49 @@ std::complex<double> * JakesPropagationLossModel::DoCalcRxPower (std::complex<do
 	a = tmp;
   }
 
+  uint32_t nPairs = nss * nss;
+  Ptr<JakesFadingLink> link = m_linkCache.GetPathData (a, b, 0);
+  if (link == 0)
+  {
+    link = Create<JakesFadingLink> ();
+    m_linkCache.AddPathData (link, a, b, 0);
+  }
+  // processes are created in antenna pair order, the first time the
+  // link is used with as many streams
+  for (uint32_t i = link->GetNProcesses (); i < nPairs; i++)
+  {
+    Ptr<JakesProcess> pathData = CreateObject<JakesProcess> ();
+    if(i>0)
+    {
+      pathData->SetDopplerFrequencyHzLater(link->GetProcess (0)->GetDoppler());
+    }
+    pathData->SetPropagationLossModel (this);
+    link->AddProcess (pathData);
+  }
+
+  // one channel matrix per MPDU start time with caudal loss, else a
+  // single one at the current time
+  uint32_t count = 1;
   if(mpduTx)
   {
     NS_LOG_DEBUG("caudal enabled");
-    int count = mpduTx[0];
     count = mpduTx[0];
-    mpduTx[0] = 0;
-    for(int j = 0; j < count; j++)
-    {
-      Time refTime = Seconds(mpduTx[j]);
-      NS_LOG_DEBUG(j << " " << refTime.GetMicroSeconds() << " " << mpduTx[j]);
-      for(int i = 1; i <= (nss*nss); i++)
-      {
-        Ptr<JakesProcess> pathData = m_propagationCache.GetPathData (a, b, i);
-        if (pathData == 0)
-        {
-          pathData = CreateObject<JakesProcess> ();
-          if(i>1)
-          {
-            Ptr<JakesProcess> orgPath = m_propagationCache.GetPathData (a,b,1);
-            pathData->SetDopplerFrequencyHzLater(orgPath->GetDoppler());
-          }
-          pathData->SetPropagationLossModel (this);
-          m_propagationCache.AddPathData (pathData, a, b, i);
-        }
-        hvector[i+j*(nss*nss)] = pathData->GetComplexGain(refTime);
-      }
-    }
-    mpduTx[0]=count;
   }
   else
   {
     NS_LOG_DEBUG("caudal disabled");
-    for(int i = 1; i <= (nss*nss); i++)
-    {
-      Ptr<JakesProcess> pathData = m_propagationCache.GetPathData (a, b, i);
-      if (pathData == 0)
-      {
-        pathData = CreateObject<JakesProcess> ();
-        if(i>1)
-        {
-          Ptr<JakesProcess> orgPath = m_propagationCache.GetPathData (a,b,1);
-          pathData->SetDopplerFrequencyHzLater(orgPath->GetDoppler());
-        }
-        pathData->SetPropagationLossModel (this);
-        m_propagationCache.AddPathData (pathData, a, b, i);
-      }
-      hvector[i] = pathData->GetComplexGain();
-    }
-
   }
+  if (m_times.size () < count)
+  {
+    m_times.resize (count);
+  }
+  m_times[0] = Now ().GetSeconds ();
+  for(uint32_t j = 1; j < count; j++)
+  {
+    m_times[j] = (Now () + Seconds (mpduTx[j])).GetSeconds ();
+    NS_LOG_DEBUG(j << " " << Seconds (mpduTx[j]).GetMicroSeconds() << " " << mpduTx[j]);
+  }
+  link->GetComplexGains (&m_times[0], count, nPairs, hvector + 1);
   return hvector;
 }
 
@@ -23,6 +23,7 @@
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-cache.h"
 #include "ns3/jakes-process.h"
+#include "ns3/jakes-fading-link.h"
 
 namespace ns3
 {
@@ -55,6 +56,9 @@ private:
   Ptr<UniformRandomVariable> m_uniformVariable;
 private:
   mutable PropagationCache<JakesProcess> m_propagationCache;
+  /// 11ac: the processes of all the antenna pairs of a link
+  mutable PropagationCache<JakesFadingLink> m_linkCache;
+  mutable std::vector<double> m_times;
 };
 
 } // namespace ns3
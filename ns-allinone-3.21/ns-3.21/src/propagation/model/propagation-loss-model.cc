@@ -480,17 +480,6 @@ TwoRayGroundPropagationLossModel::DoAssignStreams (int64_t stream)
 // ------------------------------------------------------------------------- //
 
 NS_OBJECT_ENSURE_REGISTERED (Winner2PropagationLossModel);
-/*
-double Winner2PropagationLossModel::map_pl[2][197][215] = {0,};
-double Winner2PropagationLossModel::ol_list[2][2] = {0,};
-*/
-double Winner2PropagationLossModel::wall[15][4] = {0, 0, 0, 21.6, 3.6, 0, 3.6, 10.8, 3.6, 13.7, 3.6, 21.6, 9, 5.4, 9, 10.8, 9, 13.7, 9, 21.6, 11.7, 0, 11.7, 5.4, 19.8, 0, 19.8, 10.8, 19.8, 13.7, 19.8, 21.6, 3.6, 0, 19.8, 0, 3.6, 5.4, 19.8, 5.4, 3.6, 10.8, 19.8, 10.8, 3.6, 13.7, 19.8, 13.7, 0, 13.7, 3.6, 13.7, 0, 17.3, 3.6, 17.3, 0, 21.6, 19.8, 21.6};
-//double Winner2PropagationLossModel::wall_loss[15] = {12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12, 12};
-double Winner2PropagationLossModel::wall_loss[15];
-double Winner2PropagationLossModel::A1;
-double Winner2PropagationLossModel::B1;
-double Winner2PropagationLossModel::A2;
-double Winner2PropagationLossModel::B2;
 
 TypeId
 Winner2PropagationLossModel::GetTypeId (void)
@@ -508,6 +497,23 @@ Winner2PropagationLossModel::GetTypeId (void)
 									 DoubleValue (100),
 									 MakeDoubleAccessor (&Winner2PropagationLossModel::m_referenceFrequency),
 									 MakeDoubleChecker<double> ())
+		.AddAttribute ("FloorplanFile",
+									 "File of walls, one \"x1 y1 x2 y2 [lossDb]\" per line. The media lab floorplan is used if empty.",
+									 StringValue (""),
+									 MakeStringAccessor (&Winner2PropagationLossModel::SetFloorplanFile,
+																			 &Winner2PropagationLossModel::GetFloorplanFile),
+									 MakeStringChecker ())
+		.AddAttribute ("DefaultWallLoss",
+									 "Loss (dB) of the walls of FloorplanFile without an explicit loss.",
+									 DoubleValue (12.0),
+									 MakeDoubleAccessor (&Winner2PropagationLossModel::m_defaultWallLoss),
+									 MakeDoubleChecker<double> ())
+		.AddAttribute ("CoefficientFile",
+									 "rssi_cal result file: A1 B1 A2 B2 followed by the loss of each wall.",
+									 StringValue (""),
+									 MakeStringAccessor (&Winner2PropagationLossModel::SetCoefficientFile,
+																			 &Winner2PropagationLossModel::GetCoefficientFile),
+									 MakeStringChecker ())
 		;
 	return tid;
 
@@ -517,67 +523,160 @@ Winner2PropagationLossModel::Winner2PropagationLossModel ()
 {
 }
 
+Winner2PropagationLossModel::~Winner2PropagationLossModel ()
+{
+	Untrack ();
+}
 
-double
-Winner2PropagationLossModel::DoCalcRxPower (double txPowerDbm,
-																						Ptr<MobilityModel> a,
-																						Ptr<MobilityModel> b) const
+void
+Winner2PropagationLossModel::DoDispose (void)
 {
-	double its[15] = {0};
-	double distance = a->GetDistanceFrom (b);
-	if (distance <= m_referenceDistance)
+	Untrack ();
+	m_floorplan = 0;
+	PropagationLossModel::DoDispose ();
+}
+
+void
+Winner2PropagationLossModel::SetFloorplan (Ptr<Floorplan> floorplan)
+{
+	m_floorplan = floorplan;
+	m_cache.clear ();
+}
+
+Ptr<Floorplan>
+Winner2PropagationLossModel::GetFloorplan (void) const
+{
+	// built on first use: the file attributes may come in any order
+	if (m_floorplan == 0)
 	{
-		return txPowerDbm;
+		if (m_floorplanFile.empty ())
+		{
+			m_floorplan = Floorplan::CreateMediaLab ();
+		}
+		else
+		{
+			m_floorplan = Create<Floorplan> ();
+			m_floorplan->LoadWalls (m_floorplanFile, m_defaultWallLoss);
+		}
+		if (!m_coefficientFile.empty ())
+		{
+			m_floorplan->LoadCoefficients (m_coefficientFile);
+		}
 	}
+	return m_floorplan;
+}
+
+void
+Winner2PropagationLossModel::SetFloorplanFile (std::string filename)
+{
+	m_floorplanFile = filename;
+	m_floorplan = 0;
+	m_cache.clear ();
+}
 
-	/*
-		 found intersection between rx,tx and wall
-		 num_intersect
-		 */
+std::string
+Winner2PropagationLossModel::GetFloorplanFile (void) const
+{
+	return m_floorplanFile;
+}
 
-	Vector a_pos = a->GetPosition();
-	Vector b_pos = b->GetPosition();
+void
+Winner2PropagationLossModel::SetCoefficientFile (std::string filename)
+{
+	m_coefficientFile = filename;
+	m_floorplan = 0;
+	m_cache.clear ();
+}
 
-	double a_x = a_pos.x, a_y = a_pos.y;
-	double b_x = b_pos.x, b_y = b_pos.y;
-	double w1x, w1y, w2x, w2y, compare1, compare2, coeff; //for inclination
-	double openpl, wallpl;
-	int num_wall = 15, num_intersect = 0;
+std::string
+Winner2PropagationLossModel::GetCoefficientFile (void) const
+{
+	return m_coefficientFile;
+}
 
-	for (int i=0; i<num_wall; i++)
+void
+Winner2PropagationLossModel::CourseChanged (Ptr<const MobilityModel> model) const
+{
+	const MobilityModel *m = PeekPointer (model);
+	for (PathLossCache::iterator i = m_cache.begin (); i != m_cache.end (); )
 	{
-		w1x = wall[i][0];
-		w1y = wall[i][1];
-		w2x = wall[i][2];
-		w2y = wall[i][3];
-		compare1 = std::abs((w2x - w1x) * (b_y - a_y) * a_x - (w2y - w1y) * (b_x - a_x) * w1x + (b_x - a_x) * (w2x - w1x) * (w1y - a_y));
-		compare2 = std::abs((b_y - a_y) * (w2x - w1x) * w1y - (b_x - a_x) * (w2y - w1y) * a_y + (b_y - a_y) * (w2y - w1y) * (a_x - w1x));
-		coeff =std::abs((b_y - a_y)*(w2x - w1x) - (w2y - w1y)*(b_x - a_x));
-		if ((coeff * std::min(a_x, b_x) <= compare1) && (compare1 <= coeff * std::max(a_x, b_x))) {
-			if ((coeff * std::min(w1x, w2x) <= compare1) && (compare1 <= coeff * std::max(w1x, w2x))){
-				if ((coeff * std::min(a_y, b_y) <= compare2) && (compare2 <= coeff * std::max(a_y, b_y))) {
-					if ((coeff * std::min(w1y, w2y) <= compare2) && (compare2 <= coeff * std::max(w1y, w2y))) {
-						num_intersect++;
-						its[i] = 1;
-					}
-				}
-			}
+		if (i->first.first == m || i->first.second == m)
+		{
+			m_cache.erase (i++);
+		}
+		else
+		{
+			i++;
 		}
 	}
+}
+
+void
+Winner2PropagationLossModel::Untrack (void) const
+{
+	for (std::map<const MobilityModel *, Ptr<MobilityModel> >::iterator i = m_tracked.begin (); i != m_tracked.end (); i++)
+	{
+		i->second->TraceDisconnectWithoutContext ("CourseChange",
+				MakeCallback (&Winner2PropagationLossModel::CourseChanged, this));
+	}
+	m_tracked.clear ();
+	m_cache.clear ();
+}
+
+double
+Winner2PropagationLossModel::CalcPathLoss (const Vector &a, const Vector &b) const
+{
+	double distance = CalculateDistance (a, b);
+	if (distance <= m_referenceDistance)
+	{
+		return 0;
+	}
+
+	Ptr<Floorplan> floorplan = GetFloorplan ();
+	uint32_t num_intersect = 0;
+	double wallpl = floorplan->GetWallLoss (a, b, num_intersect);
+	double openpl;
 
 	if (num_intersect == 0)
 	{
-		openpl = A1 + B1 * std::log10(distance / m_referenceDistance) + 20 * std::log10(m_referenceFrequency / 5);			
+		openpl = floorplan->GetA1 () + floorplan->GetB1 () * std::log10(distance / m_referenceDistance) + 20 * std::log10(m_referenceFrequency / 5);
 	} else {
-		openpl = A2 + B2 * std::log10(distance / m_referenceDistance) + 20 * std::log10(m_referenceFrequency / 5);			
+		openpl = floorplan->GetA2 () + floorplan->GetB2 () * std::log10(distance / m_referenceDistance) + 20 * std::log10(m_referenceFrequency / 5);
+	}
+
+	return openpl + wallpl;
+}
+
+double
+Winner2PropagationLossModel::DoCalcRxPower (double txPowerDbm,
+																						Ptr<MobilityModel> a,
+																						Ptr<MobilityModel> b) const
+{
+	std::pair<const MobilityModel *, const MobilityModel *> key (PeekPointer (a), PeekPointer (b));
+	PathLossCache::const_iterator it = m_cache.find (key);
+	if (it != m_cache.end ())
+	{
+		return txPowerDbm - it->second;
 	}
 
-	wallpl = 0;
-	for (int i=0; i<num_wall; i++) {
-		if (its[i] == 1)
-			wallpl += wall_loss[i];
+	double pathLossDb = CalcPathLoss (a->GetPosition (), b->GetPosition ());
+
+	// a moving node changes position without any course change
+	Vector va = a->GetVelocity ();
+	Vector vb = b->GetVelocity ();
+	if (va.x == 0 && va.y == 0 && va.z == 0 && vb.x == 0 && vb.y == 0 && vb.z == 0)
+	{
+		Ptr<MobilityModel> ends[2] = { a, b };
+		for (uint32_t i = 0; i < 2; i++)
+		{
+			if (m_tracked.insert (std::make_pair (PeekPointer (ends[i]), ends[i])).second)
+			{
+				ends[i]->TraceConnectWithoutContext ("CourseChange",
+						MakeCallback (&Winner2PropagationLossModel::CourseChanged, this));
+			}
+		}
+		m_cache[key] = pathLossDb;
 	}
-	double pathLossDb = openpl + wallpl;
 
 	return txPowerDbm - pathLossDb;
 }
@@ -28,7 +28,10 @@
 #include "ns3/object.h"
 #include "ns3/random-variable-stream.h"
 #include <map>
+#include <string>
 #include <complex> //11ac: mutiple_stream_tx_channel
+#include "ns3/vector.h"
+#include "floorplan.h"
 
 namespace ns3 {
 
@@ -373,19 +376,47 @@ private:
   double m_heightAboveZ;
 };
 
+/**
+ * \ingroup propagation
+ *
+ * \brief WINNER II indoor path loss with per-wall penetration losses.
+ *
+ * \f$ L = A + B log_{10}(\frac{d}{d_0}) + 20 log_{10}(\frac{f}{5}) + \sum L_w \f$
+ *
+ * where A, B are the line of sight coefficients (A1, B1) when the tx-rx
+ * segment crosses no wall and the non line of sight ones (A2, B2)
+ * otherwise, and \f$ L_w \f$ is the loss of each crossed wall. The walls
+ * and the coefficients are held by a Floorplan, the media lab one unless
+ * a FloorplanFile is given; CoefficientFile is the calibration output of
+ * rssi_cal.
+ *
+ * The loss of a pair of nodes which do not move is cached, until one of
+ * them reports a course change.
+ */
 class Winner2PropagationLossModel : public PropagationLossModel
 {
 	public:
 		static TypeId GetTypeId (void);
 		Winner2PropagationLossModel ();
-
-		static double wall[15][4]; // n_wall = 14, edge x, y
-		static double wall_loss[15];
-		static double A1, B1, A2, B2;
-		/*
-		static double map_pl[2][197][215]; // len_x = 197, len_y = 215, num_outlet = 1
-		static double ol_list[2][2];
-*/
+		virtual ~Winner2PropagationLossModel ();
+
+		/**
+		 * \param floorplan the walls and coefficients to use
+		 */
+		void SetFloorplan (Ptr<Floorplan> floorplan);
+		/**
+		 * \return the walls and coefficients in use
+		 */
+		Ptr<Floorplan> GetFloorplan (void) const;
+		/**
+		 * \param a position of one end of the link
+		 * \param b position of the other end of the link
+		 * \return the path loss (dB), not cached
+		 */
+		double CalcPathLoss (const Vector &a, const Vector &b) const;
+
+	protected:
+		virtual void DoDispose (void);
 
 	private:
 		Winner2PropagationLossModel (const Winner2PropagationLossModel &o);
@@ -395,8 +426,26 @@ class Winner2PropagationLossModel : public PropagationLossModel
 																	Ptr<MobilityModel> b) const;
 		virtual int64_t DoAssignStreams (int64_t stream);
 
+		void SetFloorplanFile (std::string filename);
+		std::string GetFloorplanFile (void) const;
+		void SetCoefficientFile (std::string filename);
+		std::string GetCoefficientFile (void) const;
+		/**
+		 * Drop the cached losses of the links of a node which moves.
+		 */
+		void CourseChanged (Ptr<const MobilityModel> model) const;
+		void Untrack (void) const;
+
 		double m_referenceDistance;
 		double m_referenceFrequency;
+		double m_defaultWallLoss;
+		std::string m_floorplanFile;
+		std::string m_coefficientFile;
+		mutable Ptr<Floorplan> m_floorplan;
+
+		typedef std::map<std::pair<const MobilityModel *, const MobilityModel *>, double> PathLossCache;
+		mutable PathLossCache m_cache;
+		mutable std::map<const MobilityModel *, Ptr<MobilityModel> > m_tracked;
 };
 
 /**
@@ -22,6 +22,8 @@
 #include "ns3/config.h"
 #include "ns3/double.h"
 #include "ns3/propagation-loss-model.h"
+#include "ns3/jakes-propagation-loss-model.h"
+#include "ns3/jakes-fading-link.h"
 #include "ns3/constant-position-mobility-model.h"
 #include "ns3/simulator.h"
 
@@ -436,6 +438,57 @@ RangePropagationLossModelTestCase::DoRun (void)
   Simulator::Destroy ();
 }
 
+class JakesFadingLinkTestCase : public TestCase
+{
+public:
+  JakesFadingLinkTestCase ();
+  virtual ~JakesFadingLinkTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+JakesFadingLinkTestCase::JakesFadingLinkTestCase ()
+  : TestCase ("Check that JakesFadingLink computes the gains of JakesProcess")
+{
+}
+
+JakesFadingLinkTestCase::~JakesFadingLinkTestCase ()
+{
+}
+
+void
+JakesFadingLinkTestCase::DoRun (void)
+{
+  Ptr<JakesPropagationLossModel> jakes = CreateObject<JakesPropagationLossModel> ();
+  JakesFadingLink link;
+  const uint32_t nProcesses = 4;
+  for (uint32_t i = 0; i < nProcesses; i++)
+    {
+      Ptr<JakesProcess> process = CreateObject<JakesProcess> ();
+      process->SetPropagationLossModel (jakes);
+      link.AddProcess (process);
+    }
+  const uint32_t nTimes = 7;
+  double times[nTimes];
+  for (uint32_t k = 0; k < nTimes; k++)
+    {
+      times[k] = MicroSeconds (123 * k).GetSeconds ();
+    }
+  std::complex<double> gains[nTimes * nProcesses];
+  link.GetComplexGains (times, nTimes, nProcesses, gains);
+  for (uint32_t k = 0; k < nTimes; k++)
+    {
+      for (uint32_t p = 0; p < nProcesses; p++)
+        {
+          std::complex<double> expected = link.GetProcess (p)->GetComplexGain (MicroSeconds (123 * k));
+          NS_TEST_ASSERT_MSG_EQ (gains[k * nProcesses + p].real (), expected.real (), "process " << p << " time " << k);
+          NS_TEST_ASSERT_MSG_EQ (gains[k * nProcesses + p].imag (), expected.imag (), "process " << p << " time " << k);
+        }
+    }
+  Simulator::Destroy ();
+}
+
 class PropagationLossModelsTestSuite : public TestSuite
 {
 public:
@@ -450,6 +503,7 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite ()
   AddTestCase (new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new MatrixPropagationLossModelTestCase, TestCase::QUICK);
   AddTestCase (new RangePropagationLossModelTestCase, TestCase::QUICK);
+  AddTestCase (new JakesFadingLinkTestCase, TestCase::QUICK);
 }
 
 static PropagationLossModelsTestSuite propagationLossModelsTestSuite;
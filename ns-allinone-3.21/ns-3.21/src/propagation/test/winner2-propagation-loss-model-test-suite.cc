@@ -0,0 +1,205 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <fstream>
+#include "ns3/log.h"
+#include "ns3/test.h"
+#include "ns3/double.h"
+#include "ns3/string.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/floorplan.h"
+#include "ns3/propagation-loss-model.h"
+#include "ns3/constant-position-mobility-model.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("Winner2PropagationLossModelTest");
+
+// ===========================================================================
+// The uniform grid of Floorplan must find exactly the walls found by
+// testing every wall of the floorplan.
+// ===========================================================================
+class FloorplanIndexTestCase : public TestCase
+{
+public:
+  FloorplanIndexTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+FloorplanIndexTestCase::FloorplanIndexTestCase ()
+  : TestCase ("Check that the wall index of Floorplan finds the same walls as an exhaustive search")
+{
+}
+
+static bool
+Crosses (double a_x, double a_y, double b_x, double b_y, const double *w)
+{
+  double compare1 = std::abs ((w[2] - w[0]) * (b_y - a_y) * a_x - (w[3] - w[1]) * (b_x - a_x) * w[0] + (b_x - a_x) * (w[2] - w[0]) * (w[1] - a_y));
+  double compare2 = std::abs ((b_y - a_y) * (w[2] - w[0]) * w[1] - (b_x - a_x) * (w[3] - w[1]) * a_y + (b_y - a_y) * (w[3] - w[1]) * (a_x - w[0]));
+  double coeff = std::abs ((b_y - a_y) * (w[2] - w[0]) - (w[3] - w[1]) * (b_x - a_x));
+  return (coeff * std::min (a_x, b_x) <= compare1) && (compare1 <= coeff * std::max (a_x, b_x))
+         && (coeff * std::min (w[0], w[2]) <= compare1) && (compare1 <= coeff * std::max (w[0], w[2]))
+         && (coeff * std::min (a_y, b_y) <= compare2) && (compare2 <= coeff * std::max (a_y, b_y))
+         && (coeff * std::min (w[1], w[3]) <= compare2) && (compare2 <= coeff * std::max (w[1], w[3]));
+}
+
+void
+FloorplanIndexTestCase::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  Ptr<UniformRandomVariable> uniform = CreateObject<UniformRandomVariable> ();
+  uniform->SetStream (1);
+
+  // a 100m x 60m floor of 400 walls on a 0.5m raster, so that segments
+  // often end on walls or run through wall ends and cell corners
+  const uint32_t nWalls = 400;
+  std::vector<double> walls;
+  Ptr<Floorplan> floorplan = Create<Floorplan> ();
+  for (uint32_t i = 0; i < nWalls; i++)
+    {
+      double x1 = 0.5 * uniform->GetInteger (0, 200);
+      double y1 = 0.5 * uniform->GetInteger (0, 120);
+      double length = 0.5 * uniform->GetInteger (1, 20);
+      double x2 = (i % 2) ? x1 + length : x1;
+      double y2 = (i % 2) ? y1 : y1 + length;
+      double lossDb = uniform->GetValue (1, 15);
+      floorplan->AddWall (x1, y1, x2, y2, lossDb);
+      walls.push_back (x1);
+      walls.push_back (y1);
+      walls.push_back (x2);
+      walls.push_back (y2);
+      walls.push_back (lossDb);
+    }
+
+  for (uint32_t trial = 0; trial < 5000; trial++)
+    {
+      Vector a, b;
+      if (trial % 2)
+        {
+          a = Vector (uniform->GetValue (0, 110), uniform->GetValue (0, 70), 1);
+          b = Vector (uniform->GetValue (0, 110), uniform->GetValue (0, 70), 1);
+        }
+      else
+        {
+          a = Vector (0.5 * uniform->GetInteger (0, 200), 0.5 * uniform->GetInteger (0, 120), 1);
+          b = Vector (0.5 * uniform->GetInteger (0, 200), 0.5 * uniform->GetInteger (0, 120), 1);
+        }
+      // segments along the raster, which are parallel to half of the
+      // walls and often on the line of some of them, and a few points
+      if (trial % 4 == 0)
+        {
+          b.x = a.x;
+        }
+      else if (trial % 8 == 2)
+        {
+          b.y = a.y;
+        }
+      else if (trial % 500 == 6)
+        {
+          b = a;
+        }
+      uint32_t expectedWalls = 0;
+      double expectedLoss = 0;
+      for (uint32_t i = 0; i < nWalls; i++)
+        {
+          if (Crosses (a.x, a.y, b.x, b.y, &walls[i * 5]))
+            {
+              expectedWalls++;
+              expectedLoss += walls[i * 5 + 4];
+            }
+        }
+      uint32_t actualWalls;
+      double actualLoss = floorplan->GetWallLoss (a, b, actualWalls);
+      NS_TEST_ASSERT_MSG_EQ (actualWalls, expectedWalls, "trial " << trial << " " << a << " -> " << b);
+      NS_TEST_ASSERT_MSG_EQ (actualLoss, expectedLoss, "trial " << trial << " " << a << " -> " << b);
+    }
+}
+
+// ===========================================================================
+// Wall and coefficient files, and the per-pair loss cache.
+// ===========================================================================
+class Winner2PropagationLossModelTestCase : public TestCase
+{
+public:
+  Winner2PropagationLossModelTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+Winner2PropagationLossModelTestCase::Winner2PropagationLossModelTestCase ()
+  : TestCase ("Check the Winner2 model with a wall file, a coefficient file and moving nodes")
+{
+}
+
+void
+Winner2PropagationLossModelTestCase::DoRun (void)
+{
+  std::string wallFile = CreateTempDirFilename ("walls.txt");
+  std::string coefFile = CreateTempDirFilename ("coefficients.txt");
+  std::ofstream walls (wallFile.c_str ());
+  walls << "# x1 y1 x2 y2 [lossDb]" << std::endl
+        << "10 0 10 10" << std::endl
+        << "20 0 20 10 3.5" << std::endl;
+  walls.close ();
+  std::ofstream coefficients (coefFile.c_str ());
+  coefficients << "40 20" << std::endl << "45 30 7" << std::endl;
+  coefficients.close ();
+
+  Ptr<Winner2PropagationLossModel> model = CreateObject<Winner2PropagationLossModel> ();
+  model->SetAttribute ("Frequency", DoubleValue (5.0));
+  model->SetAttribute ("CoefficientFile", StringValue (coefFile));
+  model->SetAttribute ("FloorplanFile", StringValue (wallFile));
+
+  Ptr<Floorplan> floorplan = model->GetFloorplan ();
+  NS_TEST_ASSERT_MSG_EQ (floorplan->GetNWalls (), 2, "walls of the wall file");
+  NS_TEST_ASSERT_MSG_EQ_TOL (floorplan->GetWallLoss (0), 7, 1e-12, "loss of the coefficient file");
+  NS_TEST_ASSERT_MSG_EQ_TOL (floorplan->GetWallLoss (1), 3.5, 1e-12, "loss of the wall file");
+
+  Ptr<ConstantPositionMobilityModel> a = CreateObject<ConstantPositionMobilityModel> ();
+  Ptr<ConstantPositionMobilityModel> b = CreateObject<ConstantPositionMobilityModel> ();
+  a->SetPosition (Vector (0, 5, 0));
+  b->SetPosition (Vector (5, 5, 0));
+  // line of sight
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->CalcRxPower (0, a, b), -(40 + 20 * std::log10 (5.0)), 1e-9, "LOS");
+  // cached value, then a course change
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->CalcRxPower (0, a, b), -(40 + 20 * std::log10 (5.0)), 1e-9, "LOS, cached");
+  b->SetPosition (Vector (15, 5, 0));
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->CalcRxPower (0, a, b), -(45 + 30 * std::log10 (15.0) + 7), 1e-9, "one wall");
+  a->SetPosition (Vector (25, 5, 0));
+  b->SetPosition (Vector (5, 5, 0));
+  NS_TEST_ASSERT_MSG_EQ_TOL (model->CalcRxPower (0, a, b), -(45 + 30 * std::log10 (20.0) + 10.5), 1e-9, "two walls");
+}
+
+class Winner2PropagationLossModelTestSuite : public TestSuite
+{
+public:
+  Winner2PropagationLossModelTestSuite ();
+};
+
+Winner2PropagationLossModelTestSuite::Winner2PropagationLossModelTestSuite ()
+  : TestSuite ("propagation-winner2", UNIT)
+{
+  AddTestCase (new FloorplanIndexTestCase, TestCase::QUICK);
+  AddTestCase (new Winner2PropagationLossModelTestCase, TestCase::QUICK);
+}
+
+static Winner2PropagationLossModelTestSuite g_winner2PropagationLossModelTestSuite;
@@ -0,0 +1,267 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Micro-benchmark of the MMSE SINR computation done by InterferenceHelper
+// for every MIMO reception. The "legacy" column is the heap-allocated
+// cofactor-inverse implementation that InterferenceHelper used before the
+// fixed-dimension MimoMmse kernel; it is kept here only as a baseline.
+
+#include <complex>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include "ns3/core-module.h"
+#include "ns3/mimo-mmse.h"
+
+using namespace ns3;
+
+typedef std::complex<double> Complex;
+
+// keeps the optimizer from discarding the timed loops
+volatile double g_sink;
+
+static Complex
+LegacyDeterminant (Complex **mtx, int size)
+{
+  Complex det = Complex (0, 0);
+  if (size == 1)
+    {
+      det = mtx[0][0];
+    }
+  else if (size == 2)
+    {
+      det = mtx[0][0] * mtx[1][1] - mtx[1][0] * mtx[0][1];
+    }
+  else
+    {
+      Complex **m = new Complex *[size];
+      for (int i = 0; i < size; i++)
+        {
+          m[i] = new Complex[size];
+        }
+      for (int j1 = 0; j1 < size; j1++)
+        {
+          for (int i = 1; i < size; i++)
+            {
+              int j2 = 0;
+              for (int j = 0; j < size; j++)
+                {
+                  if (j == j1)
+                    {
+                      continue;
+                    }
+                  m[i - 1][j2] = mtx[i][j];
+                  j2++;
+                }
+            }
+          det += std::pow (-1.0, j1 + 2.0) * mtx[0][j1] * LegacyDeterminant (m, size - 1);
+        }
+      for (int i = 0; i < size; i++)
+        {
+          delete [] m[i];
+        }
+      delete [] m;
+    }
+  return det;
+}
+
+static void
+LegacySinr (int n, const Complex *h, double n0, double *sinr)
+{
+  Complex **ch = new Complex *[n];
+  Complex **a = new Complex *[n];
+  Complex **inv = new Complex *[n];
+  Complex **c = new Complex *[n];
+  Complex **w = new Complex *[n];
+  for (int i = 0; i < n; i++)
+    {
+      ch[i] = new Complex[n];
+      a[i] = new Complex[n];
+      inv[i] = new Complex[n];
+      c[i] = new Complex[n];
+      w[i] = new Complex[n];
+      for (int j = 0; j < n; j++)
+        {
+          ch[i][j] = h[i * n + j];
+        }
+    }
+  for (int i = 0; i < n; i++)
+    {
+      for (int j = 0; j < n; j++)
+        {
+          a[i][j] = 0;
+          for (int k = 0; k < n; k++)
+            {
+              a[i][j] += std::conj (ch[k][i]) * ch[k][j];
+            }
+        }
+      a[i][i] += n0;
+    }
+  for (int j = 0; j < n; j++)
+    {
+      for (int i = 0; i < n; i++)
+        {
+          int i1 = 0;
+          for (int ii = 0; ii < n; ii++)
+            {
+              if (ii == i)
+                {
+                  continue;
+                }
+              int j1 = 0;
+              for (int jj = 0; jj < n; jj++)
+                {
+                  if (jj == j)
+                    {
+                      continue;
+                    }
+                  c[i1][j1] = a[ii][jj];
+                  j1++;
+                }
+              i1++;
+            }
+          inv[j][i] = std::pow (-1.0, i + j + 2.0) * LegacyDeterminant (c, n - 1);
+        }
+    }
+  Complex det = LegacyDeterminant (a, n);
+  for (int i = 0; i < n; i++)
+    {
+      for (int j = 0; j < n; j++)
+        {
+          inv[i][j] /= det;
+        }
+    }
+  for (int i = 0; i < n; i++)
+    {
+      for (int j = 0; j < n; j++)
+        {
+          w[i][j] = 0;
+          for (int k = 0; k < n; k++)
+            {
+              w[i][j] += inv[i][k] * std::conj (ch[j][k]);
+            }
+        }
+    }
+  for (int i = 0; i < n; i++)
+    {
+      double interference = 0;
+      double amplification = 0;
+      double signal = 0;
+      for (int j = 0; j < n; j++)
+        {
+          amplification += std::norm (w[i][j]);
+          Complex g = 0;
+          for (int k = 0; k < n; k++)
+            {
+              g += w[i][k] * ch[k][j];
+            }
+          if (i == j)
+            {
+              signal = std::norm (g);
+            }
+          else
+            {
+              interference += std::norm (g);
+            }
+        }
+      sinr[i] = signal / (interference + n0 * amplification);
+    }
+  for (int i = 0; i < n; i++)
+    {
+      delete [] ch[i];
+      delete [] a[i];
+      delete [] inv[i];
+      delete [] c[i];
+      delete [] w[i];
+    }
+  delete [] ch;
+  delete [] a;
+  delete [] inv;
+  delete [] c;
+  delete [] w;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t iterations = 1000000;
+  uint32_t channels = 64;
+
+  CommandLine cmd;
+  cmd.AddValue ("iterations", "Number of SINR computations per stream count", iterations);
+  cmd.AddValue ("channels", "Number of distinct random channel matrices", channels);
+  cmd.Parse (argc, argv);
+
+  Ptr<NormalRandomVariable> gauss = CreateObject<NormalRandomVariable> ();
+  std::vector<Complex> h (channels * 16);
+  std::vector<double> hRe (channels * 16);
+  std::vector<double> hIm (channels * 16);
+  for (uint32_t i = 0; i < h.size (); i++)
+    {
+      h[i] = Complex (gauss->GetValue (), gauss->GetValue ()) / std::sqrt (2.0);
+      hRe[i] = h[i].real ();
+      hIm[i] = h[i].imag ();
+    }
+
+  std::cout << std::setw (4) << "nss"
+            << std::setw (14) << "legacy(ns)"
+            << std::setw (14) << "kernel(ns)"
+            << std::setw (10) << "speedup"
+            << std::setw (14) << "max rel err" << std::endl;
+
+  for (int n = 2; n <= 4; n++)
+    {
+      double n0 = n * 0.01;
+      double sinr[4];
+      SystemWallClockMs clock;
+
+      clock.Start ();
+      for (uint32_t it = 0; it < iterations; it++)
+        {
+          LegacySinr (n, &h[(it % channels) * 16], n0, sinr);
+          g_sink = sinr[0];
+        }
+      double legacy = clock.End () * 1e6 / iterations;
+
+      clock.Start ();
+      for (uint32_t it = 0; it < iterations; it++)
+        {
+          uint32_t base = (it % channels) * 16;
+          MimoMmseSinr (n, &hRe[base], &hIm[base], 0, 0, n0, sinr);
+          g_sink = sinr[0];
+        }
+      double kernel = clock.End () * 1e6 / iterations;
+
+      double maxError = 0;
+      for (uint32_t c = 0; c < channels; c++)
+        {
+          double expected[4];
+          LegacySinr (n, &h[c * 16], n0, expected);
+          MimoMmseSinr (n, &hRe[c * 16], &hIm[c * 16], 0, 0, n0, sinr);
+          for (int i = 0; i < n; i++)
+            {
+              maxError = std::max (maxError, std::fabs (sinr[i] - expected[i]) / expected[i]);
+            }
+        }
+
+      std::cout << std::setw (4) << n
+                << std::setw (14) << legacy
+                << std::setw (14) << kernel
+                << std::setw (10) << (kernel > 0 ? legacy / kernel : 0)
+                << std::setw (14) << maxError << std::endl;
+    }
+  return 0;
+}
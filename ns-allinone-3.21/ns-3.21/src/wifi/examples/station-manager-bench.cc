@@ -0,0 +1,113 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// Scaling benchmark of the WifiRemoteStationManager of an AP. The STAs
+// are associated the way ApWifiMac records an association, then every
+// frame to a STA costs the NeedRts, GetDataTxVector and ReportDataOk
+// calls of MacLow. The cost per frame should not grow with the number
+// of associated STAs.
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/wifi-module.h"
+
+using namespace ns3;
+
+// keeps the optimizer from discarding the timed loops
+volatile double g_sink;
+
+static double
+BenchStations (uint32_t nStations, uint32_t frames, std::string manager)
+{
+  NodeContainer ap;
+  ap.Create (1);
+  YansWifiChannelHelper channel = YansWifiChannelHelper::Default ();
+  YansWifiPhyHelper phy = YansWifiPhyHelper::Default ();
+  phy.SetChannel (channel.Create ());
+  WifiHelper wifi = WifiHelper::Default ();
+  wifi.SetStandard (WIFI_PHY_STANDARD_80211a);
+  wifi.SetRemoteStationManager (manager);
+  NqosWifiMacHelper mac = NqosWifiMacHelper::Default ();
+  mac.SetType ("ns3::ApWifiMac",
+               "Ssid", SsidValue (Ssid ("bench")),
+               "BeaconGeneration", BooleanValue (false));
+  NetDeviceContainer devices = wifi.Install (phy, mac, ap);
+  Ptr<WifiNetDevice> device = DynamicCast<WifiNetDevice> (devices.Get (0));
+  Ptr<WifiRemoteStationManager> stations = device->GetRemoteStationManager ();
+  Ptr<WifiPhy> wifiPhy = device->GetPhy ();
+
+  std::vector<Mac48Address> addresses;
+  for (uint32_t i = 0; i < nStations; i++)
+    {
+      Mac48Address address = Mac48Address::Allocate ();
+      for (uint32_t j = 0; j < wifiPhy->GetNModes (); j++)
+        {
+          stations->AddSupportedMode (address, wifiPhy->GetMode (j));
+        }
+      stations->RecordWaitAssocTxOk (address);
+      stations->RecordGotAssocTxOk (address);
+      addresses.push_back (address);
+    }
+
+  WifiMacHeader hdr;
+  hdr.SetType (WIFI_MAC_DATA);
+  hdr.SetAddr2 (device->GetMac ()->GetAddress ());
+  Ptr<Packet> packet = Create<Packet> (1000);
+  uint32_t size = packet->GetSize () + hdr.GetSize () + 4;
+
+  SystemWallClockMs clock;
+  clock.Start ();
+  for (uint32_t f = 0; f < frames; f++)
+    {
+      // a different STA for each frame, in no particular order
+      Mac48Address address = addresses[(f * 7919) % nStations];
+      hdr.SetAddr1 (address);
+      g_sink = stations->NeedRts (address, &hdr, packet);
+      WifiTxVector txVector = stations->GetDataTxVector (address, &hdr, packet, size);
+      stations->ReportDataOk (address, &hdr, 100.0, txVector.GetMode (), 100.0);
+    }
+  double perFrame = clock.End () * 1e6 / frames;
+
+  Simulator::Destroy ();
+  return perFrame;
+}
+
+int
+main (int argc, char *argv[])
+{
+  uint32_t frames = 200000;
+  std::string manager = "ns3::ConstantRateWifiManager";
+
+  CommandLine cmd;
+  cmd.AddValue ("frames", "Number of frames per number of STAs", frames);
+  cmd.AddValue ("manager", "Type of the WifiRemoteStationManager", manager);
+  cmd.Parse (argc, argv);
+
+  std::cout << std::setw (10) << "stations"
+            << std::setw (16) << "ns per frame" << std::endl;
+
+  const uint32_t counts[] = { 10, 100, 500 };
+  for (uint32_t i = 0; i < sizeof (counts) / sizeof (counts[0]); i++)
+    {
+      double perFrame = BenchStations (counts[i], frames, manager);
+      std::cout << std::setw (10) << counts[i]
+                << std::setw (16) << perFrame << std::endl;
+    }
+  return 0;
+}
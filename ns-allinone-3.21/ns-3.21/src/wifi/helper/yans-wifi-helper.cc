@@ -21,6 +21,7 @@
 #include "ns3/trace-helper.h"
 #include "yans-wifi-helper.h"
 #include "ns3/error-rate-model.h"
+#include "ns3/effective-snr-mapping.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/propagation-delay-model.h"
 #include "ns3/yans-wifi-channel.h"
@@ -190,6 +191,7 @@ YansWifiPhyHelper::YansWifiPhyHelper ()
     m_pcapDlt (PcapHelper::DLT_IEEE802_11)
 {
   m_phy.SetTypeId ("ns3::YansWifiPhy");
+  m_effectiveSnrMapping.SetTypeId ("ns3::RbirEffectiveSnrMapping");
 }
 
 YansWifiPhyHelper
@@ -255,12 +257,36 @@ YansWifiPhyHelper::SetErrorRateModel (std::string name,
   m_errorRateModel.Set (n7, v7);
 }
 
+void
+YansWifiPhyHelper::SetEffectiveSnrMapping (std::string name,
+                                           std::string n0, const AttributeValue &v0,
+                                           std::string n1, const AttributeValue &v1,
+                                           std::string n2, const AttributeValue &v2,
+                                           std::string n3, const AttributeValue &v3,
+                                           std::string n4, const AttributeValue &v4,
+                                           std::string n5, const AttributeValue &v5,
+                                           std::string n6, const AttributeValue &v6,
+                                           std::string n7, const AttributeValue &v7)
+{
+  m_effectiveSnrMapping = ObjectFactory ();
+  m_effectiveSnrMapping.SetTypeId (name);
+  m_effectiveSnrMapping.Set (n0, v0);
+  m_effectiveSnrMapping.Set (n1, v1);
+  m_effectiveSnrMapping.Set (n2, v2);
+  m_effectiveSnrMapping.Set (n3, v3);
+  m_effectiveSnrMapping.Set (n4, v4);
+  m_effectiveSnrMapping.Set (n5, v5);
+  m_effectiveSnrMapping.Set (n6, v6);
+  m_effectiveSnrMapping.Set (n7, v7);
+}
+
 Ptr<WifiPhy>
 YansWifiPhyHelper::Create (Ptr<Node> node, Ptr<WifiNetDevice> device) const
 {
   Ptr<YansWifiPhy> phy = m_phy.Create<YansWifiPhy> ();
   Ptr<ErrorRateModel> error = m_errorRateModel.Create<ErrorRateModel> ();
   phy->SetErrorRateModel (error);
+  phy->SetEffectiveSnrMapping (m_effectiveSnrMapping.Create<EffectiveSnrMapping> ());
   phy->SetChannel (m_channel);
   phy->SetMobility (node);
   phy->SetDevice (device);
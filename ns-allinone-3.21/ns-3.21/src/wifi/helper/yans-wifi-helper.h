@@ -233,6 +233,38 @@ public:
                           std::string n5 = "", const AttributeValue &v5 = EmptyAttributeValue (),
                           std::string n6 = "", const AttributeValue &v6 = EmptyAttributeValue (),
                           std::string n7 = "", const AttributeValue &v7 = EmptyAttributeValue ());
+  /**
+   * \param name the name of the effective SNR mapping to set.
+   * \param n0 the name of the attribute to set
+   * \param v0 the value of the attribute to set
+   * \param n1 the name of the attribute to set
+   * \param v1 the value of the attribute to set
+   * \param n2 the name of the attribute to set
+   * \param v2 the value of the attribute to set
+   * \param n3 the name of the attribute to set
+   * \param v3 the value of the attribute to set
+   * \param n4 the name of the attribute to set
+   * \param v4 the value of the attribute to set
+   * \param n5 the name of the attribute to set
+   * \param v5 the value of the attribute to set
+   * \param n6 the name of the attribute to set
+   * \param v6 the value of the attribute to set
+   * \param n7 the name of the attribute to set
+   * \param v7 the value of the attribute to set
+   *
+   * Set the mapping of the SINRs of the spatial streams to one SNR, and its
+   * attributes, to use when Install is called (ns3::RbirEffectiveSnrMapping
+   * by default).
+   */
+  void SetEffectiveSnrMapping (std::string name,
+                               std::string n0 = "", const AttributeValue &v0 = EmptyAttributeValue (),
+                               std::string n1 = "", const AttributeValue &v1 = EmptyAttributeValue (),
+                               std::string n2 = "", const AttributeValue &v2 = EmptyAttributeValue (),
+                               std::string n3 = "", const AttributeValue &v3 = EmptyAttributeValue (),
+                               std::string n4 = "", const AttributeValue &v4 = EmptyAttributeValue (),
+                               std::string n5 = "", const AttributeValue &v5 = EmptyAttributeValue (),
+                               std::string n6 = "", const AttributeValue &v6 = EmptyAttributeValue (),
+                               std::string n7 = "", const AttributeValue &v7 = EmptyAttributeValue ());
 
   /**
    * An enumeration of the pcap data link types (DLTs) which this helper
@@ -302,6 +334,7 @@ private:
 
   ObjectFactory m_phy;
   ObjectFactory m_errorRateModel;
+  ObjectFactory m_effectiveSnrMapping;
   Ptr<YansWifiChannel> m_channel;
   uint32_t m_pcapDlt;
 };
@@ -0,0 +1,111 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ampdu-planner.h"
+
+NS_LOG_COMPONENT_DEFINE ("AmpduPlanner");
+
+namespace ns3 {
+
+AmpduPlanner::AmpduPlanner ()
+  : m_psduSize (0)
+{
+}
+
+void
+AmpduPlanner::Start (Ptr<MpduAggregator> aggregator, WifiTxVector txVector)
+{
+  NS_LOG_FUNCTION (this << aggregator << txVector);
+  m_aggregator = aggregator;
+  m_duration = PpduDuration::Get (txVector);
+  m_subframes.clear ();
+  m_layout = Create<AmpduSubframes> ();
+  m_psduSize = 0;
+}
+
+bool
+AmpduPlanner::Add (Ptr<const Packet> mpdu)
+{
+  NS_LOG_FUNCTION (this << mpdu);
+  uint32_t size = mpdu->GetSize ();
+  if (size > m_aggregator->GetMaxAvailableLength (m_psduSize))
+    {
+      return false;
+    }
+  Subframe subframe;
+  subframe.mpdu = mpdu;
+  subframe.padding = MpduAggregator::CalculatePadding (m_psduSize);
+  subframe.delimiter.SetLength (size);
+  m_subframes.push_back (subframe);
+  uint32_t offset = m_psduSize + subframe.padding;
+  m_layout->Add (offset, size);
+  m_psduSize = offset + subframe.delimiter.GetSerializedSize () + size;
+  NS_LOG_DEBUG ("subframe " << m_subframes.size () << " at " << offset << ", A-MPDU size " << m_psduSize);
+  return true;
+}
+
+uint16_t
+AmpduPlanner::GetN (void) const
+{
+  return m_subframes.size ();
+}
+
+uint32_t
+AmpduPlanner::GetPsduSize (void) const
+{
+  return m_psduSize;
+}
+
+uint32_t
+AmpduPlanner::GetMaxAvailableLength (void) const
+{
+  return m_aggregator->GetMaxAvailableLength (m_psduSize);
+}
+
+Time
+AmpduPlanner::CalculateTxDuration (uint32_t size, WifiPreamble preamble)
+{
+  return m_duration.Calculate (size, preamble);
+}
+
+Ptr<AmpduSubframes>
+AmpduPlanner::GetSubframes (void) const
+{
+  return m_layout;
+}
+
+Ptr<Packet>
+AmpduPlanner::Build (void) const
+{
+  NS_LOG_FUNCTION (this);
+  Ptr<Packet> ampdu = Create<Packet> ();
+  for (std::vector<Subframe>::const_iterator i = m_subframes.begin (); i != m_subframes.end (); i++)
+    {
+      if (i->padding)
+        {
+          ampdu->AddAtEnd (Create<Packet> (i->padding));
+        }
+      Ptr<Packet> subframe = i->mpdu->Copy ();
+      subframe->AddHeader (i->delimiter);
+      ampdu->AddAtEnd (subframe);
+    }
+  NS_ASSERT (ampdu->GetSize () == m_psduSize);
+  return ampdu;
+}
+
+} // namespace ns3
@@ -0,0 +1,123 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef AMPDU_PLANNER_H
+#define AMPDU_PLANNER_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/ptr.h"
+#include "ns3/packet.h"
+#include "ns3/nstime.h"
+#include "ampdu-mpdu-delimiter.h"
+#include "ampdu-subframes.h"
+#include "mpdu-aggregator.h"
+#include "ppdu-duration.h"
+#include "wifi-tx-vector.h"
+#include "wifi-preamble.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief decides the subframes of an A-MPDU before building it
+ *
+ * The MPDUs accepted for an A-MPDU are only accounted for: the padding
+ * and the delimiter of each subframe, the size of the PSDU and, for the
+ * TX vector of the A-MPDU, the duration of the PPDU by counting symbols.
+ * Neither the A-MPDU nor its duration is recomputed from scratch when an
+ * MPDU is added. Once the subframes are decided, the A-MPDU is gathered
+ * in one pass by Build.
+ */
+class AmpduPlanner
+{
+public:
+  /**
+   * What ended an A-MPDU.
+   */
+  enum Limit
+  {
+    NO_MORE_MPDUS,      //!< no more MPDU to the receiver with the TID
+    LENGTH,             //!< the next MPDU exceeds the maximum A-MPDU length
+    DURATION,           //!< the next MPDU exceeds the remaining PPDU duration
+    BLOCK_ACK_REQUEST,  //!< a block ack request is sent after the A-MPDU
+    OTHER               //!< the EDCA function held the next MPDU back (rate sampling, block ack setup)
+  };
+
+  AmpduPlanner ();
+
+  /**
+   * Start planning a new A-MPDU.
+   *
+   * \param aggregator the aggregator which sets the maximum A-MPDU length
+   * \param txVector the TX vector of the A-MPDU
+   */
+  void Start (Ptr<MpduAggregator> aggregator, WifiTxVector txVector);
+  /**
+   * \param mpdu the MPDU, with its MAC header and FCS
+   * \return true if the MPDU fits and is added to the A-MPDU, as
+   *         MpduAggregator::Aggregate would
+   */
+  bool Add (Ptr<const Packet> mpdu);
+  /**
+   * \return the number of MPDUs in the A-MPDU
+   */
+  uint16_t GetN (void) const;
+  /**
+   * \return the size of the A-MPDU
+   */
+  uint32_t GetPsduSize (void) const;
+  /**
+   * \return the size of the largest MPDU which can still be added
+   */
+  uint32_t GetMaxAvailableLength (void) const;
+  /**
+   * \param size the size of a PSDU
+   * \param preamble the type of preamble
+   * \return the duration of a PPDU of that size with the TX vector of the A-MPDU
+   */
+  Time CalculateTxDuration (uint32_t size, WifiPreamble preamble);
+  /**
+   * \return the layout of the A-MPDU
+   */
+  Ptr<AmpduSubframes> GetSubframes (void) const;
+  /**
+   * Gather the MPDUs, with their padding and delimiters, in one PSDU.
+   *
+   * \return the A-MPDU
+   */
+  Ptr<Packet> Build (void) const;
+
+private:
+  /**
+   * An MPDU of the A-MPDU and what precedes it.
+   */
+  struct Subframe
+  {
+    Ptr<const Packet> mpdu;        //!< the MPDU
+    uint32_t padding;              //!< the padding of the previous subframe
+    AmpduMpduDelimiter delimiter;  //!< the MPDU delimiter
+  };
+
+  Ptr<MpduAggregator> m_aggregator;   //!< the aggregator of the A-MPDU
+  PpduDuration m_duration;            //!< the PPDU durations of the TX vector
+  std::vector<Subframe> m_subframes;  //!< the subframes of the A-MPDU
+  Ptr<AmpduSubframes> m_layout;       //!< the layout of the A-MPDU
+  uint32_t m_psduSize;                //!< the size of the A-MPDU
+};
+
+} // namespace ns3
+
+#endif /* AMPDU_PLANNER_H */
@@ -0,0 +1,93 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include "ampdu-subframes.h"
+#include "ampdu-mpdu-delimiter.h"
+#include "ns3/packet.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+AmpduSubframes::AmpduSubframes ()
+{
+}
+
+Ptr<AmpduSubframes>
+AmpduSubframes::Parse (Ptr<const Packet> ampdu)
+{
+  // same walk as MpduAggregator::Deaggregate, without the fragments
+  Ptr<AmpduSubframes> subframes = Create<AmpduSubframes> ();
+  Ptr<Packet> copy = ampdu->Copy ();
+  uint32_t maxSize = copy->GetSize ();
+  uint32_t deserialized = 0;
+  AmpduMpduDelimiter hdr;
+  while (deserialized < maxSize)
+    {
+      uint32_t offset = deserialized;
+      deserialized += copy->RemoveHeader (hdr);
+      uint32_t length = hdr.GetLength ();
+      copy->RemoveAtStart (length);
+      deserialized += length;
+      uint32_t padding = (4 - ((length + 4) % 4)) % 4;
+      if (padding > 0 && deserialized < maxSize)
+        {
+          copy->RemoveAtStart (padding);
+          deserialized += padding;
+        }
+      subframes->Add (offset, length);
+    }
+  return subframes;
+}
+
+void
+AmpduSubframes::Add (uint32_t offset, uint32_t length)
+{
+  NS_ASSERT (m_offsets.empty () || offset >= GetPsduSize ());
+  m_offsets.push_back (offset);
+  m_lengths.push_back (length);
+}
+
+uint16_t
+AmpduSubframes::GetN (void) const
+{
+  return m_lengths.size ();
+}
+
+uint32_t
+AmpduSubframes::GetOffset (uint16_t i) const
+{
+  NS_ASSERT (i < m_offsets.size ());
+  return m_offsets[i];
+}
+
+uint32_t
+AmpduSubframes::GetLength (uint16_t i) const
+{
+  NS_ASSERT (i < m_lengths.size ());
+  return m_lengths[i];
+}
+
+uint32_t
+AmpduSubframes::GetPsduSize (void) const
+{
+  if (m_lengths.empty ())
+    {
+      return 0;
+    }
+  // the delimiter of a subframe is 4 bytes long
+  return m_offsets.back () + 4 + m_lengths.back ();
+}
+
+} // namespace ns3
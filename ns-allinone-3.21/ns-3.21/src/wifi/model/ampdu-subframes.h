@@ -0,0 +1,85 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef AMPDU_SUBFRAMES_H
+#define AMPDU_SUBFRAMES_H
+
+#include <stdint.h>
+#include <vector>
+#include "ns3/simple-ref-count.h"
+#include "ns3/ptr.h"
+
+namespace ns3 {
+
+class Packet;
+
+/**
+ * \ingroup wifi
+ * \brief Layout of the subframes of one A-MPDU.
+ *
+ * For every subframe, the offset of its MPDU delimiter within the PSDU
+ * and the length of its MPDU (the length field of the delimiter). The
+ * offset of a subframe is also its relative start time within the PSDU
+ * once scaled by the bit rate. The table is built once by
+ * MacLow::AggregateMpdu and is shared read-only, through the
+ * WifiTxVector, by the channel and by every receiving PHY, so that the
+ * A-MPDU is only split when its MPDUs are handed up to the MAC.
+ */
+class AmpduSubframes : public SimpleRefCount<AmpduSubframes>
+{
+public:
+  AmpduSubframes ();
+
+  /**
+   * Read the delimiters of an A-MPDU. This is only needed for A-MPDUs
+   * which were not built by MacLow.
+   *
+   * \param ampdu the A-MPDU
+   * \return the layout of the A-MPDU
+   */
+  static Ptr<AmpduSubframes> Parse (Ptr<const Packet> ampdu);
+
+  /**
+   * \param offset the offset of the MPDU delimiter within the PSDU
+   * \param length the length of the MPDU
+   */
+  void Add (uint32_t offset, uint32_t length);
+  /**
+   * \return the number of subframes
+   */
+  uint16_t GetN (void) const;
+  /**
+   * \param i the index of the subframe
+   * \return the offset of the MPDU delimiter within the PSDU
+   */
+  uint32_t GetOffset (uint16_t i) const;
+  /**
+   * \param i the index of the subframe
+   * \return the length of the MPDU
+   */
+  uint32_t GetLength (uint16_t i) const;
+  /**
+   * \return the size of the PSDU, i.e. the end of the last MPDU
+   */
+  uint32_t GetPsduSize (void) const;
+
+private:
+  std::vector<uint32_t> m_offsets;
+  std::vector<uint32_t> m_lengths;
+};
+
+} // namespace ns3
+
+#endif /* AMPDU_SUBFRAMES_H */
@@ -129,7 +129,7 @@ BlockAckManager::CreateAgreement (const MgtAddBaRequestHeader *reqHdr, Mac48Addr
       agreement.SetDelayedBlockAck ();
     }
   agreement.SetState (OriginatorBlockAckAgreement::PENDING);
-  PacketQueue queue (0);
+  PacketQueue queue;
   std::pair<OriginatorBlockAckAgreement, PacketQueue> value (agreement, queue);
   m_agreements.insert (std::make_pair (key, value));
   m_blockPackets (recipient, reqHdr->GetTid ());
@@ -216,22 +216,20 @@ BlockAckManager::StorePacket (Ptr<const Packet> packet, const WifiMacHeader &hdr
   NS_ASSERT (it != m_agreements.end ());
 
   //shbyeon
-  AgreementsCI it2 = m_agreements.find (std::make_pair (recipient, tid));
-  PacketQueueCI queueIt = (*it2).second.second.begin ();
-	bool exist = false;
-  while (queueIt != (*it2).second.second.end ())
-  {
-	  if(hdr.GetSequenceNumber() == (*queueIt).hdr.GetSequenceNumber ())
-		{
-			NS_LOG_DEBUG("the seq exist = " << hdr.GetSequenceNumber ());
-			exist = true;
-		}
-    queueIt++;
- 	}
-
+  PacketQueue &queue = it->second.second;
+  if (queue.index.IsSet (hdr.GetSequenceNumber ()))
+    {
+      NS_LOG_DEBUG ("the seq exist = " << hdr.GetSequenceNumber ());
+      return;
+    }
+  queue.index.Set (hdr.GetSequenceNumber (), queue.packets.insert (queue.packets.end (), item));
+}
 
-	if(!exist)
-    it->second.second.push_back (item);
+BlockAckManager::PacketQueueI
+BlockAckManager::Erase (PacketQueue &queue, PacketQueueI it)
+{
+  queue.index.Clear (it->hdr.GetSequenceNumber ());
+  return queue.packets.erase (it);
 }
 
 //shbyeon store retry packet at the front
@@ -246,19 +244,12 @@ BlockAckManager::StorePacketRetryFront (const WifiMacHeader &hdr, Time tStamp)
   uint8_t tid = hdr.GetQosTid ();
   Mac48Address recipient = hdr.GetAddr1 ();
   AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
-  PacketQueueI queueEnd = it->second.second.end ();
-  for (PacketQueueI queueIt = it->second.second.begin (); queueIt != queueEnd;)
-	{
-		NS_LOG_DEBUG("Insert !! seq = "<<hdr.GetSequenceNumber () << "queue seq = " << (*queueIt).hdr.GetSequenceNumber ());
-  	if ((*queueIt).hdr.GetSequenceNumber () == hdr.GetSequenceNumber ())
-		{
-
-			NS_LOG_DEBUG("Insert !! seq = "<<hdr.GetSequenceNumber ());
-    	m_retryPackets.push_front (queueIt);
-			break;
-		}
-		queueIt++;
-	}
+  NS_ASSERT (it != m_agreements.end ());
+  if (it->second.second.index.IsSet (hdr.GetSequenceNumber ()))
+    {
+      NS_LOG_DEBUG ("Insert !! seq = " << hdr.GetSequenceNumber ());
+      m_retryPackets.push_front (it->second.second.index.Get (hdr.GetSequenceNumber ()));
+    }
 }
 
 //shbyeon store retry packet at the back
@@ -273,19 +264,12 @@ BlockAckManager::StorePacketRetryBack (const WifiMacHeader &hdr, Time tStamp)
   uint8_t tid = hdr.GetQosTid ();
   Mac48Address recipient = hdr.GetAddr1 ();
   AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
-  PacketQueueI queueEnd = it->second.second.end ();
-  for (PacketQueueI queueIt = it->second.second.begin (); queueIt != queueEnd;)
-	{
-		NS_LOG_DEBUG("Insert !! seq = "<<hdr.GetSequenceNumber () << " queue seq = " << (*queueIt).hdr.GetSequenceNumber ());
-  	if ((*queueIt).hdr.GetSequenceNumber () == hdr.GetSequenceNumber ())
-		{
-
-			NS_LOG_DEBUG("Insert !! seq = "<<hdr.GetSequenceNumber ());
-    	m_retryPackets.push_back (queueIt);
-			break;
-		}
-		queueIt++;
-	}
+  NS_ASSERT (it != m_agreements.end ());
+  if (it->second.second.index.IsSet (hdr.GetSequenceNumber ()))
+    {
+      NS_LOG_DEBUG ("Insert !! seq = " << hdr.GetSequenceNumber ());
+      m_retryPackets.push_back (it->second.second.index.Get (hdr.GetSequenceNumber ()));
+    }
 }
 
 Ptr<const Packet>
@@ -328,7 +312,7 @@ BlockAckManager::GetNextPacket (WifiMacHeader &hdr)
            */
           hdr.SetQosAckPolicy (WifiMacHeader::NORMAL_ACK);
           AgreementsI i = m_agreements.find (std::make_pair (recipient, tid));
-          i->second.second.erase (queueIt);
+          Erase (i->second.second, queueIt);
         }
     }
   return packet;
@@ -367,6 +351,11 @@ BlockAckManager::GetNextPacketForAmpdu (WifiMacHeader &hdr, Mac48Address recipie
         m_retryPackets.erase (it);
         break;
       }
+      it++;
+    }
+    if (packet == 0)
+    {
+      return 0;
     }
 
     hdr.SetRetry ();
@@ -388,7 +377,10 @@ BlockAckManager::GetNextPacketForAmpdu (WifiMacHeader &hdr, Mac48Address recipie
     {
       hdr.SetQosAckPolicy (WifiMacHeader::NORMAL_ACK);
       AgreementsI i = m_agreements.find (std::make_pair (recipient, tid));
-      i->second.second.erase (*it);
+      if (i->second.second.index.IsSet (hdr.GetSequenceNumber ()))
+      {
+        Erase (i->second.second, i->second.second.index.Get (hdr.GetSequenceNumber ()));
+      }
     }
   }
   return packet;
@@ -418,23 +410,11 @@ uint32_t
 BlockAckManager::GetNBufferedPackets (Mac48Address recipient, uint8_t tid) const
 {
   NS_LOG_FUNCTION (this << recipient << static_cast<uint32_t> (tid));
-  uint32_t nPackets = 0;
-  if (ExistsAgreement (recipient, tid))
+  AgreementsCI it = m_agreements.find (std::make_pair (recipient, tid));
+  if (it != m_agreements.end ())
     {
-      AgreementsCI it = m_agreements.find (std::make_pair (recipient, tid));
-      PacketQueueCI queueIt = (*it).second.second.begin ();
-      uint16_t currentSeq = 0;
-      while (queueIt != (*it).second.second.end ())
-        {
-          currentSeq = (*queueIt).hdr.GetSequenceNumber ();
-          nPackets++;
-          /* a fragmented packet must be counted as one packet */
-          while (queueIt != (*it).second.second.end () && (*queueIt).hdr.GetSequenceNumber () == currentSeq)
-            {
-              queueIt++;
-            }
-        }
-      return nPackets;
+      /* one packet per sequence number */
+      return it->second.second.index.GetCount ();
     }
   return 0;
 }
@@ -498,7 +478,8 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
         {
           bool foundFirstLost = false;
           AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
-          PacketQueueI queueEnd = it->second.second.end ();
+          PacketQueue &queue = it->second.second;
+          PacketQueueI queueEnd = queue.packets.end ();
 
           if (it->second.first.m_inactivityEvent.IsRunning ())
             {
@@ -514,12 +495,12 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
             }
           if (blockAck->IsBasic ())
             {
-              for (PacketQueueI queueIt = it->second.second.begin (); queueIt != queueEnd;)
+              for (PacketQueueI queueIt = queue.packets.begin (); queueIt != queueEnd;)
                 {
                   if (blockAck->IsFragmentReceived ((*queueIt).hdr.GetSequenceNumber (),
                                                     (*queueIt).hdr.GetFragmentNumber ()))
                     {
-                      queueIt = it->second.second.erase (queueIt);
+                      queueIt = Erase (queue, queueIt);
                     }
                   else
                     {
@@ -538,39 +519,71 @@ BlockAckManager::NotifyGotBlockAck (const CtrlBAckResponseHeader *blockAck, Mac4
             {
 							//ohlee refresh m_retryPackets to rebuild it
               m_retryPackets.clear();
-              for (PacketQueueI queueIt = it->second.second.begin (); queueIt != queueEnd;)
+              /* the packets both sent and acked, 64 sequence numbers at once */
+              uint16_t startingSeq = blockAck->GetStartingSequence ();
+              uint64_t inFlight = queue.index.GetBitmap (startingSeq);
+              uint64_t acked = blockAck->GetCompressedBitmap () & inFlight;
+              if (static_cast<uint32_t> (__builtin_popcountll (inFlight)) == queue.index.GetCount ())
                 {
-                  resultsIdx++;
-                  NS_LOG_DEBUG("recieved MPDU seq=" <<  (*queueIt).hdr.GetSequenceNumber () );
-                  results_mpdu[resultsIdx-1]=(*queueIt).packet->GetSize();
-                  if (blockAck->IsPacketReceived ((*queueIt).hdr.GetSequenceNumber ()))
+                  /* all the packets sent are in the window, where the order
+                     they were sent in is the order of their sequence numbers:
+                     only the bits of the window in use are visited */
+                  for (uint64_t bits = inFlight; bits != 0; bits &= bits - 1)
                     {
-                      results[resultsIdx-1]=1;
-                      uint16_t currentSeq = (*queueIt).hdr.GetSequenceNumber ();
-                      NS_LOG_DEBUG ("received ack, seq=" << currentSeq);
-                      while (queueIt != queueEnd
-                             && (*queueIt).hdr.GetSequenceNumber () == currentSeq)
+                      uint16_t offset = __builtin_ctzll (bits);
+                      PacketQueueI queueIt = queue.index.Get ((startingSeq + offset) & 4095);
+                      resultsIdx++;
+                      results_mpdu[resultsIdx-1] = (*queueIt).packet->GetSize ();
+                      if ((acked >> offset) & 1)
                         {
-                          queueIt = it->second.second.erase (queueIt);
+                          results[resultsIdx-1] = 1;
+                          Erase (queue, queueIt);
+                        }
+                      else
+                        {
+                          if (!foundFirstLost)
+                            {
+                              foundFirstLost = true;
+                              sequenceFirstLost = (*queueIt).hdr.GetSequenceNumber ();
+                              (*it).second.first.SetStartingSequence (sequenceFirstLost);
+                            }
+                          results[resultsIdx-1] = 0;
+                          m_retryPackets.push_back (queueIt);
                         }
                     }
-                  else
+                }
+              else
+                {
+                  for (PacketQueueI queueIt = queue.packets.begin (); queueIt != queueEnd;)
                     {
-                      if (!foundFirstLost)
+                      resultsIdx++;
+                      NS_LOG_DEBUG("recieved MPDU seq=" <<  (*queueIt).hdr.GetSequenceNumber () );
+                      results_mpdu[resultsIdx-1]=(*queueIt).packet->GetSize();
+                      uint16_t offset = ((*queueIt).hdr.GetSequenceNumber () - startingSeq + 4096) % 4096;
+                      if (offset < 64 && ((acked >> offset) & 1))
                         {
-                          foundFirstLost = true;
-                          sequenceFirstLost = (*queueIt).hdr.GetSequenceNumber ();
-                          (*it).second.first.SetStartingSequence (sequenceFirstLost);
-						              NS_LOG_DEBUG ("firstlost, seq=" << sequenceFirstLost);
+                          results[resultsIdx-1]=1;
+                          NS_LOG_DEBUG ("received ack, seq=" << (*queueIt).hdr.GetSequenceNumber ());
+                          queueIt = Erase (queue, queueIt);
+                        }
+                      else
+                        {
+                          if (!foundFirstLost)
+                            {
+                              foundFirstLost = true;
+                              sequenceFirstLost = (*queueIt).hdr.GetSequenceNumber ();
+                              (*it).second.first.SetStartingSequence (sequenceFirstLost);
+                              NS_LOG_DEBUG ("firstlost, seq=" << sequenceFirstLost);
+                            }
+                          NS_LOG_DEBUG("add to retry queue seq = " << (*queueIt).hdr.GetSequenceNumber ());
+                          results[resultsIdx-1]=0; 
+                          m_retryPackets.push_back (queueIt);
+                          NS_LOG_DEBUG ("# of packets in the queue: " << 
+                                      m_queue->GetNPacketsByTidAndAddress (tid, WifiMacHeader::ADDR1, recipient) << 
+                                      " # of packets in the buffered queue: " << GetNBufferedPackets (recipient, tid) << 
+                                      " # of packets in the retry queue: " << GetNRetryNeededPackets(recipient, tid)); 
+                          queueIt++;
                         }
-											NS_LOG_DEBUG("add to retry queue seq = " << (*queueIt).hdr.GetSequenceNumber ());
-                      results[resultsIdx-1]=0; 
-                      m_retryPackets.push_back (queueIt);
-                      NS_LOG_DEBUG ("# of packets in the queue: " << 
-                                  m_queue->GetNPacketsByTidAndAddress (tid, WifiMacHeader::ADDR1, recipient) << 
-                                  " # of packets in the buffered queue: " << GetNBufferedPackets (recipient, tid) << 
-                                  " # of packets in the retry queue: " << GetNRetryNeededPackets(recipient, tid)); 
-                      queueIt++;
                     }
                 }
             }
@@ -598,9 +611,9 @@ BlockAckManager::NotifyBlockAckTimeoutCancel (uint8_t tid, Mac48Address recipien
 {
 	NS_LOG_FUNCTION(this);
 	AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
-  PacketQueueI queueEnd = it->second.second.end ();
+  PacketQueueI queueEnd = it->second.second.packets.end ();
 	m_retryPackets.clear();
-  for (PacketQueueI queueIt = it->second.second.begin (); queueIt != queueEnd;){
+  for (PacketQueueI queueIt = it->second.second.packets.begin (); queueIt != queueEnd;){
 		(*queueIt).hdr.SetRetry();
  		m_retryPackets.push_back (queueIt);
     NS_LOG_DEBUG ("# of packets in the queue: " << m_queue->GetNPacketsByTidAndAddress (tid, WifiMacHeader::ADDR1, recipient)
@@ -616,9 +629,9 @@ BlockAckManager::NotifyRtsFailed (uint8_t tid, Mac48Address recipient)
 {
 	NS_LOG_FUNCTION(this);
 	AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
-  PacketQueueI queueEnd = it->second.second.end ();
+  PacketQueueI queueEnd = it->second.second.packets.end ();
 	m_retryPackets.clear();
-  for (PacketQueueI queueIt = it->second.second.begin (); queueIt != queueEnd;){
+  for (PacketQueueI queueIt = it->second.second.packets.begin (); queueIt != queueEnd;){
 		// 120206 without set retry because there the packets are not retransmitted
 		(*queueIt).hdr.SetRetry();
  		m_retryPackets.push_back (queueIt);
@@ -641,7 +654,7 @@ BlockAckManager::NotifyGotAck (uint8_t tid, uint16_t seqNumber, Mac48Address rec
 	{
 		uint16_t newSeq=0;
 		AgreementsI it = m_agreements.find (std::make_pair (recipient, tid));
-		PacketQueueI queueEnd = it->second.second.end ();
+		PacketQueue &queue = it->second.second;
 
 		if (it->second.first.m_inactivityEvent.IsRunning ())
 		{
@@ -656,22 +669,15 @@ BlockAckManager::NotifyGotAck (uint8_t tid, uint16_t seqNumber, Mac48Address rec
 
               
 		NS_LOG_DEBUG ("received ack, seq=" << seqNumber);
-		for (PacketQueueI queueIt = it->second.second.begin (); queueIt != queueEnd;)
+		if (queue.index.IsSet (seqNumber))
 		{
-                      
-			NS_LOG_DEBUG ("queued seq=" << (*queueIt).hdr.GetSequenceNumber ());
-			if ((*queueIt).hdr.GetSequenceNumber () == seqNumber)
-			{
-				queueIt = it->second.second.erase (queueIt);
-				NS_LOG_DEBUG ("erase seq=" << (*queueIt).hdr.GetSequenceNumber ());
-  			NS_LOG_DEBUG ("retryPacketSize=" << m_retryPackets.size ());
-    		NS_LOG_DEBUG ("# of packets in the buffered queue: " << GetNBufferedPackets (recipient, tid) 
-											<< " # of packets in the retry queue: " << GetNRetryNeededPackets(recipient, tid)); 
-        newSeq = m_txMiddle->GetNextSeqNumberByTidAndAddress (tid, recipient);
-				NS_LOG_DEBUG ("nextSeq=" << newSeq);
-			}
-			else 
-				queueIt++;
+			Erase (queue, queue.index.Get (seqNumber));
+			NS_LOG_DEBUG ("erase seq=" << seqNumber);
+			NS_LOG_DEBUG ("retryPacketSize=" << m_retryPackets.size ());
+			NS_LOG_DEBUG ("# of packets in the buffered queue: " << GetNBufferedPackets (recipient, tid) 
+										<< " # of packets in the retry queue: " << GetNRetryNeededPackets(recipient, tid)); 
+			newSeq = m_txMiddle->GetNextSeqNumberByTidAndAddress (tid, recipient);
+			NS_LOG_DEBUG ("nextSeq=" << newSeq);
 		}
 		if (!SwitchToBlockAckIfNeeded (recipient, tid, newSeq))
 		{
@@ -907,13 +913,14 @@ BlockAckManager::CleanupBuffers (void)
   NS_LOG_FUNCTION (this);
   for (AgreementsI j = m_agreements.begin (); j != m_agreements.end (); j++)
     {
-      if (j->second.second.empty ())
+      PacketQueue &queue = j->second.second;
+      if (queue.packets.empty ())
         {
           continue;
         }
       Time now = Simulator::Now ();
-      PacketQueueI end = j->second.second.begin ();
-      for (PacketQueueI i = j->second.second.begin (); i != j->second.second.end (); i++)
+      PacketQueueI end = queue.packets.begin ();
+      for (PacketQueueI i = queue.packets.begin (); i != queue.packets.end (); i++)
         {
           NS_LOG_DEBUG ("timestamp: " << (i->timestamp).GetSeconds () << ", maxDelay: " << 
 				  m_maxDelay.GetSeconds () << ", now: " << now.GetSeconds ());
@@ -945,7 +952,10 @@ BlockAckManager::CleanupBuffers (void)
                 }
             }
         }
-      j->second.second.erase (j->second.second.begin (), end);
+      while (queue.packets.begin () != end)
+        {
+          Erase (queue, queue.packets.begin ());
+        }
 			NS_LOG_DEBUG("set startingsequence: " << end->hdr.GetSequenceNumber ());
       j->second.first.SetStartingSequence (end->hdr.GetSequenceNumber ());
     }
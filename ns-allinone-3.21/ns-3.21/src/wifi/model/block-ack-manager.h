@@ -30,6 +30,7 @@
 #include "originator-block-ack-agreement.h"
 #include "ctrl-headers.h"
 #include "qos-utils.h"
+#include "block-ack-scoreboard.h"
 
 namespace ns3 {
 
@@ -319,10 +320,6 @@ private:
   void InactivityTimeout (Mac48Address, uint8_t);
 
   struct Item;
-  /**
-   * typedef for a list of Item struct.
-   */
-  typedef std::list<Item> PacketQueue;
   /**
    * typedef for an iterator for PacketQueue.
    */
@@ -331,6 +328,24 @@ private:
    * typedef for a const iterator for PacketQueue.
    */
   typedef std::list<Item>::const_iterator PacketQueueCI;
+  /**
+   * The packets of an agreement, in the order they were sent, and
+   * indexed by sequence number. There is at most one packet per
+   * sequence number.
+   */
+  struct PacketQueue
+  {
+    std::list<Item> packets; //!< the packets
+    BlockAckScoreboard<PacketQueueI> index; //!< the packets, by sequence number
+  };
+  /**
+   * Remove a packet of an agreement.
+   *
+   * \param queue the packets of the agreement
+   * \param it the packet
+   * \return the packet after it
+   */
+  PacketQueueI Erase (PacketQueue &queue, PacketQueueI it);
 
   /**
    * typedef for a map between MAC address and block ACK agreement.
@@ -0,0 +1,191 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef BLOCK_ACK_SCOREBOARD_H
+#define BLOCK_ACK_SCOREBOARD_H
+
+#include <stdint.h>
+#include <string.h>
+#include <vector>
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief one slot per sequence number of a block ack agreement
+ *
+ * The 4096 sequence numbers are a ring of slots, each holding a value
+ * (the MPDU of that sequence number, typically an iterator on it), and
+ * a bitmap of the slots in use. A sequence number is found, set or
+ * cleared in constant time; the window of a compressed block ack and
+ * the next sequence number in use are read 64 slots at a time.
+ *
+ * The slots are only allocated when the first one is set.
+ */
+template <typename T>
+class BlockAckScoreboard
+{
+public:
+  BlockAckScoreboard ();
+
+  /**
+   * \param seq the sequence number
+   * \return true if the slot of the sequence number is in use
+   */
+  bool IsSet (uint16_t seq) const;
+  /**
+   * \param seq the sequence number, its slot must be in use
+   * \return the value of the slot
+   */
+  T Get (uint16_t seq) const;
+  /**
+   * \param seq the sequence number
+   * \param value the value of its slot
+   */
+  void Set (uint16_t seq, T value);
+  /**
+   * \param seq the sequence number, its slot is no longer in use
+   */
+  void Clear (uint16_t seq);
+  /**
+   * \return the number of slots in use
+   */
+  uint32_t GetCount (void) const;
+  /**
+   * \param startingSeq the first sequence number of the window
+   * \return the slots in use from startingSeq on, bit i for startingSeq + i
+   *         as in a compressed block ack bitmap
+   */
+  uint64_t GetBitmap (uint16_t startingSeq) const;
+  /**
+   * \param from the first sequence number to look at
+   * \param count the number of sequence numbers to look at
+   * \return the first sequence number in use among count from <i>from</i>
+   *         (modulo 4096), 4096 if none
+   */
+  uint16_t FindNext (uint16_t from, uint16_t count) const;
+
+private:
+  std::vector<T> m_slots; //!< the values, by sequence number
+  uint64_t m_used[64]; //!< the slots in use, bit (seq % 64) of word (seq / 64)
+  uint32_t m_count; //!< the number of slots in use
+};
+
+template <typename T>
+BlockAckScoreboard<T>::BlockAckScoreboard ()
+  : m_count (0)
+{
+  memset (m_used, 0, sizeof (m_used));
+}
+
+template <typename T>
+bool
+BlockAckScoreboard<T>::IsSet (uint16_t seq) const
+{
+  NS_ASSERT (seq < 4096);
+  return (m_used[seq >> 6] >> (seq & 63)) & 1;
+}
+
+template <typename T>
+T
+BlockAckScoreboard<T>::Get (uint16_t seq) const
+{
+  NS_ASSERT (IsSet (seq));
+  return m_slots[seq];
+}
+
+template <typename T>
+void
+BlockAckScoreboard<T>::Set (uint16_t seq, T value)
+{
+  if (m_slots.empty ())
+    {
+      m_slots.resize (4096);
+    }
+  if (!IsSet (seq))
+    {
+      m_used[seq >> 6] |= uint64_t (1) << (seq & 63);
+      m_count++;
+    }
+  m_slots[seq] = value;
+}
+
+template <typename T>
+void
+BlockAckScoreboard<T>::Clear (uint16_t seq)
+{
+  if (IsSet (seq))
+    {
+      m_used[seq >> 6] &= ~(uint64_t (1) << (seq & 63));
+      m_count--;
+    }
+}
+
+template <typename T>
+uint32_t
+BlockAckScoreboard<T>::GetCount (void) const
+{
+  return m_count;
+}
+
+template <typename T>
+uint64_t
+BlockAckScoreboard<T>::GetBitmap (uint16_t startingSeq) const
+{
+  NS_ASSERT (startingSeq < 4096);
+  uint16_t word = startingSeq >> 6;
+  uint16_t shift = startingSeq & 63;
+  uint64_t bitmap = m_used[word] >> shift;
+  if (shift != 0)
+    {
+      bitmap |= m_used[(word + 1) & 63] << (64 - shift);
+    }
+  return bitmap;
+}
+
+template <typename T>
+uint16_t
+BlockAckScoreboard<T>::FindNext (uint16_t from, uint16_t count) const
+{
+  NS_ASSERT (from < 4096);
+  uint16_t seq = from;
+  uint32_t remaining = count;
+  while (remaining > 0)
+    {
+      uint16_t shift = seq & 63;
+      uint32_t span = 64 - shift;
+      if (span > remaining)
+        {
+          span = remaining;
+        }
+      uint64_t bits = m_used[seq >> 6] >> shift;
+      if (span < 64)
+        {
+          bits &= (uint64_t (1) << span) - 1;
+        }
+      if (bits != 0)
+        {
+          return (seq + __builtin_ctzll (bits)) & 4095;
+        }
+      seq = (seq + span) & 4095;
+      remaining -= span;
+    }
+  return 4096;
+}
+
+} // namespace ns3
+
+#endif /* BLOCK_ACK_SCOREBOARD_H */
@@ -0,0 +1,79 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <new>
+#include "channel-matrix.h"
+#include "ns3/assert.h"
+
+namespace ns3 {
+
+static const uintptr_t CHANNEL_MATRIX_ALIGNMENT = 64;
+
+ChannelMatrix::ChannelMatrix (uint8_t nss, uint16_t nMpdus)
+  : m_nss (nss),
+    m_nMpdus (nMpdus)
+{
+  NS_ASSERT (nss > 0 && nMpdus > 0);
+  uint32_t n = nss * nss * nMpdus + 1;
+  m_raw = new char[n * sizeof (std::complex<double>) + CHANNEL_MATRIX_ALIGNMENT];
+  // align the first matrix, the power slot sits just before it
+  uintptr_t first = reinterpret_cast<uintptr_t> (m_raw) + sizeof (std::complex<double>);
+  first = (first + CHANNEL_MATRIX_ALIGNMENT - 1) & ~(CHANNEL_MATRIX_ALIGNMENT - 1);
+  m_data = reinterpret_cast<std::complex<double> *> (first) - 1;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      new (&m_data[i]) std::complex<double> (0, 0);
+    }
+}
+
+ChannelMatrix::~ChannelMatrix ()
+{
+  delete [] m_raw;
+  m_raw = 0;
+  m_data = 0;
+}
+
+uint8_t
+ChannelMatrix::GetNss (void) const
+{
+  return m_nss;
+}
+
+uint16_t
+ChannelMatrix::GetNMpdus (void) const
+{
+  return m_nMpdus;
+}
+
+const std::complex<double> *
+ChannelMatrix::GetMatrix (uint16_t mpdu) const
+{
+  NS_ASSERT (mpdu < m_nMpdus);
+  return m_data + 1 + mpdu * m_nss * m_nss;
+}
+
+double
+ChannelMatrix::GetRxPowerDbm (void) const
+{
+  return m_data[0].real ();
+}
+
+std::complex<double> *
+ChannelMatrix::GetBuffer (void)
+{
+  return m_data;
+}
+
+} // namespace ns3
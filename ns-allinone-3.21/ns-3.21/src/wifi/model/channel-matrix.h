@@ -0,0 +1,88 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef CHANNEL_MATRIX_H
+#define CHANNEL_MATRIX_H
+
+#include <stdint.h>
+#include <complex>
+#include "ns3/simple-ref-count.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief Channel state of one transmission as seen by one receiver.
+ *
+ * 11ac: mutiple_stream_tx_channel + caudal loss. Holds the nss x nss
+ * channel matrix H of every MPDU of the PPDU (a single one for non
+ * A-MPDU frames) in one contiguous, 64-byte aligned block. The block is
+ * filled once by YansWifiChannel through GetBuffer (), in the layout
+ * expected by PropagationLossModel::CalcRxPower, and is then shared
+ * read-only by every copy of the WifiTxVector that points to it.
+ */
+class ChannelMatrix : public SimpleRefCount<ChannelMatrix>
+{
+public:
+  /**
+   * \param nss the number of spatial streams
+   * \param nMpdus the number of MPDUs in the PPDU
+   *
+   * All entries are initialized to zero.
+   */
+  ChannelMatrix (uint8_t nss, uint16_t nMpdus);
+  ~ChannelMatrix ();
+
+  /**
+   * \return the number of spatial streams
+   */
+  uint8_t GetNss (void) const;
+  /**
+   * \return the number of MPDUs (number of channel matrices)
+   */
+  uint16_t GetNMpdus (void) const;
+  /**
+   * \param mpdu the index of the MPDU
+   * \return the row-major nss x nss channel matrix of the given MPDU
+   */
+  const std::complex<double> * GetMatrix (uint16_t mpdu) const;
+  /**
+   * \return the power slot of the buffer, i.e. the rx power (dBm)
+   *         once the propagation loss models have run.
+   */
+  double GetRxPowerDbm (void) const;
+  /**
+   * Writable view used to fill the block. Entry 0 holds the tx power
+   * (dBm) on input and the rx power on output of
+   * PropagationLossModel::CalcRxPower; the nss * nss * nMpdus entries
+   * which follow are the channel matrices.
+   *
+   * \return the buffer
+   */
+  std::complex<double> * GetBuffer (void);
+
+private:
+  ChannelMatrix (const ChannelMatrix &o);
+  ChannelMatrix &operator = (const ChannelMatrix &o);
+
+  uint8_t m_nss;
+  uint16_t m_nMpdus;
+  char *m_raw;                   //!< unaligned allocation
+  std::complex<double> *m_data;  //!< power slot followed by the aligned matrices
+};
+
+} // namespace ns3
+
+#endif /* CHANNEL_MATRIX_H */
@@ -183,6 +183,7 @@ EdcaTxopN::GetTypeId (void)
 EdcaTxopN::EdcaTxopN ()
   : m_manager (0),
     m_currentPacket (0),
+    m_accessHeld (0),
     m_aggregator (0),
     m_blockAckType (COMPRESSED_BLOCK_ACK)
 {
@@ -406,23 +407,16 @@ EdcaTxopN::GetNextPacketForAmpdu (WifiMacHeader& hdr, uint32_t maxAvailableLengt
   if (nextPacket == 0)
   {
     nextPacket = m_queue->PeekByTidAndAddress (&nextHdr, m_currentHdr.GetQosTid(), WifiMacHeader::ADDR1, m_currentHdr.GetAddr1 ());
-    WifiTxVector txvector = m_low->GetDataTxVector (nextPacket, &nextHdr);
-    Time blockAckReqDuration = m_low->CalculateTxDuration (20, txvector, WIFI_PREAMBLE_LONG);
-		if(GetImplicitBlockAckRequest())
-			blockAckReqDuration = Seconds (0.0);
-    Time blockAckDuration = m_low->CalculateTxDuration (20, txvector, WIFI_PREAMBLE_LONG) + m_low->GetSifs ();
-    Time dataDuration = m_low->CalculateTxDuration (m_low->GetSize (nextPacket, &nextHdr), txvector, WIFI_PREAMBLE_LONG);
-
-    NS_LOG_DEBUG ("dataDuration=" << dataDuration.GetMicroSeconds () 
-        << " us, blockAckReqDuration=" << blockAckReqDuration.GetMicroSeconds ()
-        << " us, blockAckDuration=" << blockAckDuration.GetMicroSeconds () << " us");
-
     if (nextPacket == 0) 
     {
       NS_LOG_DEBUG ("no available packets in the queue");
       return 0;
     }
 
+    WifiTxVector txvector = m_low->GetDataTxVector (nextPacket, &nextHdr);
+    Time dataDuration = m_low->CalculateTxDuration (m_low->GetSize (nextPacket, &nextHdr), txvector, WIFI_PREAMBLE_LONG);
+    NS_LOG_DEBUG ("dataDuration=" << dataDuration.GetMicroSeconds () << " us");
+
     WifiMacTrailer fcs;
     if (nextPacket->GetSize () + fcs.GetSerializedSize () + nextHdr.GetSerializedSize ()  > maxAvailableLength)
     {
@@ -509,10 +503,6 @@ EdcaTxopN::GetNextPacketForAmpdu (WifiMacHeader& hdr, uint32_t maxAvailableLengt
   else {
     NS_LOG_DEBUG ("Peek ba buffered packet");
     WifiTxVector txvector = m_low->GetDataTxVector (nextPacket, &nextHdr);
-    Time blockAckReqDuration = m_low->CalculateTxDuration (20, txvector, WIFI_PREAMBLE_LONG);
-		if(GetImplicitBlockAckRequest())
-			blockAckReqDuration = Seconds (0.0);
-    Time blockAckDuration = m_low->CalculateTxDuration (20, txvector, WIFI_PREAMBLE_LONG)+m_low->GetSifs () ;
     Time dataDuration = m_low->CalculateTxDuration (m_low->GetSize (nextPacket, &nextHdr), txvector, WIFI_PREAMBLE_LONG);
     //caudal loss
     //if (dataDuration + blockAckReqDuration + blockAckDuration > maxAvailableDuration)
@@ -909,6 +899,22 @@ EdcaTxopN::Queue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
   StartAccessIfNeeded ();
 }
 
+void
+EdcaTxopN::HoldAccess (void)
+{
+  NS_LOG_FUNCTION (this);
+  m_accessHeld++;
+}
+
+void
+EdcaTxopN::ReleaseAccess (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_accessHeld > 0);
+  m_accessHeld--;
+  StartAccessIfNeeded ();
+}
+
 void
 EdcaTxopN::GotAck (double snr, WifiMode txMode)
 {
@@ -1126,6 +1132,7 @@ EdcaTxopN::StartAccessIfNeeded (void)
 {
   NS_LOG_FUNCTION (this);
   if (m_currentPacket == 0
+      && m_accessHeld == 0
       && (!m_queue->IsEmpty () || m_baManager->HasPackets ())
       && !m_dcf->IsAccessRequested ())
     {
@@ -345,6 +345,17 @@ public:
    * can be sent safely.
    */
   void Queue (Ptr<const Packet> packet, const WifiMacHeader &hdr);
+  /**
+   * Do not request the channel for the packets queued until the
+   * matching ReleaseAccess, so that a burst of packets queued at once
+   * can be aggregated in a single transmission. Calls may be nested.
+   */
+  void HoldAccess (void);
+  /**
+   * Request the channel for the packets queued since HoldAccess, if no
+   * other HoldAccess is pending.
+   */
+  void ReleaseAccess (void);
   void SetMsduAggregator (Ptr<MsduAggregator> aggr);
   /**
    * \param packet packet to send
@@ -478,6 +489,7 @@ private:
      present, could be an A-MSDU.
    */
   Ptr<const Packet> m_currentPacket;
+  uint32_t m_accessHeld; //!< the number of pending HoldAccess
 
   WifiMacHeader m_currentHdr;
   Ptr<MsduAggregator> m_aggregator;
@@ -0,0 +1,543 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <cmath>
+#include "effective-snr-mapping.h"
+#include "ns3/boolean.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("EffectiveSnrMapping");
+
+namespace ns3 {
+
+/**
+ * RBIR curves, BPSK, QPSK, 16-QAM, 64-QAM and 256-QAM, -20 dB to 37 dB
+ * by 0.5 dB. The first 95 samples of the first 4 rows are the original
+ * table (up to 27 dB), the rest is the numerical symbol mutual information.
+ */
+static const double g_rbir[5][TabulatedEffectiveSnrMapping::N_SAMPLES] = {
+  {
+    0.014400, 0.016000, 0.017700, 0.019700, 0.022200, 0.024900, 0.028300, 0.031200,
+    0.035700, 0.039500, 0.043600, 0.049000, 0.055900, 0.060200, 0.067800, 0.077700,
+    0.085900, 0.095900, 0.104700, 0.118200, 0.134500, 0.147000, 0.162100, 0.180300,
+    0.201700, 0.221500, 0.249000, 0.270300, 0.292100, 0.316900, 0.350800, 0.377900,
+    0.414100, 0.446400, 0.493400, 0.524900, 0.566500, 0.602200, 0.646000, 0.681200,
+    0.722800, 0.752600, 0.804200, 0.831200, 0.855500, 0.885300, 0.909500, 0.933400,
+    0.953500, 0.964700, 0.977900, 0.987200, 0.988700, 0.994000, 0.997100, 0.998400,
+    0.999200, 0.999800, 0.999900, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000
+  },
+  {
+    0.007200, 0.008000, 0.009000, 0.010100, 0.011400, 0.012700, 0.014300, 0.015900,
+    0.017900, 0.020000, 0.022500, 0.025100, 0.028200, 0.031500, 0.035200, 0.039400,
+    0.044200, 0.049300, 0.055100, 0.061600, 0.068800, 0.076700, 0.085500, 0.095300,
+    0.106100, 0.118000, 0.131100, 0.145600, 0.161500, 0.178800, 0.197800, 0.218400,
+    0.240700, 0.265000, 0.291000, 0.319000, 0.348900, 0.380600, 0.414100, 0.449300,
+    0.485900, 0.523900, 0.562800, 0.602400, 0.642200, 0.681700, 0.720700, 0.758400,
+    0.794400, 0.828100, 0.859200, 0.887200, 0.911900, 0.933100, 0.950700, 0.964900,
+    0.976000, 0.984200, 0.990100, 0.994200, 0.996800, 0.998300, 0.999200, 0.999700,
+    0.999900, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000
+  },
+  {
+    0.003600, 0.004000, 0.004500, 0.005000, 0.005700, 0.006300, 0.007100, 0.008000,
+    0.008900, 0.010000, 0.011200, 0.012600, 0.014100, 0.015800, 0.017600, 0.019700,
+    0.022100, 0.024700, 0.027600, 0.030800, 0.034400, 0.038400, 0.042800, 0.047600,
+    0.053100, 0.059000, 0.065600, 0.072800, 0.080800, 0.089500, 0.099000, 0.109400,
+    0.120600, 0.132900, 0.146100, 0.160300, 0.175600, 0.192000, 0.209400, 0.227900,
+    0.247400, 0.268000, 0.289600, 0.312200, 0.335700, 0.360000, 0.385200, 0.411200,
+    0.437900, 0.465300, 0.493300, 0.521900, 0.550900, 0.580400, 0.610300, 0.640300,
+    0.670900, 0.701400, 0.731700, 0.761700, 0.791000, 0.819300, 0.846300, 0.871600,
+    0.894900, 0.915800, 0.934300, 0.950100, 0.963300, 0.973900, 0.982100, 0.988300,
+    0.992700, 0.995700, 0.997600, 0.998800, 0.999400, 0.999700, 0.999900, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000
+  },
+  {
+    0.002400, 0.002700, 0.003000, 0.003400, 0.003800, 0.004300, 0.004700, 0.005400,
+    0.006000, 0.006700, 0.007500, 0.008400, 0.009400, 0.010600, 0.011700, 0.013200,
+    0.014700, 0.016500, 0.018400, 0.020700, 0.022900, 0.025700, 0.028500, 0.031900,
+    0.035400, 0.039600, 0.043700, 0.048800, 0.053900, 0.059900, 0.066000, 0.073200,
+    0.080500, 0.089000, 0.097400, 0.107300, 0.117200, 0.128500, 0.139800, 0.152500,
+    0.165300, 0.179500, 0.193700, 0.209200, 0.224700, 0.241500, 0.258300, 0.276300,
+    0.294200, 0.313200, 0.332100, 0.351900, 0.371800, 0.392400, 0.413100, 0.434500,
+    0.455800, 0.477800, 0.499700, 0.522300, 0.544800, 0.567700, 0.590700, 0.614100,
+    0.637400, 0.661100, 0.684800, 0.708700, 0.732500, 0.756400, 0.780200, 0.803600,
+    0.826900, 0.848900, 0.870800, 0.890400, 0.910000, 0.926200, 0.942500, 0.954700,
+    0.966800, 0.973200, 0.979600, 0.984000, 0.988300, 0.991000, 0.993700, 0.995400,
+    0.997100, 0.998300, 0.999500, 0.999800, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000
+  },
+  {
+    0.001794, 0.002012, 0.002256, 0.002530, 0.002836, 0.003179, 0.003563, 0.003993,
+    0.004474, 0.005012, 0.005614, 0.006288, 0.007040, 0.007881, 0.008819, 0.009866,
+    0.011034, 0.012335, 0.013784, 0.015396, 0.017187, 0.019176, 0.021382, 0.023825,
+    0.026527, 0.029510, 0.032799, 0.036419, 0.040393, 0.044749, 0.049511, 0.054704,
+    0.060352, 0.066478, 0.073101, 0.080239, 0.087907, 0.096115, 0.104870, 0.114175,
+    0.124026, 0.134417, 0.145338, 0.156774, 0.168707, 0.181118, 0.193985, 0.207287,
+    0.221000, 0.235102, 0.249573, 0.264391, 0.279538, 0.294993, 0.310740, 0.326762,
+    0.343044, 0.359570, 0.376326, 0.393300, 0.410478, 0.427848, 0.445400, 0.463123,
+    0.481005, 0.499039, 0.517214, 0.535522, 0.553955, 0.572504, 0.591162, 0.609922,
+    0.628777, 0.647720, 0.666744, 0.685842, 0.705008, 0.724234, 0.743510, 0.762820,
+    0.782140, 0.801425, 0.820608, 0.839589, 0.858228, 0.876355, 0.893767, 0.910249,
+    0.925586, 0.939585, 0.952085, 0.962979, 0.972216, 0.979815, 0.985858, 0.990485,
+    0.993881, 0.996259, 0.997838, 0.998828, 0.999407, 0.999723, 0.999882, 0.999954,
+    0.999984, 0.999995, 0.999999, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000
+  }
+};
+
+/**
+ * BICM capacity per bit of the Gray mapped constellations, same grid.
+ */
+static const double g_bicm[5][TabulatedEffectiveSnrMapping::N_SAMPLES] = {
+  {
+    0.014285, 0.016008, 0.017938, 0.020096, 0.022510, 0.025209, 0.028226, 0.031595,
+    0.035357, 0.039555, 0.044236, 0.049452, 0.055259, 0.061719, 0.068899, 0.076869,
+    0.085706, 0.095492, 0.106312, 0.118255, 0.131416, 0.145889, 0.161771, 0.179157,
+    0.198139, 0.218804, 0.241227, 0.265475, 0.291594, 0.319607, 0.349514, 0.381276,
+    0.414820, 0.450022, 0.486714, 0.524667, 0.563598, 0.603164, 0.642968, 0.682560,
+    0.721452, 0.759129, 0.795073, 0.828783, 0.859803, 0.887753, 0.912352, 0.933443,
+    0.951008, 0.965168, 0.976177, 0.984397, 0.990264, 0.994244, 0.996797, 0.998335,
+    0.999197, 0.999644, 0.999857, 0.999948, 0.999983, 0.999995, 0.999999, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000
+  },
+  {
+    0.007178, 0.008049, 0.009025, 0.010118, 0.011343, 0.012715, 0.014251, 0.015971,
+    0.017896, 0.020049, 0.022458, 0.025151, 0.028160, 0.031522, 0.035276, 0.039464,
+    0.044134, 0.049339, 0.055133, 0.061579, 0.068743, 0.076696, 0.085515, 0.095280,
+    0.106078, 0.117997, 0.131132, 0.145577, 0.161429, 0.178783, 0.197732, 0.218360,
+    0.240747, 0.264957, 0.291036, 0.319011, 0.348879, 0.380604, 0.414111, 0.449282,
+    0.485944, 0.523874, 0.562788, 0.602346, 0.642149, 0.681750, 0.720661, 0.758369,
+    0.794353, 0.828114, 0.859194, 0.887210, 0.911880, 0.933045, 0.950681, 0.964909,
+    0.975980, 0.984253, 0.990164, 0.994178, 0.996756, 0.998311, 0.999184, 0.999638,
+    0.999854, 0.999947, 0.999983, 0.999995, 0.999999, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000
+  },
+  {
+    0.002880, 0.003230, 0.003623, 0.004064, 0.004558, 0.005112, 0.005733, 0.006430,
+    0.007210, 0.008084, 0.009064, 0.010161, 0.011390, 0.012765, 0.014305, 0.016028,
+    0.017955, 0.020109, 0.022516, 0.025204, 0.028204, 0.031549, 0.035277, 0.039428,
+    0.044043, 0.049171, 0.054859, 0.061160, 0.068129, 0.075824, 0.084303, 0.093627,
+    0.103857, 0.115051, 0.127270, 0.140568, 0.154998, 0.170604, 0.187427, 0.205497,
+    0.224835, 0.245451, 0.267342, 0.290493, 0.314870, 0.340426, 0.367094, 0.394788,
+    0.423403, 0.452817, 0.482893, 0.513488, 0.544457, 0.575665, 0.606989, 0.638322,
+    0.669562, 0.700600, 0.731298, 0.761474, 0.790895, 0.819271, 0.846279, 0.871579,
+    0.894850, 0.915814, 0.934264, 0.950083, 0.963256, 0.973876, 0.982133, 0.988298,
+    0.992698, 0.995683, 0.997598, 0.998751, 0.999398, 0.999733, 0.999893, 0.999961,
+    0.999987, 0.999996, 0.999999, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000
+  },
+  {
+    0.001828, 0.002050, 0.002300, 0.002580, 0.002893, 0.003245, 0.003639, 0.004081,
+    0.004576, 0.005131, 0.005752, 0.006448, 0.007227, 0.008100, 0.009076, 0.010168,
+    0.011390, 0.012755, 0.014279, 0.015982, 0.017881, 0.019999, 0.022357, 0.024982,
+    0.027899, 0.031138, 0.034728, 0.038702, 0.043094, 0.047937, 0.053268, 0.059121,
+    0.065534, 0.072539, 0.080171, 0.088460, 0.097432, 0.107113, 0.117521, 0.128670,
+    0.140569, 0.153223, 0.166632, 0.180792, 0.195695, 0.211335, 0.227704, 0.244795,
+    0.262605, 0.281130, 0.300368, 0.320316, 0.340969, 0.362313, 0.384328, 0.406985,
+    0.430242, 0.454046, 0.478337, 0.503042, 0.528087, 0.553388, 0.578861, 0.604420,
+    0.629979, 0.655461, 0.680797, 0.705930, 0.730817, 0.755414, 0.779666, 0.803487,
+    0.826745, 0.849261, 0.870811, 0.891146, 0.910011, 0.927175, 0.942450, 0.955712,
+    0.966910, 0.976080, 0.983334, 0.988856, 0.992883, 0.995682, 0.997527, 0.998671,
+    0.999336, 0.999694, 0.999871, 0.999951, 0.999983, 0.999995, 0.999999, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000
+  },
+  {
+    0.001355, 0.001520, 0.001705, 0.001912, 0.002144, 0.002405, 0.002697, 0.003024,
+    0.003391, 0.003802, 0.004262, 0.004778, 0.005355, 0.006001, 0.006725, 0.007533,
+    0.008438, 0.009449, 0.010578, 0.011838, 0.013244, 0.014811, 0.016556, 0.018498,
+    0.020656, 0.023051, 0.025705, 0.028642, 0.031887, 0.035464, 0.039400, 0.043721,
+    0.048451, 0.053617, 0.059240, 0.065344, 0.071948, 0.079066, 0.086713, 0.094896,
+    0.103622, 0.112889, 0.122695, 0.133035, 0.143899, 0.155277, 0.167157, 0.179529,
+    0.192382, 0.205706, 0.219490, 0.233723, 0.248392, 0.263479, 0.278965, 0.294825,
+    0.311033, 0.327563, 0.344396, 0.361517, 0.378924, 0.396625, 0.414638, 0.432985,
+    0.451689, 0.470768, 0.490226, 0.510056, 0.530235, 0.550726, 0.571481, 0.592444,
+    0.613552, 0.634744, 0.655957, 0.677129, 0.698200, 0.719115, 0.739829, 0.760305,
+    0.780518, 0.800446, 0.820060, 0.839306, 0.858096, 0.876299, 0.893746, 0.910242,
+    0.925584, 0.939585, 0.952085, 0.962979, 0.972216, 0.979815, 0.985858, 0.990485,
+    0.993881, 0.996259, 0.997838, 0.998828, 0.999407, 0.999723, 0.999882, 0.999954,
+    0.999984, 0.999995, 0.999999, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000,
+    1.000000, 1.000000, 1.000000
+  }
+};
+
+static const TabulatedEffectiveSnrMapping::Table g_rbirTable (g_rbir);
+static const TabulatedEffectiveSnrMapping::Table g_bicmTable (g_bicm);
+
+/// the samples of the original RBIR table, up to 27 dB
+static const uint32_t RBIR_LEGACY_SAMPLES = 95;
+
+NS_OBJECT_ENSURE_REGISTERED (EffectiveSnrMapping);
+
+TypeId
+EffectiveSnrMapping::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::EffectiveSnrMapping")
+    .SetParent<Object> ()
+  ;
+  return tid;
+}
+
+uint8_t
+EffectiveSnrMapping::GetConstellationIndex (WifiMode mode)
+{
+  switch (mode.GetConstellationSize ())
+    {
+    case 2:
+      return 0;
+    case 4:
+      return 1;
+    case 16:
+      return 2;
+    case 64:
+      return 3;
+    case 256:
+      return 4;
+    default:
+      return 0;
+    }
+}
+
+uint8_t
+EffectiveSnrMapping::GetMcsIndex (WifiMode mode)
+{
+  enum WifiCodeRate rate = mode.GetCodeRate ();
+  switch (mode.GetConstellationSize ())
+    {
+    case 4:
+      return rate == WIFI_CODE_RATE_3_4 ? 2 : 1;
+    case 16:
+      return rate == WIFI_CODE_RATE_3_4 ? 4 : 3;
+    case 64:
+      if (rate == WIFI_CODE_RATE_5_6)
+        {
+          return 7;
+        }
+      return rate == WIFI_CODE_RATE_3_4 ? 6 : 5;
+    case 256:
+      return rate == WIFI_CODE_RATE_5_6 ? 9 : 8;
+    default:
+      return 0;
+    }
+}
+
+TabulatedEffectiveSnrMapping::Table::Table (const double (*values)[N_SAMPLES])
+  : m_values (values)
+{
+  for (uint8_t cons = 0; cons < 5; cons++)
+    {
+      uint32_t i = 0;
+      for (uint32_t step = 0; step <= N_STEPS; step++)
+        {
+          double info = static_cast<double> (step) / N_STEPS;
+          while (i < N_SAMPLES && m_values[cons][i] < info)
+            {
+              i++;
+            }
+          m_first[cons][step] = i;
+        }
+    }
+}
+
+uint32_t
+TabulatedEffectiveSnrMapping::Table::FindFirstAbove (uint8_t cons, double info) const
+{
+  const double *values = m_values[cons];
+  uint32_t step = info < 1.0 ? static_cast<uint32_t> (info * N_STEPS) : N_STEPS;
+  uint32_t i = m_first[cons][step];
+  // info * N_STEPS may round up to the next step
+  while (i > 0 && values[i - 1] >= info)
+    {
+      i--;
+    }
+  while (i < N_SAMPLES && values[i] < info)
+    {
+      i++;
+    }
+  return i;
+}
+
+double
+TabulatedEffectiveSnrMapping::Table::GetInformation (uint8_t cons, double snrDb) const
+{
+  const double *values = m_values[cons];
+  double x = (snrDb + 20) * 2;
+  if (!(x > 0))
+    {
+      return values[0];
+    }
+  if (x >= N_SAMPLES - 1)
+    {
+      return values[N_SAMPLES - 1];
+    }
+  uint32_t i = static_cast<uint32_t> (x);
+  return values[i] + (x - i) * (values[i + 1] - values[i]);
+}
+
+double
+TabulatedEffectiveSnrMapping::Table::GetSnrDb (uint8_t cons, double info) const
+{
+  const double *values = m_values[cons];
+  uint32_t i = FindFirstAbove (cons, info);
+  double x;
+  if (i == 0)
+    {
+      x = 0;
+    }
+  else if (i == N_SAMPLES)
+    {
+      x = N_SAMPLES - 1;
+    }
+  else
+    {
+      x = (i - 1) + (info - values[i - 1]) / (values[i] - values[i - 1]);
+    }
+  return x / 2 - 20;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (TabulatedEffectiveSnrMapping);
+
+TypeId
+TabulatedEffectiveSnrMapping::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TabulatedEffectiveSnrMapping")
+    .SetParent<EffectiveSnrMapping> ()
+  ;
+  return tid;
+}
+
+TabulatedEffectiveSnrMapping::TabulatedEffectiveSnrMapping (const Table *table)
+  : m_table (table)
+{
+}
+
+double
+TabulatedEffectiveSnrMapping::GetEffectiveSnr (WifiMode mode, const double *sinr, uint8_t nss) const
+{
+  NS_ASSERT (nss > 0);
+  uint8_t cons = GetConstellationIndex (mode);
+  double info = 0;
+  double minSinrDb = 10.0 * std::log10 (sinr[0]);
+  for (uint8_t i = 0; i < nss; i++)
+    {
+      double sinrDb = 10.0 * std::log10 (sinr[i]);
+      if (sinrDb < minSinrDb)
+        {
+          minSinrDb = sinrDb;
+        }
+      info += m_table->GetInformation (cons, sinrDb);
+    }
+  info /= nss;
+  double esnr = m_table->GetSnrDb (cons, info);
+  if (esnr < minSinrDb)
+    {
+      esnr = minSinrDb;
+    }
+  return std::pow (10.0, esnr / 10.0);
+}
+
+NS_OBJECT_ENSURE_REGISTERED (RbirEffectiveSnrMapping);
+
+TypeId
+RbirEffectiveSnrMapping::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::RbirEffectiveSnrMapping")
+    .SetParent<TabulatedEffectiveSnrMapping> ()
+    .AddConstructor<RbirEffectiveSnrMapping> ()
+    .AddAttribute ("Interpolation",
+                   "Whether the curves are interpolated linearly between the samples, "
+                   "or the SINRs are quantized as in the original implementation.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&RbirEffectiveSnrMapping::m_interpolation),
+                   MakeBooleanChecker ())
+  ;
+  return tid;
+}
+
+RbirEffectiveSnrMapping::RbirEffectiveSnrMapping ()
+  : TabulatedEffectiveSnrMapping (&g_rbirTable),
+    m_interpolation (false)
+{
+}
+
+double
+RbirEffectiveSnrMapping::GetEffectiveSnr (WifiMode mode, const double *sinr, uint8_t nss) const
+{
+  if (m_interpolation)
+    {
+      return TabulatedEffectiveSnrMapping::GetEffectiveSnr (mode, sinr, nss);
+    }
+  NS_ASSERT (nss > 0);
+  uint8_t cons = GetConstellationIndex (mode);
+  const double *rbir = m_table->m_values[cons];
+  double info = 0;
+  double minSinrDb = 100;
+  for (uint8_t i = 0; i < nss; i++)
+    {
+      double sinrDb = 10.0 * std::log10 (sinr[i]);
+      if (sinrDb < minSinrDb)
+        {
+          minSinrDb = sinrDb;
+        }
+      if (sinrDb < -20.0)
+        {
+          sinrDb = -20.0;
+        }
+      if (sinrDb > 27.0)
+        {
+          sinrDb = 27.0;
+        }
+      info += rbir[(uint8_t)((sinrDb + 20) * 2)];
+    }
+  info /= nss;
+
+  // the nearest of the first sample which is at least info and the one before
+  uint32_t current = m_table->FindFirstAbove (cons, info);
+  uint32_t prev;
+  if (current >= RBIR_LEGACY_SAMPLES)
+    {
+      current = RBIR_LEGACY_SAMPLES - 1;
+      prev = current;
+    }
+  else
+    {
+      prev = current > 0 ? current - 1 : 0;
+    }
+  double esnr;
+  if ((rbir[current] - info) > (info - rbir[prev]))
+    {
+      esnr = prev;
+    }
+  else
+    {
+      esnr = current;
+    }
+  esnr = esnr / 2 - 20;
+  if (esnr < minSinrDb)
+    {
+      esnr = minSinrDb;
+    }
+  return std::pow (10.0, esnr / 10.0);
+}
+
+NS_OBJECT_ENSURE_REGISTERED (MiesmEffectiveSnrMapping);
+
+TypeId
+MiesmEffectiveSnrMapping::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MiesmEffectiveSnrMapping")
+    .SetParent<TabulatedEffectiveSnrMapping> ()
+    .AddConstructor<MiesmEffectiveSnrMapping> ()
+  ;
+  return tid;
+}
+
+MiesmEffectiveSnrMapping::MiesmEffectiveSnrMapping ()
+  : TabulatedEffectiveSnrMapping (&g_bicmTable)
+{
+}
+
+NS_OBJECT_ENSURE_REGISTERED (EesmEffectiveSnrMapping);
+
+TypeId
+EesmEffectiveSnrMapping::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::EesmEffectiveSnrMapping")
+    .SetParent<EffectiveSnrMapping> ()
+    .AddConstructor<EesmEffectiveSnrMapping> ()
+  ;
+  return tid;
+}
+
+EesmEffectiveSnrMapping::EesmEffectiveSnrMapping ()
+{
+  static const double beta[10] = { 1.0, 1.6, 1.7, 4.5, 5.3, 14.0, 15.5, 17.5, 60.0, 67.0 };
+  for (uint8_t mcs = 0; mcs < 10; mcs++)
+    {
+      m_beta[mcs] = beta[mcs];
+    }
+}
+
+void
+EesmEffectiveSnrMapping::SetBeta (uint8_t mcs, double beta)
+{
+  NS_ASSERT (mcs < 10 && beta > 0);
+  m_beta[mcs] = beta;
+}
+
+double
+EesmEffectiveSnrMapping::GetBeta (uint8_t mcs) const
+{
+  NS_ASSERT (mcs < 10);
+  return m_beta[mcs];
+}
+
+double
+EesmEffectiveSnrMapping::GetEffectiveSnr (WifiMode mode, const double *sinr, uint8_t nss) const
+{
+  NS_ASSERT (nss > 0);
+  double beta = m_beta[GetMcsIndex (mode)];
+  double minSinr = sinr[0];
+  for (uint8_t i = 1; i < nss; i++)
+    {
+      if (sinr[i] < minSinr)
+        {
+          minSinr = sinr[i];
+        }
+    }
+  // relative to the weakest stream, so that the exponentials cannot underflow
+  double sum = 0;
+  for (uint8_t i = 0; i < nss; i++)
+    {
+      sum += std::exp (-(sinr[i] - minSinr) / beta);
+    }
+  return minSinr - beta * std::log (sum / nss);
+}
+
+} // namespace ns3
@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef EFFECTIVE_SNR_MAPPING_H
+#define EFFECTIVE_SNR_MAPPING_H
+
+#include <stdint.h>
+#include "ns3/object.h"
+#include "wifi-mode.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief the interface of the effective SNR mappings
+ *
+ * 11ac: mutiple_stream_tx_per. An effective SNR mapping compresses the
+ * post-MMSE SINRs of the spatial streams of a frame into the single SNR
+ * of an AWGN channel with the same error rate, which is then handed to
+ * the ErrorRateModel.
+ */
+class EffectiveSnrMapping : public Object
+{
+public:
+  static TypeId GetTypeId (void);
+
+  /**
+   * \param mode the mode of the streams
+   * \param sinr the linear SINR of each stream
+   * \param nss the number of streams
+   * \return the linear effective SNR
+   */
+  virtual double GetEffectiveSnr (WifiMode mode, const double *sinr, uint8_t nss) const = 0;
+
+  /**
+   * The index of the rows of the mutual information tables: BPSK, QPSK,
+   * 16-QAM, 64-QAM and 256-QAM.
+   *
+   * \param mode the mode
+   * \return the row of the constellation of the mode
+   */
+  static uint8_t GetConstellationIndex (WifiMode mode);
+  /**
+   * \param mode the mode
+   * \return the HT/VHT MCS index (0 to 9) with the constellation and the
+   *         code rate of the mode
+   */
+  static uint8_t GetMcsIndex (WifiMode mode);
+};
+
+/**
+ * \ingroup wifi
+ * \brief a mapping through tabulated mutual information curves
+ *
+ * The curves are sampled every 0.5 dB from -20 dB to 37 dB. The effective
+ * SNR is the inverse of the curve at the mean information of the streams,
+ * it is never lower than the SINR of the weakest stream. The inverse uses
+ * a precomputed index of the first sample above each 1/1024 step of
+ * information, so it costs a lookup and a step or two instead of a scan.
+ */
+class TabulatedEffectiveSnrMapping : public EffectiveSnrMapping
+{
+public:
+  static TypeId GetTypeId (void);
+
+  /// the number of samples of the curves
+  static const uint32_t N_SAMPLES = 115;
+  /// the number of steps of the inverse index
+  static const uint32_t N_STEPS = 1024;
+
+  /**
+   * The curves and their inverse index, one row per constellation.
+   */
+  struct Table
+  {
+    /**
+     * \param values the samples of the 5 curves
+     */
+    Table (const double (*values)[N_SAMPLES]);
+    /**
+     * \param cons the row
+     * \param info the information
+     * \return the first sample of the row which is at least info,
+     *         N_SAMPLES if there is none
+     */
+    uint32_t FindFirstAbove (uint8_t cons, double info) const;
+    /**
+     * \param cons the row
+     * \param snrDb the SNR (dB)
+     * \return the information, interpolated between the samples
+     */
+    double GetInformation (uint8_t cons, double snrDb) const;
+    /**
+     * \param cons the row
+     * \param info the information
+     * \return the SNR (dB), interpolated between the samples
+     */
+    double GetSnrDb (uint8_t cons, double info) const;
+
+    const double (*m_values)[N_SAMPLES];
+    uint8_t m_first[5][N_STEPS + 1];
+  };
+
+  virtual double GetEffectiveSnr (WifiMode mode, const double *sinr, uint8_t nss) const;
+
+protected:
+  /**
+   * \param table the curves of the mapping
+   */
+  TabulatedEffectiveSnrMapping (const Table *table);
+
+  const Table *m_table;
+};
+
+/**
+ * \ingroup wifi
+ * \brief Received Bit mutual Information Rate mapping
+ *
+ * The curves are the symbol mutual information of the constellations,
+ * normalized per bit. Without interpolation the mapping reproduces the
+ * original implementation: each SINR is truncated to the 0.5 dB sample
+ * below it, clamped to 27 dB, and the inverse is the nearest sample.
+ */
+class RbirEffectiveSnrMapping : public TabulatedEffectiveSnrMapping
+{
+public:
+  static TypeId GetTypeId (void);
+
+  RbirEffectiveSnrMapping ();
+
+  virtual double GetEffectiveSnr (WifiMode mode, const double *sinr, uint8_t nss) const;
+
+private:
+  bool m_interpolation;
+};
+
+/**
+ * \ingroup wifi
+ * \brief Mutual Information Effective SINR Mapping
+ *
+ * The curves are the bit interleaved coded modulation capacity of the
+ * Gray mapped constellations, normalized per bit.
+ */
+class MiesmEffectiveSnrMapping : public TabulatedEffectiveSnrMapping
+{
+public:
+  static TypeId GetTypeId (void);
+
+  MiesmEffectiveSnrMapping ();
+};
+
+/**
+ * \ingroup wifi
+ * \brief Exponential Effective SINR Mapping
+ *
+ * esnr = -beta ln (1/nss sum exp (-sinr_i / beta)), with one beta per
+ * MCS. The default betas are typical values of the literature, they are
+ * not calibrated against the error rate models of this module.
+ */
+class EesmEffectiveSnrMapping : public EffectiveSnrMapping
+{
+public:
+  static TypeId GetTypeId (void);
+
+  EesmEffectiveSnrMapping ();
+
+  /**
+   * \param mcs the MCS index (0 to 9)
+   * \param beta the calibration factor of the MCS
+   */
+  void SetBeta (uint8_t mcs, double beta);
+  /**
+   * \param mcs the MCS index (0 to 9)
+   * \return the calibration factor of the MCS
+   */
+  double GetBeta (uint8_t mcs) const;
+
+  virtual double GetEffectiveSnr (WifiMode mode, const double *sinr, uint8_t nss) const;
+
+private:
+  double m_beta[10];
+};
+
+} // namespace ns3
+
+#endif /* EFFECTIVE_SNR_MAPPING_H */
@@ -8,6 +8,10 @@
 #include "wifi-mac.h"
 #include "yans-wifi-phy.h"
 #include "yans-wifi-channel.h"
+#include "interference-helper.h"
+#include "error-rate-model.h"
+#include "effective-snr-mapping.h"
+#include "channel-matrix.h"
 #include "ns3/string.h"
 #include "ns3/log.h"
 #include "ns3/object.h"
@@ -19,6 +23,8 @@
 #include "ns3/log.h"
 
 #include "ns3/random-variable.h"
+#include "ns3/simulator.h"
+#include "ns3/nstime.h"
 #define Min(a,b) ((a < b) ? a : b)
 
 namespace ns3 {
@@ -26,6 +32,9 @@ namespace ns3 {
 struct GenieWifiRemoteStation : public WifiRemoteStation
 {
   double m_lastSnr;
+  /// the channel last drawn for each number of streams, and when
+  Ptr<ChannelMatrix> m_channel[4];
+  Time m_channelTime[4];
 };
 
 NS_OBJECT_ENSURE_REGISTERED (GenieWifiManager);
@@ -47,6 +56,12 @@ GenieWifiManager::GetTypeId (void)
                    DoubleValue (10e-2),
                    MakeDoubleAccessor (&GenieWifiManager::m_per),
                    MakeDoubleChecker<double> ())
+    .AddAttribute ("CoherenceTime",
+                   "How long the channel drawn for a receiver is reused, "
+                   "it is drawn for every frame if zero",
+                   TimeValue (Seconds (0)),
+                   MakeTimeAccessor (&GenieWifiManager::m_coherenceTime),
+                   MakeTimeChecker ())
   ;
   return tid;
 }
@@ -97,28 +112,63 @@ GenieWifiManager::SetupPhy (Ptr<WifiPhy> phy)
 double
 GenieWifiManager::GetSnrThreshold (WifiMode mode) const
 {
-  for (Thresholds::const_iterator i = m_thresholds.begin (); i != m_thresholds.end (); i++)
-    {
-      if (mode == i->second)
-        {
-          return i->first;
-        }
-    }
-  NS_ASSERT (false);
-  return 0.0;
+  Thresholds::const_iterator i = m_thresholds.find (mode.GetUid ());
+  NS_ASSERT (i != m_thresholds.end ());
+  return i->second;
 }
 
 void
 GenieWifiManager::AddModeSnrThreshold (WifiMode mode, double snr)
 {
-  for (Thresholds::const_iterator i = m_thresholds.begin (); i != m_thresholds.end (); i++)
+  // the first threshold of a mode is kept
+  m_thresholds.insert (std::make_pair (mode.GetUid (), snr));
+}
+
+Ptr<YansWifiPhy>
+GenieWifiManager::GetReceiverPhy (Mac48Address address)
+{
+  Receivers::const_iterator i = m_receivers.find (address);
+  if (i == m_receivers.end () || i->second->GetMac ()->GetAddress () != address)
     {
-      if (mode == i->second)
+      // a device was added or readdressed since the index was built
+      m_receivers.clear ();
+      Ptr<WifiChannel> channel = GetWifiPhy ()->GetChannel ();
+      uint32_t nDevices = channel->GetNDevices ();
+      for (uint32_t k = 0; k < nDevices; k++)
         {
-          return;
+          Ptr<WifiNetDevice> device = channel->GetDevice (k)->GetObject<WifiNetDevice> ();
+          // the first device with the address, as the scan it replaces
+          m_receivers.insert (std::make_pair (device->GetMac ()->GetAddress (), device));
         }
+      i = m_receivers.find (address);
+      NS_ASSERT_MSG (i != m_receivers.end (), "no device " << address << " on the channel");
     }
-  m_thresholds.push_back (std::make_pair (snr,mode));
+  return i->second->GetPhy ()->GetObject<YansWifiPhy> ();
+}
+
+Ptr<ChannelMatrix>
+GenieWifiManager::GetChannelMatrix (GenieWifiRemoteStation *station,
+                                    Ptr<YansWifiPhy> receiver, uint8_t nss)
+{
+  Time now = Simulator::Now ();
+  Ptr<ChannelMatrix> &channelMatrix = station->m_channel[nss - 1];
+  if (channelMatrix != 0 && now - station->m_channelTime[nss - 1] < m_coherenceTime)
+    {
+      return channelMatrix;
+    }
+  Ptr<YansWifiPhy> phy = GetWifiPhy ()->GetObject<YansWifiPhy> ();
+  Ptr<YansWifiChannel> channel = phy->GetChannel ()->GetObject<YansWifiChannel> ();
+  // Mobility models for calculating pathloss
+  Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+  Ptr<MobilityModel> senderMobility = phy->GetMobility ()->GetObject<MobilityModel> ();
+  double txPowerDbm = phy->GetPowerDbm (GetDefaultTxPowerLevel ()) + phy->GetTxGain ();
+
+  channelMatrix = Create<ChannelMatrix> (nss, 1);
+  std::complex<double> * hvector = channelMatrix->GetBuffer ();
+  hvector[0] = txPowerDbm;
+  channel->GetPropagationLossModel ()->CalcRxPower (hvector, senderMobility, receiverMobility, nss, NULL);
+  station->m_channelTime[nss - 1] = now;
+  return channelMatrix;
 }
 
 WifiRemoteStation *
@@ -169,42 +219,13 @@ GenieWifiManager::DoReportFinalDataFailed (WifiRemoteStation *station)
 WifiTxVector
 GenieWifiManager::DoGetDataTxVector (WifiRemoteStation *st, uint32_t size, uint16_t bw)
 {
-
+  GenieWifiRemoteStation *station = (GenieWifiRemoteStation *)st;
 	uint16_t bwLoss = bw/20;
 	uint16_t txAntenna = Min (GetNumberOfReceiveAntennas (st),GetNumberOfTransmitAntennas());
   //////////////////////////ns3_lecture//////////////////////////////
-  Ptr<WifiPhy> wifiPhy = GetWifiPhy();
-  // Receiver MAC address and PHY instances
-  Mac48Address receiverMac48Address = st->m_state->m_address;
-  Ptr<WifiPhy> receiverWifiPhy;
-  Ptr<YansWifiPhy> receiverYansWifiPhy;
-  // Target instances attached to the channel
-  Ptr<WifiNetDevice> testWifiNetDevice;
-  Mac48Address testMac48Address;
-  // Channel instance that this WifiManager is attached to
-  Ptr<YansWifiChannel> channel;
-  // Find the receiver PHY instances
-
-  uint32_t nDevices = wifiPhy->GetChannel()->GetNDevices();
-  for (uint32_t k = 0; k < nDevices; k++)
-  {
-    testWifiNetDevice = wifiPhy->GetChannel()->GetDevice(k)->GetObject<WifiNetDevice>();
-    testMac48Address = testWifiNetDevice->GetMac()->GetAddress();
-    if (testMac48Address == receiverMac48Address)
-    {
-      receiverWifiPhy = testWifiNetDevice->GetPhy();
-      break;
-    }
-  }
-  receiverYansWifiPhy = receiverWifiPhy->GetObject<YansWifiPhy>();
-  channel = wifiPhy->GetChannel()->GetObject<YansWifiChannel>();
-  // Mobility models for calculating pathloss
-  Ptr<MobilityModel> receiverMobility = receiverYansWifiPhy->GetMobility()->GetObject<MobilityModel>();
-  Ptr<MobilityModel> senderMobility = wifiPhy->GetObject<YansWifiPhy>()->GetMobility()->GetObject<MobilityModel>();
-
-  // Noise figure >> Noise floor (ref: InterferenceHelper::CalculateSnr)
-  double txPowerDbm = wifiPhy->GetObject<YansWifiPhy>()->GetPowerDbm(GetDefaultTxPowerLevel()) 
-										+ wifiPhy->GetObject<YansWifiPhy>()->GetTxGain();
+  Ptr<YansWifiPhy> receiverYansWifiPhy = GetReceiverPhy (st->m_state->m_address);
+  // the SNRs are computed as the receiver would (ref: InterferenceHelper::CalculateSnr)
+  const InterferenceHelper &interference = receiverYansWifiPhy->GetInterferenceHelper ();
  
 	//shbyeon: multiple stream processing
   WifiTxVector txVector (GetDefaultMode(), GetDefaultTxPowerLevel (), GetLongRetryCount (st), GetShortGuardInterval (st),
@@ -217,100 +238,57 @@ GenieWifiManager::DoGetDataTxVector (WifiRemoteStation *st, uint32_t size, uint1
 	{
 		txVector.SetNss(nss);
 		double maxThreshold = 0.0;
-		if(nss == 1)
+		NS_ASSERT_MSG(nss == 1 || HasHtSupported() || HasVhtSupported(), 
+				"# of antenna should be smmaller than 2 for 11a");
+		Ptr<ChannelMatrix> channelMatrix = GetChannelMatrix (station, receiverYansWifiPhy, nss);
+		double rxPower = channelMatrix->GetRxPowerDbm () + 1; //m_rxGain
+		rxPower = pow(10.0, rxPower/10.0)/bwLoss/1000;
+		txVector.SetChannelMatrix(channelMatrix);
+
+		// the streams do not depend on the MCS, only their effective SNR does
+		double sinr[4];
+		interference.CalculateStreamSinr (rxPower, 0, txVector, sinr);
+
+		WifiMode maxMode = GetDefaultMode ();
+		uint32_t supported = 0;
+		bool HT = false;
+		bool VHT = false;
+		if(HasHtSupported())
 		{
-			std::complex<double> * hvector = new std::complex<double> [nss*nss+1];
-			hvector[0].real() = txPowerDbm;
-			hvector = channel->GetPropagationLossModel()->CalcRxPower (hvector, senderMobility, receiverMobility, nss, NULL);
-			double rxPower = hvector[0].real() + 1; //m_rxGain
-			rxPower = pow(10.0, rxPower/10.0)/bwLoss/1000;
-
-			WifiMode maxMode = GetDefaultMode ();
-			uint32_t supported = 0;
-			bool HT = false;
-			bool VHT = false;
-			if(HasHtSupported())
+			supported = GetNMcsSupported(st);
+			HT = true;
+			if(HasVhtSupported())
 			{
-				supported = GetNMcsSupported(st);
-				HT = true;
-				if(HasVhtSupported())
-				{
-					VHT = true;
-					maxMode = AcMcsToWifiMode(GetDefaultMcs(), bw);
-				}
-				else
-					maxMode = McsToWifiMode(GetDefaultMcs());
+				VHT = true;
+				maxMode = AcMcsToWifiMode(GetDefaultMcs(), bw);
 			}
 			else
-				supported = GetNSupported(st); 
-			
-      txVector.SetChannelMatrix(hvector, nss, 1);
-      delete [] hvector;
-
-			for (uint32_t i = 0; i < supported; i++)
-			{
-				WifiMode mode;
-				if(VHT)
-					mode = AcMcsToWifiMode(GetMcsSupported (st, i), bw);
-				else if(HT)
-					mode = McsToWifiMode(GetMcsSupported (st, i));
-				else
-					mode = GetSupported (st, i);
-        
-        txVector.SetMode(mode);
-        m_currentSnr = receiverYansWifiPhy->GetInterferenceHelper().CalculateSnr (rxPower, 0, txVector);
-
-				double threshold = GetSnrThreshold (mode);
-				if (threshold > maxThreshold
-						&& threshold < m_currentSnr)
-				{
-					maxThreshold = threshold;
-					maxMode = mode;
-				}
-			}
-			results[0] = maxMode;
-			NS_LOG_DEBUG(nss << "-streams, " << "estimated snr=" << 10* std::log10(m_currentSnr));
+				maxMode = McsToWifiMode(GetDefaultMcs());
 		}
-		else if(nss >= 2)
+		else
+			supported = GetNSupported(st); 
+
+		for (uint32_t i = 0; i < supported; i++)
 		{
-			NS_ASSERT_MSG(HasHtSupported() || HasVhtSupported(), 
-					"# of antenna should be smmaller than 2 for 11a");
-			std::complex<double> * hvector = new std::complex<double> [nss*nss+1];
-			hvector[0].real() = txPowerDbm;
-			hvector = channel->GetPropagationLossModel()->CalcRxPower (hvector, senderMobility, receiverMobility, nss, NULL);
-			double rxPower = hvector[0].real() + 1; //m_rxGain
-			rxPower = pow(10.0, rxPower/10.0)/bwLoss/1000;
-			WifiMode maxMode;
-			if(HasVhtSupported())
-				maxMode = AcMcsToWifiMode(GetDefaultMcs(), bw);
+			WifiMode mode;
+			if(VHT)
+				mode = AcMcsToWifiMode(GetMcsSupported (st, i), bw);
+			else if(HT)
+				mode = McsToWifiMode(GetMcsSupported (st, i));
 			else
-				maxMode = McsToWifiMode(GetDefaultMcs());
-			txVector.SetNss(nss);
-			txVector.SetChannelMatrix(hvector, nss, 1);
-      delete [] hvector;
-      uint16_t mcsMax = GetNMcsSupported(st);	
-
-      for (uint16_t mcs = 0; mcs < mcsMax; mcs++)
-      {
-        //802.11ac call interference helper 
-        WifiMode mode;
-        if(HasVhtSupported())
-          mode = AcMcsToWifiMode(GetMcsSupported (st, mcs), bw);
-        else
-          mode = McsToWifiMode(GetMcsSupported (st, mcs));
-        txVector.SetMode(mode);
-        m_currentSnr = receiverYansWifiPhy->GetInterferenceHelper().CalculateSnr (rxPower, 0, txVector);
-        double threshold = GetSnrThreshold (mode);
-        if(threshold > maxThreshold && threshold < m_currentSnr)
-        {
-          maxThreshold = threshold;
-          maxMode = mode;
-        }
-        results[nss-1] = maxMode;
-      }
+				mode = GetSupported (st, i);
 
-			NS_LOG_DEBUG(nss << "-streams, " << "estimated snr=" << 10* std::log10(m_currentSnr));
-    }
+			m_currentSnr = interference.CalculateEffectiveSnr (mode, sinr, nss);
+			double threshold = GetSnrThreshold (mode);
+			if (threshold > maxThreshold
+					&& threshold < m_currentSnr)
+			{
+				maxThreshold = threshold;
+				maxMode = mode;
+			}
+		}
+		results[nss-1] = maxMode;
+		NS_LOG_DEBUG(nss << "-streams, " << "estimated snr=" << 10* std::log10(m_currentSnr));
 	}
 	WifiMode final = results[0];
 	uint16_t final_idx = 0;
@@ -331,163 +309,7 @@ GenieWifiManager::DoGetDataTxVector (WifiRemoteStation *st, uint32_t size, uint1
 WifiTxVector
 GenieWifiManager::DoGetDataTxVector (WifiRemoteStation *st, uint32_t size)
 {
-	uint16_t bw = GetCurrentBandwidth(st);
-	uint16_t bwLoss = bw/20;
-	uint16_t txAntenna = Min (GetNumberOfReceiveAntennas (st),GetNumberOfTransmitAntennas());
-  //////////////////////////ns3_lecture//////////////////////////////
-  Ptr<WifiPhy> wifiPhy = GetWifiPhy();
-  // Receiver MAC address and PHY instances
-  Mac48Address receiverMac48Address = st->m_state->m_address;
-  Ptr<WifiPhy> receiverWifiPhy;
-  Ptr<YansWifiPhy> receiverYansWifiPhy;
-  // Target instances attached to the channel
-  Ptr<WifiNetDevice> testWifiNetDevice;
-  Mac48Address testMac48Address;
-  // Channel instance that this WifiManager is attached to
-  Ptr<YansWifiChannel> channel;
-  // Find the receiver PHY instances
-
-  uint32_t nDevices = wifiPhy->GetChannel()->GetNDevices();
-  for (uint32_t k = 0; k < nDevices; k++)
-  {
-    testWifiNetDevice = wifiPhy->GetChannel()->GetDevice(k)->GetObject<WifiNetDevice>();
-    testMac48Address = testWifiNetDevice->GetMac()->GetAddress();
-    if (testMac48Address == receiverMac48Address)
-    {
-      receiverWifiPhy = testWifiNetDevice->GetPhy();
-      break;
-    }
-  }
-  receiverYansWifiPhy = receiverWifiPhy->GetObject<YansWifiPhy>();
-  channel = wifiPhy->GetChannel()->GetObject<YansWifiChannel>();
-  // Mobility models for calculating pathloss
-  Ptr<MobilityModel> receiverMobility = receiverYansWifiPhy->GetMobility()->GetObject<MobilityModel>();
-  Ptr<MobilityModel> senderMobility = wifiPhy->GetObject<YansWifiPhy>()->GetMobility()->GetObject<MobilityModel>();
-
-  // Noise figure >> Noise floor (ref: InterferenceHelper::CalculateSnr)
-  double txPowerDbm = wifiPhy->GetObject<YansWifiPhy>()->GetPowerDbm(GetDefaultTxPowerLevel()) 
-										+ wifiPhy->GetObject<YansWifiPhy>()->GetTxGain();
- 
-	//shbyeon: multiple stream processing
-  WifiTxVector txVector (GetDefaultMode(), GetDefaultTxPowerLevel (), GetLongRetryCount (st), GetShortGuardInterval (st),
-			txAntenna, GetNumberOfTransmitAntennas (st), GetStbc (st));
-	txVector.SetBandwidth(bw);
-	
-	WifiMode results[txAntenna];
-
-	for(uint16_t nss = 1; nss < txAntenna+1; nss++)
-	{
-		txVector.SetNss(nss);
-		double maxThreshold = 0.0;
-		if(nss == 1)
-		{
-			std::complex<double> * hvector = new std::complex<double> [nss*nss+1];
-			hvector[0].real() = txPowerDbm;
-			hvector = channel->GetPropagationLossModel()->CalcRxPower (hvector, senderMobility, receiverMobility, nss, NULL);
-			double rxPower = hvector[0].real() + 1; //m_rxGain
-			rxPower = pow(10.0, rxPower/10.0)/bwLoss/1000;
-
-			WifiMode maxMode = GetDefaultMode ();
-			uint32_t supported = 0;
-			bool HT = false;
-			bool VHT = false;
-			if(HasHtSupported())
-			{
-				supported = GetNMcsSupported(st);
-				HT = true;
-				if(HasVhtSupported())
-				{
-					VHT = true;
-					maxMode = AcMcsToWifiMode(GetDefaultMcs(), bw);
-				}
-				else
-					maxMode = McsToWifiMode(GetDefaultMcs());
-			}
-			else
-				supported = GetNSupported(st); 
-			
-      txVector.SetChannelMatrix(hvector, nss, 1);
-      delete [] hvector;
-
-			for (uint32_t i = 0; i < supported; i++)
-			{
-				WifiMode mode;
-				if(VHT)
-					mode = AcMcsToWifiMode(GetMcsSupported (st, i), bw);
-				else if(HT)
-					mode = McsToWifiMode(GetMcsSupported (st, i));
-				else
-					mode = GetSupported (st, i);
-        
-        txVector.SetMode(mode);
-        m_currentSnr = receiverYansWifiPhy->GetInterferenceHelper().CalculateSnr (rxPower, 0, txVector);
-
-				double threshold = GetSnrThreshold (mode);
-				if (threshold > maxThreshold
-						&& threshold < m_currentSnr)
-				{
-					maxThreshold = threshold;
-					maxMode = mode;
-				}
-			}
-			results[0] = maxMode;
-			NS_LOG_DEBUG(nss << "-streams, " << "estimated snr=" << 10* std::log10(m_currentSnr));
-		}
-		else if(nss >= 2)
-		{
-			NS_ASSERT_MSG(HasHtSupported() || HasVhtSupported(), 
-					"# of antenna should be smmaller than 2 for 11a");
-			std::complex<double> * hvector = new std::complex<double> [nss*nss+1];
-			hvector[0].real() = txPowerDbm;
-			hvector = channel->GetPropagationLossModel()->CalcRxPower (hvector, senderMobility, receiverMobility, nss, NULL);
-			double rxPower = hvector[0].real() + 1; //m_rxGain
-			rxPower = pow(10.0, rxPower/10.0)/bwLoss/1000;
-			WifiMode maxMode;
-			if(HasVhtSupported())
-				maxMode = AcMcsToWifiMode(GetDefaultMcs(), bw);
-			else
-				maxMode = McsToWifiMode(GetDefaultMcs());
-			txVector.SetNss(nss);
-			txVector.SetChannelMatrix(hvector, nss, 1);
-      delete [] hvector;
-      uint16_t mcsMax = GetNMcsSupported(st);	
-
-      for (uint16_t mcs = 0; mcs < mcsMax; mcs++)
-      {
-        //802.11ac call interference helper 
-        WifiMode mode;
-        if(HasVhtSupported())
-          mode = AcMcsToWifiMode(GetMcsSupported (st, mcs), bw);
-        else
-          mode = McsToWifiMode(GetMcsSupported (st, mcs));
-        txVector.SetMode(mode);
-        m_currentSnr = receiverYansWifiPhy->GetInterferenceHelper().CalculateSnr (rxPower, 0, txVector);
-        double threshold = GetSnrThreshold (mode);
-        if(threshold > maxThreshold && threshold < m_currentSnr)
-        {
-          maxThreshold = threshold;
-          maxMode = mode;
-        }
-        results[nss-1] = maxMode;
-      }
-
-			NS_LOG_DEBUG(nss << "-streams, " << "estimated snr=" << 10* std::log10(m_currentSnr));
-    }
-	}
-	WifiMode final = results[0];
-	uint16_t final_idx = 0;
-	for (uint16_t nss = 0; nss < txAntenna-1; nss++)
-	{
-		if(results[final_idx].GetDataRate()*(final_idx+1) < results[nss+1].GetDataRate()*(nss+2))
-		{
-			final = results[nss+1];
-			final_idx = nss+1;
-		}
-	}
-	txVector.SetNss(final_idx+1);
-	txVector.SetMode(final);
-  NS_LOG_DEBUG("final ss=" << final_idx+1);
-	return txVector;
+  return DoGetDataTxVector (st, size, GetCurrentBandwidth (st));
 }
 
 
@@ -502,29 +324,8 @@ GenieWifiManager::DoGetRtsTxVector (WifiRemoteStation *st)
   Ptr<WifiPhy> wifiPhy = GetWifiPhy();
   WifiMacHeader rts;
   rts.SetType (WIFI_MAC_CTL_RTS);
-  // Receiver MAC address and PHY instances
-  Mac48Address receiverMac48Address = st->m_state->m_address;
-  Ptr<WifiPhy> receiverWifiPhy;
-  Ptr<YansWifiPhy> receiverYansWifiPhy;
-  // Target instances attached to the channel
-  Ptr<WifiNetDevice> testWifiNetDevice;
-  Mac48Address testMac48Address;
-  // Channel instance that this WifiManager is attached to
-  Ptr<YansWifiChannel> channel;
-  // Find the receiver PHY instances
-  uint32_t nDevices = wifiPhy->GetChannel()->GetNDevices();
-  for (uint32_t k = 0; k < nDevices; k++)
-  {
-    testWifiNetDevice = wifiPhy->GetChannel()->GetDevice(k)->GetObject<WifiNetDevice>();
-    testMac48Address = testWifiNetDevice->GetMac()->GetAddress();
-    if (testMac48Address == receiverMac48Address)
-    {
-      receiverWifiPhy = testWifiNetDevice->GetPhy();
-      break;
-    }
-  }
-  receiverYansWifiPhy = receiverWifiPhy->GetObject<YansWifiPhy>();
-  channel = wifiPhy->GetChannel()->GetObject<YansWifiChannel>();
+  Ptr<YansWifiPhy> receiverYansWifiPhy = GetReceiverPhy (st->m_state->m_address);
+  Ptr<YansWifiChannel> channel = wifiPhy->GetChannel()->GetObject<YansWifiChannel>();
   // Mobility models for calculating pathloss
   Ptr<MobilityModel> receiverMobility = receiverYansWifiPhy->GetMobility()->GetObject<MobilityModel>();
   Ptr<MobilityModel> senderMobility = wifiPhy->GetObject<YansWifiPhy>()->GetMobility()->GetObject<MobilityModel>();
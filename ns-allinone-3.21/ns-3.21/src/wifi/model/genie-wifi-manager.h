@@ -3,6 +3,7 @@
 
 #include <stdint.h>
 #include <vector>
+#include <map>
 #include "wifi-mode.h"
 #include "wifi-remote-station-manager.h"
 
@@ -12,9 +13,25 @@
 #include "ns3/ptr.h"
 #include "ns3/mac48-address.h"
 #include "ns3/packet.h"
+#include "ns3/nstime.h"
 
 namespace ns3 {
 
+class YansWifiPhy;
+class ChannelMatrix;
+struct GenieWifiRemoteStation;
+
+/**
+ * \ingroup wifi
+ * \brief a rate manager which knows the channel of the receiver
+ *
+ * For every data frame the channel to the receiver is drawn for each
+ * number of spatial streams, and the MCS with the highest threshold below
+ * the effective SNR of the streams is chosen. The post-MMSE SINRs of the
+ * streams are computed once per number of streams, only their mapping to
+ * an effective SNR depends on the MCS. With a non-zero CoherenceTime the
+ * channel drawn for a receiver is reused until it is that old.
+ */
 class GenieWifiManager : public WifiRemoteStationManager
 {
 public:
@@ -47,7 +64,24 @@ private:
   double GetSnrThreshold (WifiMode mode) const;
   void AddModeSnrThreshold (WifiMode mode, double ber);
 
-  typedef std::vector<std::pair<double,WifiMode> > Thresholds;
+  /**
+   * \param address the MAC address of a device of the channel
+   * \return the PHY of the device, from the index of the devices of the
+   *         channel, which is rebuilt when it misses
+   */
+  Ptr<YansWifiPhy> GetReceiverPhy (Mac48Address address);
+  /**
+   * \param station the receiver
+   * \param receiver the PHY of the receiver
+   * \param nss the number of streams
+   * \return the channel to the receiver, with the rx power (dBm)
+   */
+  Ptr<ChannelMatrix> GetChannelMatrix (GenieWifiRemoteStation *station,
+                                       Ptr<YansWifiPhy> receiver, uint8_t nss);
+
+  /// SNR threshold of each mode, by mode uid
+  typedef std::map<uint32_t, double> Thresholds;
+  typedef std::map<Mac48Address, Ptr<WifiNetDevice> > Receivers;
 
   double m_ber;
   Thresholds m_thresholds;
@@ -55,6 +89,8 @@ private:
   double m_maxSnr;
   double m_per;
   double m_currentSnr;
+  Time m_coherenceTime;
+  Receivers m_receivers;
 };
 
 } // namespace ns3
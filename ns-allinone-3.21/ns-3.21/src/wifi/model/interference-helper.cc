@@ -23,8 +23,9 @@
 #include "ns3/simulator.h"
 #include "ns3/log.h"
 #include <algorithm>
-#include "rbir.h" //11ac: mutiple_stream_tx_per
+#include "effective-snr-mapping.h" //11ac: mutiple_stream_tx_per
 #include "correlation-matrix.h" //11ac: mutiple_stream_tx_per
+#include "mimo-mmse.h"
 
 NS_LOG_COMPONENT_DEFINE ("InterferenceHelper");
 
@@ -79,19 +80,9 @@ InterferenceHelper::Event::GetRealRxPowerW (void)
 	uint8_t nss = 	m_txVector.GetNss();
 	double realRxPowerW = m_rxPowerW;
 	if (nss == 1){
-		std::complex<double> **ch = new std::complex<double> *[nss];
-		for (int i=0;i<nss;i++)
-			ch[i] = new std::complex<double>[nss];
-		m_txVector.GetChannelMatrix (ch);
-		double a = ch[0][0].real();
-		double b = ch[0][0].imag();
-		double squareValue = (a*a + b*b);
-		realRxPowerW = m_rxPowerW*squareValue/2; 
-		for(int j=0; j<nss; j++)
-		{
-			delete [] ch[j];
-		}
-		delete [] ch; 
+		std::complex<double> ch;
+		m_txVector.GetChannelMatrix (&ch, 0);
+		realRxPowerW = m_rxPowerW*std::norm (ch)/2; 
 	}		
 	return realRxPowerW;
 //  return m_rxPowerW;
@@ -145,13 +136,190 @@ InterferenceHelper::NiChange::operator < (const InterferenceHelper::NiChange& o)
   return (m_time < o.m_time);
 }
 
+/****************************************************************
+ *       NI changes of a reception, read from the timeline
+ ****************************************************************/
+
+InterferenceHelper::NiChanges::iterator::iterator ()
+  : m_ni (0),
+    m_state (END)
+{
+}
+
+InterferenceHelper::NiChange
+InterferenceHelper::NiChanges::iterator::operator * () const
+{
+  switch (m_state)
+    {
+    case FIRST:
+      return m_ni->m_first;
+    case TIMELINE:
+      return NiChange (m_it->first, m_it->second);
+    case LAST:
+      return m_ni->m_last;
+    default:
+      NS_ASSERT (false);
+      return m_ni->m_last;
+    }
+}
+
+InterferenceHelper::NiChanges::iterator &
+InterferenceHelper::NiChanges::iterator::operator ++ ()
+{
+  switch (m_state)
+    {
+    case FIRST:
+      m_it = m_ni->m_begin;
+      m_state = (m_it == m_ni->m_stop) ? LAST : TIMELINE;
+      break;
+    case TIMELINE:
+      if (++m_it == m_ni->m_stop)
+        {
+          m_state = LAST;
+        }
+      break;
+    default:
+      m_state = END;
+      break;
+    }
+  return *this;
+}
+
+InterferenceHelper::NiChanges::iterator
+InterferenceHelper::NiChanges::iterator::operator ++ (int)
+{
+  iterator old = *this;
+  ++(*this);
+  return old;
+}
+
+bool
+InterferenceHelper::NiChanges::iterator::operator == (const iterator &o) const
+{
+  return m_state == o.m_state && (m_state != TIMELINE || m_it == o.m_it);
+}
+
+bool
+InterferenceHelper::NiChanges::iterator::operator != (const iterator &o) const
+{
+  return !(*this == o);
+}
+
+InterferenceHelper::NiChanges::NiChanges ()
+  : m_first (Seconds (0), 0),
+    m_n (0),
+    m_last (Seconds (0), 0)
+{
+}
+
+void
+InterferenceHelper::NiChanges::Set (Ptr<const InterferenceTimeline> timeline,
+                                    NiChange first, InterferenceTimeline::Iterator begin,
+                                    InterferenceTimeline::Iterator stop, uint32_t n, NiChange last)
+{
+  m_timeline = timeline;
+  m_first = first;
+  m_begin = begin;
+  m_stop = stop;
+  m_n = n;
+  m_last = last;
+}
+
+InterferenceHelper::NiChanges::iterator
+InterferenceHelper::NiChanges::begin (void) const
+{
+  iterator it;
+  it.m_ni = this;
+  it.m_state = iterator::FIRST;
+  return it;
+}
+
+InterferenceHelper::NiChanges::iterator
+InterferenceHelper::NiChanges::end (void) const
+{
+  iterator it;
+  it.m_ni = this;
+  return it;
+}
+
+InterferenceHelper::NiChange
+InterferenceHelper::NiChanges::back (void) const
+{
+  return m_last;
+}
+
+uint32_t
+InterferenceHelper::NiChanges::size (void) const
+{
+  // the start and the end of the event around the changes
+  return m_n + 2;
+}
+
+/****************************************************************
+ *       Timeline of the NI changes of all the subchannels
+ ****************************************************************/
+
+InterferenceTimeline::InterferenceTimeline ()
+{
+  for (uint8_t i = 0; i < 4; i++)
+    {
+      m_firstPower[i] = 0.0;
+    }
+}
+
+void
+InterferenceTimeline::Add (uint8_t subchannel, Time time, double delta)
+{
+  NS_ASSERT (subchannel < 4);
+  Changes &changes = m_changes[subchannel];
+  // after the changes at the same time
+  changes.insert (changes.upper_bound (time), std::make_pair (time, delta));
+}
+
+void
+InterferenceTimeline::Prune (uint8_t subchannel, Time moment)
+{
+  Changes &changes = m_changes[subchannel];
+  while (!changes.empty () && changes.begin ()->first <= moment)
+    {
+      m_firstPower[subchannel] += changes.begin ()->second;
+      changes.erase (changes.begin ());
+    }
+}
+
+void
+InterferenceTimeline::Clear (uint8_t subchannel)
+{
+  m_changes[subchannel].clear ();
+  m_firstPower[subchannel] = 0.0;
+}
+
+double
+InterferenceTimeline::GetFirstPower (uint8_t subchannel) const
+{
+  return m_firstPower[subchannel];
+}
+
+InterferenceTimeline::Iterator
+InterferenceTimeline::Begin (uint8_t subchannel) const
+{
+  return m_changes[subchannel].begin ();
+}
+
+InterferenceTimeline::Iterator
+InterferenceTimeline::End (uint8_t subchannel) const
+{
+  return m_changes[subchannel].end ();
+}
+
 /****************************************************************
  *       The actual InterferenceHelper
  ****************************************************************/
 
 InterferenceHelper::InterferenceHelper ()
   : m_errorRateModel (0),
-    m_firstPower (0.0),
+    m_timeline (Create<InterferenceTimeline> ()),
+    m_subchannel (0),
     m_rxing (false),
     m_PI (3.141592653589793),
     m_antennaCorrelation (0)
@@ -159,8 +327,19 @@ InterferenceHelper::InterferenceHelper ()
 }
 InterferenceHelper::~InterferenceHelper ()
 {
-  EraseEvents ();
+  // the timeline may be shared with copies of this helper, it is
+  // released, not erased
+  m_timeline = 0;
   m_errorRateModel = 0;
+  m_effectiveSnrMapping = 0;
+}
+
+void
+InterferenceHelper::SetTimeline (Ptr<InterferenceTimeline> timeline, uint8_t subchannel)
+{
+  NS_ASSERT (subchannel < 4);
+  m_timeline = timeline;
+  m_subchannel = subchannel;
 }
 
 Ptr<InterferenceHelper::Event>
@@ -211,17 +390,30 @@ InterferenceHelper::GetErrorRateModel (void) const
   return m_errorRateModel;
 }
 
+void
+InterferenceHelper::SetEffectiveSnrMapping (Ptr<EffectiveSnrMapping> mapping)
+{
+  m_effectiveSnrMapping = mapping;
+}
+
+Ptr<EffectiveSnrMapping>
+InterferenceHelper::GetEffectiveSnrMapping (void) const
+{
+  return m_effectiveSnrMapping;
+}
+
 Time
 InterferenceHelper::GetEnergyDuration (double energyW)
 {
   Time now = Simulator::Now ();
   double noiseInterferenceW = 0.0;
   Time end = now;
-  noiseInterferenceW = m_firstPower;
-  for (NiChanges::const_iterator i = m_niChanges.begin (); i != m_niChanges.end (); i++)
+  noiseInterferenceW = m_timeline->GetFirstPower (m_subchannel);
+  InterferenceTimeline::Iterator last = m_timeline->End (m_subchannel);
+  for (InterferenceTimeline::Iterator i = m_timeline->Begin (m_subchannel); i != last; i++)
     {
-      noiseInterferenceW += i->GetDelta ();
-      end = i->GetTime ();
+      noiseInterferenceW += i->second;
+      end = i->first;
       if (end < now)
         {
           continue;
@@ -243,19 +435,12 @@ InterferenceHelper::AppendEvent (Ptr<InterferenceHelper::Event> event)
 				"us, power=" << WToDbm(event->GetRealRxPowerW ()) );
   if (!m_rxing)
     {
-      NiChanges::iterator nowIterator = GetPosition (now);
-      for (NiChanges::iterator i = m_niChanges.begin (); i != nowIterator; i++)
-        {
-          m_firstPower += i->GetDelta ();
-        }
-      m_niChanges.erase (m_niChanges.begin (), nowIterator);
-      m_niChanges.insert (m_niChanges.begin (), NiChange (event->GetStartTime (), event->GetRealRxPowerW ())); //160413 skim11 : channel bug fix
-    }
-  else
-    {
-      AddNiChangeEvent (NiChange (event->GetStartTime (), event->GetRealRxPowerW ()));//160413 skim11 : channel bug fix
+      // the changes left are after now, the start of the event is the
+      // first change of this subchannel
+      m_timeline->Prune (m_subchannel, now);
     }
-  AddNiChangeEvent (NiChange (event->GetEndTime (), -event->GetRealRxPowerW ()));//160413 skim11 : channel bug fix
+  m_timeline->Add (m_subchannel, event->GetStartTime (), event->GetRealRxPowerW ());//160413 skim11 : channel bug fix
+  m_timeline->Add (m_subchannel, event->GetEndTime (), -event->GetRealRxPowerW ());//160413 skim11 : channel bug fix
 
 }
 
@@ -279,6 +464,14 @@ double
 InterferenceHelper::CalculateSnr (double signal, double noiseInterference, WifiTxVector txVector)
 {
 	NS_LOG_DEBUG("signal " << signal << " noise " << noiseInterference << " nss " << (int) txVector.GetNss() << " mode " << txVector.GetMode() << " bw " << (int)txVector.GetBandwidth());
+  double sinr[4];
+  CalculateStreamSinr (signal, noiseInterference, txVector, sinr);
+  return CalculateEffectiveSnr (txVector.GetMode (), sinr, txVector.GetNss ());
+}
+
+void
+InterferenceHelper::CalculateStreamSinr (double signal, double noiseInterference, WifiTxVector txVector, double sinr[]) const
+{
   // thermal noise at 290K in J/s = W
   static const double BOLTZMANN = 1.3803e-23;
   // Nt is the power of thermal noise in W
@@ -293,151 +486,23 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, WifiT
 
   if (nss == 1)
   {
-    std::complex<double> **ch = new std::complex<double> *[nss];
-    for (int i=0;i<nss;i++)
-  	  ch[i] = new std::complex<double>[nss];
-    txVector.GetChannelMatrix (ch);
-    double a = ch[0][0].real();
-    double b = ch[0][0].imag();
-    double squareValue = (a*a + b*b);
-    snr = snr*squareValue/2; 
-      for(int j=0; j<nss; j++)
-      {
-        delete [] ch[j];
-      }
-      delete [] ch;
-    return snr;
+    std::complex<double> ch;
+    txVector.GetChannelMatrix (&ch, 0);
+    sinr[0] = snr*std::norm (ch)/2;
+    return;
   }
 
-  std::complex<double> **ch = new std::complex<double> *[nss];
-  for (int i=0;i<nss;i++)
-  	{
-  	ch[i] = new std::complex<double>[nss];
-  	}
-  std::complex<double> **mmse = new std::complex<double> *[nss];
-  std::complex<double> **temp = new std::complex<double> *[nss];
-  for (int i=0;i<nss;i++)
-  	{
-  	mmse[i] = new std::complex<double>[nss];
-	temp[i] = new std::complex<double>[nss];
-  	}
-
-  for (int i=0;i<nss;i++)
-  	for (int j=0;j<nss;j++)
-	{	mmse[i][j] = RTx[i][j]; //mmse = RTx
-	}
-
-  txVector.GetChannelMatrix(ch);
-
-  //shbyeon bug report : input channel variance 1
-  for (int i=0;i<nss;i++)
-  	for (int j=0;j<nss;j++)
-	{	ch[i][j] /= std::sqrt(2);
-	}
-
-  MtxMultiplication(ch, mmse, nss, temp); //temp = ch*RTx
-  for (int i=0;i<nss;i++)
-  	for (int j=0;j<nss;j++)
-	{	mmse[i][j] = RRx[i][j]; //mmse = RRx
-	}
-
-  if (m_antennaCorrelation)
-      {MtxMultiplication(mmse, temp, nss, ch); }//ch = RRx*ch*RTx: channel which reflect antenna correlation
-  	
-  for (int i=0;i<nss;i++)
-  	for (int j=0;j<nss;j++)
-	{	temp[i][j] = ch[i][j];}
-
-  
-  Hermitian(temp, nss); //temp = hermitian(ch)
-  MtxMultiplication(temp, ch, nss, mmse); //mmse = hermitian(ch)*ch
-  
-  for(int i=0;i<nss;i++)
-      mmse[i][i].real() +=noise*nss /signal; //mmse = hermitian(ch)*ch + N0I
-
-  Inverse(mmse, nss, temp); //temp = inverse(hermitian(ch)*ch + N0I)
-  Hermitian(ch, nss); //ch = hermitian(ch)
-  MtxMultiplication(temp, ch, nss, mmse); //mmse = MMSE weight matrix
-  Hermitian(ch, nss); //ch = ch
-  Transpose(ch, nss); //ch = transpose(ch)
-
-  double *sinr = new double[nss];
-  double interference;
-  double noiseAmplification;
-  for (int i=0; i<nss; i++)
-  {
-      interference = 0;
-      noiseAmplification = 0;  
-      for (int j=0; j<nss; j++)
-      {
-         noiseAmplification += std::norm (mmse[i][j]) ;
-         if (j!=i)
-         {	interference += std::norm(VectorMultiplication(mmse[i],ch[j],nss));}
-      	}
-	interference += nss*noise*noiseAmplification/signal;
-	sinr[i] = std::norm(VectorMultiplication(mmse[i],ch[i],nss)) / interference;	
-  }
-  
-  for(int i=0; i<nss;i++)
-  {
-  delete [] ch[i];
-  delete [] mmse[i];
-  delete [] temp[i];
-  }
-  delete [] ch;
-  delete [] mmse;
-  delete [] temp;
-  
-  uint8_t cons_mode;
-  switch (txVector.GetMode().GetConstellationSize () ) 
-  {
-	case 2:cons_mode=0; break;
-	case 4:cons_mode=1; break;
-	case 16:cons_mode=2; break;
-	case 64:cons_mode=3; break;
-	default:cons_mode=0; 
-  }
-
-  double eesm = 0;
-  double esnr ;
-  uint8_t snr_idx ;
-  double min_sinr = 100;
-  for (int i=0; i<nss; i++)
-  {
-     sinr[i] = 10.0*std::log10(sinr[i]);
-     if (sinr[i] < min_sinr)
-	 {	min_sinr = sinr[i];}
-     if (sinr[i] < -20.0){sinr[i]= -20.0;}
-     if (sinr[i] > 27.0){sinr[i]= 27.0;}
-     snr_idx = (uint8_t)( (sinr[i]+20)*2 );
-     eesm += RBIR[	cons_mode][snr_idx];
-     
-  }
-  eesm /= nss;
-  
-  delete [] sinr;
-
-  uint8_t current, prev = 0;
-  for (int sidx =0; sidx<95; sidx++)
-  {
-	current = sidx;
-	if (eesm <= RBIR[cons_mode][sidx])
-	{	break;}
-       prev = sidx;
-  }
-  if ( (RBIR[cons_mode][current]-eesm) > (eesm-RBIR[cons_mode][prev]) )
-  	{esnr = prev;}
-  else
-  	{esnr = current;}
-  esnr = esnr/2 - 20;
-  if(esnr < min_sinr)
-  	{esnr = min_sinr;}
-
-
-  esnr = std::pow (10.0, esnr/10.0);
+  CalculateMmseSinr (signal, noise, txVector, 0, sinr);
+}
 
-  //return snr;
-  return esnr;
+double
+InterferenceHelper::CalculateEffectiveSnr (WifiMode mode, const double sinr[], uint8_t nss) const
+{
+  if (nss == 1)
+    {
+      return sinr[0];
+    }
+  return m_effectiveSnrMapping->GetEffectiveSnr (mode, sinr, nss);
 }
 
 double
@@ -463,25 +528,20 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, WifiT
 
   if (nss == 1)
   { 
-    std::complex<double> **ch = new std::complex<double> *[nss];
-    std::complex<double> **ch2 = new std::complex<double> *[nss];
-    for (int i=0;i<nss;i++)
-    {
-      ch[i] = new std::complex<double>[nss];
-      ch2[i] = new std::complex<double>[nss];
-    }
-    txVector.GetChannelMatrix(ch);
-    txVector.GetChannelMatrix(ch2, subframeIdx);
+    std::complex<double> ch;
+    txVector.GetChannelMatrix (&ch, 0);
 
-    double a = ch[0][0].real();
-    double b = ch[0][0].imag();
+    double a = ch.real();
+    double b = ch.imag();
     double squareValue = (a*a + b*b);
     snr = snr*squareValue/2; 
     
     if(caudalOn && subframeIdx > 0)
     {
-      double c = ch2[0][0].real();
-      double d = ch2[0][0].imag();
+      std::complex<double> ch2;
+      txVector.GetChannelMatrix (&ch2, subframeIdx);
+      double c = ch2.real();
+      double d = ch2.imag();
       double numer = (squareValue-a*c-b*d)*(squareValue-a*c-b*d)+(a*d-b*c)*(a*d-b*c);
       double noise_mob = numer/squareValue * signal / 2;
       double newSnr = signal * squareValue/2 / (noise + noise_mob) ;
@@ -490,201 +550,42 @@ InterferenceHelper::CalculateSnr (double signal, double noiseInterference, WifiT
     }
     else
       NS_LOG_DEBUG("org=" << 10*log10(snr) << " " << subframeIdx <<"th MPDU's=" << 10*log10(snr));
-    for(int j=0; j<nss; j++)
-    {
-      delete [] ch[j];
-      delete [] ch2[j];
-    }
-    delete [] ch;
-    delete [] ch2;
     return snr;
   }
-  
- 
-
-  std::complex<double> **ch = new std::complex<double> *[nss];
-  std::complex<double> **ch2 = new std::complex<double> *[nss];
-  for (int i=0;i<nss;i++)
-  	{
-  	ch[i] = new std::complex<double>[nss];
-  	ch2[i] = new std::complex<double>[nss];
-  	}
-  std::complex<double> **mmse = new std::complex<double> *[nss];
-  std::complex<double> **temp = new std::complex<double> *[nss];
-  for (int i=0;i<nss;i++)
-  	{
-  	mmse[i] = new std::complex<double>[nss];
-	temp[i] = new std::complex<double>[nss];
-  	}
-
-  for (int i=0;i<nss;i++)
-  	for (int j=0;j<nss;j++)
-	{	mmse[i][j] = RTx[i][j]; //mmse = RTx
-	}
-
-  txVector.GetChannelMatrix(ch);
-
-  //shbyeon bug report : input channel variance 1
-  for (int i=0;i<nss;i++)
-  	for (int j=0;j<nss;j++)
-	{	ch[i][j] /= std::sqrt(2);
-	}
-
-  MtxMultiplication(ch, mmse, nss, temp); //temp = ch*RTx
-  for (int i=0;i<nss;i++)
-  	for (int j=0;j<nss;j++)
-	{ mmse[i][j] = RRx[i][j]; //mmse = RRx
-	}
-
-  if (m_antennaCorrelation)
-      {MtxMultiplication(mmse, temp, nss, ch); }//ch = RRx*ch*RTx: channel which reflect antenna correlation
-  	
-  for (int i=0;i<nss;i++)
-  	for (int j=0;j<nss;j++)
-	{	temp[i][j] = ch[i][j];}
-
-  
-  Hermitian(temp, nss); //temp = hermitian(ch)
-  MtxMultiplication(temp, ch, nss, mmse); //mmse = hermitian(ch)*ch
-  
-  for(int i=0;i<nss;i++)
-      mmse[i][i].real() +=noise*nss /signal; //mmse = hermitian(ch)*ch + N0I
-
-  Inverse(mmse, nss, temp); //temp = inverse(hermitian(ch)*ch + N0I)
-  Hermitian(ch, nss); //ch = hermitian(ch)
-  MtxMultiplication(temp, ch, nss, mmse); //mmse = MMSE weight matrix
-  Hermitian(ch, nss); //ch = ch
-  Transpose(ch, nss); //ch = transpose(ch)
 
-  double noise_mob[nss];
-  for (int i=0;i<nss;i++)
-    noise_mob[i] = 0;
-
-  if(caudalOn && subframeIdx > 0)
-  {
-    txVector.GetChannelMatrix(ch2, subframeIdx);
-
-    //shbyeon bug report : input channel variance 1
-    for (int i=0;i<nss;i++)
-  	  for (int j=0;j<nss;j++)
-		  ch2[i][j] /= std::sqrt(2);
-	
-    Transpose(ch2, nss);
-
-    for(int i=0; i<nss; i++)
-    {
-//      double sgain = std::norm(VectorMultiplication(mmse[i],ch[i],nss));
-      for(int j=0; j<nss; j++)
-      {
-        std::complex<double> *chdiff = new std::complex<double>[nss];
-        for(int l = 0; l<nss; l++){
-            chdiff[l] = ch[j][l] - ch2[j][l];
-            NS_LOG_DEBUG(subframeIdx << "th frame, channel diff of" << l << " and " << j << " =" << chdiff[l]); 
-        }
-        double nmob = std::norm(VectorMultiplication(mmse[i],chdiff,nss));
-        //double nmob = std::norm(VectorMultiplication(mmse[i],chdiff,nss))*std::norm(VectorMultiplication(mmse[i],ch[j],nss));
-        noise_mob[i] += nmob;
-        delete [] chdiff;
-      }
-//      noise_mob[i] *= 1/sgain;
-    }
-  }
-
-  double *sinr = new double[nss];
-  double interference;
-  double noiseAmplification;
+  double sinr[4];
+  CalculateMmseSinr (signal, noise, txVector, caudalOn ? subframeIdx : 0, sinr);
   for (int i=0; i<nss; i++)
-  {
-    interference = 0;
-    noiseAmplification = 0;  
-    for (int j=0; j<nss; j++)
-    {
-      noiseAmplification += std::norm (mmse[i][j]) ;
-      if (j!=i)
-      	interference += std::norm(VectorMultiplication(mmse[i],ch[j],nss));
-    }
-    interference += nss*noise*noiseAmplification/signal;
-    sinr[i] = std::norm(VectorMultiplication(mmse[i],ch[i],nss)) / (interference+noise_mob[i]);
-    NS_LOG_DEBUG("sinr of " << i << "th stream=" << 10*log10(sinr[i]) << " if=" << 10*log10(interference) << " Nmob=" << noise_mob[i]);
-  }
-
-  for(int i=0; i<nss;i++)
-  {
-  delete [] ch[i];
-  delete [] ch2[i];
-  delete [] mmse[i];
-  delete [] temp[i];
-  }
-  delete [] ch;
-  delete [] ch2;
-  delete [] mmse;
-  delete [] temp;
+    NS_LOG_DEBUG("sinr of " << i << "th stream=" << 10*log10(sinr[i]));
   
-  uint8_t cons_mode;
-  switch (txVector.GetMode().GetConstellationSize () ) 
-  {
-	case 2:cons_mode=0; break;
-	case 4:cons_mode=1; break;
-	case 16:cons_mode=2; break;
-	case 64:cons_mode=3; break;
-	default:cons_mode=0; 
-  }
-
-  double eesm = 0;
-  double esnr ;
-  uint8_t snr_idx ;
-  double min_sinr = 100;
-  for (int i=0; i<nss; i++)
-  {
-     sinr[i] = 10.0*std::log10(sinr[i]);
-     if (sinr[i] < min_sinr)
-	 {	min_sinr = sinr[i];}
-     if (sinr[i] < -20.0){sinr[i]= -20.0;}
-     if (sinr[i] > 27.0){sinr[i]= 27.0;}
-     snr_idx = (uint8_t)( (sinr[i]+20)*2 );
-     eesm += RBIR[	cons_mode][snr_idx];
-     
-  }
-  eesm /= nss;
-  
-  delete [] sinr;
-
-  uint8_t current, prev = 0;
-  for (int sidx =0; sidx<95; sidx++)
-  {
-	current = sidx;
-	if (eesm <= RBIR[cons_mode][sidx])
-	{	break;}
-       prev = sidx;
-  }
-  if ( (RBIR[cons_mode][current]-eesm) > (eesm-RBIR[cons_mode][prev]) )
-  	{esnr = prev;}
-  else
-  	{esnr = current;}
-  esnr = esnr/2 - 20;
-  if(esnr < min_sinr)
-  	{esnr = min_sinr;}
-
-
-  esnr = std::pow (10.0, esnr/10.0);
+  double esnr = m_effectiveSnrMapping->GetEffectiveSnr (txVector.GetMode (), sinr, nss);
   NS_LOG_DEBUG("esnr=" << 10*std::log10(esnr)); 
   return esnr;
 }
 double
 InterferenceHelper::CalculateNoiseInterferenceW (Ptr<InterferenceHelper::Event> event, NiChanges *ni) const
 {
-  double noiseInterference = m_firstPower;
+  double noiseInterference = m_timeline->GetFirstPower (m_subchannel);
   NS_ASSERT (m_rxing);
-  for (NiChanges::const_iterator i = m_niChanges.begin () + 1; i != m_niChanges.end (); i++)
+  // the first change is the start of the event, the view stops at the
+  // end of the event
+  InterferenceTimeline::Iterator first = m_timeline->Begin (m_subchannel);
+  InterferenceTimeline::Iterator last = m_timeline->End (m_subchannel);
+  NS_ASSERT (first != last);
+  InterferenceTimeline::Iterator begin = first;
+  begin++;
+  InterferenceTimeline::Iterator stop = begin;
+  uint32_t n = 0;
+  double rxPowerW = event->GetRealRxPowerW ();
+  while (stop != last
+         && !((event->GetEndTime () == stop->first) && rxPowerW == -stop->second))
     {
-      if ((event->GetEndTime () == i->GetTime ()) && event->GetRealRxPowerW () == -i->GetDelta ())
-        {
-          break;
-        }
-      ni->push_back (*i);
+      stop++;
+      n++;
     }
-  ni->insert (ni->begin (), NiChange (event->GetStartTime (), noiseInterference));
-  ni->push_back (NiChange (event->GetEndTime (), 0));
+  ni->Set (m_timeline,
+           NiChange (event->GetStartTime (), noiseInterference), begin, stop, n,
+           NiChange (event->GetEndTime (), 0));
   return noiseInterference;
 }
 
@@ -1024,9 +925,12 @@ InterferenceHelper::CalculateAmpduSubframePer (WifiMode payloadMode,double snr,
 
 //802.11ac channel bonding: per mpdu error calculation
 std::list<struct InterferenceHelper::SnrPer>
-InterferenceHelper::CalculateAmpduSnrPer (Ptr<InterferenceHelper::Event> event, uint32_t size, uint16_t ampduSize, Ptr<Packet> packet)
+InterferenceHelper::CalculateAmpduSnrPer (Ptr<InterferenceHelper::Event> event)
 {
 	NS_LOG_FUNCTION(this);
+  Ptr<const AmpduSubframes> subframes = event->GetTxVector ().GetAmpduSubframes ();
+  NS_ASSERT (subframes != 0);
+  uint16_t ampduSize = subframes->GetN ();
   NiChanges ni;
   double noiseInterferenceW = CalculateNoiseInterferenceW (event, &ni);
   double snr = CalculateSnr (event->GetRxPowerW (),
@@ -1042,7 +946,7 @@ InterferenceHelper::CalculateAmpduSnrPer (Ptr<InterferenceHelper::Event> event,
     sinr[k]=0;
   }
   sinr[0] = snr;
-  CalculateAmpduPer(event, &ni, packet, per, sinr);
+  CalculateAmpduPer(event, &ni, subframes, per, sinr);
   struct SnrPer snrPer;
   for(k=0;k<ampduSize+1;k++)
   {
@@ -1054,15 +958,9 @@ InterferenceHelper::CalculateAmpduSnrPer (Ptr<InterferenceHelper::Event> event,
   return snrPers;
 }
 
-void
-InterferenceHelper::DeleteChannelMatrix(Ptr<const InterferenceHelper::Event> event)
-{
-  event->GetTxVector().DeleteChannelMatrix();
-}
-
 //shbyeon ampdu per calculation
 void
-InterferenceHelper::CalculateAmpduPer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni, Ptr<Packet> packet, double per[], double sinr[]) 
+InterferenceHelper::CalculateAmpduPer (Ptr<const InterferenceHelper::Event> event, NiChanges *ni, Ptr<const AmpduSubframes> subframes, double per[], double sinr[]) 
 {
 	NS_LOG_FUNCTION(this);
   NiChanges::iterator j = ni->begin ();
@@ -1076,12 +974,10 @@ InterferenceHelper::CalculateAmpduPer (Ptr<const InterferenceHelper::Event> even
   double noiseInterferenceW = (*j).GetDelta ();
   double powerW = event->GetRxPowerW ();
   NS_LOG_DEBUG("Preamble RxPower=" << 10*log10(powerW));
-  double ampduSize = packet->GetSize();
+  double ampduSize = subframes->GetPsduSize ();
   uint16_t bw = payloadMode.GetBandwidth()/1000000;
   //shbyeon ampdu subframe time location
-  MpduAggregator::DeaggregatedMpdus packets;
-  packets = MpduAggregator::Deaggregate(packet);
-  uint16_t numOfSubframe = packets.size();
+  uint16_t numOfSubframe = subframes->GetN ();
   double psr[numOfSubframe+1];
   uint16_t k=0;
   Time subframeDuration_us[numOfSubframe+1];
@@ -1097,33 +993,31 @@ InterferenceHelper::CalculateAmpduPer (Ptr<const InterferenceHelper::Event> even
   j++;
 
   //shbyeon set subframe transmission time
-  Time ampduTime = (*(--ni->end())).GetTime() - plcpPayloadStart;
+  Time ampduTime = ni->back ().GetTime () - plcpPayloadStart;
   uint16_t subframeIndex = 1;
-  for (MpduAggregator::DeaggregatedMpdusCI i = packets.begin();
-      i != packets.end(); ++i)
+  for (; subframeIndex <= numOfSubframe; subframeIndex++)
   {
     if (subframeIndex == numOfSubframe)
     {
-      subframeDuration_us[numOfSubframe] = (*(--ni->end())).GetTime();
+      subframeDuration_us[numOfSubframe] = ni->back ().GetTime ();
     }
     else
     {
       subframeDuration_us[subframeIndex] = subframeDuration_us[subframeIndex-1]
-        + MicroSeconds(ampduTime.GetMicroSeconds() *(*i).first->GetSize()/ampduSize);
+        + MicroSeconds(ampduTime.GetMicroSeconds() *subframes->GetLength (subframeIndex-1)/ampduSize);
     }
-    subframeIndex++;
   }
 
   subframeIndex=0;
 
   NS_LOG_DEBUG("subframeEnd=" << subframeDuration_us[numOfSubframe] <<
-      ", nichangeEnd=" << (*(--ni->end())).GetTime() << 
-      ", diff=" << subframeDuration_us[numOfSubframe] - (*(--ni->end())).GetTime() <<
+      ", nichangeEnd=" << ni->back ().GetTime () << 
+      ", diff=" << subframeDuration_us[numOfSubframe] - ni->back ().GetTime () <<
       ", datarate=" << (double)payloadMode.GetDataRate()/1000000);
   
   while(ni->end () != j)
   {
-  	if (subframeIndex > packets.size())//160404 skim11 
+  	if (subframeIndex > numOfSubframe)//160404 skim11 
 			break;
     Time current = (*j).GetTime ();
     NS_LOG_DEBUG("previous="<< previous << " current=" << current << ", subframeIndex=" << subframeIndex << ", nisize=" << ni->size());
@@ -1138,7 +1032,7 @@ InterferenceHelper::CalculateAmpduPer (Ptr<const InterferenceHelper::Event> even
         sinr[subframeIndex] = CalculateSnr (powerW, noiseInterferenceW, txVector, subframeIndex); 
         previous = subframeDuration_us[subframeIndex];
         
-        if(subframeIndex == packets.size()+0)//160404 skim11 +1 -> +0
+        if(subframeIndex == numOfSubframe+0)//160404 skim11 +1 -> +0
         {
           noiseInterferenceW += (*j).GetDelta ();
           previous = (*j).GetTime ();
@@ -1281,20 +1175,8 @@ InterferenceHelper::CalculatePlcpSnrPer(Ptr<InterferenceHelper::Event> event)
 void
 InterferenceHelper::EraseEvents (void)
 {
-  m_niChanges.clear ();
+  m_timeline->Clear (m_subchannel);
   m_rxing = false;
-  m_firstPower = 0.0;
-}
-InterferenceHelper::NiChanges::iterator
-InterferenceHelper::GetPosition (Time moment)
-{
-  return std::upper_bound (m_niChanges.begin (), m_niChanges.end (), NiChange (moment, 0));
-
-}
-void
-InterferenceHelper::AddNiChangeEvent (NiChange change)
-{
-  m_niChanges.insert (GetPosition (change.GetTime ()), change);
 }
 void
 InterferenceHelper::NotifyRxStart ()
@@ -1308,154 +1190,63 @@ InterferenceHelper::NotifyRxEnd ()
 }
 
 //11ac: mutiple_stream_tx_per 
-std::complex<double> 
-InterferenceHelper::Determinant (std::complex<double> **mtx, int size)
- {
-   
-   std::complex<double> det = std::complex<double>(0,0);
-   
-
-   if (size< 1) { /* Error */   }
-   else if (size== 1) 
-   { /* Shouldn't get used */
-   	det = mtx[0][0];
-    }
-   else if (size == 2) 
-   {
-      det = mtx[0][0] * mtx[1][1] - mtx[1][0] * mtx[0][1];
-   } 
-   else 
-   {
-   
-      int i,j,j1,j2;
-      std::complex<double> **m = new std::complex<double> *[size];
-      for (int i=0;i<size;i++)
-     {
-  	 m[i] = new std::complex<double>[size];
-     }
-        for (j1=0;j1<size;j1++) 
-      {
-         for (i=1;i<size;i++) 
-	  {
-            j2 = 0;
-            for (j=0;j<size;j++) 
-	     {
-               if (j == j1)
-                  continue;
-               m[i-1][j2] = mtx[i][j];
-               j2++;
-            }
-         }
-         det += std::pow(-1.0,j1+2.0) * mtx[0][j1] * Determinant(m,size-1);
-      }
-      
-      for(int i=0; i<size;i++)
-	{
-	  delete [] m[i];
-	}
-      delete [] m;
-
-   }
-   //NS_LOG_DEBUG("determinant: "<<det);
-   //NS_LOG_DEBUG("mtx: "<<mtx[0][0]<<"  "<<mtx[0][1]<<"  "<<mtx[1][0]<<"  "<<mtx[1][1]);
-   return(det);
- }
-void 
-InterferenceHelper::Inverse (std::complex<double> **mtx, int size, std::complex<double> **cmtx)
+void
+InterferenceHelper::CalculateMmseSinr (double signal, double noise, WifiTxVector txVector, uint16_t subframeIdx, double sinr[]) const
 {
-   int i,j,ii,jj,i1,j1;
-   std::complex<double> det;
-   std::complex<double> **c = new std::complex<double> *[size];
-   for (int i=0;i<size;i++)
-   {
-  	 c[i] = new std::complex<double>[size];
-   }
+  uint8_t nss = txVector.GetNss ();
+  NS_ASSERT (nss >= 1 && nss <= 4);
+  Ptr<const ChannelMatrix> channel = txVector.GetChannelMatrix ();
+  NS_ASSERT (channel != 0 && channel->GetNss () == nss);
+  const std::complex<double> *h = channel->GetMatrix (0);
 
-   for (j=0;j<size;j++) {
-      for (i=0;i<size;i++) {
-
-         /* Form the adjoint a_ij */
-         i1 = 0;
-         for (ii=0;ii<size;ii++) {
-            if (ii == i)
-               continue;
-            j1 = 0;
-            for (jj=0;jj<size;jj++) {
-               if (jj == j)
-                  continue;
-               c[i1][j1] = mtx[ii][jj];
-               j1++;
-            }
-            i1++;
-         }
+  //shbyeon bug report : input channel variance 1
+  std::complex<double> ch[16];
+  for (int i=0;i<nss*nss;i++)
+    ch[i] = h[i]/std::sqrt(2);
 
-         /* Calculate the determinate */
-         det = Determinant(c,size-1);
+  if (m_antennaCorrelation)
+    {
+      //ch = RRx*ch*RTx: channel which reflect antenna correlation
+      std::complex<double> temp[16];
+      for (int i=0;i<nss;i++)
+        for (int j=0;j<nss;j++)
+          {
+            temp[i*nss+j] = 0;
+            for (int k=0;k<nss;k++)
+              temp[i*nss+j] += ch[i*nss+k]*RTx[k][j];
+          }
+      for (int i=0;i<nss;i++)
+        for (int j=0;j<nss;j++)
+          {
+            ch[i*nss+j] = 0;
+            for (int k=0;k<nss;k++)
+              ch[i*nss+j] += RRx[i][k]*temp[k*nss+j];
+          }
+    }
 
-         /* Fill in the elements of the cofactor */
-         cmtx[i][j] = std::pow(-1.0,i+j+2.0) * det;
-      }
-   }
-   for(int i=0; i<size;i++)
-   {
-      delete [] c[i];
-   }
-   delete [] c;
-   Transpose(cmtx,size);
-   std::complex<double> determinant = Determinant(mtx,size);
-   for(int i=0;i<size;i++)
-   	for(int j=0; j<size; j++)
-		cmtx[i][j] /=determinant;
-	
-}
-void 
-InterferenceHelper::Transpose (std::complex<double> **mtx, int size)
-{
-   int i,j;
-   std::complex<double> tmp;
+  double hRe[16], hIm[16];
+  for (int i=0;i<nss*nss;i++)
+    {
+      hRe[i] = ch[i].real ();
+      hIm[i] = ch[i].imag ();
+    }
 
-   for (i=1;i<size;i++) {
-      for (j=0;j<i;j++) {
-         tmp = mtx[i][j];
-         mtx[i][j] = mtx[j][i];
-         mtx[j][i] = tmp;
-      }
-   }
-}
-void 
-InterferenceHelper::Hermitian (std::complex<double> **mtx, int size)
-{
-   Transpose(mtx,size);
-   for (int i=0;i<size;i++) {
-      for (int j=0;j<size;j++) {
-         mtx[i][j] = std::conj(mtx[i][j]);
-      }
-   }
-}
-void 
-InterferenceHelper::MtxMultiplication (std::complex<double> **mtx1, std::complex<double> **mtx2, int size, std::complex<double> **cmtx)
-{
-  for (int i=0;i<size;i++)
-  {
-  for (int j=0;j<size;j++)
-  	{
-		cmtx[i][j]=0;
-		for (int k=0;k<size;k++)
-  		{
-           	    cmtx[i][j] += mtx1[i][k]*mtx2[k][j]; 
-  		}
-  	}
-  }  		
-}
-std::complex<double>
-InterferenceHelper::VectorMultiplication (std::complex<double> *vt1, std::complex<double> *vt2, int size)
-{
-  std::complex<double> innerproduct = std::complex<double>(0,0);
-  for (int i=0;i<size;i++)
-  {
-      innerproduct += vt1[i]*vt2[i];
-  }		
-  return innerproduct;
+  if (subframeIdx == 0)
+    {
+      MimoMmseSinr (nss, hRe, hIm, 0, 0, noise*nss/signal, sinr);
+      return;
+    }
+
+  //caudal loss: mismatch between the estimated channel and the one of the subframe
+  const std::complex<double> *ch2 = channel->GetMatrix (subframeIdx);
+  double dRe[16], dIm[16];
+  for (int i=0;i<nss*nss;i++)
+    {
+      std::complex<double> diff = ch[i] - ch2[i]/std::sqrt(2);
+      dRe[i] = diff.real ();
+      dIm[i] = diff.imag ();
+    }
+  MimoMmseSinr (nss, hRe, hIm, dRe, dIm, noise*nss/signal, sinr);
 }
 
 //160328 skim11
@@ -23,6 +23,7 @@
 #include <stdint.h>
 #include <vector>
 #include <list>
+#include <map>
 #include "wifi-mode.h"
 #include "wifi-preamble.h"
 #include "wifi-phy-standard.h"
@@ -35,6 +36,68 @@
 namespace ns3 {
 
 class ErrorRateModel;
+class EffectiveSnrMapping;
+
+/**
+ * \ingroup wifi
+ * \brief Noise and interference changes of the 20 MHz subchannels of a PHY.
+ *
+ * 802.11ac channel bonding: the InterferenceHelper of every subchannel of
+ * a YansWifiPhy records its changes in the same timeline. Each subchannel
+ * has its own changes, sorted by time in a balanced tree, changes at the
+ * same time in insertion order, so adding one is O(log n). The changes of
+ * a subchannel which are over are folded into the first power of the
+ * subchannel and removed from the front of its tree.
+ */
+class InterferenceTimeline : public SimpleRefCount<InterferenceTimeline>
+{
+public:
+  /// power changes (W) of one subchannel, sorted by time
+  typedef std::multimap<Time, double> Changes;
+  typedef Changes::const_iterator Iterator;
+
+  InterferenceTimeline ();
+
+  /**
+   * \param subchannel the subchannel
+   * \param time the time of the change
+   * \param delta the power change (W)
+   */
+  void Add (uint8_t subchannel, Time time, double delta);
+  /**
+   * Fold the changes of the subchannel up to and including the given
+   * time into the first power of the subchannel, and remove them.
+   *
+   * \param subchannel the subchannel
+   * \param moment the time
+   */
+  void Prune (uint8_t subchannel, Time moment);
+  /**
+   * Remove all the changes of the subchannel and reset its first power.
+   *
+   * \param subchannel the subchannel
+   */
+  void Clear (uint8_t subchannel);
+  /**
+   * \param subchannel the subchannel
+   * \return the power (W) before the first change of the subchannel
+   */
+  double GetFirstPower (uint8_t subchannel) const;
+  /**
+   * \param subchannel the subchannel
+   * \return the first change of the subchannel, or End (subchannel)
+   */
+  Iterator Begin (uint8_t subchannel) const;
+  /**
+   * \param subchannel the subchannel
+   * \return the end of the changes of the subchannel
+   */
+  Iterator End (uint8_t subchannel) const;
+
+private:
+  Changes m_changes[4];
+  double m_firstPower[4];
+};
 
 /**
  * \ingroup wifi
@@ -146,6 +209,12 @@ private:
    * \param rate Error rate model
    */
   void SetErrorRateModel (Ptr<ErrorRateModel> rate);
+  /**
+   * Set the mapping of the SINRs of the spatial streams to one SNR.
+   *
+   * \param mapping the effective SNR mapping
+   */
+  void SetEffectiveSnrMapping (Ptr<EffectiveSnrMapping> mapping);
 
   //11ac: mutiple_stream_tx_per
   void SetAntennaCorrelation (bool antennaCorrelation); 
@@ -162,6 +231,10 @@ private:
    * \return Error rate model
    */
   Ptr<ErrorRateModel> GetErrorRateModel (void) const;
+  /**
+   * \return the effective SNR mapping
+   */
+  Ptr<EffectiveSnrMapping> GetEffectiveSnrMapping (void) const;
 
 
   /**
@@ -198,7 +271,14 @@ private:
   
   
   //802.11ac channel bonding: shbyeon phy module for ampdu reception
-  std::list<struct InterferenceHelper::SnrPer> CalculateAmpduSnrPer (Ptr<InterferenceHelper::Event> event, uint32_t size, uint16_t ampduSize, Ptr<Packet> packet);
+  /**
+   * The layout of the A-MPDU is read from the AmpduSubframes of the
+   * TXVECTOR of the event.
+   *
+   * \param event the A-MPDU reception
+   * \return the SNR and PER of the PLCP header, then of every subframe
+   */
+  std::list<struct InterferenceHelper::SnrPer> CalculateAmpduSnrPer (Ptr<InterferenceHelper::Event> event);
   struct InterferenceHelper::SnrPer CalculatePlcpSnrPer (Ptr<InterferenceHelper::Event> event);
   /**
    * Notify that RX has started.
@@ -212,6 +292,16 @@ private:
    * Erase all events.
    */
   void EraseEvents (void);
+  /**
+   * 802.11ac channel bonding: record the changes in a timeline shared
+   * with the helpers of the other subchannels of the PHY. A helper which
+   * is never attached uses a timeline of its own. Copies of a helper
+   * share its timeline.
+   *
+   * \param timeline the timeline
+   * \param subchannel the subchannel of this helper
+   */
+  void SetTimeline (Ptr<InterferenceTimeline> timeline, uint8_t subchannel);
 private:
   /**
    * Noise and Interference (thus Ni) event.
@@ -250,9 +340,67 @@ private:
     double m_delta;
   };
   /**
-   * typedef for a vector of NiChanges
+   * The NI changes seen during one reception: the NI power at the start
+   * of the event, the changes of the timeline until the end of the
+   * event, then the end of the event. The changes are read in place
+   * from the timeline, which must not change while the view is used.
    */
-  typedef std::vector <NiChange> NiChanges;
+  class NiChanges
+  {
+public:
+    class iterator
+    {
+public:
+      iterator ();
+      NiChange operator * () const;
+      iterator & operator ++ ();
+      iterator operator ++ (int);
+      bool operator == (const iterator &o) const;
+      bool operator != (const iterator &o) const;
+private:
+      friend class NiChanges;
+      enum State
+      {
+        FIRST,
+        TIMELINE,
+        LAST,
+        END
+      };
+      const NiChanges *m_ni;
+      enum State m_state;
+      InterferenceTimeline::Iterator m_it;
+    };
+
+    NiChanges ();
+    /**
+     * \param timeline the timeline
+     * \param first the start of the event, with the NI power at that time
+     * \param begin the first change of the timeline after the start
+     * \param stop the change which ends the view
+     * \param n the number of changes from begin to stop
+     * \param last the end of the event
+     */
+    void Set (Ptr<const InterferenceTimeline> timeline,
+              NiChange first, InterferenceTimeline::Iterator begin,
+              InterferenceTimeline::Iterator stop, uint32_t n, NiChange last);
+    iterator begin (void) const;
+    iterator end (void) const;
+    /**
+     * \return the end of the event
+     */
+    NiChange back (void) const;
+    /**
+     * \return the number of changes
+     */
+    uint32_t size (void) const;
+private:
+    Ptr<const InterferenceTimeline> m_timeline;
+    NiChange m_first;
+    InterferenceTimeline::Iterator m_begin;
+    InterferenceTimeline::Iterator m_stop;
+    uint32_t m_n;
+    NiChange m_last;
+  };
   /**
    * typedef for a list of Events
    */
@@ -289,6 +437,26 @@ private:
 public:
   double CalculateSnr (double signal, double noiseInterference, WifiTxVector txVector);
   double CalculateSnr (double signal, double noiseInterference, WifiTxVector txVector, uint16_t si);
+  /**
+   * The first half of CalculateSnr: the SINR of each spatial stream
+   * (post-MMSE if there are several), which does not depend on the MCS.
+   *
+   * \param signal the receive power (W)
+   * \param noiseInterference the interference power (W)
+   * \param txVector TXVECTOR carrying the channel matrix
+   * \param sinr the linear SINR of each stream (output, nss entries)
+   */
+  void CalculateStreamSinr (double signal, double noiseInterference, WifiTxVector txVector, double sinr[]) const;
+  /**
+   * The second half of CalculateSnr: the effective SNR of the streams
+   * with the mode, the SINR itself for a single stream.
+   *
+   * \param mode the mode
+   * \param sinr the linear SINR of each stream
+   * \param nss the number of streams
+   * \return the linear effective SNR
+   */
+  double CalculateEffectiveSnr (WifiMode mode, const double sinr[], uint8_t nss) const;
 
 
   /**
@@ -315,33 +483,28 @@ public:
   
 private:
 	//802.11ac channel bonding
-  void CalculateAmpduPer (Ptr<const Event> event, NiChanges *ni, Ptr<Packet> packet, double per[], double sinr[]);
-  void DeleteChannelMatrix (Ptr<const Event> event);
+  void CalculateAmpduPer (Ptr<const Event> event, NiChanges *ni, Ptr<const AmpduSubframes> subframes, double per[], double sinr[]);
 
   double m_noiseFigure; /**< noise figure (linear) */
   Ptr<ErrorRateModel> m_errorRateModel;
+  Ptr<EffectiveSnrMapping> m_effectiveSnrMapping;
   /// Experimental: needed for energy duration calculation
-  NiChanges m_niChanges;
-  double m_firstPower;
+  Ptr<InterferenceTimeline> m_timeline;
+  uint8_t m_subchannel;
   bool m_rxing;
-  /// Returns an iterator to the first nichange, which is later than moment
-  NiChanges::iterator GetPosition (Time moment);
+
+  //11ac: mutiple_stream_tx_per
   /**
-   * Add NiChange to the list at the appropriate position.
+   * Calculate the post-MMSE SINR of every spatial stream (see MimoMmse).
    *
-   * \param change
+   * \param signal the receive power (W)
+   * \param noise noise plus interference power (W)
+   * \param txVector TXVECTOR carrying the channel matrices
+   * \param subframeIdx index of the channel matrix of the subframe (caudal loss), 0 for none
+   * \param sinr the linear SINR of each stream (output, nss entries)
    */
-  void AddNiChangeEvent (NiChange change);
-
-  //11ac: mutiple_stream_tx_per
-  std::complex<double> Determinant (std::complex<double> **mtx, int size);
-  void Inverse (std::complex<double> **mtx, int size, std::complex<double> **cmtx);
-  void Transpose (std::complex<double> **mtx, int size);
-  void Hermitian (std::complex<double> **mtx, int size);
-  void MtxMultiplication (std::complex<double> **mtx1, std::complex<double> **mtx2, int size, std::complex<double> **cmtx);
-  std::complex<double> VectorMultiplication (std::complex<double> *vt1, std::complex<double> *vt2, int sizeulti);
+  void CalculateMmseSinr (double signal, double noise, WifiTxVector txVector, uint16_t subframeIdx, double sinr[]) const;
   //11ac: mutiple_stream_tx_per
-  static double RBIR[4][95]; 
   static std::complex<double> RTx[4][4]; 
   static std::complex<double> RRx[4][4]; 
 
@@ -27,6 +27,7 @@
 #include "ns3/log.h"
 #include "ns3/node.h"
 #include "ns3/double.h"
+#include "ns3/trace-source-accessor.h"
 
 #include "mac-low.h"
 #include "wifi-phy.h"
@@ -312,6 +313,22 @@ namespace ns3{
     };
 
 
+    NS_OBJECT_ENSURE_REGISTERED (MacLow);
+
+    TypeId
+        MacLow::GetTypeId (void)
+        {
+            static TypeId tid = TypeId ("ns3::MacLow")
+                .SetParent<Object> ()
+                .AddConstructor<MacLow> ()
+                .AddTraceSource ("AmpduDecision",
+                        "The MPDUs planned for an A-MPDU: the receiver, the TID, the number of MPDUs, "
+                        "the size of the PSDU and what ended the A-MPDU.",
+                        MakeTraceSourceAccessor (&MacLow::m_ampduDecisionTrace))
+                ;
+            return tid;
+        }
+
     MacLow::MacLow ()
         : m_operationalBandwidth (80),
         m_da(0),
@@ -395,7 +412,7 @@ namespace ns3{
 
     //802.11ac channel bonding
     bool
-        MacLow::RunningAckEvent(Time rxDuration, Ptr<Packet> packet)
+        MacLow::RunningAckEvent(Time rxDuration, Ptr<const Packet> packet)
         {
             bool waiting = false;
             bool sending = false;
@@ -2216,8 +2233,11 @@ rxPacket:
             else
                 preamble=WIFI_PREAMBLE_LONG;
 
+            NS_ASSERT (m_currentSubframes != 0 && m_currentSubframes->GetPsduSize () == m_currentPacket->GetSize ());
+            dataTxVector.SetAmpduSubframes (m_currentSubframes);
             ForwardDown (m_currentPacket, &m_currentHdr, dataTxVector, preamble);
             m_currentPacket = 0;
+            m_currentSubframes = 0;
         }
 
     //shbyeon send ampdu
@@ -2267,11 +2287,13 @@ rxPacket:
 
             NS_LOG_DEBUG("First Size with hdr/trailer: " << m_currentPacket->GetSize () );
 
-            Ptr<Packet> currentAggregatedPacket = Create<Packet> ();
-            aggregator->Aggregate (m_currentPacket, currentAggregatedPacket);
-
+            // the subframes are decided first, the A-MPDU is only built
+            // once, and the layout and the duration of the PSDU follow from
+            // the sizes of the MPDUs and the TX vector
+            m_ampduPlanner.Start (aggregator, dataTxVector);
+            m_ampduPlanner.Add (m_currentPacket);
 
-            NS_LOG_DEBUG("1st packet is aggregated size: " << currentAggregatedPacket->GetSize () );
+            NS_LOG_DEBUG("1st packet is aggregated size: " << m_ampduPlanner.GetPsduSize () );
             WifiPreamble preamble;       
             if (dataTxVector.GetMode().GetModulationClass () == WIFI_MOD_CLASS_VHT)
                 preamble= WIFI_PREAMBLE_VHT;
@@ -2281,9 +2303,10 @@ rxPacket:
                 preamble=WIFI_PREAMBLE_LONG;
 
             bool aggregated = false;
+            AmpduPlanner::Limit limit = AmpduPlanner::NO_MORE_MPDUS;
 
             WifiMacHeader nextHdr; 
-            int32_t maxAvailableLength = aggregator->GetMaxAvailableLength (currentAggregatedPacket);
+            int32_t maxAvailableLength = m_ampduPlanner.GetMaxAvailableLength ();
 
             //caudal loss
             Time maxAvailableDuration = Seconds(0);
@@ -2299,7 +2322,7 @@ rxPacket:
             else
                 maxAvailableDuration_ref = m_stationManager->GetAggrTime(m_currentHdr.GetAddr1(), &m_currentHdr);
             maxAvailableDuration = maxAvailableDuration_ref
-                - CalculateTxDuration (currentAggregatedPacket->GetSize (), dataTxVector, WIFI_PREAMBLE_LONG);
+                - m_ampduPlanner.CalculateTxDuration (m_ampduPlanner.GetPsduSize (), WIFI_PREAMBLE_LONG);
             NS_LOG_DEBUG ("maximum length for ampdu= " << maxAvailableLength 
                     << ", maximum duration for ampdu=" << maxAvailableDuration.GetMicroSeconds () 
                     << " us, m_maxPpduTime=" << m_maxPpduTime.GetMicroSeconds ()
@@ -2307,7 +2330,6 @@ rxPacket:
             Ptr<Packet> nextPacket = m_edca->GetNextPacketForAmpdu(nextHdr, maxAvailableLength, 
                     maxAvailableDuration);
 
-            int k = 1;
             while (nextPacket != 0 )
             {
                 NS_LOG_DEBUG("nextPacket: "<< nextPacket <<
@@ -2328,12 +2350,11 @@ rxPacket:
                     nextPacket->AddPacketTag (AmpduTag (false));
 
                 NS_LOG_DEBUG("Nextpacket Size with hdr/trailer: " << nextPacket->GetSize () );
-                aggregated = aggregator->Aggregate (nextPacket, currentAggregatedPacket);
+                aggregated = m_ampduPlanner.Add (nextPacket);
 
                 if (aggregated)
                 {
-                    k++;
-                    NS_LOG_DEBUG(k << "th packet is aggregated size: " << currentAggregatedPacket->GetSize () );
+                    NS_LOG_DEBUG(m_ampduPlanner.GetN () << "th packet is aggregated size: " << m_ampduPlanner.GetPsduSize () );
                     isAmpdu = true;
                 }
                 else 
@@ -2341,18 +2362,28 @@ rxPacket:
                     NS_ASSERT("No aggregation!");
                     AmpduTag tag;
                     nextPacket-> RemovePacketTag(tag);
+                    limit = AmpduPlanner::LENGTH;
                     break;
                 }
-                maxAvailableLength = aggregator->GetMaxAvailableLength (currentAggregatedPacket);
+                maxAvailableLength = m_ampduPlanner.GetMaxAvailableLength ();
                 //shbyeon txop implementation
-                maxAvailableDuration = maxAvailableDuration_ref - CalculateTxDuration (currentAggregatedPacket->GetSize (), dataTxVector, preamble);
+                maxAvailableDuration = maxAvailableDuration_ref - m_ampduPlanner.CalculateTxDuration (m_ampduPlanner.GetPsduSize (), preamble);
 
                 NS_LOG_DEBUG ("remaining length for ampdu= " << maxAvailableLength 
                         << ", remaining duration for ampdu=" << maxAvailableDuration.GetMicroSeconds () << " us");	
                 nextPacket = m_edca->GetNextPacketForAmpdu(nextHdr, maxAvailableLength, 
                         maxAvailableDuration);
 
-                NS_LOG_DEBUG("Aggregation size: " << k << ", aggregated packet size: " << currentAggregatedPacket->GetSize () );
+                NS_LOG_DEBUG("Aggregation size: " << m_ampduPlanner.GetN () << ", aggregated packet size: " << m_ampduPlanner.GetPsduSize () );
+            }
+
+            if (nextPacket == 0)
+            {
+                limit = GetAmpduLimit (m_edca, maxAvailableDuration);
+            }
+            else if (nextHdr.IsBlockAckReq ())
+            {
+                limit = AmpduPlanner::BLOCK_ACK_REQUEST;
             }
 
             if (nextPacket != 0 && nextHdr.IsBlockAckReq() && m_edca->GetImplicitBlockAckRequest ()){
@@ -2367,19 +2398,27 @@ rxPacket:
                 nextPacket->AddTrailer (fcs);
                 NS_LOG_DEBUG("Nextpacket Size with hdr/trailer: " << nextPacket->GetSize () );
 
-                aggregated = aggregator->Aggregate (nextPacket, currentAggregatedPacket);
+                aggregated = m_ampduPlanner.Add (nextPacket);
                 if (aggregated)
                 {
-                    k++;
-                    NS_LOG_DEBUG(k << "th (last) packet is aggregated size: " << currentAggregatedPacket->GetSize () );
+                    NS_LOG_DEBUG(m_ampduPlanner.GetN () << "th (last) packet is aggregated size: " << m_ampduPlanner.GetPsduSize () );
                     isAmpdu = true;
                 }
             }
 
+            uint16_t k = m_ampduPlanner.GetN ();
+            m_ampduDecisionTrace (recipient, tid, k, m_ampduPlanner.GetPsduSize (), limit);
+
+            Ptr<Packet> currentAggregatedPacket = 0;
+            if (isAmpdu || m_stationManager->m_txop > 0)
+            {
+                currentAggregatedPacket = m_ampduPlanner.Build ();
+            }
+
             //shbyeon txop implementation
             if(m_stationManager->m_txop>0)
             {
-                Time txopConsumption = CalculateTxDuration(currentAggregatedPacket->GetSize(), dataTxVector, preamble);
+                Time txopConsumption = m_ampduPlanner.CalculateTxDuration (currentAggregatedPacket->GetSize(), preamble);
                 WifiTxVector rtsTxVector = GetRtsTxVector (m_currentPacket, &m_currentHdr);
                 txopConsumption += GetSifs();
                 txopConsumption += GetBlockAckDuration (m_currentHdr.GetAddr1 (), rtsTxVector,COMPRESSED_BLOCK_ACK);
@@ -2400,6 +2439,7 @@ rxPacket:
 
             if (isAmpdu)
             {    
+                m_currentSubframes = m_ampduPlanner.GetSubframes ();
                 if (m_edca->m_blockAckType == BASIC_BLOCK_ACK)
                 {
                     m_txParams.EnableBasicBlockAck ();
@@ -2451,6 +2491,30 @@ rxPacket:
             return isAmpdu;
         }
 
+    AmpduPlanner::Limit
+        MacLow::GetAmpduLimit (Ptr<EdcaTxopN> edca, Time remaining)
+        {
+            // the EDCA function keeps the MPDU it held back at the head of
+            // its queue, the limits are checked again against that one
+            WifiMacHeader hdr;
+            Ptr<const Packet> packet = edca->GetQueue ()->PeekByTidAndAddress (&hdr, m_currentHdr.GetQosTid (),
+                    WifiMacHeader::ADDR1, m_currentHdr.GetAddr1 ());
+            if (packet == 0)
+            {
+                return AmpduPlanner::NO_MORE_MPDUS;
+            }
+            uint32_t size = GetSize (packet, &hdr);
+            if (size > m_ampduPlanner.GetMaxAvailableLength ())
+            {
+                return AmpduPlanner::LENGTH;
+            }
+            if (m_ampduPlanner.CalculateTxDuration (size, WIFI_PREAMBLE_LONG) > remaining)
+            {
+                return AmpduPlanner::DURATION;
+            }
+            return AmpduPlanner::OTHER;
+        }
+
     bool
         MacLow::IsNavZero (void) const
         {
@@ -2691,8 +2755,11 @@ rxPacket:
             m_currentHdr.SetDuration (duration);
 
             StartAmpduTxTimers (dataTxVector);
+            NS_ASSERT (m_currentSubframes != 0 && m_currentSubframes->GetPsduSize () == m_currentPacket->GetSize ());
+            dataTxVector.SetAmpduSubframes (m_currentSubframes);
             ForwardDown (m_currentPacket, &m_currentHdr, dataTxVector, preamble);
             m_currentPacket = 0;
+            m_currentSubframes = 0;
         }
 
 
@@ -2775,17 +2842,35 @@ rxPacket:
                 WifiMacTrailer fcs;
                 packet->RemoveTrailer (fcs);
                 BufferedPacket bufferedPacket (packet, hdr);
+                ReorderBuffer &buffer = (*it).second.second;
 
                 uint16_t endSequence = ((*it).second.first.GetStartingSequence () + 2047) % 4096;
                 uint16_t mappedSeqControl = QosUtilsMapSeqControlToUniqueInteger (hdr.GetSequenceControl (), endSequence);
+                uint16_t seq = hdr.GetSequenceNumber ();
 
-                BufferedPacketI i = (*it).second.second.begin ();
-                for (; i != (*it).second.second.end ()
-                        && QosUtilsMapSeqControlToUniqueInteger ((*i).second.GetSequenceControl (), endSequence) < mappedSeqControl; i++)
+                /* the buffer is in order of sequence control, the packet goes
+                   among the fragments of its sequence number or before the
+                   first packet of the next sequence number in use */
+                BufferedPacketI i;
+                if (buffer.index.IsSet (seq))
                 {
-                    ;
+                    i = buffer.index.Get (seq);
+                    for (; i != buffer.packets.end () && (*i).second.GetSequenceNumber () == seq
+                            && QosUtilsMapSeqControlToUniqueInteger ((*i).second.GetSequenceControl (), endSequence) < mappedSeqControl; i++)
+                    {
+                        ;
+                    }
+                }
+                else
+                {
+                    uint16_t next = buffer.index.FindNext ((seq + 1) % 4096, (endSequence - seq + 4096) % 4096);
+                    i = next < 4096 ? buffer.index.Get (next) : buffer.packets.end ();
+                }
+                BufferedPacketI inserted = buffer.packets.insert (i, bufferedPacket);
+                if (!buffer.index.IsSet (seq) || buffer.index.Get (seq) == i)
+                {
+                    buffer.index.Set (seq, inserted);
                 }
-                (*it).second.second.insert (i, bufferedPacket);
 
                 //Update block ack cache
                 BlockAckCachesI j = m_bAckCaches.find (std::make_pair (hdr.GetAddr2 (), hdr.GetQosTid ()));
@@ -2816,7 +2901,7 @@ rxPacket:
             agreement.SetTimeout (respHdr->GetTimeout ());
             agreement.SetStartingSequence (startingSeq);
 
-            std::list<BufferedPacket> buffer (0);
+            ReorderBuffer buffer;
             AgreementKey key (originator, respHdr->GetTid ());
             AgreementValue value (agreement, buffer);
             m_bAckAgreements.insert (std::make_pair (key, value));
@@ -2865,15 +2950,15 @@ rxPacket:
                 uint16_t endSequence = ((*it).second.first.GetStartingSequence () + 2047) % 4096;
                 //shbyeon ampdu bug
                 uint16_t mappedStart = QosUtilsMapSeqControlToUniqueInteger (seq, endSequence);
-                BufferedPacketI last = (*it).second.second.begin ();
+                BufferedPacketI last = (*it).second.second.packets.begin ();
                 uint16_t guard = 0;
-                if (last != (*it).second.second.end ())
+                if (last != (*it).second.second.packets.end ())
                 {
-                    guard = (*it).second.second.begin ()->second.GetSequenceControl ();
+                    guard = (*it).second.second.packets.begin ()->second.GetSequenceControl ();
                 }
                 NS_LOG_DEBUG("endSequence=" << endSequence << " mappedStart=" << mappedStart << " guard=" << guard);
-                BufferedPacketI i = (*it).second.second.begin ();
-                for (; i != (*it).second.second.end ()
+                BufferedPacketI i = (*it).second.second.packets.begin ();
+                for (; i != (*it).second.second.packets.end ()
                         //shbyeon ampdu bug
                         && QosUtilsMapSeqControlToUniqueInteger ((*i).second.GetSequenceControl (), endSequence) < mappedStart;)
                 {
@@ -2889,13 +2974,13 @@ rxPacket:
                             m_rxCallback ((*last).first, &(*last).second);
                             last++;
                             /* go to next packet */
-                            //while (i != (*it).second.second.end () && ((guard >> 4) & 0x0fff) == (*i).second.GetSequenceNumber ())
+                            //while (i != (*it).second.second.packets.end () && ((guard >> 4) & 0x0fff) == (*i).second.GetSequenceNumber ())
                             //shbyeon ampdu bug
-                            while (i != (*it).second.second.end () && guard == (*i).second.GetSequenceControl ())
+                            while (i != (*it).second.second.packets.end () && guard == (*i).second.GetSequenceControl ())
                             {
                                 i++;
                             }
-                            if (i != (*it).second.second.end ())
+                            if (i != (*it).second.second.packets.end ())
                             {
                                 //shbyeon ampdu bug
                                 guard = (*i).second.GetSequenceControl ();
@@ -2912,11 +2997,11 @@ rxPacket:
                     else
                     {
                         /* go to next packet */
-                        while (i != (*it).second.second.end () && guard == (*i).second.GetSequenceControl ())
+                        while (i != (*it).second.second.packets.end () && guard == (*i).second.GetSequenceControl ())
                         {
                             i++;
                         }
-                        if (i != (*it).second.second.end ())
+                        if (i != (*it).second.second.packets.end ())
                         {
                             guard = (*i).second.GetSequenceControl ();
                             last = i;
@@ -2924,7 +3009,7 @@ rxPacket:
                     }
                 }
                 NS_LOG_DEBUG("erase this packet");
-                (*it).second.second.erase ((*it).second.second.begin (), i);
+                EraseBufferedPackets ((*it).second.second, i);
             }
         }
 
@@ -2938,9 +3023,9 @@ rxPacket:
                 uint16_t guard = (*it).second.first.GetStartingSequenceControl ();
                 NS_LOG_DEBUG("ok, here before update " << (uint16_t) ((guard >> 4) & 0x0fff)); 
 
-                BufferedPacketI lastComplete = (*it).second.second.begin ();
-                BufferedPacketI i = (*it).second.second.begin ();
-                for (; i != (*it).second.second.end () && guard == (*i).second.GetSequenceControl (); i++)
+                BufferedPacketI lastComplete = (*it).second.second.packets.begin ();
+                BufferedPacketI i = (*it).second.second.packets.begin ();
+                for (; i != (*it).second.second.packets.end () && guard == (*i).second.GetSequenceControl (); i++)
                 {
                     if (!(*i).second.IsMoreFragments ())
                     {
@@ -2959,7 +3044,32 @@ rxPacket:
                 (*it).second.first.SetStartingSequenceControl(guard);
                 /* All packets already forwarded to WifiMac must be removed from buffer:
                    [begin (), lastComplete) */
-                (*it).second.second.erase ((*it).second.second.begin (), lastComplete);
+                EraseBufferedPackets ((*it).second.second, lastComplete);
+            }
+        }
+
+    void
+        MacLow::EraseBufferedPackets (ReorderBuffer &buffer, BufferedPacketI last)
+        {
+            while (buffer.packets.begin () != last)
+            {
+                BufferedPacketI i = buffer.packets.begin ();
+                uint16_t seq = (*i).second.GetSequenceNumber ();
+                if (buffer.index.IsSet (seq) && buffer.index.Get (seq) == i)
+                {
+                    /* the next packet heads the sequence number, if it has the same */
+                    BufferedPacketI next = i;
+                    next++;
+                    if (next != buffer.packets.end () && (*next).second.GetSequenceNumber () == seq)
+                    {
+                        buffer.index.Set (seq, next);
+                    }
+                    else
+                    {
+                        buffer.index.Clear (seq);
+                    }
+                }
+                buffer.packets.erase (i);
             }
         }
 
@@ -3124,26 +3234,26 @@ rxPacket:
                 NS_ASSERT (i != m_bAckCaches.end ());
                 (*i).second.FillBlockAckBitmap (&blockAck);
 
-                BufferedPacketI ii = (*it).second.second.begin ();
-                for (; ii != (*it).second.second.end () ; ii++)
+                BufferedPacketI ii = (*it).second.second.packets.begin ();
+                for (; ii != (*it).second.second.packets.end () ; ii++)
                 {
-                    NS_LOG_DEBUG ("info: SequenceControl(Bpacket): " << (*ii).second.GetSequenceControl () <<  " SequenceNumber(Bpacket): " << (*ii).second.GetSequenceNumber () << " Bpacket Sizer: " << (*it).second.second.size());
+                    NS_LOG_DEBUG ("info: SequenceControl(Bpacket): " << (*ii).second.GetSequenceControl () <<  " SequenceNumber(Bpacket): " << (*ii).second.GetSequenceNumber () << " Bpacket Sizer: " << (*it).second.second.packets.size());
                 }
                 RxCompleteBufferedPacketsWithSmallerSequence ((startingSeq <<4) & 0xfff0 , originator, tid);
                 NS_LOG_FUNCTION ("RxCompleteBufferedPacketWithSmallerSequence..");
 
-                ii = (*it).second.second.begin ();
-                for (; ii != (*it).second.second.end () ; ii++)
+                ii = (*it).second.second.packets.begin ();
+                for (; ii != (*it).second.second.packets.end () ; ii++)
                 {
-                    NS_LOG_DEBUG ("SequenceControl(Bpacket): " << (*ii).second.GetSequenceControl () <<  " SequenceNumber(Bpacket): " << (*ii).second.GetSequenceNumber () << " Bpacket Sizer: " << (*it).second.second.size());
+                    NS_LOG_DEBUG ("SequenceControl(Bpacket): " << (*ii).second.GetSequenceControl () <<  " SequenceNumber(Bpacket): " << (*ii).second.GetSequenceNumber () << " Bpacket Sizer: " << (*it).second.second.packets.size());
                 }
 
                 RxCompleteBufferedPacketsUntilFirstLost (originator, tid);
                 NS_LOG_DEBUG ("RxCompleteBufferedPacketUltilFirstLost..");
-                ii = (*it).second.second.begin ();
-                for (; ii != (*it).second.second.end () ; ii++)
+                ii = (*it).second.second.packets.begin ();
+                for (; ii != (*it).second.second.packets.end () ; ii++)
                 {
-                    NS_LOG_FUNCTION ("SequenceControl(Bpacket): " << (*ii).second.GetSequenceControl () <<  " SequenceNumber(Bpacket): " << (*ii).second.GetSequenceNumber () << " Bpacket Sizer: " << (*it).second.second.size());
+                    NS_LOG_FUNCTION ("SequenceControl(Bpacket): " << (*ii).second.GetSequenceControl () <<  " SequenceNumber(Bpacket): " << (*ii).second.GetSequenceNumber () << " Bpacket Sizer: " << (*it).second.second.packets.size());
                 }
 
             }
@@ -42,9 +42,12 @@
 #include "ns3/nstime.h"
 #include "qos-utils.h"
 #include "block-ack-cache.h"
+#include "block-ack-scoreboard.h"
 #include "wifi-tx-vector.h"
 //shbyeon add header
 #include "mpdu-aggregator.h"
+#include "ampdu-planner.h"
+#include "ns3/traced-callback.h"
 
 namespace ns3 {
 
@@ -429,6 +432,7 @@ public:
   //shbyeon typedef edcaqueues
   typedef std::map<AcIndex, Ptr<EdcaTxopN> > EdcaQueues;
 
+  static TypeId GetTypeId (void);
   MacLow ();
   virtual ~MacLow ();
 
@@ -750,7 +754,7 @@ public:
   uint16_t GetOperationalBandwidth (void);
   void SetDynamicAccess (uint16_t da);
   uint16_t GetDynamicAccess (void);
-  bool RunningAckEvent (Time rxDuration, Ptr<Packet> pkt);
+  bool RunningAckEvent (Time rxDuration, Ptr<const Packet> pkt);
 
 private:
   /**
@@ -1078,6 +1082,12 @@ private:
   //shbyeon send ampdu
   void SendAmpduPacket (void);
   bool AggregateMpdu (Ptr<MpduAggregator> aggregator);
+  /**
+   * \param edca the EDCA function of the A-MPDU
+   * \param remaining the PPDU duration left to the next MPDU
+   * \return what held the next MPDU back, when the EDCA function gave none
+   */
+  AmpduPlanner::Limit GetAmpduLimit (Ptr<EdcaTxopN> edca, Time remaining);
 
   virtual void DoDispose (void);
   /**
@@ -1188,6 +1198,8 @@ private:
 
   Ptr<Packet> m_currentPacket;              //!< Current packet transmitted/to be transmitted
   WifiMacHeader m_currentHdr;               //!< Header of the current packet
+  Ptr<const AmpduSubframes> m_currentSubframes; //!< Layout of the current packet when it is an A-MPDU
+  AmpduPlanner m_ampduPlanner;              //!< Subframes of the A-MPDU being aggregated
   MacLowTransmissionParameters m_txParams;  //!< Transmission parameters of the current packet
   MacLowTransmissionListener *m_listener;   //!< Transmission listener for the current packet
   Mac48Address m_self;                      //!< Address of this MacLow (Mac48Address)
@@ -1216,9 +1228,25 @@ private:
    */
   typedef std::pair<Ptr<Packet>, WifiMacHeader> BufferedPacket;
   typedef std::list<BufferedPacket>::iterator BufferedPacketI;
+  /**
+   * The buffered MPDUs of an agreement, in order of increasing sequence
+   * control, and the first one of each sequence number.
+   */
+  struct ReorderBuffer
+  {
+    std::list<BufferedPacket> packets;
+    BlockAckScoreboard<BufferedPacketI> index;
+  };
+  /**
+   * \param buffer the buffered MPDUs of an agreement
+   * \param last the first MPDU which is kept
+   *
+   * Removes the MPDUs before <i>last</i> from the buffer.
+   */
+  void EraseBufferedPackets (ReorderBuffer &buffer, BufferedPacketI last);
 
   typedef std::pair<Mac48Address, uint8_t> AgreementKey;
-  typedef std::pair<BlockAckAgreement, std::list<BufferedPacket> > AgreementValue;
+  typedef std::pair<BlockAckAgreement, ReorderBuffer> AgreementValue;
 
   typedef std::map<AgreementKey, AgreementValue> Agreements;
   typedef std::map<AgreementKey, AgreementValue>::iterator AgreementsI;
@@ -1239,6 +1267,12 @@ private:
   AmpduAggregators m_aggregators;
   EdcaQueues m_edcas;
 
+  /**
+   * The A-MPDUs planned: the receiver, the TID, the number of MPDUs, the
+   * size of the PSDU and what ended the A-MPDU.
+   */
+  TracedCallback<Mac48Address, uint8_t, uint16_t, uint32_t, AmpduPlanner::Limit> m_ampduDecisionTrace;
+
 	double rx_count;
 	double err_count;
 	double err_rate;
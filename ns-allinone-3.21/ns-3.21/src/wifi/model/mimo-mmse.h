@@ -0,0 +1,224 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MIMO_MMSE_H
+#define MIMO_MMSE_H
+
+#include <stdint.h>
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief Fixed-dimension MMSE receiver kernel for N spatial streams.
+ *
+ * 11ac: mutiple_stream_tx_per. All matrices are N x N, row-major, with the
+ * real and imaginary parts stored in separate arrays so that the inner
+ * products reduce to plain multiply-adds which the compiler unrolls and
+ * vectorizes for a fixed N. Nothing is allocated on the heap.
+ *
+ * The MMSE weight matrix W = (H^H H + n0 I)^-1 H^H is obtained from an
+ * LDL^H factorization of the Hermitian positive definite matrix
+ * H^H H + n0 I instead of the cofactor expansion.
+ */
+template <int N>
+class MimoMmse
+{
+public:
+  /**
+   * Compute the post-MMSE SINR of every stream.
+   *
+   * \param hRe real part of the channel matrix H
+   * \param hIm imaginary part of the channel matrix H
+   * \param dRe real part of the channel mismatch matrix (caudal loss), or 0
+   * \param dIm imaginary part of the channel mismatch matrix (caudal loss), or 0
+   * \param n0 nss * noise / signal
+   * \param sinr the linear SINR of each stream (output)
+   */
+  static void Sinr (const double *hRe, const double *hIm,
+                    const double *dRe, const double *dIm,
+                    double n0, double *sinr)
+  {
+    double aRe[N][N], aIm[N][N];
+    double lRe[N][N], lIm[N][N];
+    double diag[N];
+    double wRe[N][N], wIm[N][N];
+
+    // A = H^H H + n0 I, lower triangle only (A is Hermitian)
+    for (int i = 0; i < N; i++)
+      {
+        for (int j = 0; j <= i; j++)
+          {
+            double re = 0;
+            double im = 0;
+            for (int k = 0; k < N; k++)
+              {
+                // conj (H[k][i]) * H[k][j]
+                re += hRe[k * N + i] * hRe[k * N + j] + hIm[k * N + i] * hIm[k * N + j];
+                im += hRe[k * N + i] * hIm[k * N + j] - hIm[k * N + i] * hRe[k * N + j];
+              }
+            aRe[i][j] = re;
+            aIm[i][j] = im;
+          }
+        aRe[i][i] += n0;
+        aIm[i][i] = 0;
+      }
+
+    // A = L D L^H with unit lower triangular L and real positive D
+    for (int j = 0; j < N; j++)
+      {
+        double d = aRe[j][j];
+        for (int k = 0; k < j; k++)
+          {
+            d -= (lRe[j][k] * lRe[j][k] + lIm[j][k] * lIm[j][k]) * diag[k];
+          }
+        diag[j] = d;
+        lRe[j][j] = 1;
+        lIm[j][j] = 0;
+        for (int i = j + 1; i < N; i++)
+          {
+            double re = aRe[i][j];
+            double im = aIm[i][j];
+            for (int k = 0; k < j; k++)
+              {
+                // L[i][k] * D[k] * conj (L[j][k])
+                double pRe = (lRe[i][k] * lRe[j][k] + lIm[i][k] * lIm[j][k]) * diag[k];
+                double pIm = (lIm[i][k] * lRe[j][k] - lRe[i][k] * lIm[j][k]) * diag[k];
+                re -= pRe;
+                im -= pIm;
+              }
+            lRe[i][j] = re / d;
+            lIm[i][j] = im / d;
+          }
+      }
+
+    // W = A^-1 H^H, solved one column of H^H at a time
+    for (int c = 0; c < N; c++)
+      {
+        double yRe[N], yIm[N];
+        // column c of H^H is conj (row c of H)
+        for (int i = 0; i < N; i++)
+          {
+            double re = hRe[c * N + i];
+            double im = -hIm[c * N + i];
+            for (int k = 0; k < i; k++)
+              {
+                re -= lRe[i][k] * yRe[k] - lIm[i][k] * yIm[k];
+                im -= lRe[i][k] * yIm[k] + lIm[i][k] * yRe[k];
+              }
+            yRe[i] = re;
+            yIm[i] = im;
+          }
+        for (int i = 0; i < N; i++)
+          {
+            yRe[i] /= diag[i];
+            yIm[i] /= diag[i];
+          }
+        for (int i = N - 1; i >= 0; i--)
+          {
+            double re = yRe[i];
+            double im = yIm[i];
+            for (int k = i + 1; k < N; k++)
+              {
+                // conj (L[k][i]) * x[k]
+                re -= lRe[k][i] * wRe[k][c] + lIm[k][i] * wIm[k][c];
+                im -= lRe[k][i] * wIm[k][c] - lIm[k][i] * wRe[k][c];
+              }
+            wRe[i][c] = re;
+            wIm[i][c] = im;
+          }
+      }
+
+    for (int i = 0; i < N; i++)
+      {
+        double noiseAmplification = 0;
+        double interference = 0;
+        double signal = 0;
+        double mobility = 0;
+        for (int j = 0; j < N; j++)
+          {
+            noiseAmplification += wRe[i][j] * wRe[i][j] + wIm[i][j] * wIm[i][j];
+            double gRe = 0;
+            double gIm = 0;
+            for (int k = 0; k < N; k++)
+              {
+                gRe += wRe[i][k] * hRe[k * N + j] - wIm[i][k] * hIm[k * N + j];
+                gIm += wRe[i][k] * hIm[k * N + j] + wIm[i][k] * hRe[k * N + j];
+              }
+            if (j == i)
+              {
+                signal = gRe * gRe + gIm * gIm;
+              }
+            else
+              {
+                interference += gRe * gRe + gIm * gIm;
+              }
+            if (dRe != 0)
+              {
+                double mRe = 0;
+                double mIm = 0;
+                for (int k = 0; k < N; k++)
+                  {
+                    mRe += wRe[i][k] * dRe[k * N + j] - wIm[i][k] * dIm[k * N + j];
+                    mIm += wRe[i][k] * dIm[k * N + j] + wIm[i][k] * dRe[k * N + j];
+                  }
+                mobility += mRe * mRe + mIm * mIm;
+              }
+          }
+        interference += n0 * noiseAmplification;
+        sinr[i] = signal / (interference + mobility);
+      }
+  }
+};
+
+/**
+ * \ingroup wifi
+ * Runtime dispatch of MimoMmse<N>::Sinr on the number of spatial streams.
+ *
+ * \param nss the number of spatial streams
+ * \param hRe real part of the channel matrix H (nss x nss, row-major)
+ * \param hIm imaginary part of the channel matrix H
+ * \param dRe real part of the channel mismatch matrix, or 0
+ * \param dIm imaginary part of the channel mismatch matrix, or 0
+ * \param n0 nss * noise / signal
+ * \param sinr the linear SINR of each stream (output)
+ * \return false if nss is not in 1..4
+ */
+inline bool
+MimoMmseSinr (uint8_t nss, const double *hRe, const double *hIm,
+              const double *dRe, const double *dIm, double n0, double *sinr)
+{
+  switch (nss)
+    {
+    case 1:
+      MimoMmse<1>::Sinr (hRe, hIm, dRe, dIm, n0, sinr);
+      return true;
+    case 2:
+      MimoMmse<2>::Sinr (hRe, hIm, dRe, dIm, n0, sinr);
+      return true;
+    case 3:
+      MimoMmse<3>::Sinr (hRe, hIm, dRe, dIm, n0, sinr);
+      return true;
+    case 4:
+      MimoMmse<4>::Sinr (hRe, hIm, dRe, dIm, n0, sinr);
+      return true;
+    default:
+      return false;
+    }
+}
+
+} // namespace ns3
+
+#endif /* MIMO_MMSE_H */
@@ -37,6 +37,7 @@
 #include "ns3/wifi-mac.h"
 #include "ns3/assert.h"
 #include <vector>
+#include <algorithm>
 
 #define Min(a,b) ((a < b) ? a : b)
 
@@ -66,6 +67,7 @@ namespace ns3 {
         uint32_t sum_mpdu;
         uint32_t sum_packet;
         uint32_t avg_ampduLen;
+        double m_avgAmpduLen;  ///< avg_ampduLen without truncation, for the link metric
         uint32_t m_col[3], m_index[3];	// kjyoon
         uint32_t m_ngroup;				// number of supported groups	kjyoon
         uint32_t m_cs_group;				// current sampling group id	kjyoon
@@ -99,14 +101,59 @@ namespace ns3 {
 
         bool m_initialized;  ///< for initializing tables
 
-        MinstrelRate m_minstrelTable;  ///< minstrel table
         MinstrelRate m_minstrelTable_Allgroup[3];	// kjyoon
-        SampleRate m_sampleTable;  ///< sample table
         SampleRate m_sampleTable_Allgroup[3];  // kjyoon
 
         bool m_updatedByBlockAck;		// GotBlockAck function in edca-txop-n.cc kjyoon
     };
 
+    void
+        MinstrelRateTable::Add (WifiMode mode, Time txTime)
+        {
+            uint32_t uid = mode.GetUid ();
+            if (uid >= m_entries.size ())
+            {
+                Entry empty;
+                empty.valid = false;
+                m_entries.resize (uid + 1, empty);
+            }
+            Entry &entry = m_entries[uid];
+            if (entry.valid)
+            {
+                return;
+            }
+            entry.valid = true;
+            entry.txTime = txTime;
+            for (uint8_t nss = 1; nss <= MAX_NSS; nss++)
+            {
+                // For simplification, the perfect tx time of a stream is the
+                // tx time divided by the number of spatial streams. kjyoon
+                Time perfectTxTime = txTime / static_cast<int64_t> (nss);
+                /// just for initialization
+                if (perfectTxTime.GetMicroSeconds () == 0)
+                {
+                    perfectTxTime = Seconds (1);
+                }
+                entry.scale[nss - 1] = 1000000 / perfectTxTime.GetMicroSeconds ();
+            }
+        }
+
+    Time
+        MinstrelRateTable::GetTxTime (WifiMode mode) const
+        {
+            uint32_t uid = mode.GetUid ();
+            NS_ASSERT (uid < m_entries.size () && m_entries[uid].valid);
+            return m_entries[uid].txTime;
+        }
+
+    int64_t
+        MinstrelRateTable::GetThroughputScale (uint32_t uid, uint8_t nss) const
+        {
+            NS_ASSERT (uid < m_entries.size () && m_entries[uid].valid);
+            NS_ASSERT (nss >= 1 && nss <= MAX_NSS);
+            return m_entries[uid].scale[nss - 1];
+        }
+
     NS_OBJECT_ENSURE_REGISTERED (MinstrelWifiManager);
 
     TypeId
@@ -218,21 +265,13 @@ namespace ns3 {
     Time
         MinstrelWifiManager::GetCalcTxTime (WifiMode mode) const
         {
-            for (TxTime::const_iterator i = m_calcTxTime.begin (); i != m_calcTxTime.end (); i++)
-            {
-                if (mode == i->second)
-                {
-                    return i->first;
-                }
-            }
-            NS_ASSERT (false);
-            return Seconds (0);
+            return m_calcTxTime.GetTxTime (mode);
         }
 
     void
         MinstrelWifiManager::AddCalcTxTime (WifiMode mode, Time t)
         {
-            m_calcTxTime.push_back (std::make_pair (t, mode));
+            m_calcTxTime.Add (mode, t);
         }
 
     WifiRemoteStation *
@@ -246,6 +285,7 @@ namespace ns3 {
             station->sum_mpdu = 0;	// kjyoon
             station->sum_packet = 0;
             station->avg_ampduLen= 0;
+            station->m_avgAmpduLen = 0;
             station->m_col[0] = 0;	// kjyoon
             station->m_col[1] = 0;
             station->m_col[2] = 0;
@@ -299,11 +339,10 @@ namespace ns3 {
                 else
                     m_nsupported = GetNSupported (station);
 
-                station->m_minstrelTable = MinstrelRate (m_nsupported);
-                station->m_sampleTable = SampleRate (m_nsupported, std::vector<uint32_t> (m_sampleCol));
+                NS_ASSERT (station->m_ngroup <= MinstrelRateTable::MAX_NSS);
                 for (uint32_t i_gr = 0; i_gr < station->m_ngroup; i_gr++) {
-                    station->m_minstrelTable_Allgroup [i_gr] = station->m_minstrelTable;	// kjyoon
-                    station->m_sampleTable_Allgroup [i_gr] = station->m_sampleTable;	// kjyoon
+                    station->m_minstrelTable_Allgroup [i_gr] = MinstrelRate (m_nsupported);	// kjyoon
+                    station->m_sampleTable_Allgroup [i_gr] = SampleRate (m_nsupported * m_sampleCol);	// kjyoon
                 }
                 InitSampleTable (station);
                 //	  PrintSampleTable (station);	// kjyoon
@@ -374,9 +413,7 @@ namespace ns3 {
 
             NS_LOG_DEBUG ("DoReportDataFailed " << station << "\t rate " << station->m_txrate << "\tlongRetry \t" << station->m_longRetry);
 
-            uint32_t org_group = station->m_group_txrate;	// kjyoon
-            MinstrelRate tmp_minstrelTable;	// kjyoon
-            tmp_minstrelTable = station->m_minstrelTable_Allgroup[station->m_group_txrate];		// kjyoon
+            const MinstrelRate &tmp_minstrelTable = station->m_minstrelTable_Allgroup[station->m_group_txrate];		// kjyoon
             //tmp_minstrelTable[station->m_txrate].numRateAttempt++;
             /// for normal rate, we're not currently sampling random rates
             if (!station->m_isSampling)
@@ -458,7 +495,6 @@ namespace ns3 {
                     NS_LOG_DEBUG("m_group_txrate update to 0: " << station->m_group_txrate);	// kjyoon
                 }
             }
-            station->m_minstrelTable_Allgroup[org_group] = tmp_minstrelTable;		// kjyoon
         }
     /* 150702 kjyoon
      * [Minstrel HT] Downgrade one group when attempt > 30 && success prob < 0.2
@@ -473,10 +509,9 @@ namespace ns3 {
             {
                 return;
             }
-            MinstrelRate tmp_minstrelTable;
-            tmp_minstrelTable = station->m_minstrelTable_Allgroup[station->m_group_maxTpRate];
-            uint32_t tmp_success = tmp_minstrelTable[station->m_maxTpRate].numRateSuccess;
-            uint32_t tmp_attempt = tmp_minstrelTable[station->m_maxTpRate].numRateAttempt;
+            const RateInfo *tmp_rate = &station->m_minstrelTable_Allgroup[station->m_group_maxTpRate][station->m_maxTpRate];
+            uint32_t tmp_success = tmp_rate->numRateSuccess;
+            uint32_t tmp_attempt = tmp_rate->numRateAttempt;
             NS_LOG_DEBUG ("maxTp m_isSampling=" << station->m_isSampling);
             if ((!station->m_isSampling)&&(tmp_attempt > 30)&&(tmp_success*5 < tmp_attempt)) {
                 if (station->m_group_maxTpRate > 0)
@@ -490,9 +525,9 @@ namespace ns3 {
                     NS_LOG_DEBUG ("maxTp Already lowest group");
             }
 
-            tmp_minstrelTable = station->m_minstrelTable_Allgroup[station->m_group_maxTpRate2];
-            tmp_success = tmp_minstrelTable[station->m_maxTpRate2].numRateSuccess;
-            tmp_attempt = tmp_minstrelTable[station->m_maxTpRate2].numRateAttempt;
+            tmp_rate = &station->m_minstrelTable_Allgroup[station->m_group_maxTpRate2][station->m_maxTpRate2];
+            tmp_success = tmp_rate->numRateSuccess;
+            tmp_attempt = tmp_rate->numRateAttempt;
             if ((!station->m_isSampling)&&(tmp_attempt > 30)&&(tmp_success*5 < tmp_attempt)) {
                 if (station->m_group_maxTpRate2 > 0)
                 {
@@ -537,6 +572,14 @@ namespace ns3 {
             //	  NS_LOG_DEBUG ("sum_mpdu: " << station->sum_mpdu << ", sum_packet: " << station->sum_packet);	// kjyoon
         }
 
+    double
+        MinstrelWifiManager::DoGetAverageAmpduLength (WifiRemoteStation *st)
+        {
+            MinstrelWifiRemoteStation *station = (MinstrelWifiRemoteStation *) st;
+            // the average is refreshed with the statistics, every UpdateStatistics
+            return std::max (station->m_avgAmpduLen, 1.0);
+        }
+
     /**
      * 150623 added by kjyoon
      *
@@ -553,14 +596,11 @@ namespace ns3 {
             {
                 return;
             }
-            uint32_t org_group = station->m_group_txrate;	// kjyoon
-            MinstrelRate tmp_minstrelTable;	// kjyoon
-            tmp_minstrelTable = station->m_minstrelTable_Allgroup[station->m_group_txrate];		// kjyoon
+            MinstrelRate &tmp_minstrelTable = station->m_minstrelTable_Allgroup[station->m_group_txrate];		// kjyoon
             tmp_minstrelTable[station->m_txrate].numRateSuccess += success;
             tmp_minstrelTable[station->m_txrate].numRateAttempt += attempt;
             NS_LOG_DEBUG ("m_minstrelTable_Allgroup[" << station->m_group_txrate  << "][" << station->m_txrate << "]: Success = " << tmp_minstrelTable[station->m_txrate].numRateSuccess << ", attempt = " << tmp_minstrelTable[station->m_txrate].numRateAttempt);		// kjyoon
 
-            station->m_minstrelTable_Allgroup[org_group] = tmp_minstrelTable;		// kjyoon
             station->m_packetCount+=attempt;		//  += attempt?
             station->m_updatedByBlockAck = true;	// kjyoon
 
@@ -590,9 +630,7 @@ namespace ns3 {
                 return;
             }
 
-            uint32_t org_group = station->m_group_txrate;	// kjyoon
-            MinstrelRate tmp_minstrelTable;	// kjyoon
-            tmp_minstrelTable = station->m_minstrelTable_Allgroup[station->m_group_txrate];		// kjyoon
+            MinstrelRate &tmp_minstrelTable = station->m_minstrelTable_Allgroup[station->m_group_txrate];		// kjyoon
             tmp_minstrelTable[station->m_txrate].numRateSuccess++;
             tmp_minstrelTable[station->m_txrate].numRateAttempt++;
 
@@ -600,7 +638,6 @@ namespace ns3 {
 
             //tmp_minstrelTable[station->m_txrate].numRateAttempt += station->m_retry;
             NS_LOG_DEBUG ("DoReportDataOk m_minstrelTable_Allgroup[" << station->m_group_txrate  << "][" << station->m_txrate << "]: Success = " << tmp_minstrelTable[station->m_txrate].numRateSuccess << ", attempt = " << tmp_minstrelTable[station->m_txrate].numRateAttempt);		// kjyoon
-            station->m_minstrelTable_Allgroup[org_group] = tmp_minstrelTable;		// kjyoon
             station->m_packetCount++;
 
 
@@ -623,14 +660,11 @@ namespace ns3 {
 
             UpdateRetry (station);
 
-            uint32_t org_group = station->m_group_txrate;	// kjyoon
-            MinstrelRate tmp_minstrelTable;	// kjyoon
-            tmp_minstrelTable = station->m_minstrelTable_Allgroup[station->m_group_txrate];		// kjyoon
+            MinstrelRate &tmp_minstrelTable = station->m_minstrelTable_Allgroup[station->m_group_txrate];		// kjyoon
 
             tmp_minstrelTable[station->m_txrate].numRateAttempt += station->m_retry;
 
             station->m_retry = 0;
-            station->m_minstrelTable_Allgroup[org_group] = tmp_minstrelTable;		// kjyoon
             station->m_err++;
 
             if (m_nsupported >= 1)
@@ -740,9 +774,8 @@ namespace ns3 {
                 station->m_cs_group = 0;
             }
             uint32_t bitrate;
-            SampleRate tmp_sampleTable;	// kjyoon
-            tmp_sampleTable = station->m_sampleTable_Allgroup[tmp_cs_group];	// kjyoon
-            bitrate = tmp_sampleTable[station->m_index[tmp_cs_group]][station->m_col[tmp_cs_group]];
+            const SampleRate &tmp_sampleTable = station->m_sampleTable_Allgroup[tmp_cs_group];	// kjyoon
+            bitrate = tmp_sampleTable[station->m_index[tmp_cs_group] * m_sampleCol + station->m_col[tmp_cs_group]];
             station->m_index[tmp_cs_group]++;
 
             /// bookeeping for m_index and m_col variables
@@ -778,7 +811,6 @@ namespace ns3 {
 
 
             uint32_t idx;
-            MinstrelRate tmp_minstrelTable;	// kjyoon
 
             /**
              * if we are below the target of look around rate percentage, look around
@@ -792,7 +824,7 @@ namespace ns3 {
                 station->m_waited = 0;
 
                 idx = GetNextSample (station);
-                tmp_minstrelTable = station->m_minstrelTable_Allgroup[station->m_cs_group];		// kjyoon
+                const MinstrelRate &tmp_minstrelTable = station->m_minstrelTable_Allgroup[station->m_cs_group];		// kjyoon
 
                 /**
                  * This if condition is used to make sure that we don't need to use
@@ -893,30 +925,21 @@ namespace ns3 {
 
             station->m_nextStatsUpdate = Simulator::Now () + m_updateStats;
 
-            Time txTime;
             uint32_t tempProb;
 
             station->avg_ampduLen = static_cast<uint32_t> (((station->avg_ampduLen * (100 - m_ewmaLevel)) + (m_ewmaLevel * station->sum_mpdu / station->sum_packet) ) / 100);	// kjyoon
+            station->m_avgAmpduLen = (station->m_avgAmpduLen * (100 - m_ewmaLevel)
+                                      + m_ewmaLevel * station->sum_mpdu / station->sum_packet) / 100;
             NS_LOG_DEBUG ("sum_mpdu: " << station->sum_mpdu << ", sum_packet: " << station->sum_packet << ", avg_ampduLen: " << station->avg_ampduLen);	// kjyoon
             station->sum_mpdu = 0;
             station->sum_packet = 0;
 
-            MinstrelRate tmp_minstrelTable;	// kjyoon
             for (uint32_t i_gr = 0; i_gr < station->m_ngroup; i_gr++)
             {
-                tmp_minstrelTable = station->m_minstrelTable_Allgroup[i_gr];		// kjyoon
+                MinstrelRate &tmp_minstrelTable = station->m_minstrelTable_Allgroup[i_gr];		// kjyoon
                 for (uint32_t i = 0; i < m_nsupported; i++)
                 {
 
-                    /// calculate the perfect tx time for this rate
-                    txTime = tmp_minstrelTable[i].perfectTxTime;
-
-                    /// just for initialization
-                    if (txTime.GetMicroSeconds () == 0)
-                    {
-                        txTime = Seconds (1);
-                    }
-
                     NS_LOG_DEBUG ("m_txrate[nss" << i_gr << "][rate" << i << "]=" << station->m_txrate <<
                             "\t attempt=" << tmp_minstrelTable[i].numRateAttempt <<
                             "\t success=" << tmp_minstrelTable[i].numRateSuccess);
@@ -943,8 +966,8 @@ namespace ns3 {
                         tmp_minstrelTable[i].ewmaProb = tempProb;
 
 
-                        /// calculating throughput
-                        tmp_minstrelTable[i].throughput = tempProb * (1000000 / txTime.GetMicroSeconds ());
+                        /// calculating throughput, from the perfect tx time of this rate
+                        tmp_minstrelTable[i].throughput = tempProb * m_calcTxTime.GetThroughputScale (tmp_minstrelTable[i].modeUid, i_gr + 1);
 
                     }
 
@@ -978,7 +1001,6 @@ namespace ns3 {
                         tmp_minstrelTable[i].adjustedRetryCount = 1;
                     }
                 }
-                station->m_minstrelTable_Allgroup[i_gr] = tmp_minstrelTable;		// kjyoon
             }
 
             uint32_t max_prob = 0, index_max_prob = 0, max_tp = 0, index_max_tp = 0, index_max_tp2 = 0;
@@ -989,7 +1011,7 @@ namespace ns3 {
             /// go find max throughput, high probability succ
             for (uint32_t i_gr = 0; i_gr < station->m_ngroup; i_gr++)
             {
-                tmp_minstrelTable = station->m_minstrelTable_Allgroup[i_gr];		// kjyoon
+                const MinstrelRate &tmp_minstrelTable = station->m_minstrelTable_Allgroup[i_gr];		// kjyoon
                 local_max_tp = 0;
                 for (uint32_t i = 0; i < m_nsupported; i++)
                 {
@@ -1023,7 +1045,6 @@ namespace ns3 {
                         }
                     }
                 }
-                station->m_minstrelTable_Allgroup[i_gr] = tmp_minstrelTable;		// kjyoon
             }
 
 
@@ -1031,7 +1052,7 @@ namespace ns3 {
             /// find the second highest max
             for (uint32_t i_gr = 0; i_gr < station->m_ngroup; i_gr++)
             {
-                tmp_minstrelTable = station->m_minstrelTable_Allgroup[i_gr];		// kjyoon
+                const MinstrelRate &tmp_minstrelTable = station->m_minstrelTable_Allgroup[i_gr];		// kjyoon
                 local_max_tp = 0;
                 for (uint32_t i = 0; i < m_nsupported; i++)
                 {
@@ -1048,7 +1069,6 @@ namespace ns3 {
                         max_tp = tmp_minstrelTable[i].throughput;
                     }
                 }
-                station->m_minstrelTable_Allgroup[i_gr] = tmp_minstrelTable;		// kjyoon
             }
 
             NS_LOG_DEBUG("maxTpRate: " << index_max_tp << "," << index_group_max_tp 
@@ -1084,12 +1104,9 @@ namespace ns3 {
         MinstrelWifiManager::RateInit (MinstrelWifiRemoteStation *station)
         {
             //NS_LOG_DEBUG ("RateInit=" << station);
-            MinstrelRate tmp_minstrelTable;	// kjyoon
-            int64_t tmp_Nss;	// kjyoon
             for (uint32_t i_gr = 0; i_gr < station->m_ngroup; i_gr++)
             {
-                tmp_minstrelTable = station->m_minstrelTable_Allgroup[i_gr];		// kjyoon
-                tmp_Nss = i_gr + 1;
+                MinstrelRate &tmp_minstrelTable = station->m_minstrelTable_Allgroup[i_gr];		// kjyoon
                 for (uint32_t i = 0; i < m_nsupported; i++)
                 {
                     tmp_minstrelTable[i].numRateAttempt = 0;
@@ -1102,17 +1119,19 @@ namespace ns3 {
                     tmp_minstrelTable[i].attemptHist = 0;
                     tmp_minstrelTable[i].throughput = 0;
                     //11ac: multiple multiple_stream_tx_ra
+                    WifiMode mode;
                     if (HasVhtSupported())
-                        tmp_minstrelTable[i].perfectTxTime = GetCalcTxTime (AcMcsToWifiMode(GetMcsSupported (station, i), GetCurrentBandwidth(station)));
+                        mode = AcMcsToWifiMode(GetMcsSupported (station, i), GetCurrentBandwidth(station));
                     else if (HasHtSupported())	  
-                        tmp_minstrelTable[i].perfectTxTime = GetCalcTxTime (McsToWifiMode(GetMcsSupported (station, i)));
+                        mode = McsToWifiMode(GetMcsSupported (station, i));
                     else
-                        tmp_minstrelTable[i].perfectTxTime = GetCalcTxTime (GetSupported (station, i));
-                    tmp_minstrelTable[i].perfectTxTime = tmp_minstrelTable[i].perfectTxTime / tmp_Nss;	// kjyoon	// For simplification, we just divide perfectTxTime by # of spatial stream.
+                        mode = GetSupported (station, i);
+                    // the perfect tx time of each group is in the shared rate table
+                    NS_ASSERT (GetCalcTxTime (mode).IsStrictlyPositive ());
+                    tmp_minstrelTable[i].modeUid = mode.GetUid ();
                     tmp_minstrelTable[i].retryCount = 1;
                     tmp_minstrelTable[i].adjustedRetryCount = 1;
                 }
-                station->m_minstrelTable_Allgroup[i_gr] = tmp_minstrelTable;		// kjyoon
             }
         }
 
@@ -1131,8 +1150,7 @@ namespace ns3 {
             uint32_t newIndex;
             for (uint32_t i_gr = 0; i_gr < station->m_ngroup; i_gr++)
             {
-                SampleRate tmp_sampleTable;	// kjyoon
-                tmp_sampleTable = station->m_sampleTable_Allgroup[i_gr];	// kjyoon
+                SampleRate &tmp_sampleTable = station->m_sampleTable_Allgroup[i_gr];	// kjyoon
 
                 for (uint32_t col = 0; col < m_sampleCol; col++)
                 {
@@ -1147,15 +1165,14 @@ namespace ns3 {
                         newIndex = (i + uv) % numSampleRates;
 
                         /// this loop is used for filling in other uninitilized places
-                        while (tmp_sampleTable[newIndex][col] != 0)
+                        while (tmp_sampleTable[newIndex * m_sampleCol + col] != 0)
                         {
                             newIndex = (newIndex + 1) % m_nsupported;
                         }
-                        tmp_sampleTable[newIndex][col] = i;
+                        tmp_sampleTable[newIndex * m_sampleCol + col] = i;
 
                     }
                 }
-                station->m_sampleTable_Allgroup[i_gr] = tmp_sampleTable ;	// kjyoon
             }
         }
 
@@ -1165,17 +1182,16 @@ namespace ns3 {
             NS_LOG_DEBUG ("PrintSampleTable=" << station);
 
             uint32_t numSampleRates = m_nsupported;
-            SampleRate tmp_sampleTable;	// kjyoon
 
             for (uint32_t i_gr = 0; i_gr < station->m_ngroup; i_gr++)	// kjyoon
             {
-                tmp_sampleTable = station->m_sampleTable_Allgroup[i_gr];	// kjyoon
+                const SampleRate &tmp_sampleTable = station->m_sampleTable_Allgroup[i_gr];	// kjyoon
                 std::cout << "[Group " << i_gr << "]\n";
                 for (uint32_t i = 0; i < numSampleRates; i++)
                 {
                     for (uint32_t j = 0; j < m_sampleCol; j++)
                     {
-                        std::cout << tmp_sampleTable[i][j] << "\t";
+                        std::cout << tmp_sampleTable[i * m_sampleCol + j] << "\t";
                     }
                     std::cout << std::endl;
                 }
@@ -1187,11 +1203,9 @@ namespace ns3 {
         {
             NS_LOG_DEBUG ("PrintTable=" << station);
 
-            MinstrelRate tmp_minstrelTable;	// kjyoon
-
             for (uint32_t i_gr = 0; i_gr < station->m_ngroup; i_gr++)	// kjyoon
             {
-                tmp_minstrelTable = station->m_minstrelTable_Allgroup[i_gr];	// kjyoon
+                const MinstrelRate &tmp_minstrelTable = station->m_minstrelTable_Allgroup[i_gr];	// kjyoon
                 //		std::cout << "[Group " << i_gr << "]\n";
                 NS_LOG_DEBUG ("[Group " << i_gr << "]");
                 for (uint32_t i = 0; i < m_nsupported; i++)
@@ -38,10 +38,10 @@ struct MinstrelWifiRemoteStation;
 struct RateInfo
 {
   /**
-   * Perfect transmission time calculation, or frame calculation
-   * Given a bit rate and a packet length n bytes
+   * The mode of the rate, its index in the MinstrelRateTable which holds
+   * the perfect transmission time of the rate
    */
-  Time perfectTxTime;
+  uint32_t modeUid;
 
 
   uint32_t retryCount;  ///< retry limit
@@ -71,9 +71,55 @@ typedef std::vector<struct RateInfo> MinstrelRate;
 
 /**
  * Data structure for a Sample Rate table
- * A vector of a vector uint32_t
+ * The rows of the rates one after the other, a row has one entry per
+ * sample column
  */
-typedef std::vector<std::vector<uint32_t> > SampleRate;
+typedef std::vector<uint32_t> SampleRate;
+
+/**
+ * \brief the transmission times of the modes of a PHY
+ * \ingroup wifi
+ *
+ * Built once by MinstrelWifiManager::SetupPhy and shared by all the
+ * stations of the manager, indexed by the uid of the mode (a VHT mode
+ * is one mode per bandwidth): the time to send the reference packet with
+ * the mode and, per number of spatial streams, the throughput scale of
+ * the perfect transmission time of a stream, which the success
+ * probability is multiplied with to get the throughput of the rate.
+ */
+class MinstrelRateTable
+{
+public:
+  /// the number of spatial streams (Minstrel groups)
+  static const uint8_t MAX_NSS = 3;
+
+  /**
+   * \param mode the mode
+   * \param txTime the time to send the reference packet with the mode,
+   *        the first time added for a mode is kept
+   */
+  void Add (WifiMode mode, Time txTime);
+  /**
+   * \param mode the mode, which must have been added
+   * \return the time to send the reference packet with the mode
+   */
+  Time GetTxTime (WifiMode mode) const;
+  /**
+   * \param uid the uid of the mode, which must have been added
+   * \param nss the number of spatial streams
+   * \return 1000000 / the perfect transmission time (us) of a stream
+   */
+  int64_t GetThroughputScale (uint32_t uid, uint8_t nss) const;
+
+private:
+  struct Entry
+  {
+    bool valid;
+    Time txTime;
+    int64_t scale[MAX_NSS];
+  };
+  std::vector<Entry> m_entries;
+};
 
 
 /**
@@ -111,6 +157,7 @@ public:
   virtual bool DoIsSampling(WifiRemoteStation *st);
   virtual void DoUpdateMinstrelTable(WifiRemoteStation *st, uint32_t success, uint32_t attempt);
   virtual void DoUpdateSumAmpdu(WifiRemoteStation *st, uint32_t mpdus);
+  virtual double DoGetAverageAmpduLength (WifiRemoteStation *st);
   void DowngradeRate (WifiRemoteStation *st);
 
 private:
@@ -135,7 +182,7 @@ private:
   /// for estimating the TxTime of a packet with a given mode
   Time GetCalcTxTime (WifiMode mode) const;
   /**
-   * Add transmission time for the given mode to an internal list.
+   * Add transmission time for the given mode to the rate table.
    *
    * \param mode Wi-Fi mode
    * \param t transmission time
@@ -168,12 +215,6 @@ private:
 
   void CheckInit (MinstrelWifiRemoteStation *station);  ///< check for initializations
 
-  /**
-   * typedef for a vector of a pair of Time, WifiMode.
-   * (Essentially a list for WifiMode and its corresponding transmission time
-   * to transmit a reference packet.
-   */
-  typedef std::vector<std::pair<Time,WifiMode> > TxTime;
 /*  MinstrelRate m_minstrelTable;  ///< minstrel table
   MinstrelRate m_minstrelTable_Allgroup[3];	// kjyoon
   SampleRate m_sampleTable;  ///< sample table
@@ -182,7 +223,7 @@ private:
   bool m_updatedByBlockAck;		// GotBlockAck function in edca-txop-n.cc kjyoon
 */
 
-  TxTime m_calcTxTime;  ///< to hold all the calculated TxTime for all modes
+  MinstrelRateTable m_calcTxTime;  ///< to hold all the calculated TxTime for all modes
   Time m_updateStats;  ///< how frequent do we calculate the stats(1/10 seconds)
   double m_lookAroundRate;  ///< the % to try other rates than our current rate
   double m_ewmaLevel;  ///< exponential weighted moving average
@@ -18,6 +18,12 @@ MpduAggregator::GetTypeId (void)
   return tid;
 }
 
+uint32_t
+MpduAggregator::CalculatePadding (uint32_t ampduSize)
+{
+  return (4 - (ampduSize % 4)) % 4;
+}
+
 MpduAggregator::DeaggregatedMpdus
 MpduAggregator::Deaggregate (Ptr<Packet> aggregatedPacket)
 {
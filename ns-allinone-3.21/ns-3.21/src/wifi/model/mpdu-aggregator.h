@@ -31,6 +31,21 @@ public:
   virtual bool Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacket) = 0;
 
   virtual uint32_t GetMaxAvailableLength (Ptr<Packet> aggregatedPacket) = 0; 
+  /**
+   * \param ampduSize the size of an A-MPDU
+   * \return the size of the largest MPDU which can still be added to it
+   *
+   * Lets an A-MPDU be planned before it is built: an MPDU can be added
+   * by Aggregate if and only if its size is at most this length.
+   */
+  virtual uint32_t GetMaxAvailableLength (uint32_t ampduSize) = 0;
+
+  /**
+   * \param ampduSize the size of an A-MPDU
+   * \return the padding to add before the next subframe, so that each
+   *         subframe starts on a multiple of 4 octets
+   */
+  static uint32_t CalculatePadding (uint32_t ampduSize);
 
   static DeaggregatedMpdus Deaggregate (Ptr<Packet> aggregatedPacket);
 };
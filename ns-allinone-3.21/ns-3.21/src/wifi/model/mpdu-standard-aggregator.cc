@@ -39,8 +39,8 @@ MpduStandardAggregator::Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggrega
   Ptr<Packet> currentPacket;
   AmpduMpduDelimiter currentHdr;
 
-  uint32_t padding = CalculatePadding (aggregatedPacket);
   uint32_t actualSize = aggregatedPacket->GetSize ();
+  uint32_t padding = CalculatePadding (actualSize);
 
 	NS_LOG_DEBUG("padding size: "<< padding <<
 							 ", actual size"<< actualSize );
@@ -65,27 +65,26 @@ MpduStandardAggregator::Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggrega
 uint32_t
 MpduStandardAggregator::GetMaxAvailableLength (Ptr<Packet> aggregatedPacket)
 {
-  NS_LOG_FUNCTION (this);
-  uint32_t padding = CalculatePadding (aggregatedPacket);
-  uint32_t actualSize = aggregatedPacket->GetSize ();
+  return GetMaxAvailableLength (aggregatedPacket->GetSize ());
+}
+
+uint32_t
+MpduStandardAggregator::GetMaxAvailableLength (uint32_t ampduSize)
+{
+  NS_LOG_FUNCTION (this << ampduSize);
+  uint32_t padding = CalculatePadding (ampduSize);
 
   NS_LOG_DEBUG("padding size: "<< padding <<
-							 ", actual size: "<< actualSize );
+							 ", actual size: "<< ampduSize );
 
 
-	if (m_maxAmpduLength -14 -actualSize -padding > m_maxAmpduLength) 
+	if (m_maxAmpduLength -14 -ampduSize -padding > m_maxAmpduLength) 
 		return 0;
 	else 
-	  return (m_maxAmpduLength - 14 - actualSize - padding);
+	  return (m_maxAmpduLength - 14 - ampduSize - padding);
   
 }
 
-uint32_t
-MpduStandardAggregator::CalculatePadding (Ptr<const Packet> packet)
-{
-  return (4 - (packet->GetSize () % 4 )) % 4;
-}
-
 
 }  // namespace ns3
 
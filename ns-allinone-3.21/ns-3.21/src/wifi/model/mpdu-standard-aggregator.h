@@ -28,13 +28,8 @@ public:
   virtual bool Aggregate (Ptr<const Packet> packet, Ptr<Packet> aggregatedPacket);
   
   virtual uint32_t GetMaxAvailableLength (Ptr<Packet> aggregatedPacket);
+  virtual uint32_t GetMaxAvailableLength (uint32_t ampduSize);
 private:
-  /*  Calculates how much padding must be added to the end of aggregated packet,
-      after that a new packet is added.
-      Each A-MPDU subframe is padded so that its length is multiple of 4 octets.
-   */
-  uint32_t CalculatePadding (Ptr<const Packet> packet);
-  
   uint32_t m_maxAmpduLength;
 };
 
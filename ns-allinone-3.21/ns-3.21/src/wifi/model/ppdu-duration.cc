@@ -0,0 +1,200 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <deque>
+#include <vector>
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ppdu-duration.h"
+#include "wifi-phy.h"
+
+NS_LOG_COMPONENT_DEFINE ("PpduDuration");
+
+namespace ns3 {
+
+PpduDuration::PpduDuration ()
+  : m_symbolDurationUs (0),
+    m_numDataBitsPerSymbol (0),
+    m_stbc (1),
+    m_serviceBits (0),
+    m_tailBits (0),
+    m_signalExtensionUs (0)
+{
+  for (uint32_t i = 0; i <= WIFI_PREAMBLE_VHT; i++)
+    {
+      m_headerUs[i] = -1;
+    }
+}
+
+PpduDuration::PpduDuration (WifiTxVector txVector)
+  : m_txVector (txVector),
+    m_stbc (1),
+    m_serviceBits (16),
+    m_tailBits (6),
+    m_signalExtensionUs (0)
+{
+  for (uint32_t i = 0; i <= WIFI_PREAMBLE_VHT; i++)
+    {
+      m_headerUs[i] = -1;
+    }
+  WifiMode payloadMode = txVector.GetMode ();
+  switch (payloadMode.GetModulationClass ())
+    {
+    case WIFI_MOD_CLASS_OFDM:
+    case WIFI_MOD_CLASS_ERP_OFDM:
+      {
+        // (Section 18.3.2.4 "Timing related parameters" Table 18-5 "Timing-related parameters"; IEEE Std 802.11-2012
+        // corresponds to T_{SYM} in the table)
+        uint32_t symbolDurationUs;
+
+        switch (payloadMode.GetBandwidth ())
+          {
+          case 20000000:
+          default:
+            symbolDurationUs = 4;
+            break;
+          case 10000000:
+            symbolDurationUs = 8;
+            break;
+          case 5000000:
+            symbolDurationUs = 16;
+            break;
+          }
+        m_symbolDurationUs = symbolDurationUs;
+
+        // (Section 18.3.2.3 "Modulation-dependent parameters" Table 18-4 "Modulation-dependent parameters"; IEEE Std 802.11-2012)
+        // corresponds to N_{DBPS} in the table
+        m_numDataBitsPerSymbol = payloadMode.GetDataRate () * symbolDurationUs / 1e6;
+
+        // Add signal extension for ERP PHY
+        if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM)
+          {
+            m_signalExtensionUs = 6;
+          }
+        break;
+      }
+    case WIFI_MOD_CLASS_HT:
+      {
+        //if short GI data rate is used then symbol duration is 3.6us else symbol duration is 4us
+        //In the future has to create a stationmanager that only uses these data rates if sender and reciever support GI
+        if (payloadMode.GetUniqueName () == "OfdmRate135MbpsBW40MHzShGi" || payloadMode.GetUniqueName () == "OfdmRate65MbpsBW20MHzShGi" )
+          {
+            m_symbolDurationUs = 3.6;
+          }
+        else
+          {
+            switch (payloadMode.GetDataRate ()) //11ac: multiple_stream_tx_etc
+              { //shortGi
+              case 7200000:
+              case 14400000:
+              case 21700000:
+              case 28900000:
+              case 43300000:
+              case 57800000:
+              case 72200000:
+              case 15000000:
+              case 30000000:
+              case 45000000:
+              case 60000000:
+              case 90000000:
+              case 120000000:
+              case 150000000:
+                m_symbolDurationUs = 3.6;
+                break;
+              default:
+                m_symbolDurationUs = 4;
+              }
+          }
+        if (txVector.IsStbc ())
+          {
+            m_stbc = 2;
+          }
+        m_numDataBitsPerSymbol = payloadMode.GetDataRate () * txVector.GetNss () * m_symbolDurationUs / 1e6;
+        //check tables 20-35 and 20-36 in the standard to get cases when nes =2
+        // IEEE Std 802.11n, section 20.3.11, equation (20-32)
+        m_tailBits = 6.0 * 1;
+        break;
+      }
+    case WIFI_MOD_CLASS_VHT: //11ac: vht_standard
+      {
+        m_symbolDurationUs = 3.6;
+        if (txVector.IsStbc ())
+          {
+            m_stbc = 2;
+          }
+        m_numDataBitsPerSymbol = payloadMode.GetDataRate () * txVector.GetNss () * m_symbolDurationUs / 1e6;
+        m_tailBits = 6.0 * 0;
+        break;
+      }
+    case WIFI_MOD_CLASS_DSSS:
+      // (Section 17.2.3.6 "Long PLCP LENGTH field"; IEEE Std 802.11-2012)
+      // one bit per "symbol" of a microsecond, no SERVICE field nor tail
+      m_symbolDurationUs = 1;
+      m_numDataBitsPerSymbol = payloadMode.GetDataRate () / 1.0e6;
+      m_serviceBits = 0;
+      m_tailBits = 0;
+      break;
+    default:
+      NS_FATAL_ERROR ("unsupported modulation class");
+    }
+}
+
+const PpduDuration &
+PpduDuration::Get (WifiTxVector txVector)
+{
+  // the deque owns the durations and never moves them, the vector
+  // indexes them by key
+  static std::deque<PpduDuration> durations;
+  static std::vector<const PpduDuration *> index;
+  uint32_t key = ((txVector.GetMode ().GetUid () << 8) + txVector.GetNss ()) * 2 + (txVector.IsStbc () ? 1 : 0);
+  if (key >= index.size ())
+    {
+      index.resize (key + 1, 0);
+    }
+  if (index[key] == 0)
+    {
+      NS_LOG_DEBUG ("durations of " << txVector);
+      durations.push_back (PpduDuration (txVector));
+      index[key] = &durations.back ();
+    }
+  return *index[key];
+}
+
+double
+PpduDuration::GetPayloadDurationMicroSeconds (uint32_t size) const
+{
+  // IEEE Std 802.11-2012, Equation 18-11, and IEEE Std 802.11n, equation (20-32)
+  uint32_t numSymbols = lrint (m_stbc * ceil ((m_serviceBits + size * 8.0 + m_tailBits) / (m_stbc * m_numDataBitsPerSymbol)));
+  return numSymbols * m_symbolDurationUs + m_signalExtensionUs;
+}
+
+Time
+PpduDuration::Calculate (uint32_t size, WifiPreamble preamble) const
+{
+  NS_ASSERT (preamble <= WIFI_PREAMBLE_VHT);
+  if (m_headerUs[preamble] < 0)
+    {
+      WifiMode payloadMode = m_txVector.GetMode ();
+      m_headerUs[preamble] = WifiPhy::GetPlcpPreambleDurationMicroSeconds (payloadMode, preamble)
+        + WifiPhy::GetPlcpHeaderDurationMicroSeconds (payloadMode, preamble)
+        + WifiPhy::GetPlcpHtSigHeaderDurationMicroSeconds (payloadMode, preamble)
+        + WifiPhy::GetPlcpHtTrainingSymbolDurationMicroSeconds (payloadMode, preamble, m_txVector);
+    }
+  return MicroSeconds (m_headerUs[preamble] + GetPayloadDurationMicroSeconds (size));
+}
+
+} // namespace ns3
@@ -0,0 +1,82 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef PPDU_DURATION_H
+#define PPDU_DURATION_H
+
+#include <stdint.h>
+#include "ns3/nstime.h"
+#include "wifi-tx-vector.h"
+#include "wifi-preamble.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief the duration of the PPDUs of one TX vector
+ *
+ * The payload of a PPDU is a whole number of symbols. Once the symbol
+ * duration and the data bits per symbol of a TX vector are known, the
+ * duration of a PPDU is a closed form of its size, the number of symbols
+ * being a single division. The durations are those of
+ * WifiPhy::CalculateTxDuration, without looking the modulation of the
+ * mode up again for every size.
+ *
+ * Only the mode, the number of spatial streams and STBC change the
+ * durations, so that Get keeps one PpduDuration per combination for the
+ * whole simulation.
+ */
+class PpduDuration
+{
+public:
+  PpduDuration ();
+  /**
+   * \param txVector the TX vector of the PPDUs
+   */
+  PpduDuration (WifiTxVector txVector);
+
+  /**
+   * \param txVector the TX vector of the PPDUs
+   * \return the PpduDuration of the mode, the number of spatial streams
+   *         and STBC of the TX vector, created on first use
+   */
+  static const PpduDuration & Get (WifiTxVector txVector);
+
+  /**
+   * \param size the number of bytes of the PSDU
+   * \return the duration of the payload in microseconds
+   */
+  double GetPayloadDurationMicroSeconds (uint32_t size) const;
+  /**
+   * \param size the number of bytes of the PSDU
+   * \param preamble the type of preamble
+   * \return the duration of the PPDU, as WifiPhy::CalculateTxDuration
+   */
+  Time Calculate (uint32_t size, WifiPreamble preamble) const;
+
+private:
+  WifiTxVector m_txVector;        //!< the TX vector of the PPDUs
+  double m_symbolDurationUs;      //!< the duration of a symbol
+  double m_numDataBitsPerSymbol;  //!< the data bits of a symbol, over all the spatial streams
+  double m_stbc;                  //!< 2 with STBC, 1 otherwise
+  double m_serviceBits;           //!< the bits of the SERVICE field
+  double m_tailBits;              //!< the tail bits
+  double m_signalExtensionUs;     //!< the signal extension of ERP-OFDM
+  mutable double m_headerUs[WIFI_PREAMBLE_VHT + 1]; //!< the PLCP preamble and headers, by preamble, negative until needed
+};
+
+} // namespace ns3
+
+#endif /* PPDU_DURATION_H */
@@ -1,18 +0,0 @@
-#ifndef RBIR_H
-#define RBIR_H 
-
-//#include <stdint.h>
-namespace ns3 {
-
-double InterferenceHelper::RBIR [4][95] = {
-	{0.014400, 0.016000, 0.017700, 0.019700, 0.022200, 0.024900, 0.028300, 0.031200, 0.035700, 0.039500, 0.043600, 0.049000, 0.055900, 0.060200, 0.067800, 0.077700, 0.085900, 0.095900, 0.104700, 0.118200, 0.134500, 0.147000, 0.162100, 0.180300, 0.201700, 0.221500, 0.249000, 0.270300, 0.292100, 0.316900, 0.350800, 0.377900, 0.414100, 0.446400, 0.493400, 0.524900, 0.566500, 0.602200, 0.646000, 0.681200, 0.722800, 0.752600, 0.804200, 0.831200, 0.855500, 0.885300, 0.909500, 0.933400, 0.953500, 0.964700, 0.977900, 0.987200, 0.988700, 0.994000, 0.997100, 0.998400, 0.999200, 0.999800, 0.999900, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000},
-    {0.007200, 0.008000, 0.009000, 0.010100, 0.011400, 0.012700, 0.014300, 0.015900, 0.017900, 0.020000, 0.022500, 0.025100, 0.028200, 0.031500, 0.035200, 0.039400, 0.044200, 0.049300, 0.055100, 0.061600, 0.068800, 0.076700, 0.085500, 0.095300, 0.106100, 0.118000, 0.131100, 0.145600, 0.161500, 0.178800, 0.197800, 0.218400, 0.240700, 0.265000, 0.291000, 0.319000, 0.348900, 0.380600, 0.414100, 0.449300, 0.485900, 0.523900, 0.562800, 0.602400, 0.642200, 0.681700, 0.720700, 0.758400, 0.794400, 0.828100, 0.859200, 0.887200, 0.911900, 0.933100, 0.950700, 0.964900, 0.976000, 0.984200, 0.990100, 0.994200, 0.996800, 0.998300, 0.999200, 0.999700, 0.999900, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000},
-    {0.003600, 0.004000, 0.004500, 0.005000, 0.005700, 0.006300, 0.007100, 0.008000, 0.008900, 0.010000, 0.011200, 0.012600, 0.014100, 0.015800, 0.017600, 0.019700, 0.022100, 0.024700, 0.027600, 0.030800, 0.034400, 0.038400, 0.042800, 0.047600, 0.053100, 0.059000, 0.065600, 0.072800, 0.080800, 0.089500, 0.099000, 0.109400, 0.120600, 0.132900, 0.146100, 0.160300, 0.175600, 0.192000, 0.209400, 0.227900, 0.247400, 0.268000, 0.289600, 0.312200, 0.335700, 0.360000, 0.385200, 0.411200, 0.437900, 0.465300, 0.493300, 0.521900, 0.550900, 0.580400, 0.610300, 0.640300, 0.670900, 0.701400, 0.731700, 0.761700, 0.791000, 0.819300, 0.846300, 0.871600, 0.894900, 0.915800, 0.934300, 0.950100, 0.963300, 0.973900, 0.982100, 0.988300, 0.992700, 0.995700, 0.997600, 0.998800, 0.999400, 0.999700, 0.999900, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000, 1.000000},
-    {0.002400, 0.002700, 0.003000, 0.003400, 0.003800, 0.004300, 0.004700, 0.005400, 0.006000, 0.006700, 0.007500, 0.008400, 0.009400, 0.010600, 0.011700, 0.013200, 0.014700, 0.016500, 0.018400, 0.020700, 0.022900, 0.025700, 0.028500, 0.031900, 0.035400, 0.039600, 0.043700, 0.048800, 0.053900, 0.059900, 0.066000, 0.073200, 0.080500, 0.089000, 0.097400, 0.107300, 0.117200, 0.128500, 0.139800, 0.152500, 0.165300, 0.179500, 0.193700, 0.209200, 0.224700, 0.241500, 0.258300, 0.276300, 0.294200, 0.313200, 0.332100, 0.351900, 0.371800, 0.392400, 0.413100, 0.434500, 0.455800, 0.477800, 0.499700, 0.522300, 0.544800, 0.567700, 0.590700, 0.614100, 0.637400, 0.661100, 0.684800, 0.708700, 0.732500, 0.756400, 0.780200, 0.803600, 0.826900, 0.848900, 0.870800, 0.890400, 0.910000, 0.926200, 0.942500, 0.954700, 0.966800, 0.973200, 0.979600, 0.984000, 0.988300, 0.991000, 0.993700, 0.995400, 0.997100, 0.998300, 0.999500, 0.999800, 1.000000, 1.000000, 1.000000}
-
-};
-
-
-}
-
-#endif /* RBIR_H */
@@ -202,6 +202,12 @@ RegularWifiMac::GetBKQueue () const
   return m_edca.find (AC_BK)->second;
 }
 
+Ptr<MacLow>
+RegularWifiMac::GetMacLow () const
+{
+  return m_low;
+}
+
 void
 RegularWifiMac::SetWifiPhy (Ptr<WifiPhy> phy)
 {
@@ -708,6 +714,11 @@ RegularWifiMac::GetTypeId (void)
                    PointerValue (),
                    MakePointerAccessor (&RegularWifiMac::GetBKQueue),
                    MakePointerChecker<EdcaTxopN> ())
+    .AddAttribute ("MacLow",
+                   "The MacLow, which sends the frames and aggregates the MPDUs",
+                   PointerValue (),
+                   MakePointerAccessor (&RegularWifiMac::GetMacLow),
+                   MakePointerChecker<MacLow> ())
     .AddTraceSource ( "TxOkHeader",
                       "The header of successfully transmitted packet",
                       MakeTraceSourceAccessor (&RegularWifiMac::m_txOkCallback))
@@ -290,6 +290,12 @@ protected:
    * \return a smart pointer to EdcaTxopN
    */
   Ptr<EdcaTxopN> GetBKQueue (void) const;
+  /**
+   * Accessor for the MacLow
+   *
+   * \return a smart pointer to MacLow
+   */
+  Ptr<MacLow> GetMacLow (void) const;
 
   /**
    * \param standard the phy standard to be used
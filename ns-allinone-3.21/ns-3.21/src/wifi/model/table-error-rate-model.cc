@@ -0,0 +1,333 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#include <cmath>
+#include <map>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include "table-error-rate-model.h"
+#include "wifi-phy.h"
+#include "ns3/string.h"
+#include "ns3/log.h"
+
+NS_LOG_COMPONENT_DEFINE ("TableErrorRateModel");
+
+namespace ns3 {
+
+static const double MIN_SNR_DB = -10.0;
+static const double SNR_STEP_DB = 0.05;
+static const uint32_t N_SNR = 1001;
+
+/// ln (pe) of a bit which is always received
+static const double MIN_EXPONENT = -1000.0;
+
+/**
+ * \param pe the error rate of one bit
+ * \return ln (pe), clamped
+ */
+static double
+GetExponent (double pe)
+{
+  if (!(pe > 0))
+    {
+      return MIN_EXPONENT;
+    }
+  return std::max (MIN_EXPONENT, std::log (pe));
+}
+
+/**
+ * The curves of the NistErrorRateModel, computed once from a mode of
+ * each constellation and code rate it supports.
+ */
+class NistErrorRateCurves
+{
+public:
+  NistErrorRateCurves ();
+  /**
+   * \param curve the index of the curve
+   * \return the curve, 0 if none
+   */
+  const double * Get (int32_t curve) const;
+
+private:
+  std::vector<double> m_curves[20];
+};
+
+NistErrorRateCurves::NistErrorRateCurves ()
+{
+  Ptr<NistErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+  WifiMode modes[] = { WifiPhy::GetOfdmRate6Mbps (), WifiPhy::GetOfdmRate9Mbps (),
+                       WifiPhy::GetOfdmRate12Mbps (), WifiPhy::GetOfdmRate18Mbps (),
+                       WifiPhy::GetOfdmRate24Mbps (), WifiPhy::GetOfdmRate36Mbps (),
+                       WifiPhy::GetOfdmRate48Mbps (), WifiPhy::GetOfdmRate54Mbps (),
+                       WifiPhy::Get11acMcs7BW20MHz () };
+  for (uint32_t m = 0; m < sizeof (modes) / sizeof (modes[0]); m++)
+    {
+      std::vector<double> &curve = m_curves[TableErrorRateModel::GetCurveIndex (modes[m])];
+      curve.resize (N_SNR);
+      uint32_t first = N_SNR;
+      for (uint32_t i = 0; i < N_SNR; i++)
+        {
+          double snr = std::pow (10.0, (MIN_SNR_DB + i * SNR_STEP_DB) / 10.0);
+          double q = nist->GetChunkSuccessRate (modes[m], snr, 1);
+          curve[i] = GetExponent (1 - q);
+          if (q > 0 && first == N_SNR)
+            {
+              first = i;
+            }
+        }
+      // NIST clamps the union bound at 1, which leaves a kink that cannot
+      // be interpolated: extend the bound below it instead. The extension
+      // is not clamped, a positive exponent (pe > 1) is a zero success rate
+      NS_ASSERT (first + 1 < N_SNR);
+      double slope = curve[first + 1] - curve[first];
+      for (uint32_t i = 0; i < first; i++)
+        {
+          curve[i] = curve[first] + slope * (static_cast<double> (i) - first);
+        }
+    }
+}
+
+const double *
+NistErrorRateCurves::Get (int32_t curve) const
+{
+  return m_curves[curve].empty () ? 0 : &m_curves[curve][0];
+}
+
+static const NistErrorRateCurves &
+GetNistErrorRateCurves (void)
+{
+  static NistErrorRateCurves curves;
+  return curves;
+}
+
+NS_OBJECT_ENSURE_REGISTERED (TableErrorRateModel);
+
+TypeId
+TableErrorRateModel::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TableErrorRateModel")
+    .SetParent<ErrorRateModel> ()
+    .AddConstructor<TableErrorRateModel> ()
+    .AddAttribute ("CurveFile",
+                   "File of link level curves, one \"constellation codeRate bits snrDb per\" "
+                   "point per line. Only the curves of the NistErrorRateModel are used if empty.",
+                   StringValue (""),
+                   MakeStringAccessor (&TableErrorRateModel::SetCurveFile,
+                                       &TableErrorRateModel::GetCurveFile),
+                   MakeStringChecker ())
+  ;
+  return tid;
+}
+
+TableErrorRateModel::TableErrorRateModel ()
+  : m_nist (CreateObject<NistErrorRateModel> ())
+{
+  const NistErrorRateCurves &curves = GetNistErrorRateCurves ();
+  for (int32_t i = 0; i < 20; i++)
+    {
+      m_curves[i] = curves.Get (i);
+    }
+}
+
+int32_t
+TableErrorRateModel::GetCurveIndex (uint16_t constellation, enum WifiCodeRate rate)
+{
+  int32_t row;
+  switch (constellation)
+    {
+    case 2:
+      row = 0;
+      break;
+    case 4:
+      row = 1;
+      break;
+    case 16:
+      row = 2;
+      break;
+    case 64:
+      row = 3;
+      break;
+    case 256:
+      row = 4;
+      break;
+    default:
+      return -1;
+    }
+  switch (rate)
+    {
+    case WIFI_CODE_RATE_1_2:
+      return row * 4;
+    case WIFI_CODE_RATE_2_3:
+      return row * 4 + 1;
+    case WIFI_CODE_RATE_3_4:
+      return row * 4 + 2;
+    case WIFI_CODE_RATE_5_6:
+      return row * 4 + 3;
+    default:
+      return -1;
+    }
+}
+
+int32_t
+TableErrorRateModel::GetCurveIndex (WifiMode mode)
+{
+  if (mode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM || mode.GetModulationClass () == WIFI_MOD_CLASS_OFDM
+      || mode.GetModulationClass () == WIFI_MOD_CLASS_VHT || mode.GetModulationClass () == WIFI_MOD_CLASS_HT)
+    {
+      return GetCurveIndex (mode.GetConstellationSize (), mode.GetCodeRate ());
+    }
+  return -1;
+}
+
+void
+TableErrorRateModel::SetCurveFile (std::string filename)
+{
+  m_curveFile = filename;
+  if (!filename.empty ())
+    {
+      LoadCurves (filename);
+    }
+}
+
+std::string
+TableErrorRateModel::GetCurveFile (void) const
+{
+  return m_curveFile;
+}
+
+void
+TableErrorRateModel::LoadCurves (std::string filename)
+{
+  std::ifstream file (filename.c_str ());
+  if (!file.is_open ())
+    {
+      NS_FATAL_ERROR ("Can not open curve file " << filename);
+    }
+  // the (snr, exponent) points of each curve
+  std::map<int32_t, std::vector<std::pair<double, double> > > points;
+  std::string line;
+  uint32_t lineNumber = 0;
+  while (std::getline (file, line))
+    {
+      lineNumber++;
+      std::string::size_type start = line.find_first_not_of (" \t\r");
+      if (start == std::string::npos || line[start] == '#')
+        {
+          continue;
+        }
+      std::istringstream is (line);
+      uint32_t constellation, bits;
+      std::string rateName;
+      double snrDb, per;
+      if (!(is >> constellation >> rateName >> bits >> snrDb >> per) || bits == 0)
+        {
+          NS_FATAL_ERROR (filename << ":" << lineNumber << ": expected \"constellation codeRate bits snrDb per\"");
+        }
+      enum WifiCodeRate rate = WIFI_CODE_RATE_UNDEFINED;
+      if (rateName == "1/2")
+        {
+          rate = WIFI_CODE_RATE_1_2;
+        }
+      else if (rateName == "2/3")
+        {
+          rate = WIFI_CODE_RATE_2_3;
+        }
+      else if (rateName == "3/4")
+        {
+          rate = WIFI_CODE_RATE_3_4;
+        }
+      else if (rateName == "5/6")
+        {
+          rate = WIFI_CODE_RATE_5_6;
+        }
+      int32_t curve = GetCurveIndex (constellation, rate);
+      if (curve < 0)
+        {
+          NS_FATAL_ERROR (filename << ":" << lineNumber << ": no curve for " << constellation << " " << rateName);
+        }
+      // the error rate of one bit, 1 - (1 - per)^(1/bits)
+      double exponent = per < 1 ? GetExponent (-expm1 (log1p (-per) / bits)) : 0;
+      points[curve].push_back (std::make_pair (snrDb, exponent));
+    }
+
+  for (std::map<int32_t, std::vector<std::pair<double, double> > >::iterator i = points.begin ();
+       i != points.end (); i++)
+    {
+      std::vector<std::pair<double, double> > &p = i->second;
+      std::sort (p.begin (), p.end ());
+      std::vector<double> &curve = m_loaded[i->first];
+      curve.resize (N_SNR);
+      uint32_t j = 0;
+      for (uint32_t k = 0; k < N_SNR; k++)
+        {
+          double snrDb = MIN_SNR_DB + k * SNR_STEP_DB;
+          while (j < p.size () && p[j].first < snrDb)
+            {
+              j++;
+            }
+          if (j == 0)
+            {
+              curve[k] = p.front ().second;
+            }
+          else if (j == p.size ())
+            {
+              curve[k] = p.back ().second;
+            }
+          else
+            {
+              double f = (snrDb - p[j - 1].first) / (p[j].first - p[j - 1].first);
+              curve[k] = p[j - 1].second + f * (p[j].second - p[j - 1].second);
+            }
+        }
+      m_curves[i->first] = &curve[0];
+      NS_LOG_DEBUG ("curve " << i->first << ": " << p.size () << " points from " << filename);
+    }
+}
+
+double
+TableErrorRateModel::GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const
+{
+  int32_t index = GetCurveIndex (mode);
+  if (index < 0 || m_curves[index] == 0)
+    {
+      return m_nist->GetChunkSuccessRate (mode, snr, nbits);
+    }
+  const double *curve = m_curves[index];
+  double x = (10.0 * std::log10 (snr) - MIN_SNR_DB) / SNR_STEP_DB;
+  double exponent;
+  if (!(x > 0))
+    {
+      exponent = curve[0];
+    }
+  else if (x >= N_SNR - 1)
+    {
+      exponent = curve[N_SNR - 1];
+    }
+  else
+    {
+      uint32_t i = static_cast<uint32_t> (x);
+      exponent = curve[i] + (x - i) * (curve[i + 1] - curve[i]);
+    }
+  double pe = std::exp (exponent);
+  if (pe >= 1)
+    {
+      return 0;
+    }
+  return std::exp (nbits * log1p (-pe));
+}
+
+} // namespace ns3
@@ -0,0 +1,96 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef TABLE_ERROR_RATE_MODEL_H
+#define TABLE_ERROR_RATE_MODEL_H
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include "wifi-mode.h"
+#include "error-rate-model.h"
+#include "nist-error-rate-model.h"
+
+namespace ns3 {
+
+/**
+ * \ingroup wifi
+ * \brief an error rate model which looks up precomputed curves
+ *
+ * The success rate of a chunk of n bits is (1 - pe)^n, pe being the error
+ * rate of one bit, so one curve per constellation and code rate is
+ * enough: ln (pe) is tabulated every 0.05 dB from -10 dB to 40 dB and
+ * interpolated linearly, which is smooth enough for the error against
+ * the NistErrorRateModel curves it is computed from to stay below 1e-3
+ * (in absolute success rate, for any chunk size). Those curves are
+ * computed once and shared by all the instances.
+ *
+ * Link level curves can replace or complement them (256-QAM for
+ * instance) with the CurveFile attribute. Each line of the file is
+ * "constellation codeRate bits snrDb per", e.g. "16 3/4 8000 12.5 0.1",
+ * the PER of a packet of the given number of bits at the given SNR; the
+ * points of a curve are interpolated the same way. The modes without a
+ * curve (DSSS, and 256-QAM unless loaded) use the NistErrorRateModel.
+ */
+class TableErrorRateModel : public ErrorRateModel
+{
+public:
+  static TypeId GetTypeId (void);
+
+  TableErrorRateModel ();
+
+  /**
+   * Load the curves of a file, they replace the curves of the same
+   * constellation and code rate.
+   *
+   * \param filename the file of curves
+   */
+  void LoadCurves (std::string filename);
+
+  virtual double GetChunkSuccessRate (WifiMode mode, double snr, uint32_t nbits) const;
+
+  /**
+   * \param constellation the constellation size
+   * \param rate the code rate
+   * \return the index of the curve, -1 if the pair has none
+   */
+  static int32_t GetCurveIndex (uint16_t constellation, enum WifiCodeRate rate);
+  /**
+   * \param mode the mode
+   * \return the index of the curve of the mode, -1 if it has none
+   */
+  static int32_t GetCurveIndex (WifiMode mode);
+
+private:
+  /**
+   * \param filename the file of curves, none if empty
+   */
+  void SetCurveFile (std::string filename);
+  /**
+   * \return the file of curves
+   */
+  std::string GetCurveFile (void) const;
+
+  Ptr<NistErrorRateModel> m_nist;
+  /// ln (pe) on the grid, per constellation and code rate, 0 if none
+  const double *m_curves[20];
+  /// the curves loaded from a file
+  std::vector<double> m_loaded[20];
+  std::string m_curveFile;
+};
+
+} // namespace ns3
+
+#endif /* TABLE_ERROR_RATE_MODEL_H */
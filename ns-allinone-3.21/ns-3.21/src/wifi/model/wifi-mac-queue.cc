@@ -36,7 +36,20 @@ WifiMacQueue::Item::Item (Ptr<const Packet> packet,
                           Time tstamp)
   : packet (packet),
     hdr (hdr),
-    tstamp (tstamp)
+    tstamp (tstamp),
+    position (0),
+    receiver (0),
+    subQueue (0)
+{
+}
+
+WifiMacQueue::SubQueue::SubQueue ()
+  : size (0)
+{
+}
+
+WifiMacQueue::Receiver::Receiver ()
+  : size (0)
 {
 }
 
@@ -59,8 +72,11 @@ WifiMacQueue::GetTypeId (void)
 }
 
 WifiMacQueue::WifiMacQueue ()
-  : m_size (0)
+  : m_front (0),
+    m_back (0),
+    m_size (0)
 {
+  m_peeked = m_queue.end ();
 }
 
 WifiMacQueue::~WifiMacQueue ()
@@ -92,6 +108,69 @@ WifiMacQueue::GetMaxDelay (void) const
   return m_maxDelay;
 }
 
+void
+WifiMacQueue::Insert (Ptr<const Packet> packet, const WifiMacHeader &hdr, bool front)
+{
+  Time now = Simulator::Now ();
+  PacketQueueI it;
+  if (front)
+    {
+      it = m_queue.insert (m_queue.begin (), Item (packet, hdr, now));
+      it->position = --m_front;
+    }
+  else
+    {
+      it = m_queue.insert (m_queue.end (), Item (packet, hdr, now));
+      it->position = m_back++;
+    }
+  if (hdr.IsQosData ())
+    {
+      it->receiver = &m_receivers[hdr.GetAddr1 ()];
+      it->receiver->size++;
+      it->subQueue = &it->receiver->tids[hdr.GetQosTid ()];
+    }
+  else
+    {
+      it->subQueue = &m_others;
+    }
+  std::list<PacketQueueI> &items = it->subQueue->items;
+  it->inSubQueue = items.insert (front ? items.begin () : items.end (), it);
+  it->subQueue->size++;
+  // the timestamps are those of the insertions, they are in this order
+  it->inArrivals = m_arrivals.insert (m_arrivals.end (), it);
+  m_size++;
+}
+
+void
+WifiMacQueue::Erase (PacketQueueI it)
+{
+  if (it == m_peeked)
+    {
+      m_peeked = m_queue.end ();
+    }
+  it->subQueue->items.erase (it->inSubQueue);
+  it->subQueue->size--;
+  // FindFirstAvailable visits every receiver, keep only those with packets
+  if (it->receiver != 0 && --it->receiver->size == 0)
+    {
+      m_receivers.erase (it->hdr.GetAddr1 ());
+    }
+  m_arrivals.erase (it->inArrivals);
+  m_queue.erase (it);
+  m_size--;
+}
+
+WifiMacQueue::SubQueue *
+WifiMacQueue::FindSubQueue (uint8_t tid, Mac48Address addr)
+{
+  Receivers::iterator it = m_receivers.find (addr);
+  if (it == m_receivers.end () || tid >= 16)
+    {
+      return 0;
+    }
+  return &it->second.tids[tid];
+}
+
 void
 WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
 {
@@ -100,9 +179,7 @@ WifiMacQueue::Enqueue (Ptr<const Packet> packet, const WifiMacHeader &hdr)
     {
       return;
     }
-  Time now = Simulator::Now ();
-  m_queue.push_back (Item (packet, hdr, now));
-  m_size++;
+  Insert (packet, hdr, false);
 }
 
 void
@@ -114,20 +191,11 @@ WifiMacQueue::Cleanup (void)
     }
 
   Time now = Simulator::Now ();
-  uint32_t n = 0;
-  for (PacketQueueI i = m_queue.begin (); i != m_queue.end ();)
+  while (!m_arrivals.empty ()
+         && m_arrivals.front ()->tstamp + m_maxDelay <= now)
     {
-      if (i->tstamp + m_maxDelay > now)
-        {
-          i++;
-        }
-      else
-        {
-          i = m_queue.erase (i);
-          n++;
-        }
+      Erase (m_arrivals.front ());
     }
-  m_size -= n;
 }
 
 Ptr<const Packet>
@@ -137,8 +205,7 @@ WifiMacQueue::Dequeue (WifiMacHeader *hdr)
   if (!m_queue.empty ())
     {
       Item i = m_queue.front ();
-      m_queue.pop_front ();
-      m_size--;
+      Erase (m_queue.begin ());
       *hdr = i.hdr;
       return i.packet;
     }
@@ -164,6 +231,18 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
 {
   Cleanup ();
   Ptr<const Packet> packet = 0;
+  if (type == WifiMacHeader::ADDR1)
+    {
+      SubQueue *subQueue = FindSubQueue (tid, dest);
+      if (subQueue != 0 && subQueue->size > 0)
+        {
+          PacketQueueI it = subQueue->items.front ();
+          packet = it->packet;
+          *hdr = it->hdr;
+          Erase (it);
+        }
+      return packet;
+    }
   if (!m_queue.empty ())
     {
       PacketQueueI it;
@@ -176,8 +255,7 @@ WifiMacQueue::DequeueByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                 {
                   packet = it->packet;
                   *hdr = it->hdr;
-                  m_queue.erase (it);
-                  m_size--;
+                  Erase (it);
                   break;
                 }
             }
@@ -191,6 +269,17 @@ WifiMacQueue::PeekByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
                                    WifiMacHeader::AddressType type, Mac48Address dest)
 {
   Cleanup ();
+  if (type == WifiMacHeader::ADDR1)
+    {
+      SubQueue *subQueue = FindSubQueue (tid, dest);
+      if (subQueue != 0 && subQueue->size > 0)
+        {
+          m_peeked = subQueue->items.front ();
+          *hdr = m_peeked->hdr;
+          return m_peeked->packet;
+        }
+      return 0;
+    }
   if (!m_queue.empty ())
     {
       PacketQueueI it;
@@ -201,6 +290,7 @@ WifiMacQueue::PeekByTidAndAddress (WifiMacHeader *hdr, uint8_t tid,
               if (GetAddressForPacket (type, it) == dest
                   && it->hdr.GetQosTid () == tid)
                 {
+                  m_peeked = it;
                   *hdr = it->hdr;
                   return it->packet;
                 }
@@ -227,6 +317,12 @@ void
 WifiMacQueue::Flush (void)
 {
   m_queue.erase (m_queue.begin (), m_queue.end ());
+  m_arrivals.clear ();
+  m_receivers.clear ();
+  m_others = SubQueue ();
+  m_peeked = m_queue.end ();
+  m_front = 0;
+  m_back = 0;
   m_size = 0;
 }
 
@@ -251,13 +347,18 @@ WifiMacQueue::GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQ
 bool
 WifiMacQueue::Remove (Ptr<const Packet> packet)
 {
+  // the packet is usually the one which was just peeked
+  if (m_peeked != m_queue.end () && m_peeked->packet == packet)
+    {
+      Erase (m_peeked);
+      return true;
+    }
   PacketQueueI it = m_queue.begin ();
   for (; it != m_queue.end (); it++)
     {
       if (it->packet == packet)
         {
-          m_queue.erase (it);
-          m_size--;
+          Erase (it);
           return true;
         }
     }
@@ -272,9 +373,7 @@ WifiMacQueue::PushFront (Ptr<const Packet> packet, const WifiMacHeader &hdr)
     {
       return;
     }
-  Time now = Simulator::Now ();
-  m_queue.push_front (Item (packet, hdr, now));
-  m_size++;
+  Insert (packet, hdr, true);
 }
 
 uint32_t
@@ -282,6 +381,11 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, WifiMacHeader::AddressTyp
                                           Mac48Address addr)
 {
   Cleanup ();
+  if (type == WifiMacHeader::ADDR1)
+    {
+      SubQueue *subQueue = FindSubQueue (tid, addr);
+      return subQueue != 0 ? subQueue->size : 0;
+    }
   uint32_t nPackets = 0;
   if (!m_queue.empty ())
     {
@@ -300,24 +404,59 @@ WifiMacQueue::GetNPacketsByTidAndAddress (uint8_t tid, WifiMacHeader::AddressTyp
   return nPackets;
 }
 
+WifiMacQueue::PacketQueueI
+WifiMacQueue::FindFirstAvailable (const QosBlockedDestinations *blockedPackets)
+{
+  if (m_queue.empty ())
+    {
+      return m_queue.end ();
+    }
+  PacketQueueI first = m_queue.begin ();
+  if (!first->hdr.IsQosData ()
+      || !blockedPackets->IsBlocked (first->hdr.GetAddr1 (), first->hdr.GetQosTid ()))
+    {
+      return first;
+    }
+  // a pair is blocked or not as a whole, so the first available packet
+  // is the head of a sub-queue: the one closest to the front of the queue
+  first = m_queue.end ();
+  if (m_others.size > 0)
+    {
+      first = m_others.items.front ();
+    }
+  for (Receivers::iterator i = m_receivers.begin (); i != m_receivers.end (); i++)
+    {
+      for (uint8_t tid = 0; tid < 16; tid++)
+        {
+          const SubQueue &subQueue = i->second.tids[tid];
+          if (subQueue.size == 0)
+            {
+              continue;
+            }
+          PacketQueueI head = subQueue.items.front ();
+          if ((first == m_queue.end () || head->position < first->position)
+              && !blockedPackets->IsBlocked (i->first, tid))
+            {
+              first = head;
+            }
+        }
+    }
+  return first;
+}
+
 Ptr<const Packet>
 WifiMacQueue::DequeueFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
                                      const QosBlockedDestinations *blockedPackets)
 {
   Cleanup ();
   Ptr<const Packet> packet = 0;
-  for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
+  PacketQueueI it = FindFirstAvailable (blockedPackets);
+  if (it != m_queue.end ())
     {
-      if (!it->hdr.IsQosData ()
-          || !blockedPackets->IsBlocked (it->hdr.GetAddr1 (), it->hdr.GetQosTid ()))
-        {
-          *hdr = it->hdr;
-          timestamp = it->tstamp;
-          packet = it->packet;
-          m_queue.erase (it);
-          m_size--;
-          return packet;
-        }
+      *hdr = it->hdr;
+      timestamp = it->tstamp;
+      packet = it->packet;
+      Erase (it);
     }
   return packet;
 }
@@ -327,15 +466,12 @@ WifiMacQueue::PeekFirstAvailable (WifiMacHeader *hdr, Time &timestamp,
                                   const QosBlockedDestinations *blockedPackets)
 {
   Cleanup ();
-  for (PacketQueueI it = m_queue.begin (); it != m_queue.end (); it++)
+  PacketQueueI it = FindFirstAvailable (blockedPackets);
+  if (it != m_queue.end ())
     {
-      if (!it->hdr.IsQosData ()
-          || !blockedPackets->IsBlocked (it->hdr.GetAddr1 (), it->hdr.GetQosTid ()))
-        {
-          *hdr = it->hdr;
-          timestamp = it->tstamp;
-          return it->packet;
-        }
+      *hdr = it->hdr;
+      timestamp = it->tstamp;
+      return it->packet;
     }
   return 0;
 }
@@ -23,10 +23,12 @@
 #define WIFI_MAC_QUEUE_H
 
 #include <list>
+#include <map>
 #include <utility>
 #include "ns3/packet.h"
 #include "ns3/nstime.h"
 #include "ns3/object.h"
+#include "ns3/mac48-address.h"
 #include "wifi-mac-header.h"
 
 namespace ns3 {
@@ -46,6 +48,13 @@ class QosBlockedDestinations;
  * to verify whether or not it should be dropped. If
  * dot11EDCATableMSDULifetime has elapsed, it is dropped.
  * Otherwise, it is returned to the caller.
+ *
+ * Besides the queue order, every QoS data packet is linked in the FIFO
+ * of its (TID, receiver) pair, and every packet in the order in which
+ * it was queued (which is also the order of the timestamps). So the
+ * lookups by TID and ADDR1 take the head of a FIFO instead of walking
+ * the queue, and the expired packets are always the oldest ones of the
+ * arrival order.
  */
 class WifiMacQueue : public Object
 {
@@ -143,8 +152,9 @@ public:
                                          Mac48Address addr);
   /**
    * If exists, removes <i>packet</i> from queue and returns true. Otherwise it
-   * takes no effects and return false. Deletion of the packet is
-   * performed in linear time (O(n)).
+   * takes no effects and return false. Deletion of the last packet returned
+   * by PeekByTidAndAddress is performed in constant time, deletion of any
+   * other packet in linear time (O(n)).
    *
    * \param packet the packet to be removed
    * \return true if the packet was removed, false otherwise
@@ -234,6 +244,31 @@ protected:
    */
   Mac48Address GetAddressForPacket (enum WifiMacHeader::AddressType type, PacketQueueI it);
 
+  /**
+   * The packets of one (TID, receiver) pair, or the packets without one,
+   * in queue order.
+   */
+  struct SubQueue
+  {
+    SubQueue ();
+    std::list<PacketQueueI> items; //!< the packets
+    uint32_t size; //!< the number of packets
+  };
+  /**
+   * The sub-queue of each TID of a receiver. A receiver is removed when
+   * its last packet leaves the queue.
+   */
+  struct Receiver
+  {
+    Receiver ();
+    SubQueue tids[16]; //!< the sub-queues, by TID
+    uint32_t size; //!< the number of packets of all the TIDs
+  };
+  /**
+   * typedef for the receivers, by address 1.
+   */
+  typedef std::map<Mac48Address, Receiver> Receivers;
+
   /**
    * A struct that holds information about a packet for putting
    * in a packet queue.
@@ -253,9 +288,46 @@ protected:
     Ptr<const Packet> packet; //!< Actual packet
     WifiMacHeader hdr; //!< Wifi MAC header associated with the packet
     Time tstamp; //!< timestamp when the packet arrived at the queue
+    int64_t position; //!< increases from the front to the back of the queue
+    Receiver *receiver; //!< the receiver of a QoS data packet, 0 otherwise
+    SubQueue *subQueue; //!< the sub-queue of the packet
+    std::list<PacketQueueI>::iterator inSubQueue; //!< the packet in its sub-queue
+    std::list<PacketQueueI>::iterator inArrivals; //!< the packet in the arrival order
   };
 
+  /**
+   * Insert a packet at the front or at the back of the queue.
+   *
+   * \param packet the packet
+   * \param hdr the header of the packet
+   * \param front whether the packet is inserted at the front
+   */
+  void Insert (Ptr<const Packet> packet, const WifiMacHeader &hdr, bool front);
+  /**
+   * Remove a packet from the queue and from its sub-queue.
+   *
+   * \param it the packet
+   */
+  void Erase (PacketQueueI it);
+  /**
+   * \param tid the TID
+   * \param addr the receiver
+   * \return the sub-queue of the pair, 0 if the receiver has no packet
+   */
+  SubQueue *FindSubQueue (uint8_t tid, Mac48Address addr);
+  /**
+   * \param blockedPackets the blocked (receiver, TID) pairs
+   * \return the first packet which is not blocked, the end of the queue if none
+   */
+  PacketQueueI FindFirstAvailable (const QosBlockedDestinations *blockedPackets);
+
   PacketQueue m_queue; //!< Packet (struct Item) queue
+  std::list<PacketQueueI> m_arrivals; //!< the packets in the order they were queued
+  Receivers m_receivers; //!< the sub-queues of the QoS data packets
+  SubQueue m_others; //!< the packets which are not QoS data
+  PacketQueueI m_peeked; //!< the last packet returned by PeekByTidAndAddress
+  int64_t m_front; //!< the position of the front of the queue
+  int64_t m_back; //!< the position after the back of the queue
   uint32_t m_size; //!< Current queue size
   uint32_t m_maxSize; //!< Queue capacity
   Time m_maxDelay; //!< Time to live for packets in the queue
@@ -63,59 +63,11 @@ std::istream & operator >> (std::istream &is, WifiMode &mode)
   return is;
 }
 
-uint32_t
-WifiMode::GetBandwidth (void) const
-{
-  struct WifiModeFactory::WifiModeItem *item = WifiModeFactory::GetFactory ()->Get (m_uid);
-  return item->bandwidth;
-}
-uint64_t
-WifiMode::GetPhyRate (void) const
-{
-  struct WifiModeFactory::WifiModeItem *item = WifiModeFactory::GetFactory ()->Get (m_uid);
-  return item->phyRate;
-}
-uint64_t
-WifiMode::GetDataRate (void) const
-{
-  struct WifiModeFactory::WifiModeItem *item = WifiModeFactory::GetFactory ()->Get (m_uid);
-  return item->dataRate;
-}
-enum WifiCodeRate
-WifiMode::GetCodeRate (void) const
-{
-  struct WifiModeFactory::WifiModeItem *item = WifiModeFactory::GetFactory ()->Get (m_uid);
-  return item->codingRate;
-}
-uint16_t  //11ac: vht_standard
-WifiMode::GetConstellationSize (void) const
-{
-  struct WifiModeFactory::WifiModeItem *item = WifiModeFactory::GetFactory ()->Get (m_uid);
-  return item->constellationSize;
-}
 std::string
 WifiMode::GetUniqueName (void) const
 {
   // needed for ostream printing of the invalid mode
-  struct WifiModeFactory::WifiModeItem *item = WifiModeFactory::GetFactory ()->Get (m_uid);
-  return item->uniqueUid;
-}
-bool
-WifiMode::IsMandatory (void) const
-{
-  struct WifiModeFactory::WifiModeItem *item = WifiModeFactory::GetFactory ()->Get (m_uid);
-  return item->isMandatory;
-}
-uint32_t
-WifiMode::GetUid (void) const
-{
-  return m_uid;
-}
-enum WifiModulationClass
-WifiMode::GetModulationClass () const
-{
-  struct WifiModeFactory::WifiModeItem *item = WifiModeFactory::GetFactory ()->Get (m_uid);
-  return item->modClass;
+  return WifiModeFactory::GetItem (m_uid).uniqueUid;
 }
 WifiMode::WifiMode ()
   : m_uid (0)
@@ -132,6 +84,9 @@ WifiMode::WifiMode (std::string name)
 
 ATTRIBUTE_HELPER_CPP (WifiMode);
 
+const WifiModeFactory::WifiModeItem *WifiModeFactory::m_items = 0;
+uint32_t WifiModeFactory::m_nItems = 0;
+
 WifiModeFactory::WifiModeFactory ()
 {
 }
@@ -247,6 +202,8 @@ WifiModeFactory::AllocateUid (std::string uniqueUid)
     }
   uint32_t uid = m_itemList.size ();
   m_itemList.push_back (WifiModeItem ());
+  m_items = &m_itemList[0];
+  m_nItems = m_itemList.size ();
   return uid;
 }
 
@@ -25,6 +25,7 @@
 #include <vector>
 #include <ostream>
 #include "ns3/attribute-helper.h"
+#include "ns3/assert.h"
 #include "ns3/wifi-phy-standard.h"
 
 namespace ns3 {
@@ -87,7 +88,9 @@ enum WifiCodeRate
  * A WifiMode is implemented by a single integer which is used
  * to lookup in a global array the characteristics of the
  * associated transmission mode. It is thus extremely cheap to
- * keep a WifiMode variable around.
+ * keep a WifiMode variable around, and its characteristics are
+ * read straight from the array, without going through the
+ * WifiModeFactory.
  */
 class WifiMode
 {
@@ -290,14 +293,76 @@ private:
    * \return WifiModeItem at the given uid
    */
   WifiModeItem* Get (uint32_t uid);
+  /**
+   * Return the WifiModeItem of a uid, without looking the factory up
+   * once it exists.
+   *
+   * \param uid
+   * \return WifiModeItem at the given uid
+   */
+  static const WifiModeItem & GetItem (uint32_t uid);
 
   /**
    * typedef for a vector of WifiModeItem.
    */
   typedef std::vector<struct WifiModeItem> WifiModeItemList;
   WifiModeItemList m_itemList;
+  static const WifiModeItem *m_items; //!< the items of m_itemList, 0 until the factory exists
+  static uint32_t m_nItems;           //!< the number of items of m_itemList
 };
 
+inline const WifiModeFactory::WifiModeItem &
+WifiModeFactory::GetItem (uint32_t uid)
+{
+  if (m_items == 0)
+    {
+      GetFactory ();
+    }
+  NS_ASSERT (uid < m_nItems);
+  return m_items[uid];
+}
+
+inline uint32_t
+WifiMode::GetBandwidth (void) const
+{
+  return WifiModeFactory::GetItem (m_uid).bandwidth;
+}
+inline uint64_t
+WifiMode::GetPhyRate (void) const
+{
+  return WifiModeFactory::GetItem (m_uid).phyRate;
+}
+inline uint64_t
+WifiMode::GetDataRate (void) const
+{
+  return WifiModeFactory::GetItem (m_uid).dataRate;
+}
+inline enum WifiCodeRate
+WifiMode::GetCodeRate (void) const
+{
+  return WifiModeFactory::GetItem (m_uid).codingRate;
+}
+inline uint16_t
+WifiMode::GetConstellationSize (void) const
+{
+  return WifiModeFactory::GetItem (m_uid).constellationSize;
+}
+inline bool
+WifiMode::IsMandatory (void) const
+{
+  return WifiModeFactory::GetItem (m_uid).isMandatory;
+}
+inline uint32_t
+WifiMode::GetUid (void) const
+{
+  return m_uid;
+}
+inline enum WifiModulationClass
+WifiMode::GetModulationClass () const
+{
+  return WifiModeFactory::GetItem (m_uid).modClass;
+}
+
 } // namespace ns3
 
 #endif /* WIFI_MODE_H */
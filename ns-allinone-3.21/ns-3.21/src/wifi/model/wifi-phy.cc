@@ -22,6 +22,7 @@
 #include "wifi-mode.h"
 #include "wifi-channel.h"
 #include "wifi-preamble.h"
+#include "ppdu-duration.h"
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
 #include "ns3/assert.h"
@@ -365,149 +366,16 @@ WifiPhy::GetPlcpPreambleDurationMicroSeconds (WifiMode payloadMode, WifiPreamble
 double
 WifiPhy::GetPayloadDurationMicroSeconds (uint32_t size, WifiTxVector txvector)
 {
-  WifiMode payloadMode=txvector.GetMode();
-
-  NS_LOG_FUNCTION (size << payloadMode);
- 
-  switch (payloadMode.GetModulationClass ())
-    {
-    case WIFI_MOD_CLASS_OFDM:
-    case WIFI_MOD_CLASS_ERP_OFDM:
-      {
-        // (Section 18.3.2.4 "Timing related parameters" Table 18-5 "Timing-related parameters"; IEEE Std 802.11-2012
-        // corresponds to T_{SYM} in the table)
-        uint32_t symbolDurationUs;
-
-        switch (payloadMode.GetBandwidth ())
-          {
-          case 20000000:
-          default:
-            symbolDurationUs = 4;
-            break;
-          case 10000000:
-            symbolDurationUs = 8;
-            break;
-          case 5000000:
-            symbolDurationUs = 16;
-            break;
-          }
-
-        // (Section 18.3.2.3 "Modulation-dependent parameters" Table 18-4 "Modulation-dependent parameters"; IEEE Std 802.11-2012)
-        // corresponds to N_{DBPS} in the table
-        double numDataBitsPerSymbol = payloadMode.GetDataRate () * symbolDurationUs / 1e6;
-
-        // (Section 18.3.5.4 "Pad bits (PAD)" Equation 18-11; IEEE Std 802.11-2012)
-        uint32_t numSymbols = lrint (ceil ((16 + size * 8.0 + 6.0) / numDataBitsPerSymbol));
-
-        // Add signal extension for ERP PHY
-        if (payloadMode.GetModulationClass () == WIFI_MOD_CLASS_ERP_OFDM)
-          {
-            return numSymbols * symbolDurationUs + 6;
-          }
-        else
-          {
-            return numSymbols * symbolDurationUs;
-          }
-      }
-    case WIFI_MOD_CLASS_HT:
-      {
-         double symbolDurationUs;
-         double m_Stbc;
-        //if short GI data rate is used then symbol duration is 3.6us else symbol duration is 4us
-        //In the future has to create a stationmanager that only uses these data rates if sender and reciever support GI
-         if (payloadMode.GetUniqueName() == "OfdmRate135MbpsBW40MHzShGi" || payloadMode.GetUniqueName() == "OfdmRate65MbpsBW20MHzShGi" )
-           {
-             symbolDurationUs=3.6;
-           }
-         else
-           {
-             switch (payloadMode.GetDataRate ()) //11ac: multiple_stream_tx_etc
-             //switch (payloadMode.GetDataRate ()/ (txvector.GetNss()))
-               { //shortGi
-                  case 7200000:
-                  case 14400000:
-                  case 21700000:
-                  case 28900000:
-                  case 43300000:
-                  case 57800000:
-                  case 72200000:
-                  case 15000000:
-                  case 30000000:
-                  case 45000000:
-                  case 60000000:
-                  case 90000000:
-                  case 120000000:
-                  case 150000000:
-                    symbolDurationUs=3.6;
-                    break;               
-                 default:
-                    symbolDurationUs=4;
-              }
-           }
-         if  (txvector.IsStbc())
-            m_Stbc=2;
-         else
-           m_Stbc=1;
-         double numDataBitsPerSymbol = payloadMode.GetDataRate () *txvector.GetNss()  * symbolDurationUs / 1e6;
-         //check tables 20-35 and 20-36 in the standard to get cases when nes =2
-         double Nes=1;
-        // IEEE Std 802.11n, section 20.3.11, equation (20-32)
-        uint32_t numSymbols = lrint (m_Stbc*ceil ((16 + size * 8.0 + 6.0*Nes) / (m_Stbc* numDataBitsPerSymbol)));
-       
-        return numSymbols * symbolDurationUs;
-         
-      }
-    case WIFI_MOD_CLASS_VHT: //11ac: vht_standard
-      {
-         double symbolDurationUs = 3.6;
-         double m_Stbc;
-        
-         if  (txvector.IsStbc())
-            m_Stbc=2;
-         else
-           m_Stbc=1;
-         double numDataBitsPerSymbol = payloadMode.GetDataRate () *txvector.GetNss()  * symbolDurationUs / 1e6;
-         //check tables 20-35 and 20-36 in the standard to get cases when nes =2
-         double Nes=0;
-        // IEEE Std 802.11n, section 20.3.11, equation (20-32)
-        uint32_t numSymbols = lrint (m_Stbc*ceil ((16 + size * 8.0 + 6.0*Nes) / (m_Stbc* numDataBitsPerSymbol)));
-       
-	   NS_LOG_DEBUG(" size=" << size
-                             << " mode=" << payloadMode
-                             << " rate=" << payloadMode.GetDataRate () 
-                             << " numDataBitsPerSymbol=" << numDataBitsPerSymbol
-                             << " symbolDurationUs=" << symbolDurationUs );
-        return numSymbols * symbolDurationUs;
-         
-      }	
-    case WIFI_MOD_CLASS_DSSS:
-      // (Section 17.2.3.6 "Long PLCP LENGTH field"; IEEE Std 802.11-2012)
-      NS_LOG_LOGIC (" size=" << size
-                             << " mode=" << payloadMode
-                             << " rate=" << payloadMode.GetDataRate () );
-      return lrint (ceil ((size * 8.0) / (payloadMode.GetDataRate () / 1.0e6)));
-
-    default:
-      NS_FATAL_ERROR ("unsupported modulation class");
-      return 0;
-    }
+  NS_LOG_FUNCTION (size << txvector.GetMode ());
+  return PpduDuration::Get (txvector).GetPayloadDurationMicroSeconds (size);
 }
 
 Time
 WifiPhy::CalculateTxDuration (uint32_t size, WifiTxVector txvector, WifiPreamble preamble)
 {
-  WifiMode payloadMode=txvector.GetMode();
-  double duration = GetPlcpPreambleDurationMicroSeconds (payloadMode, preamble)
-    + GetPlcpHeaderDurationMicroSeconds (payloadMode, preamble)
-    + GetPlcpHtSigHeaderDurationMicroSeconds (payloadMode, preamble)
-    + GetPlcpHtTrainingSymbolDurationMicroSeconds (payloadMode, preamble,txvector)
-    + GetPayloadDurationMicroSeconds (size, txvector);
-  NS_LOG_DEBUG ("Plcp preamble duration=" << GetPlcpPreambleDurationMicroSeconds (payloadMode, preamble)
-                             << " Plcp header duration=" << GetPlcpHeaderDurationMicroSeconds (payloadMode, preamble)
-                             << " Plcp HT header duration=" << GetPlcpHtSigHeaderDurationMicroSeconds (payloadMode, preamble)
-                             << " Plcp HT training duration=" << GetPlcpHtTrainingSymbolDurationMicroSeconds (payloadMode, preamble,txvector)
-                             << " payload duration=" << GetPayloadDurationMicroSeconds (size, txvector) );
-  return MicroSeconds (duration);
+  Time duration = PpduDuration::Get (txvector).Calculate (size, preamble);
+  NS_LOG_DEBUG ("duration=" << duration << " for " << size << " bytes");
+  return duration;
 }
 
 
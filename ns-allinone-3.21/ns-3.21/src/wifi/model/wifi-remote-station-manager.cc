@@ -40,6 +40,7 @@
 #include "ns3/random-variable.h"
 #include "ns3/error-rate-model.h"
 #include <cmath>
+#include <algorithm>
 
 NS_LOG_COMPONENT_DEFINE ("WifiRemoteStationManager");
 
@@ -334,7 +335,8 @@ namespace ns3 {
 
     WifiRemoteStationManager::WifiRemoteStationManager ()
     {
-
+        IndexSlot free = { 0, 0 };
+        m_index.assign (16, free);
     }
 
     WifiRemoteStationManager::~WifiRemoteStationManager ()
@@ -343,11 +345,13 @@ namespace ns3 {
     void
         WifiRemoteStationManager::DoDispose (void)
         {
-            for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+            for (StationRecords::const_iterator i = m_records.begin (); i != m_records.end (); i++)
             {
-                delete (*i);
+                delete i->m_state;
             }
-            m_states.clear ();
+            m_records.clear ();
+            IndexSlot free = { 0, 0 };
+            m_index.assign (16, free);
             for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
             {
                 delete (*i);
@@ -1255,14 +1259,18 @@ namespace ns3 {
             return state->m_info;
         }
 
-    WifiRemoteStationState *
-        WifiRemoteStationManager::LookupState (Mac48Address address) const
+    uint32_t
+        WifiRemoteStationManager::LookupRecord (Mac48Address address) const
         {
-            for (StationStates::const_iterator i = m_states.begin (); i != m_states.end (); i++)
+            uint64_t key = GetKey (address);
+            uint32_t mask = m_index.size () - 1;
+            // Fibonacci hashing, the high bits are the best mixed
+            uint32_t slot = ((key * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+            for (; m_index[slot].m_key != 0; slot = (slot + 1) & mask)
             {
-                if ((*i)->m_address == address)
+                if (m_index[slot].m_key == key)
                 {
-                    return (*i);
+                    return m_index[slot].m_record;
                 }
             }
             WifiRemoteStationState *state = new WifiRemoteStationState ();
@@ -1276,8 +1284,57 @@ namespace ns3 {
             state->m_tx=1;
             state->m_stbc=false;
             state->m_operationalBandwidth=20;
-            const_cast<WifiRemoteStationManager *> (this)->m_states.push_back (state);
-            return state;
+            StationRecord record;
+            record.m_state = state;
+            std::fill (record.m_stations, record.m_stations + 16, (WifiRemoteStation *)0);
+            WifiRemoteStationManager *self = const_cast<WifiRemoteStationManager *> (this);
+            uint32_t index = m_records.size ();
+            self->m_records.push_back (record);
+            self->m_index[slot].m_key = key;
+            self->m_index[slot].m_record = index;
+            if (m_records.size () * 2 > m_index.size ())
+            {
+                self->GrowIndex ();
+            }
+            return index;
+        }
+    uint64_t
+        WifiRemoteStationManager::GetKey (Mac48Address address)
+        {
+            uint8_t buffer[6];
+            address.CopyTo (buffer);
+            uint64_t key = 1;
+            for (uint32_t i = 0; i < 6; i++)
+            {
+                key = (key << 8) | buffer[i];
+            }
+            return key;
+        }
+    void
+        WifiRemoteStationManager::GrowIndex (void)
+        {
+            IndexSlot free = { 0, 0 };
+            StationIndex index (m_index.size () * 2, free);
+            index.swap (m_index);
+            uint32_t mask = m_index.size () - 1;
+            for (StationIndex::const_iterator i = index.begin (); i != index.end (); i++)
+            {
+                if (i->m_key == 0)
+                {
+                    continue;
+                }
+                uint32_t slot = ((i->m_key * 0x9e3779b97f4a7c15ULL) >> 32) & mask;
+                while (m_index[slot].m_key != 0)
+                {
+                    slot = (slot + 1) & mask;
+                }
+                m_index[slot] = *i;
+            }
+        }
+    WifiRemoteStationState *
+        WifiRemoteStationManager::LookupState (Mac48Address address) const
+        {
+            return m_records[LookupRecord (address)].m_state;
         }
     WifiRemoteStation *
         WifiRemoteStationManager::Lookup (Mac48Address address, const WifiMacHeader *header) const
@@ -1296,15 +1353,13 @@ namespace ns3 {
     WifiRemoteStation *
         WifiRemoteStationManager::Lookup (Mac48Address address, uint8_t tid) const
         {
-            for (Stations::const_iterator i = m_stations.begin (); i != m_stations.end (); i++)
+            NS_ASSERT (tid < 16);
+            uint32_t index = LookupRecord (address);
+            if (m_records[index].m_stations[tid] != 0)
             {
-                if ((*i)->m_tid == tid
-                        && (*i)->m_state->m_address == address)
-                {
-                    return (*i);
-                }
+                return m_records[index].m_stations[tid];
             }
-            WifiRemoteStationState *state = LookupState (address);
+            WifiRemoteStationState *state = m_records[index].m_state;
             WifiRemoteStation *station = DoCreateStation ();
             station->m_state = state;
             station->m_tid = tid;
@@ -1324,7 +1379,9 @@ namespace ns3 {
             //shbyeon txop implementation
             station->txopLength = MicroSeconds(m_txop);
 
-            const_cast<WifiRemoteStationManager *> (this)->m_stations.push_back (station);
+            WifiRemoteStationManager *self = const_cast<WifiRemoteStationManager *> (this);
+            self->m_stations.push_back (station);
+            self->m_records[index].m_stations[tid] = station;
             return station;
 
         }
@@ -1365,6 +1422,10 @@ namespace ns3 {
                 delete (*i);
             }
             m_stations.clear ();
+            for (StationRecords::iterator i = m_records.begin (); i != m_records.end (); i++)
+            {
+                std::fill (i->m_stations, i->m_stations + 16, (WifiRemoteStation *)0);
+            }
             m_bssBasicRateSet.clear ();
 
             //11ac: control_mode
@@ -1701,6 +1762,17 @@ namespace ns3 {
         WifiRemoteStation *station = Lookup (addr, hdr);
         return DoIsSampling (station);
     }
+    double
+        WifiRemoteStationManager::GetAverageAmpduLength (Mac48Address addr, const WifiMacHeader *hdr)
+        {
+            WifiRemoteStation *station = Lookup (addr, hdr);
+            return DoGetAverageAmpduLength (station);
+        }
+    double
+        WifiRemoteStationManager::DoGetAverageAmpduLength (WifiRemoteStation *st)
+        {
+            return 1.0;
+        }
     //shbyeon RTSCTS buf fix
     void WifiRemoteStationManager::SetPrevTxVector(Mac48Address addr, const WifiMacHeader *hdr, WifiTxVector txVector)
     {
@@ -124,6 +124,18 @@ public:
   bool IsSampling(Mac48Address addr, const WifiMacHeader *hdr); // kjyoon
   virtual bool DoIsSampling(WifiRemoteStation *st) {return false;};        // kjyoon
   virtual void DoSetIsSampling(WifiRemoteStation *st, bool re) {};        // kjyoon
+  /**
+   * \param addr the address of the remote station
+   * \param hdr the header of a data frame for the station
+   * \return the average number of MPDUs of the A-MPDUs sent to the
+   *         station, 1 when the rate control does not keep it
+   */
+  double GetAverageAmpduLength (Mac48Address addr, const WifiMacHeader *hdr);
+  /**
+   * \param st the remote station
+   * \return the average number of MPDUs of the A-MPDUs sent to the station
+   */
+  virtual double DoGetAverageAmpduLength (WifiRemoteStation *st);
  
 	//shbyeon A-MPDU management
   void SetNframes (Mac48Address addr, const WifiMacHeader *hdr, uint16_t nframes);
@@ -945,16 +957,58 @@ private:
    */
   uint32_t GetNFragments (const WifiMacHeader *header, Ptr<const Packet> packet);
 
+  /**
+   * Return the record of the given address, created with a new state if
+   * the address is not known yet.
+   *
+   * \param address the address of the station
+   * \return the index of the record in m_records
+   */
+  uint32_t LookupRecord (Mac48Address address) const;
+  /**
+   * \param address the address of a station
+   * \return the key of the address in m_index, never 0
+   */
+  static uint64_t GetKey (Mac48Address address);
+  /**
+   * Double the number of slots of m_index.
+   */
+  void GrowIndex (void);
+
   /**
    * A vector of WifiRemoteStations
    */
   typedef std::vector <WifiRemoteStation *> Stations;
   /**
-   * A vector of WifiRemoteStationStates
+   * The state of a known address and its station of each TID, 0 until
+   * the TID is used.
+   */
+  struct StationRecord
+  {
+    WifiRemoteStationState *m_state;
+    WifiRemoteStation *m_stations[16];
+  };
+  /**
+   * The records, in the order the addresses became known
+   */
+  typedef std::vector <StationRecord> StationRecords;
+  /**
+   * A slot of the index of the records
+   */
+  struct IndexSlot
+  {
+    uint64_t m_key;  //!< the key of the address, 0 when the slot is free
+    uint32_t m_record;  //!< the index of the record of the address in m_records
+  };
+  /**
+   * The index of the record of each known address: an open addressing
+   * table with linear probing, a power of two of slots and never more
+   * than half full. Records are never removed from it one by one.
    */
-  typedef std::vector <WifiRemoteStationState *> StationStates;
+  typedef std::vector <IndexSlot> StationIndex;
 
-  StationStates m_states;  //!< States of known stations
+  StationRecords m_records;  //!< States and stations of known addresses
+  StationIndex m_index;  //!< Index of m_records by address
   Stations m_stations;  //!< Information for each known stations
   /**
    * This is a pointer to the WifiPhy associated with this
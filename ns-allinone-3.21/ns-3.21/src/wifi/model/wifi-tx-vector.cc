@@ -43,15 +43,11 @@ WifiTxVector::WifiTxVector (WifiMode mode, uint8_t powerLevel, uint8_t retries,
     m_bw(20),
     m_mpdus(1),
     m_caudalLoss(false),
-    m_lowRate(false),
-    m_setChannel(false),
-    m_prevMpdus(1)
+    m_lowRate(false)
 {
 }
 WifiTxVector::~WifiTxVector()
 {
-//  if(m_hmatrix && m_setChannel)
-//    DeleteChannelMatrix();
 }
 
 WifiMode
@@ -86,19 +82,22 @@ WifiTxVector::GetNess (void) const
 }
 //11ac: mutiple_stream_tx_channel
 void
-WifiTxVector::GetChannelMatrix ( std::complex<double> ** ch) 
+WifiTxVector::GetChannelMatrix (std::complex<double> *ch, uint16_t subframeIdx) const
 {
-  for (int i=0;i<m_nss;i++)
-    for (int j=0; j<m_nss; j++)
-      ch[i][j] = m_hmatrix[0][i][j];
+  NS_ASSERT (m_channel != 0 && m_channel->GetNss () == m_nss);
+  const std::complex<double> *h = m_channel->GetMatrix (subframeIdx);
+  for (int i = 0; i < m_nss * m_nss; i++)
+    ch[i] = h[i];
 }
-//caudal loss
-void
-WifiTxVector::GetChannelMatrix (std::complex<double> ** ch, uint16_t subframeIdx) 
+Ptr<const ChannelMatrix>
+WifiTxVector::GetChannelMatrix (void) const
 {
-    for (int j=0;j<m_nss;j++)
-      for (int k=0; k<m_nss; k++)
-        ch[j][k] = m_hmatrix[subframeIdx][j][k];
+  return m_channel;
+}
+Ptr<const AmpduSubframes>
+WifiTxVector::GetAmpduSubframes (void) const
+{
+  return m_subframes;
 }
 bool 
 WifiTxVector::IsStbc (void) const
@@ -183,49 +182,15 @@ WifiTxVector::SetNess (uint8_t ness)
   m_ness=ness;
 }
 //11ac: mutiple_stream_tx_channel
-void 
-WifiTxVector::SetChannelMatrix (std::complex<double> * vector, uint8_t nss, uint16_t nMpdus)
-{
-  //if(m_setChannel)
-  //  DeleteChannelMatrix();
-  m_hmatrix = new std::complex<double> ** [nMpdus];
-  for(int i = 0; i < nMpdus; i++)
-  {
-    m_hmatrix[i] = new std::complex<double> * [nss];
-    for (int j = 0; j < nss; j++)
-      m_hmatrix[i][j] = new std::complex<double> [nss];
-  }
-
-  for(int i = 0; i < nMpdus; i++)
-  {
-    for(int r = 0; r < nss; r++)
-    {
-      for(int c = 0; c < nss; c++)
-      {
-        m_hmatrix[i][r][c] = vector[1+c+r*nss+i*nss*nss];
-      }
-    }
-  }
-	NS_LOG_DEBUG( "JWHUR SetChannelMatrix vector.real: " << vector[1].real());
-  m_prevMpdus = nMpdus;
-  m_setChannel = true;
+void
+WifiTxVector::SetChannelMatrix (Ptr<const ChannelMatrix> channel)
+{
+  m_channel = channel;
 }
 void
-WifiTxVector::DeleteChannelMatrix (void)
-{
-  m_setChannel = false;
-  uint16_t nMpdus = m_prevMpdus;
-  uint16_t nss = GetNss();
-  for(int i=0; i<nMpdus; i++)
-  {
-    for(int j=0; j<nss; j++)
-    {
-      delete [] m_hmatrix[i][j];
-    }
-    delete [] m_hmatrix[i];
-  }
-  delete [] m_hmatrix;
-  m_hmatrix = NULL;
+WifiTxVector::SetAmpduSubframes (Ptr<const AmpduSubframes> subframes)
+{
+  m_subframes = subframes;
 }
 void 
 WifiTxVector::SetStbc (bool stbc)
@@ -25,6 +25,9 @@
 #include <ns3/wifi-mode.h>
 #include <ostream>
 #include <complex> //11ac: multiple_stream_tx_channel
+#include "ns3/ptr.h"
+#include "ns3/channel-matrix.h"
+#include "ns3/ampdu-subframes.h"
 
 namespace ns3 {
 
@@ -136,13 +139,39 @@ public:
    */
   void SetNess (uint8_t ness);
 
-  //11ac: mutiple_stream_tx_channel
-  void GetChannelMatrix ( std::complex<double> **);
-  //caudal loss
-  void GetChannelMatrix ( std::complex<double> **ch, uint16_t sub);
-
-  void SetChannelMatrix (std::complex<double> * vector, uint8_t nss, uint16_t nMpdus);
-  void DeleteChannelMatrix (void); 
+  //11ac: mutiple_stream_tx_channel + caudal loss
+  /**
+   * Copy the channel matrix of the given subframe into a flat row-major
+   * array of nss * nss entries.
+   *
+   * \param ch the destination array
+   * \param sub the subframe index
+   */
+  void GetChannelMatrix (std::complex<double> *ch, uint16_t sub) const;
+  /**
+   * \return the shared channel state of this transmission, or 0 if none
+   *         has been set.
+   */
+  Ptr<const ChannelMatrix> GetChannelMatrix (void) const;
+  /**
+   * Attach the channel state seen by the receiver. The block is shared,
+   * not copied, by every copy of this TXVECTOR.
+   *
+   * \param channel the channel state
+   */
+  void SetChannelMatrix (Ptr<const ChannelMatrix> channel);
+  /**
+   * \return the layout of the A-MPDU carried by this transmission, or 0
+   *         if none has been set.
+   */
+  Ptr<const AmpduSubframes> GetAmpduSubframes (void) const;
+  /**
+   * Attach the layout of the A-MPDU. As the channel matrix, the table is
+   * shared, not copied, by every copy of this TXVECTOR.
+   *
+   * \param subframes the layout of the A-MPDU
+   */
+  void SetAmpduSubframes (Ptr<const AmpduSubframes> subframes);
   /**
    * Check if STBC is used or not
    *  \returns true if STBC is used,
@@ -177,9 +206,8 @@ private:
   uint16_t m_mpdus;
   bool m_caudalLoss;
   bool m_lowRate;
-  bool m_setChannel;
-  uint16_t m_prevMpdus;
-	std::complex<double> *** m_hmatrix;
+  Ptr<const ChannelMatrix> m_channel;
+  Ptr<const AmpduSubframes> m_subframes;
 };
 
 /**
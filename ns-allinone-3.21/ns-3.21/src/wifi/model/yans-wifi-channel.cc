@@ -17,6 +17,7 @@
  *
  * Author: Mathieu Lacage, <mathieu.lacage@sophia.inria.fr>
  */
+#include <algorithm>
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 #include "ns3/mobility-model.h"
@@ -32,6 +33,7 @@
 #include "ns3/propagation-delay-model.h"
 #include "ns3/duplicate-tag.h"
 #include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/ampdu-tag.h"
 
 NS_LOG_COMPONENT_DEFINE ("YansWifiChannel");
@@ -58,17 +60,34 @@ YansWifiChannel::GetTypeId (void)
                    BooleanValue (false),
                    MakeBooleanAccessor (&YansWifiChannel::m_caudal),
                    MakeBooleanChecker ())
+    .AddAttribute ("ReceptionFloorLossModel",
+                   "Deterministic loss model (no fading) giving the mean loss of a link. When set, "
+                   "receivers whose mean rx power is below the lowest of their energy detection and "
+                   "CCA mode 1 thresholds minus ReceptionFloorMargin are not scheduled at all. "
+                   "The mean loss is cached per pair as long as both nodes do not move.",
+                   PointerValue (),
+                   MakePointerAccessor (&YansWifiChannel::m_floorLoss),
+                   MakePointerChecker<PropagationLossModel> ())
+    .AddAttribute ("ReceptionFloorMargin",
+                   "Headroom (dB) kept below the thresholds of the receiver for fading and "
+                   "aggregate interference.",
+                   DoubleValue (30.0),
+                   MakeDoubleAccessor (&YansWifiChannel::m_floorMargin),
+                   MakeDoubleChecker<double> (0.0))
   ;
   return tid;
 }
 
 YansWifiChannel::YansWifiChannel ()
+  : m_channelIndexValid (false)
 {
 }
 YansWifiChannel::~YansWifiChannel ()
 {
   NS_LOG_FUNCTION_NOARGS ();
   m_phyList.clear ();
+  m_channelIndex.clear ();
+  m_meanLoss.clear ();
 }
 
 void
@@ -97,18 +116,24 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
   //caudal loss
   AmpduTag tag;
   bool isAmpdu = packet->PeekPacketTag(tag);
+  uint16_t noMpdus = 1;
+  double* mpdu_us = NULL;
 
   if(isAmpdu)
   {
-    int k=0;
-    MpduAggregator::DeaggregatedMpdus packets;
-    Ptr<Packet> packet_copy = packet->Copy ();
-    packets = MpduAggregator::Deaggregate(packet_copy);
-    uint16_t noMpdus = packets.size();
+    // A-MPDUs built by MacLow carry their layout, only parse the
+    // delimiters of the other ones, once for all the receivers
+    Ptr<const AmpduSubframes> subframes = txVector.GetAmpduSubframes ();
+    if (subframes == 0)
+    {
+      subframes = AmpduSubframes::Parse (packet);
+      txVector.SetAmpduSubframes (subframes);
+    }
+    noMpdus = subframes->GetN ();
 
     txVector.SetNumberMpdus(noMpdus);
 
-    double* mpdu_us = new double [noMpdus];
+    mpdu_us = new double [noMpdus];
     for(int i=0; i<noMpdus; i++)
       mpdu_us[i]=0;
 
@@ -116,158 +141,164 @@ YansWifiChannel::Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double
     uint64_t txMode = txVector.GetMode().GetDataRate() * txVector.GetNss(); 
     Time ampduTx = Seconds ((double)packet->GetSize() * 8 / txMode);
     NS_LOG_DEBUG(mpdu_us << " " << txMode << " " << packet->GetSize() << " " << ampduTx);
-    for (MpduAggregator::DeaggregatedMpdusCI i = packets.begin(); i != packets.end(); ++i)
+    for (uint16_t k = 1; k < noMpdus; k++)
     {
-      if(k==0)
-        mpdu_us[0]=0; 
-
-      else
-        mpdu_us[k] = mpdu_us[k-1] + (double)(*i).first->GetSize() * 8 / txMode;
-      k++;
-      NS_LOG_DEBUG(k-1 << "th time=" << mpdu_us[k-1] << " packetSize=" << (double)(*i).first->GetSize() * 8);
+      mpdu_us[k] = mpdu_us[k-1] + (double)subframes->GetLength (k) * 8 / txMode;
+      NS_LOG_DEBUG(k << "th time=" << mpdu_us[k] << " packetSize=" << (double)subframes->GetLength (k) * 8);
     }
     NS_LOG_DEBUG("1 send AMPDU, #ofMpdus=" << noMpdus << " TxMode=" << txMode << " NSS=" << (int)txVector.GetNss()); 
     // first value (mpdu_us[0]) shows size of this array
     mpdu_us[0] = noMpdus;
+  }
 
-    //802.11ac channel bonding 
-    enum ChannelBonding ch = DIFF_CHANNEL;
-    Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
-    NS_ASSERT (senderMobility != 0);
-    uint32_t j = 0;
-    for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  //802.11ac channel bonding 
+  enum ChannelBonding ch = DIFF_CHANNEL;
+  Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
+  NS_ASSERT (senderMobility != 0);
+  uint32_t senderNode = sender->GetDevice ()->GetObject<NetDevice> ()->GetNode ()->GetId ();
+  NS_LOG_DEBUG("caudal loss: " << m_caudal); 
+  // PHYs outside of the bucket of the sender primary channel would all
+  // be found DIFF_CHANNEL by OverlapCheck, they are not visited at all.
+  const PhyBucket &bucket = GetBucket (sender->GetChannelNumber ());
+  // the MAC of the sender modifies its packet after the transmission,
+  // the receivers share a copy of it
+  Ptr<const Packet> copy = packet->Copy ();
+  for (PhyBucket::const_iterator it = bucket.begin (); it != bucket.end (); it++)
+  {
+    uint32_t j = *it;
+    Ptr<YansWifiPhy> receiver = m_phyList[j];
+    if (sender == receiver)
     {
-      if (sender != (*i))
-      {
-        // For now don't account for inter channel interference
-        ch = sender->OverlapCheck((*i)->GetChannelNumber(), (*i)->GetOperationalBandwidth(), (*i)->GetChannelNumberS20(), (*i)->GetChannelNumberS40_up(), (*i)->GetChannelNumberS40_down());  
-        //          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-        //            {
-        //              continue;
-        //            }
-        if(ch == DIFF_CHANNEL)
-        {
-          continue;
-        }
+      continue;
+    }
+    // For now don't account for inter channel interference
+    ch = sender->OverlapCheck(receiver->GetChannelNumber(), receiver->GetOperationalBandwidth(), receiver->GetChannelNumberS20(), receiver->GetChannelNumberS40_up(), receiver->GetChannelNumberS40_down());  
+    if(ch == DIFF_CHANNEL)
+    {
+      continue;
+    }
 
-        Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-        Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
+    Ptr<MobilityModel> receiverMobility = receiver->GetMobility ()->GetObject<MobilityModel> ();
+    if (m_floorLoss != 0
+        && IsBelowReceptionFloor (sender, receiver, senderMobility, receiverMobility, txPowerDbm))
+    {
+      continue;
+    }
+    Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
 
-        //11ac: mutiple_stream_tx_channel	
-        uint8_t nss = txVector.GetNss ();
-        double rxPowerDbm = 0;
+    //11ac: mutiple_stream_tx_channel	
+    uint8_t nss = txVector.GetNss ();
+    double rxPowerDbm = 0;
 
-        std::complex<double> * hvector = new std::complex<double> [(nss*nss)*noMpdus+1];
-        hvector[0].real() = txPowerDbm;//m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-        hvector = m_loss->CalcRxPower (hvector, senderMobility, receiverMobility, nss, mpdu_us);
-        NS_LOG_DEBUG(sender << " " << hvector << " " << (int)nss << " " << mpdu_us[0]);
-        rxPowerDbm = hvector[0].real();
-        txVector.SetCaudalLoss(m_caudal);
-        txVector.SetChannelMatrix(hvector, nss, noMpdus);
-				
-	/*
-        for (int i=0; i<(nss*nss)*noMpdus+1;i++)
-        {
-          NS_LOG_DEBUG("hvector["<<i<<"]="<<hvector[i]);
-        }
-	*/
-        NS_LOG_DEBUG("set channel matrix in yanswifichannel to "<<sender << "  nss="<<(int)nss<<" nmpdus="<<noMpdus);
-        delete [] hvector;
+    Ptr<ChannelMatrix> channel = Create<ChannelMatrix> (nss, noMpdus);
+    std::complex<double> * hvector = channel->GetBuffer ();
+    hvector[0] = txPowerDbm;//m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
+    m_loss->CalcRxPower (hvector, senderMobility, receiverMobility, nss, mpdu_us);
+    rxPowerDbm = channel->GetRxPowerDbm ();
+    txVector.SetCaudalLoss(m_caudal);
+    txVector.SetChannelMatrix(channel);
+    NS_LOG_DEBUG("set channel matrix in yanswifichannel to "<<sender << "  nss="<<(int)nss<<" nmpdus="<<noMpdus);
 
-        NS_LOG_DEBUG ("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-            "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-        Ptr<Packet> copy = packet->Copy ();
-        Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-        uint32_t dstNode;
-        uint32_t senderNode = sender->GetDevice ()->GetObject<NetDevice> ()->GetNode ()->GetId ();
-        if (dstNetDevice == 0)
-        {
-          dstNode = 0xffffffff;
-        }
-        else
-        {
-          dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
-        }
-        NS_LOG_DEBUG ("channelbonding -- " << "sender: " << senderNode << ", dst: " << dstNode  
-            << ", channel number: " << sender->GetChannelNumber()
-            << ", operation width: " << sender->GetOperationalBandwidth() 
-            << ", current width: " << sender->GetCurrentWidth());
-        Simulator::ScheduleWithContext (dstNode,
-            delay, &YansWifiChannel::Receive, this,
-            j, copy, rxPowerDbm, txVector, preamble, ch);
-      }
+    NS_LOG_DEBUG("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
+        "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
+    Ptr<Object> dstNetDevice = receiver->GetDevice ();
+    uint32_t dstNode;
+    if (dstNetDevice == 0)
+    {
+      dstNode = 0xffffffff;
     }
-    delete [] mpdu_us;
+    else
+    {
+      dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
+    }
+    NS_LOG_DEBUG ("channelbonding -- " << "sender: " << senderNode << ", dst: " << dstNode  
+        << ", channel number: " << sender->GetChannelNumber()
+        << ", operation width: " << sender->GetOperationalBandwidth() 
+        << ", current width: " << sender->GetCurrentWidth());
+    Simulator::ScheduleWithContext (dstNode,
+        delay, &YansWifiChannel::Receive, this,
+        j, copy, rxPowerDbm, txVector, preamble, ch);
   }
-  else
-  {
-    //802.11ac channel bonding 
-    enum ChannelBonding ch = DIFF_CHANNEL;
-    Ptr<MobilityModel> senderMobility = sender->GetMobility ()->GetObject<MobilityModel> ();
-    NS_ASSERT (senderMobility != 0);
-    uint32_t j = 0;
-    for (PhyList::const_iterator i = m_phyList.begin (); i != m_phyList.end (); i++, j++)
+  delete [] mpdu_us;
+}
+
+void
+YansWifiChannel::UpdateChannelIndex (void) const
+{
+  m_channelIndex.clear ();
+  for (uint32_t j = 0; j < m_phyList.size (); j++)
     {
-      if (sender != (*i))
-      {
-        // For now don't account for inter channel interference
-        ch = sender->OverlapCheck((*i)->GetChannelNumber(), (*i)->GetOperationalBandwidth(), (*i)->GetChannelNumberS20(), (*i)->GetChannelNumberS40_up(), (*i)->GetChannelNumberS40_down());  
-        //          if ((*i)->GetChannelNumber () != sender->GetChannelNumber ())
-        //            {
-        //              continue;
-        //            }
-        if(ch == DIFF_CHANNEL)
+      uint16_t channels[4];
+      channels[0] = m_phyList[j]->GetChannelNumber ();
+      channels[1] = m_phyList[j]->GetChannelNumberS20 ();
+      channels[2] = m_phyList[j]->GetChannelNumberS40_up ();
+      channels[3] = m_phyList[j]->GetChannelNumberS40_down ();
+      for (uint32_t c = 0; c < 4; c++)
         {
-          continue;
+          PhyBucket &bucket = m_channelIndex[channels[c]];
+          // PHYs are visited in order, so each bucket stays sorted and
+          // receptions are scheduled in the order of the PHY list
+          if (bucket.empty () || bucket.back () != j)
+            {
+              bucket.push_back (j);
+            }
         }
+    }
+  m_channelIndexValid = true;
+}
 
-        Ptr<MobilityModel> receiverMobility = (*i)->GetMobility ()->GetObject<MobilityModel> ();
-        Time delay = m_delay->GetDelay (senderMobility, receiverMobility);
-
-        //11ac: mutiple_stream_tx_channel	
-        uint8_t nss = txVector.GetNss ();
-        double rxPowerDbm = 0;
-
-        NS_LOG_DEBUG("caudal loss: " << m_caudal); 
-
-        std::complex<double> * hvector = new std::complex<double> [nss*nss+1];
-        hvector[0].real() = txPowerDbm;//m_loss->CalcRxPower (txPowerDbm, senderMobility, receiverMobility);
-        hvector = m_loss->CalcRxPower (hvector, senderMobility, receiverMobility, nss, NULL);
-        rxPowerDbm = hvector[0].real();
-        txVector.SetCaudalLoss(m_caudal);
-        txVector.SetChannelMatrix(hvector, nss, 1);
-	NS_LOG_DEBUG("JWHUR hvector: " << hvector[0].real());
-        delete [] hvector;
-
-        NS_LOG_DEBUG("propagation: txPower=" << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, " <<
-            "distance=" << senderMobility->GetDistanceFrom (receiverMobility) << "m, delay=" << delay);
-        Ptr<Packet> copy = packet->Copy ();
-        Ptr<Object> dstNetDevice = m_phyList[j]->GetDevice ();
-        uint32_t dstNode;
-        uint32_t senderNode = sender->GetDevice ()->GetObject<NetDevice> ()->GetNode ()->GetId ();
-        if (dstNetDevice == 0)
-        {
-          dstNode = 0xffffffff;
-        }
-        else
-        {
-          dstNode = dstNetDevice->GetObject<NetDevice> ()->GetNode ()->GetId ();
-        }
-        NS_LOG_DEBUG ("channelbonding -- " << "sender: " << senderNode << ", dst: " << dstNode  
-            << ", channel number: " << sender->GetChannelNumber()
-            << ", operation width: " << sender->GetOperationalBandwidth() 
-            << ", current width: " << sender->GetCurrentWidth());
-        Simulator::ScheduleWithContext (dstNode,
-            delay, &YansWifiChannel::Receive, this,
-            j, copy, rxPowerDbm, txVector, preamble, ch);
-      }
+const YansWifiChannel::PhyBucket &
+YansWifiChannel::GetBucket (uint16_t channelNumber) const
+{
+  if (!m_channelIndexValid)
+    {
+      UpdateChannelIndex ();
     }
-  }
+  ChannelIndex::const_iterator it = m_channelIndex.find (channelNumber);
+  if (it == m_channelIndex.end ())
+    {
+      return m_emptyBucket;
+    }
+  return it->second;
+}
 
+bool
+YansWifiChannel::IsBelowReceptionFloor (Ptr<YansWifiPhy> sender, Ptr<YansWifiPhy> receiver,
+                                        Ptr<MobilityModel> senderMobility,
+                                        Ptr<MobilityModel> receiverMobility,
+                                        double txPowerDbm) const
+{
+  Vector senderPosition = senderMobility->GetPosition ();
+  Vector receiverPosition = receiverMobility->GetPosition ();
+  MeanLossCache::key_type key = std::make_pair (PeekPointer (sender), PeekPointer (receiver));
+  MeanLossCache::iterator it = m_meanLoss.find (key);
+  if (it == m_meanLoss.end ()
+      || it->second.senderPosition.x != senderPosition.x
+      || it->second.senderPosition.y != senderPosition.y
+      || it->second.senderPosition.z != senderPosition.z
+      || it->second.receiverPosition.x != receiverPosition.x
+      || it->second.receiverPosition.y != receiverPosition.y
+      || it->second.receiverPosition.z != receiverPosition.z)
+    {
+      MeanLoss entry;
+      entry.senderPosition = senderPosition;
+      entry.receiverPosition = receiverPosition;
+      entry.lossDb = -m_floorLoss->CalcRxPower (0, senderMobility, receiverMobility);
+      it = m_meanLoss.insert (m_meanLoss.end (), std::make_pair (key, entry));
+      it->second = entry;
+    }
+  double floorDbm = std::min (receiver->GetEdThreshold (), receiver->GetCcaMode1Threshold ()) - m_floorMargin;
+  double meanRxPowerDbm = txPowerDbm - it->second.lossDb;
+  if (meanRxPowerDbm < floorDbm)
+    {
+      NS_LOG_DEBUG ("below reception floor: mean rxPower=" << meanRxPowerDbm << "dbm, floor=" << floorDbm << "dbm");
+      return true;
+    }
+  return false;
 }
 
 void
-YansWifiChannel::Receive (uint32_t i, Ptr<Packet> packet, double rxPowerDbm,
+YansWifiChannel::Receive (uint32_t i, Ptr<const Packet> packet, double rxPowerDbm,
                           WifiTxVector txVector, WifiPreamble preamble, enum ChannelBonding ch) const
 {
   m_phyList[i]->StartReceivePacket (packet, rxPowerDbm, txVector, preamble, ch);
@@ -288,6 +319,13 @@ void
 YansWifiChannel::Add (Ptr<YansWifiPhy> phy)
 {
   m_phyList.push_back (phy);
+  m_channelIndexValid = false;
+}
+
+void
+YansWifiChannel::NotifyChannelChange (void)
+{
+  m_channelIndexValid = false;
 }
 
 int64_t
@@ -21,6 +21,7 @@
 #define YANS_WIFI_CHANNEL_H
 
 #include <vector>
+#include <map>
 #include <stdint.h>
 #include "ns3/packet.h"
 #include "wifi-channel.h"
@@ -29,6 +30,7 @@
 #include "wifi-preamble.h"
 #include "wifi-tx-vector.h"
 #include "ns3/mobility-model.h"
+#include "ns3/vector.h"
 
 namespace ns3 {
 
@@ -68,6 +70,11 @@ public:
    * \param phy the YansWifiPhy to be added to the PHY list
    */
   void Add (Ptr<YansWifiPhy> phy);
+  /**
+   * Invalidate the channel index. Must be called whenever the primary or
+   * secondary channel numbers of one of the attached PHYs change.
+   */
+  void NotifyChannelChange (void);
 
   /**
    * \param loss the new propagation loss model.
@@ -90,7 +97,10 @@ public:
    * This method should not be invoked by normal users. It is
    * currently invoked only from WifiPhy::Send. YansWifiChannel
    * delivers packets only between PHYs with the same m_channelNumber,
-   * e.g. PHYs that are operating on the same channel.
+   * e.g. PHYs that are operating on the same channel. The receivers all
+   * get the same copy of \p packet, made once per transmission since the
+   * MAC of the sender goes on tagging \p packet: a PHY copies it again
+   * only if it starts receiving it.
    */
   void Send (Ptr<YansWifiPhy> sender, Ptr<const Packet> packet, double txPowerDbm,
              WifiTxVector txVector, WifiPreamble preamble) const;
@@ -119,14 +129,57 @@ private:
    * bit of the packet has arrived.
    *
    * \param i index of the corresponding YansWifiPhy in the PHY list
-   * \param packet the packet being sent
+   * \param packet the packet being sent, shared by all the receivers
    * \param rxPowerDbm the received power of the packet
    * \param txVector the TXVECTOR of the packet
    * \param preamble the type of preamble being used to send the packet
    */
-  void Receive (uint32_t i, Ptr<Packet> packet, double rxPowerDbm,
+  void Receive (uint32_t i, Ptr<const Packet> packet, double rxPowerDbm,
                 WifiTxVector txVector, WifiPreamble preamble, enum ChannelBonding ch) const;
 
+  /**
+   * Indices (in the PHY list) of the PHYs which have a given channel
+   * number as primary, secondary 20, or one of the secondary 40 channels.
+   */
+  typedef std::vector<uint32_t> PhyBucket;
+  typedef std::map<uint16_t, PhyBucket> ChannelIndex;
+  /**
+   * Rebuild m_channelIndex from the current channel numbers of the PHYs.
+   */
+  void UpdateChannelIndex (void) const;
+  /**
+   * Only the PHYs of the bucket of the sender primary channel can overlap
+   * with the sender (see YansWifiPhy::OverlapCheck), whatever the widths.
+   *
+   * \param channelNumber the primary channel number of the sender
+   * \return the PHYs which may receive a frame sent on that channel
+   */
+  const PhyBucket & GetBucket (uint16_t channelNumber) const;
+  /**
+   * \param sender the sending PHY
+   * \param receiver the receiving PHY
+   * \param senderMobility the mobility model of the sender
+   * \param receiverMobility the mobility model of the receiver
+   * \param txPowerDbm the tx power
+   * \return true if the mean rx power is below the reception floor of the receiver
+   */
+  bool IsBelowReceptionFloor (Ptr<YansWifiPhy> sender, Ptr<YansWifiPhy> receiver,
+                              Ptr<MobilityModel> senderMobility,
+                              Ptr<MobilityModel> receiverMobility,
+                              double txPowerDbm) const;
+
+  /**
+   * Mean loss of a sender/receiver pair, valid while both nodes stay
+   * at the recorded positions.
+   */
+  struct MeanLoss
+  {
+    Vector senderPosition;
+    Vector receiverPosition;
+    double lossDb;
+  };
+  typedef std::map<std::pair<const YansWifiPhy *, const YansWifiPhy *>, MeanLoss> MeanLossCache;
+
 
   PhyList m_phyList; //!< List of YansWifiPhys connected to this YansWifiChannel
   Ptr<PropagationLossModel> m_loss; //!< Propagation loss model
@@ -134,6 +187,15 @@ private:
 
   //caudal loss
   bool m_caudal;
+
+  mutable ChannelIndex m_channelIndex; //!< PHY buckets, keyed by channel number
+  mutable bool m_channelIndexValid;
+  PhyBucket m_emptyBucket;
+
+  //reception floor
+  Ptr<PropagationLossModel> m_floorLoss; //!< deterministic loss model giving the mean loss
+  double m_floorMargin;                 //!< fading and interference headroom (dB)
+  mutable MeanLossCache m_meanLoss;
 };
 
 } // namespace ns3
@@ -25,6 +25,7 @@
 #include "wifi-preamble.h"
 #include "wifi-phy-state-helper.h"
 #include "error-rate-model.h"
+#include "effective-snr-mapping.h"
 #include "ns3/simulator.h"
 #include "ns3/packet.h"
 #include "ns3/assert.h"
@@ -213,6 +214,12 @@ namespace ns3 {
         m_random = CreateObject<UniformRandomVariable> ();
         for(int j = 0; j < 4; j++)
             m_state[j] = CreateObject<WifiPhyStateHelper> ();
+        //802.11ac channel bonding: one NI timeline for all the subchannels
+        Ptr<InterferenceTimeline> timeline = Create<InterferenceTimeline> ();
+        for(int j = 0; j < 4; j++)
+            m_interference[j].SetTimeline (timeline, j);
+        //11ac: mutiple_stream_tx_per
+        SetEffectiveSnrMapping (CreateObject<RbirEffectiveSnrMapping> ());
 
         //JWHUR rxpowertest
         rx_count = 0;
@@ -349,6 +356,12 @@ namespace ns3 {
             m_interference[2].SetErrorRateModel (rate);
             m_interference[3].SetErrorRateModel (rate);
         }
+    void
+        YansWifiPhy::SetEffectiveSnrMapping (Ptr<EffectiveSnrMapping> mapping)
+        {
+            for(int j = 0; j < 4; j++)
+                m_interference[j].SetEffectiveSnrMapping (mapping);
+        }
     void
         YansWifiPhy::SetDevice (Ptr<Object> device)
         {
@@ -404,6 +417,11 @@ namespace ns3 {
         {
             return m_interference[0].GetErrorRateModel ();
         }
+    Ptr<EffectiveSnrMapping>
+        YansWifiPhy::GetEffectiveSnrMapping (void) const
+        {
+            return m_interference[0].GetEffectiveSnrMapping ();
+        }
     Ptr<Object>
         YansWifiPhy::GetDevice (void) const
         {
@@ -415,8 +433,8 @@ namespace ns3 {
             return m_mobility;
         }
     //shbyeon 802.11ac genie
-    InterferenceHelper
-        YansWifiPhy::GetInterferenceHelper(void)
+    const InterferenceHelper &
+        YansWifiPhy::GetInterferenceHelper(void) const
         {
             return m_interference[0];
         }
@@ -649,6 +667,10 @@ namespace ns3 {
                 }
                 NS_LOG_DEBUG ("primary channel: " << nch << ", secondary: " << 
                         m_secondary20 << ", secondary 40: " << (m_secondary40_up + m_secondary40_down)/2 );
+                if (m_channel != 0)
+                {
+                    m_channel->NotifyChannelChange ();
+                }
                 return;
             }
 
@@ -755,6 +777,10 @@ switchChannel:
             }
             NS_LOG_DEBUG ("switch channel ==> primary channel: " << nch << ", secondary: " << 
                     m_secondary20 << ", secondary 40: " << (m_secondary40_up + m_secondary40_down)/2 );
+            if (m_channel != 0)
+            {
+                m_channel->NotifyChannelChange ();
+            }
         }
 
     uint16_t
@@ -857,7 +883,7 @@ switchChannel:
         }
 
     void
-        YansWifiPhy::StartReceivePacket (Ptr<Packet> packet,
+        YansWifiPhy::StartReceivePacket (Ptr<const Packet> packet,
                 double rxPowerDbm,
                 WifiTxVector txVector,
                 enum WifiPreamble preamble,
@@ -875,20 +901,10 @@ switchChannel:
             double realRxPowerW = rxPowerW;
             uint8_t nss = txVector.GetNss();
             if (nss == 1){
-                std::complex<double> **ch = new std::complex<double> *[nss];
-                for (int i=0;i<nss;i++)
-                    ch[i] = new std::complex<double>[nss];
-                txVector.GetChannelMatrix (ch);
-                double a = ch[0][0].real();
-                double b = ch[0][0].imag();
-                double squareValue = (a*a + b*b);
-                realRxPowerW = rxPowerW*squareValue/2; 
+                std::complex<double> ch;
+                txVector.GetChannelMatrix (&ch, 0);
+                realRxPowerW = rxPowerW*std::norm (ch)/2; 
                 realRxPowerDbm = WToDbm(realRxPowerW);
-                for(int j=0; j<nss; j++)
-                {
-                    delete [] ch[j];
-                }
-                delete [] ch; 
             }
 
             //802.11ac channel bonding
@@ -1322,18 +1338,21 @@ switchChannel:
                                     NS_LOG_DEBUG("used channel " << currentWidth[0] << " " << currentWidth[1] << " " <<
                                             currentWidth[2] << " " << currentWidth[3] <<", bw=" << bandWidth);
 
+                                    // the packet is shared with the other receivers
+                                    // until now, the reception modifies its copy
+                                    Ptr<Packet> copy = packet->Copy ();
                                     AmpduTag tag;
                                     bool isAmpdu = packet->PeekPacketTag(tag);
                                     if(isAmpdu)
                                         m_endRxEvent = Simulator::Schedule (rxDuration, &YansWifiPhy::EndAmpduReceive, this,
-                                                packet,
+                                                copy,
                                                 event[0], event[1], event[2], event[3]);
                                     else
                                         m_endRxEvent = Simulator::Schedule (rxDuration, &YansWifiPhy::EndReceive, this,
-                                                packet,
+                                                copy,
                                                 event[0], event[1], event[2], event[3]);
                                     //11ac: second_capture 
-                                    m_prevPacket = packet;
+                                    m_prevPacket = copy;
                                     m_prevSnr = m_interference[0].CalculateSnrPer(event[0]).snr;
                                     m_prevRxPowerW = realRxPowerW; //160413 skim11 : channel bug fix
                                     m_prevRxpowerDbm = realRxPowerDbm; //160413 skim11
@@ -1909,15 +1928,18 @@ switchChannel:
                                 NS_LOG_DEBUG("used channel " << currentWidth[0] << " " << currentWidth[1] << " " <<
                                         currentWidth[2] << " " << currentWidth[3] <<", bw=" << bandWidth);
 
+                                // the packet is shared with the other receivers
+                                // until now, the reception modifies its copy
+                                Ptr<Packet> copy = packet->Copy ();
                                 AmpduTag tag;
                                 bool isAmpdu = packet->PeekPacketTag(tag);
                                 if(isAmpdu)
                                     m_endRxEvent = Simulator::Schedule (rxDuration, &YansWifiPhy::EndAmpduReceive, this,
-                                            packet,
+                                            copy,
                                             event[0], event[1], event[2], event[3]);
                                 else
                                     m_endRxEvent = Simulator::Schedule (rxDuration, &YansWifiPhy::EndReceive, this,
-                                            packet,
+                                            copy,
                                             event[0], event[1], event[2], event[3]);
                                 //11ac: second_capture (shbyeon bug fix) 
                                 m_prevPacket = packet->Copy();
@@ -2721,17 +2743,12 @@ maybeCcaBusy:
             NS_LOG_FUNCTION (this << " receiving start");
             NS_ASSERT (IsStateRx ());
             NS_ASSERT (event0->GetEndTime () == Simulator::Now ());
-            Ptr<Packet> ampdu0 = packet->Copy();
-            Ptr<Packet> ampdu1 = packet->Copy();
-            Ptr<Packet> ampdu2 = packet->Copy();
-            Ptr<Packet> ampdu3 = packet->Copy();
             bool rxOneMPDU = false;
 
-            MpduAggregator::DeaggregatedMpdus packets; 
-            packets = MpduAggregator::Deaggregate (packet);
-
-            NS_LOG_DEBUG("YansWifiPhy,  AmpduSize: " << packets.size() );
-            NS_LOG_DEBUG ("# aggregated packets: " << packets.size ());	
+            // the subframes are located with the layout carried by the
+            // TXVECTOR, the A-MPDU is only split to hand the MPDUs up
+            NS_ASSERT (event0->GetTxVector ().GetAmpduSubframes () != 0);
+            NS_LOG_DEBUG ("# aggregated packets: " << event0->GetTxVector ().GetAmpduSubframes ()->GetN ());
 
             struct InterferenceHelper::SnrPer _plcpSnrPer1;
             struct InterferenceHelper::SnrPer _plcpSnrPer2;
@@ -2777,13 +2794,13 @@ maybeCcaBusy:
                 plcpHeaderError = true;
             }
             if(event0)
-                snrPers0 = m_interference[0].CalculateAmpduSnrPer (event0, packet->GetSize(), packets.size(), ampdu0);
+                snrPers0 = m_interference[0].CalculateAmpduSnrPer (event0);
             if(event1)
-                snrPers1 = m_interference[1].CalculateAmpduSnrPer (event1, packet->GetSize(), packets.size(), ampdu1);
+                snrPers1 = m_interference[1].CalculateAmpduSnrPer (event1);
             if(event2)
-                snrPers2 = m_interference[2].CalculateAmpduSnrPer (event2, packet->GetSize(), packets.size(), ampdu2);
+                snrPers2 = m_interference[2].CalculateAmpduSnrPer (event2);
             if(event3)
-                snrPers3 = m_interference[3].CalculateAmpduSnrPer (event3, packet->GetSize(), packets.size(), ampdu3);
+                snrPers3 = m_interference[3].CalculateAmpduSnrPer (event3);
 
             if(division > 0)
                 m_interference[0].NotifyRxEnd ();
@@ -2834,6 +2851,8 @@ maybeCcaBusy:
                 //find effective snr and packet error rate
                 NS_LOG_DEBUG("ESNR=" << 10*log10(snrPer.snr) << " EPER=" << snrPer.per << " bw=" << division << " plcpSnrPer=" << plcpSnrPer);
             }
+            MpduAggregator::DeaggregatedMpdus packets; 
+            packets = MpduAggregator::Deaggregate (packet);
             NS_ASSERT(packets.size()+1 == snrPers.size());
             YansWifiPhy::SnrPersCI j = snrPers.begin ();
             j++;
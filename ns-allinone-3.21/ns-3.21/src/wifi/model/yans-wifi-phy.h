@@ -108,12 +108,13 @@ public:
   /**
    * Starting receiving the packet (i.e. the first bit of the preamble has arrived).
    *
-   * \param packet the arriving packet
+   * \param packet the arriving packet, shared with the other receivers
+   *        and copied if the PHY starts receiving it
    * \param rxPowerDbm the receive power in dBm
    * \param txVector the TXVECTOR of the arriving packet
    * \param preamble the preamble of the arriving packet
    */
-  void StartReceivePacket (Ptr<Packet> packet,
+  void StartReceivePacket (Ptr<const Packet> packet,
                            double rxPowerDbm,
                            WifiTxVector txVector,
                            WifiPreamble preamble,
@@ -179,6 +180,13 @@ public:
    * \param rate the error rate model
    */
   void SetErrorRateModel (Ptr<ErrorRateModel> rate);
+  /**
+   * Sets the mapping of the SINRs of the spatial streams to one SNR,
+   * an RbirEffectiveSnrMapping by default.
+   *
+   * \param mapping the effective SNR mapping
+   */
+  void SetEffectiveSnrMapping (Ptr<EffectiveSnrMapping> mapping);
   /**
    * Sets the device this PHY is associated with.
    *
@@ -227,6 +235,12 @@ public:
    * \return the error rate model this PHY is using
    */
   Ptr<ErrorRateModel> GetErrorRateModel (void) const;
+  /**
+   * Return the effective SNR mapping this PHY is using.
+   *
+   * \return the effective SNR mapping this PHY is using
+   */
+  Ptr<EffectiveSnrMapping> GetEffectiveSnrMapping (void) const;
   /**
    * Return the device this PHY is associated with
    *
@@ -279,7 +293,7 @@ public:
   virtual bool IsAcMcsSupported (WifiMode mode); //11ac: vht_standard
   virtual double CalculateSnr (WifiMode txMode, double ber) const;
 	//shbyeon 802.11ac genie
-  virtual InterferenceHelper GetInterferenceHelper(void);
+  virtual const InterferenceHelper & GetInterferenceHelper(void) const;
   virtual Ptr<WifiChannel> GetChannel (void) const;
   
   virtual void ConfigureStandard (enum WifiPhyStandard standard);
@@ -0,0 +1,172 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <vector>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/uinteger.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/ppdu-duration.h"
+#include "ns3/ampdu-planner.h"
+#include "ns3/mpdu-standard-aggregator.h"
+
+NS_LOG_COMPONENT_DEFINE ("AmpduPlannerTest");
+
+using namespace ns3;
+
+/**
+ * The closed form of PpduDuration gives the durations of
+ * WifiPhy::CalculateTxDuration, for every preamble with one object.
+ */
+class PpduDurationTest : public TestCase
+{
+public:
+  PpduDurationTest ();
+  virtual void DoRun (void);
+
+private:
+  void Check (WifiMode mode, uint8_t nss, bool stbc);
+};
+
+PpduDurationTest::PpduDurationTest ()
+  : TestCase ("PpduDuration against WifiPhy::CalculateTxDuration")
+{
+}
+
+void
+PpduDurationTest::Check (WifiMode mode, uint8_t nss, bool stbc)
+{
+  WifiTxVector txVector;
+  txVector.SetMode (mode);
+  txVector.SetNss (nss);
+  txVector.SetStbc (stbc);
+  PpduDuration duration (txVector);
+  const WifiPreamble preambles[] = { WIFI_PREAMBLE_LONG, WIFI_PREAMBLE_SHORT, WIFI_PREAMBLE_HT_MF,
+                                     WIFI_PREAMBLE_HT_GF, WIFI_PREAMBLE_VHT };
+  for (uint32_t size = 1; size < 70000; size += 97)
+    {
+      for (uint32_t i = 0; i < sizeof (preambles) / sizeof (preambles[0]); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (duration.Calculate (size, preambles[i]),
+                                 WifiPhy::CalculateTxDuration (size, txVector, preambles[i]),
+                                 "mode " << mode << " nss " << (uint32_t)nss << " size " << size
+                                         << " preamble " << preambles[i]);
+        }
+    }
+}
+
+void
+PpduDurationTest::DoRun (void)
+{
+  Check (WifiPhy::GetDsssRate11Mbps (), 1, false);
+  Check (WifiPhy::GetOfdmRate54Mbps (), 1, false);
+  Check (WifiPhy::GetOfdmRate3MbpsBW10MHz (), 1, false);
+  Check (WifiPhy::GetErpOfdmRate24Mbps (), 1, false);
+  Check (WifiPhy::GetOfdmRate65MbpsBW20MHz (), 1, false);
+  Check (WifiPhy::GetOfdmRate65MbpsBW20MHzShGi (), 2, false);
+  Check (WifiPhy::GetOfdmRate135MbpsBW40MHz (), 2, true);
+  Check (WifiPhy::Get11acMcs0BW20MHz (), 1, false);
+  Check (WifiPhy::Get11acMcs8BW20MHz (), 3, true);
+}
+
+/**
+ * An A-MPDU planned with AmpduPlanner is the A-MPDU which
+ * MpduStandardAggregator builds one MPDU at a time.
+ */
+class AmpduPlannerTest : public TestCase
+{
+public:
+  AmpduPlannerTest ();
+  virtual void DoRun (void);
+};
+
+AmpduPlannerTest::AmpduPlannerTest ()
+  : TestCase ("AmpduPlanner against MpduStandardAggregator")
+{
+}
+
+void
+AmpduPlannerTest::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  Ptr<UniformRandomVariable> random = CreateObject<UniformRandomVariable> ();
+  Ptr<MpduStandardAggregator> aggregator = CreateObject<MpduStandardAggregator> ();
+  aggregator->SetAttribute ("MaxAmpduSize", UintegerValue (8000));
+  WifiTxVector txVector;
+  txVector.SetMode (WifiPhy::GetOfdmRate65MbpsBW20MHz ());
+  txVector.SetNss (1);
+  AmpduPlanner planner;
+
+  for (uint32_t n = 0; n < 200; n++)
+    {
+      planner.Start (aggregator, txVector);
+      Ptr<Packet> reference = Create<Packet> ();
+      bool added = true;
+      while (added)
+        {
+          uint8_t content[1600];
+          uint32_t size = random->GetInteger (10, 1600);
+          for (uint32_t i = 0; i < size; i++)
+            {
+              content[i] = random->GetInteger (0, 255);
+            }
+          Ptr<Packet> mpdu = Create<Packet> (content, size);
+          NS_TEST_EXPECT_MSG_EQ (planner.GetMaxAvailableLength (),
+                                 aggregator->GetMaxAvailableLength (reference), "wrong available length");
+          added = aggregator->Aggregate (mpdu, reference);
+          NS_TEST_EXPECT_MSG_EQ (planner.Add (mpdu), added, "wrong decision for an MPDU of " << size);
+          NS_TEST_EXPECT_MSG_EQ (planner.GetPsduSize (), reference->GetSize (), "wrong A-MPDU size");
+        }
+      NS_TEST_EXPECT_MSG_EQ (planner.CalculateTxDuration (planner.GetPsduSize (), WIFI_PREAMBLE_HT_MF),
+                             WifiPhy::CalculateTxDuration (reference->GetSize (), txVector, WIFI_PREAMBLE_HT_MF),
+                             "wrong A-MPDU duration");
+
+      Ptr<AmpduSubframes> layout = planner.GetSubframes ();
+      Ptr<AmpduSubframes> parsed = AmpduSubframes::Parse (reference);
+      NS_TEST_ASSERT_MSG_EQ (layout->GetN (), parsed->GetN (), "wrong number of subframes");
+      for (uint16_t i = 0; i < layout->GetN (); i++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (layout->GetOffset (i), parsed->GetOffset (i), "wrong offset of subframe " << i);
+          NS_TEST_EXPECT_MSG_EQ (layout->GetLength (i), parsed->GetLength (i), "wrong length of subframe " << i);
+        }
+
+      Ptr<Packet> ampdu = planner.Build ();
+      NS_TEST_ASSERT_MSG_EQ (ampdu->GetSize (), reference->GetSize (), "wrong size of the built A-MPDU");
+      std::vector<uint8_t> built (ampdu->GetSize ());
+      std::vector<uint8_t> expected (reference->GetSize ());
+      ampdu->CopyData (&built[0], built.size ());
+      reference->CopyData (&expected[0], expected.size ());
+      NS_TEST_EXPECT_MSG_EQ ((built == expected), true, "the built A-MPDU differs");
+    }
+}
+
+class AmpduPlannerTestSuite : public TestSuite
+{
+public:
+  AmpduPlannerTestSuite ();
+};
+
+AmpduPlannerTestSuite::AmpduPlannerTestSuite ()
+  : TestSuite ("wifi-ampdu-planner", UNIT)
+{
+  AddTestCase (new PpduDurationTest, TestCase::QUICK);
+  AddTestCase (new AmpduPlannerTest, TestCase::QUICK);
+}
+
+static AmpduPlannerTestSuite g_ampduPlannerTestSuite;
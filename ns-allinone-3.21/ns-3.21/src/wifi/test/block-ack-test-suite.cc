@@ -21,6 +21,7 @@
 #include "ns3/log.h"
 #include "ns3/qos-utils.h"
 #include "ns3/ctrl-headers.h"
+#include "ns3/block-ack-scoreboard.h"
 #include <list>
 
 using namespace ns3;
@@ -275,6 +276,53 @@ CtrlBAckResponseHeaderTest::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_blockAckHdr.IsPacketReceived (80), false, "error in compressed bitmap");
 }
 
+//Test for the sequence number scoreboard
+class BlockAckScoreboardTest : public TestCase
+{
+public:
+  BlockAckScoreboardTest ();
+private:
+  virtual void DoRun ();
+};
+
+BlockAckScoreboardTest::BlockAckScoreboardTest ()
+  : TestCase ("Check the block ack scoreboard across the sequence number wrap")
+{
+}
+
+void
+BlockAckScoreboardTest::DoRun (void)
+{
+  BlockAckScoreboard<uint32_t> scoreboard;
+  CtrlBAckResponseHeader blockAckHdr;
+  blockAckHdr.SetType (COMPRESSED_BLOCK_ACK);
+  blockAckHdr.SetStartingSequence (4090);
+  for (uint32_t i = 4090; i != 10; i = (i + 1) % 4096)
+    {
+      scoreboard.Set (i, i * 2);
+      blockAckHdr.SetReceivedPacket (i);
+    }
+  for (uint32_t i = 22; i < 25; i++)
+    {
+      scoreboard.Set (i, i * 2);
+      blockAckHdr.SetReceivedPacket (i);
+    }
+  scoreboard.Set (80, 160);
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetCount (), 20, "error in count");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetBitmap (4090), blockAckHdr.GetCompressedBitmap (), "error in bitmap");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetBitmap (0), 0x00000000001c003ffLL, "error in bitmap");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.Get (4095), 8190, "error in slot");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.FindNext (10, 100), 22, "error in next sequence number");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.FindNext (25, 55), 4096, "error in next sequence number");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.FindNext (25, 56), 80, "error in next sequence number");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.FindNext (81, 4015), 4090, "error in next sequence number");
+  scoreboard.Clear (4090);
+  scoreboard.Clear (4090);
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.IsSet (4090), false, "error in clear");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.GetCount (), 19, "error in count");
+  NS_TEST_EXPECT_MSG_EQ (scoreboard.FindNext (4090, 10), 4091, "error in next sequence number");
+}
+
 class BlockAckTestSuite : public TestSuite
 {
 public:
@@ -287,6 +335,7 @@ BlockAckTestSuite::BlockAckTestSuite ()
   AddTestCase (new PacketBufferingCaseA, TestCase::QUICK);
   AddTestCase (new PacketBufferingCaseB, TestCase::QUICK);
   AddTestCase (new CtrlBAckResponseHeaderTest, TestCase::QUICK);
+  AddTestCase (new BlockAckScoreboardTest, TestCase::QUICK);
 }
 
 static BlockAckTestSuite g_blockAckTestSuite;
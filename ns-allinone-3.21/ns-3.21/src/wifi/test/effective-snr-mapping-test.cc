@@ -0,0 +1,142 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/boolean.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/effective-snr-mapping.h"
+
+NS_LOG_COMPONENT_DEFINE ("EffectiveSnrMappingTest");
+
+using namespace ns3;
+
+static double
+ToDb (double ratio)
+{
+  return 10.0 * std::log10 (ratio);
+}
+
+/**
+ * Streams with the same SINR map to that SINR, unequal streams map
+ * between the weakest and the strongest one, and 256-QAM has its own
+ * curve.
+ */
+class EffectiveSnrMappingTest : public TestCase
+{
+public:
+  EffectiveSnrMappingTest ();
+  virtual void DoRun (void);
+};
+
+EffectiveSnrMappingTest::EffectiveSnrMappingTest ()
+  : TestCase ("EffectiveSnrMapping")
+{
+}
+
+void
+EffectiveSnrMappingTest::DoRun (void)
+{
+  Ptr<RbirEffectiveSnrMapping> legacy = CreateObject<RbirEffectiveSnrMapping> ();
+  Ptr<RbirEffectiveSnrMapping> rbir = CreateObject<RbirEffectiveSnrMapping> ();
+  rbir->SetAttribute ("Interpolation", BooleanValue (true));
+  Ptr<EffectiveSnrMapping> mappings[] = { legacy, rbir,
+                                          CreateObject<MiesmEffectiveSnrMapping> (),
+                                          CreateObject<EesmEffectiveSnrMapping> () };
+  WifiMode modes[] = { WifiPhy::Get11acMcs0BW20MHz (), WifiPhy::Get11acMcs4BW20MHz (),
+                       WifiPhy::Get11acMcs7BW20MHz (), WifiPhy::Get11acMcs9BW20MHz () };
+
+  for (uint32_t m = 0; m < 4; m++)
+    {
+      for (uint32_t k = 0; k < 4; k++)
+        {
+          // on a sample of the curves, below their saturation
+          double same[] = { std::pow (10.0, 0.5), std::pow (10.0, 0.5) };
+          NS_TEST_ASSERT_MSG_EQ_TOL (ToDb (mappings[m]->GetEffectiveSnr (modes[k], same, 2)), 5.0, 0.01,
+                                     "mapping " << m << " mode " << modes[k]);
+          double sinr[] = { 2.0, 40.0, 300.0 };
+          double esnr = mappings[m]->GetEffectiveSnr (modes[k], sinr, 3);
+          NS_TEST_ASSERT_MSG_EQ ((esnr >= sinr[0] && esnr <= sinr[2]), true,
+                                 "mapping " << m << " mode " << modes[k] << " esnr " << esnr);
+        }
+    }
+
+  // 256-QAM needs more SNR than BPSK for the same information
+  double sinr[] = { 10.0, 1000.0 };
+  NS_TEST_ASSERT_MSG_GT (rbir->GetEffectiveSnr (WifiPhy::Get11acMcs9BW20MHz (), sinr, 2),
+                         rbir->GetEffectiveSnr (WifiPhy::Get11acMcs0BW20MHz (), sinr, 2) * 5,
+                         "256-QAM curve");
+  NS_TEST_ASSERT_MSG_EQ ((int)EffectiveSnrMapping::GetMcsIndex (WifiPhy::Get11acMcs9BW20MHz ()), 9, "MCS index");
+  NS_TEST_ASSERT_MSG_EQ ((int)EffectiveSnrMapping::GetMcsIndex (WifiPhy::Get11acMcs5BW20MHz ()), 5, "MCS index");
+}
+
+/**
+ * The RBIR mapping without interpolation gives the effective SNRs of
+ * the original CalculateSnr, for the constellations it had curves for.
+ */
+class RbirLegacyMappingTest : public TestCase
+{
+public:
+  RbirLegacyMappingTest ();
+  virtual void DoRun (void);
+};
+
+RbirLegacyMappingTest::RbirLegacyMappingTest ()
+  : TestCase ("RbirEffectiveSnrMapping, quantized as the original CalculateSnr")
+{
+}
+
+void
+RbirLegacyMappingTest::DoRun (void)
+{
+  Ptr<RbirEffectiveSnrMapping> legacy = CreateObject<RbirEffectiveSnrMapping> ();
+  // BPSK, QPSK, 16-QAM and 64-QAM
+  WifiMode modes[] = { WifiPhy::Get11acMcs0BW20MHz (), WifiPhy::Get11acMcs1BW20MHz (),
+                       WifiPhy::Get11acMcs3BW20MHz (), WifiPhy::Get11acMcs5BW20MHz () };
+  double sinrs[][3] = { { 2.0, 40.0, 300.0 }, { 0.5, 3.0, 8.0 }, { 10.0, 1000.0 },
+                        { 0.01, 0.2 }, { 5000.0, 20.0 } };
+  uint8_t nss[] = { 3, 3, 2, 2, 2 };
+  // in dB, as worked out by the CalculateSnr this mapping was taken from
+  double expected[][4] = { { 4.5, 6.0, 10.0, 13.0 },
+                           { 1.0, 2.5, 4.0, 4.0 },
+                           { 10.0, 10.5, 12.0, 15.0 },
+                           { -10.0, -10.0, -10.0, -10.0 },
+                           { 13.010299956639813, 13.010299956639813, 14.0, 16.5 } };
+  for (uint32_t s = 0; s < 5; s++)
+    {
+      for (uint32_t k = 0; k < 4; k++)
+        {
+          NS_TEST_EXPECT_MSG_EQ_TOL (ToDb (legacy->GetEffectiveSnr (modes[k], sinrs[s], nss[s])),
+                                     expected[s][k], 1e-9, "SINRs " << s << " mode " << modes[k]);
+        }
+    }
+}
+
+class EffectiveSnrMappingTestSuite : public TestSuite
+{
+public:
+  EffectiveSnrMappingTestSuite ();
+};
+
+EffectiveSnrMappingTestSuite::EffectiveSnrMappingTestSuite ()
+  : TestSuite ("devices-wifi-effective-snr-mapping", UNIT)
+{
+  AddTestCase (new EffectiveSnrMappingTest, TestCase::QUICK);
+  AddTestCase (new RbirLegacyMappingTest, TestCase::QUICK);
+}
+
+static EffectiveSnrMappingTestSuite g_effectiveSnrMappingTestSuite;
@@ -0,0 +1,87 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/interference-helper.h"
+
+NS_LOG_COMPONENT_DEFINE ("InterferenceTimelineTest");
+
+using namespace ns3;
+
+/**
+ * Check the order of the changes of InterferenceTimeline, and that the
+ * subchannels which share it only see and prune their own changes.
+ */
+class InterferenceTimelineTest : public TestCase
+{
+public:
+  InterferenceTimelineTest ();
+  virtual void DoRun (void);
+};
+
+InterferenceTimelineTest::InterferenceTimelineTest ()
+  : TestCase ("InterferenceTimeline")
+{
+}
+
+void
+InterferenceTimelineTest::DoRun (void)
+{
+  Ptr<InterferenceTimeline> timeline = Create<InterferenceTimeline> ();
+  timeline->Add (0, MicroSeconds (10), 1.0);
+  timeline->Add (1, MicroSeconds (5), 7.0);
+  timeline->Add (0, MicroSeconds (30), -1.0);
+  timeline->Add (0, MicroSeconds (20), 2.0);
+  // same time, after the change already there
+  timeline->Add (0, MicroSeconds (20), 3.0);
+  timeline->Add (1, MicroSeconds (25), -7.0);
+
+  const double expected[] = { 1.0, 2.0, 3.0, -1.0 };
+  const int64_t times[] = { 10, 20, 20, 30 };
+  uint32_t n = 0;
+  for (InterferenceTimeline::Iterator i = timeline->Begin (0); i != timeline->End (0); i++, n++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (i->second, expected[n], "change " << n);
+      NS_TEST_ASSERT_MSG_EQ (i->first.GetMicroSeconds (), times[n], "change " << n);
+    }
+  NS_TEST_ASSERT_MSG_EQ (n, 4, "changes of subchannel 0");
+
+  // the changes of subchannel 1 before 20us are kept
+  timeline->Prune (0, MicroSeconds (20));
+  NS_TEST_ASSERT_MSG_EQ (timeline->GetFirstPower (0), 6.0, "folded changes");
+  NS_TEST_ASSERT_MSG_EQ (timeline->GetFirstPower (1), 0.0, "other subchannel");
+  NS_TEST_ASSERT_MSG_EQ (timeline->Begin (0)->first.GetMicroSeconds (), 30, "first change left");
+  NS_TEST_ASSERT_MSG_EQ (timeline->Begin (1)->first.GetMicroSeconds (), 5, "other subchannel");
+
+  timeline->Clear (1);
+  NS_TEST_ASSERT_MSG_EQ ((timeline->Begin (1) == timeline->End (1)), true, "cleared subchannel");
+  NS_TEST_ASSERT_MSG_EQ (timeline->Begin (0)->second, -1.0, "other subchannel");
+}
+
+class InterferenceTimelineTestSuite : public TestSuite
+{
+public:
+  InterferenceTimelineTestSuite ();
+};
+
+InterferenceTimelineTestSuite::InterferenceTimelineTestSuite ()
+  : TestSuite ("devices-wifi-interference-timeline", UNIT)
+{
+  AddTestCase (new InterferenceTimelineTest, TestCase::QUICK);
+}
+
+static InterferenceTimelineTestSuite g_interferenceTimelineTestSuite;
@@ -0,0 +1,197 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <complex>
+#include <cmath>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/mimo-mmse.h"
+
+NS_LOG_COMPONENT_DEFINE ("MimoMmseTest");
+
+using namespace ns3;
+
+/**
+ * Compare MimoMmseSinr against a textbook MMSE receiver built on a
+ * Gauss-Jordan inverse of H^H H + n0 I, for random channels of 1 to 4
+ * streams, with and without a caudal-loss channel mismatch.
+ */
+class MimoMmseTest : public TestCase
+{
+public:
+  MimoMmseTest ();
+  virtual void DoRun (void);
+
+private:
+  typedef std::complex<double> Complex;
+  void Reference (int n, const Complex *h, const Complex *d, double n0, double *sinr);
+};
+
+MimoMmseTest::MimoMmseTest ()
+  : TestCase ("MIMO MMSE SINR kernel")
+{
+}
+
+void
+MimoMmseTest::Reference (int n, const Complex *h, const Complex *d, double n0, double *sinr)
+{
+  Complex a[4][8];
+  for (int i = 0; i < n; i++)
+    {
+      for (int j = 0; j < n; j++)
+        {
+          a[i][j] = 0;
+          for (int k = 0; k < n; k++)
+            {
+              a[i][j] += std::conj (h[k * n + i]) * h[k * n + j];
+            }
+          a[i][n + j] = (i == j) ? 1 : 0;
+        }
+      a[i][i] += n0;
+    }
+  for (int c = 0; c < n; c++)
+    {
+      int pivot = c;
+      for (int r = c + 1; r < n; r++)
+        {
+          if (std::abs (a[r][c]) > std::abs (a[pivot][c]))
+            {
+              pivot = r;
+            }
+        }
+      for (int k = 0; k < 2 * n; k++)
+        {
+          std::swap (a[c][k], a[pivot][k]);
+        }
+      Complex p = a[c][c];
+      for (int k = 0; k < 2 * n; k++)
+        {
+          a[c][k] /= p;
+        }
+      for (int r = 0; r < n; r++)
+        {
+          if (r != c)
+            {
+              Complex f = a[r][c];
+              for (int k = 0; k < 2 * n; k++)
+                {
+                  a[r][k] -= f * a[c][k];
+                }
+            }
+        }
+    }
+  Complex w[4][4];
+  for (int i = 0; i < n; i++)
+    {
+      for (int j = 0; j < n; j++)
+        {
+          w[i][j] = 0;
+          for (int k = 0; k < n; k++)
+            {
+              w[i][j] += a[i][n + k] * std::conj (h[j * n + k]);
+            }
+        }
+    }
+  for (int i = 0; i < n; i++)
+    {
+      double amplification = 0;
+      double interference = 0;
+      double mobility = 0;
+      double signal = 0;
+      for (int j = 0; j < n; j++)
+        {
+          amplification += std::norm (w[i][j]);
+          Complex g = 0;
+          Complex m = 0;
+          for (int k = 0; k < n; k++)
+            {
+              g += w[i][k] * h[k * n + j];
+              if (d != 0)
+                {
+                  m += w[i][k] * d[k * n + j];
+                }
+            }
+          if (i == j)
+            {
+              signal = std::norm (g);
+            }
+          else
+            {
+              interference += std::norm (g);
+            }
+          mobility += std::norm (m);
+        }
+      sinr[i] = signal / (interference + n0 * amplification + mobility);
+    }
+}
+
+void
+MimoMmseTest::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  Ptr<NormalRandomVariable> gauss = CreateObject<NormalRandomVariable> ();
+  gauss->SetStream (1);
+
+  for (int n = 1; n <= 4; n++)
+    {
+      for (int trial = 0; trial < 50; trial++)
+        {
+          Complex h[16], d[16];
+          double hRe[16], hIm[16], dRe[16], dIm[16];
+          for (int i = 0; i < n * n; i++)
+            {
+              h[i] = Complex (gauss->GetValue (), gauss->GetValue ()) / std::sqrt (2.0);
+              d[i] = Complex (gauss->GetValue (), gauss->GetValue ()) / 20.0;
+              hRe[i] = h[i].real ();
+              hIm[i] = h[i].imag ();
+              dRe[i] = d[i].real ();
+              dIm[i] = d[i].imag ();
+            }
+          // from 30 dB down to -10 dB of SNR
+          double n0 = n * std::pow (10.0, (trial % 5) - 3.0);
+          bool mismatch = (trial % 2) == 1;
+          double expected[4], actual[4];
+          Reference (n, h, mismatch ? d : 0, n0, expected);
+          bool ok = MimoMmseSinr (n, hRe, hIm, mismatch ? dRe : 0, mismatch ? dIm : 0, n0, actual);
+          NS_TEST_ASSERT_MSG_EQ (ok, true, "nss " << n << " not dispatched");
+          for (int i = 0; i < n; i++)
+            {
+              NS_TEST_ASSERT_MSG_EQ_TOL (actual[i], expected[i], 1e-9 * expected[i],
+                                         "nss " << n << " trial " << trial << " stream " << i);
+            }
+        }
+    }
+  double sinr[5];
+  double dummy[25] = { 0 };
+  NS_TEST_ASSERT_MSG_EQ (MimoMmseSinr (5, dummy, dummy, 0, 0, 1.0, sinr), false, "nss 5 is not supported");
+}
+
+class MimoMmseTestSuite : public TestSuite
+{
+public:
+  MimoMmseTestSuite ();
+};
+
+MimoMmseTestSuite::MimoMmseTestSuite ()
+  : TestSuite ("devices-wifi-mimo-mmse", UNIT)
+{
+  AddTestCase (new MimoMmseTest, TestCase::QUICK);
+}
+
+static MimoMmseTestSuite g_mimoMmseTestSuite;
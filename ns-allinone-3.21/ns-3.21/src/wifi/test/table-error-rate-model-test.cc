@@ -0,0 +1,184 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <cmath>
+#include <fstream>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/string.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/table-error-rate-model.h"
+
+NS_LOG_COMPONENT_DEFINE ("TableErrorRateModelTest");
+
+using namespace ns3;
+
+/**
+ * The tabulated curves stay within 1e-3 of the NistErrorRateModel.
+ */
+class TableErrorRateModelNistTest : public TestCase
+{
+public:
+  TableErrorRateModelNistTest ();
+  virtual void DoRun (void);
+};
+
+TableErrorRateModelNistTest::TableErrorRateModelNistTest ()
+  : TestCase ("TableErrorRateModel against NistErrorRateModel")
+{
+}
+
+void
+TableErrorRateModelNistTest::DoRun (void)
+{
+  Ptr<NistErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+  WifiMode modes[] = { WifiPhy::GetOfdmRate6Mbps (), WifiPhy::GetOfdmRate9Mbps (),
+                       WifiPhy::GetOfdmRate18Mbps (), WifiPhy::GetOfdmRate48Mbps (),
+                       WifiPhy::Get11acMcs0BW20MHz (), WifiPhy::Get11acMcs3BW40MHz (),
+                       WifiPhy::Get11acMcs4BW80MHz (), WifiPhy::Get11acMcs7BW20MHz (),
+                       WifiPhy::GetDsssRate11Mbps () };
+  uint32_t sizes[] = { 1, 8, 100, 1000, 12000, 65535 };
+  double maxError = 0;
+  for (uint32_t m = 0; m < sizeof (modes) / sizeof (modes[0]); m++)
+    {
+      for (double snrDb = -15; snrDb < 45; snrDb += 0.037)
+        {
+          double snr = std::pow (10.0, snrDb / 10.0);
+          for (uint32_t s = 0; s < sizeof (sizes) / sizeof (sizes[0]); s++)
+            {
+              double error = std::fabs (table->GetChunkSuccessRate (modes[m], snr, sizes[s])
+                                        - nist->GetChunkSuccessRate (modes[m], snr, sizes[s]));
+              maxError = std::max (maxError, error);
+              NS_TEST_ASSERT_MSG_LT (error, 1e-3, modes[m] << " snr " << snrDb << " dB " << sizes[s] << " bits");
+            }
+        }
+    }
+  NS_LOG_INFO ("largest error " << maxError);
+}
+
+/**
+ * A curve loaded from a file is found again at its points, and scales
+ * with the chunk size.
+ */
+class TableErrorRateModelFileTest : public TestCase
+{
+public:
+  TableErrorRateModelFileTest ();
+  virtual void DoRun (void);
+};
+
+TableErrorRateModelFileTest::TableErrorRateModelFileTest ()
+  : TestCase ("TableErrorRateModel curve file")
+{
+}
+
+void
+TableErrorRateModelFileTest::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("curves.txt");
+  {
+    std::ofstream file (filename.c_str ());
+    file << "# constellation codeRate bits snrDb per" << std::endl;
+    file << "256 5/6 8000 30 0.001" << std::endl;
+    file << "256 5/6 8000 20 0.9" << std::endl;
+    file << "256 5/6 8000 25 0.1" << std::endl;
+  }
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+  table->SetAttribute ("CurveFile", StringValue (filename));
+  WifiMode mode = WifiPhy::Get11acMcs9BW20MHz ();
+
+  NS_TEST_ASSERT_MSG_EQ_TOL (table->GetChunkSuccessRate (mode, std::pow (10.0, 2.5), 8000), 0.9, 1e-9, "point");
+  NS_TEST_ASSERT_MSG_EQ_TOL (table->GetChunkSuccessRate (mode, std::pow (10.0, 2.5), 4000), std::sqrt (0.9), 1e-9, "half size");
+  NS_TEST_ASSERT_MSG_EQ_TOL (table->GetChunkSuccessRate (mode, 1e4, 8000), 0.999, 1e-9, "above the curve");
+  double middle = table->GetChunkSuccessRate (mode, std::pow (10.0, 2.25), 8000);
+  NS_TEST_ASSERT_MSG_EQ ((middle > 0.1 && middle < 0.9), true, "between two points");
+  // the other curves are untouched
+  Ptr<NistErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+  NS_TEST_ASSERT_MSG_EQ_TOL (table->GetChunkSuccessRate (WifiPhy::Get11acMcs7BW20MHz (), 300.0, 8000),
+                             nist->GetChunkSuccessRate (WifiPhy::Get11acMcs7BW20MHz (), 300.0, 8000), 1e-3, "NIST curve");
+}
+
+/**
+ * Below the first SNR of the table at which the NistErrorRateModel is not
+ * clamped, the success rate follows NIST smoothly down to zero instead of
+ * dropping to zero at the previous SNR of the table.
+ */
+class TableErrorRateModelClampTest : public TestCase
+{
+public:
+  TableErrorRateModelClampTest ();
+  virtual void DoRun (void);
+};
+
+TableErrorRateModelClampTest::TableErrorRateModelClampTest ()
+  : TestCase ("TableErrorRateModel below the NIST clamp")
+{
+}
+
+void
+TableErrorRateModelClampTest::DoRun (void)
+{
+  Ptr<NistErrorRateModel> nist = CreateObject<NistErrorRateModel> ();
+  Ptr<TableErrorRateModel> table = CreateObject<TableErrorRateModel> ();
+  WifiMode modes[] = { WifiPhy::GetOfdmRate6Mbps (), WifiPhy::GetOfdmRate12Mbps (),
+                       WifiPhy::GetOfdmRate36Mbps (), WifiPhy::GetOfdmRate54Mbps () };
+  for (uint32_t m = 0; m < sizeof (modes) / sizeof (modes[0]); m++)
+    {
+      // the first SNR of the table (-10 dB by 0.05 dB) NIST does not clamp
+      double firstDb = -10;
+      while (nist->GetChunkSuccessRate (modes[m], std::pow (10.0, firstDb / 10.0), 1) == 0)
+        {
+          firstDb += 0.05;
+        }
+      double first = table->GetChunkSuccessRate (modes[m], std::pow (10.0, firstDb / 10.0), 1);
+      NS_TEST_ASSERT_MSG_GT (first, 0, modes[m] << " at " << firstDb << " dB");
+      double previous = first;
+      uint32_t nonZero = 0;
+      for (uint32_t k = 1; k < 10; k++)
+        {
+          double snr = std::pow (10.0, (firstDb - 0.005 * k) / 10.0);
+          double success = table->GetChunkSuccessRate (modes[m], snr, 1);
+          NS_TEST_ASSERT_MSG_LT_OR_EQ (success, previous, modes[m] << " not monotonic at " << snr);
+          double expected = nist->GetChunkSuccessRate (modes[m], snr, 1);
+          NS_TEST_ASSERT_MSG_EQ_TOL (success, expected, 1e-3, modes[m] << " snr " << snr);
+          if (expected > 0)
+            {
+              NS_TEST_ASSERT_MSG_GT (success, 0, modes[m] << " snr " << snr);
+            }
+          nonZero += (success > 0);
+          previous = success;
+        }
+      NS_TEST_ASSERT_MSG_GT (nonZero, 0, modes[m] << " no success rate below " << firstDb << " dB");
+    }
+}
+
+class TableErrorRateModelTestSuite : public TestSuite
+{
+public:
+  TableErrorRateModelTestSuite ();
+};
+
+TableErrorRateModelTestSuite::TableErrorRateModelTestSuite ()
+  : TestSuite ("devices-wifi-table-error-rate-model", UNIT)
+{
+  AddTestCase (new TableErrorRateModelNistTest, TestCase::QUICK);
+  AddTestCase (new TableErrorRateModelFileTest, TestCase::QUICK);
+  AddTestCase (new TableErrorRateModelClampTest, TestCase::QUICK);
+}
+
+static TableErrorRateModelTestSuite g_tableErrorRateModelTestSuite;
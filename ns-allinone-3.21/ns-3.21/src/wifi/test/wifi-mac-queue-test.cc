@@ -0,0 +1,252 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <list>
+#include "ns3/test.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/wifi-mac-queue.h"
+#include "ns3/qos-blocked-destinations.h"
+
+NS_LOG_COMPONENT_DEFINE ("WifiMacQueueTest");
+
+using namespace ns3;
+
+/**
+ * Random operations on a WifiMacQueue give the same packets as on a
+ * plain list searched from the front.
+ */
+class WifiMacQueueReferenceTest : public TestCase
+{
+public:
+  WifiMacQueueReferenceTest ();
+  virtual void DoRun (void);
+
+private:
+  struct Item
+  {
+    Ptr<const Packet> packet;
+    WifiMacHeader hdr;
+    Time tstamp;
+  };
+  typedef std::list<Item>::iterator ItemI;
+
+  void Step (void);
+  void Cleanup (void);
+  bool IsAvailable (const WifiMacHeader &hdr) const;
+  Ptr<const Packet> Take (ItemI it, bool remove);
+
+  Ptr<WifiMacQueue> m_queue;
+  std::list<Item> m_reference;
+  QosBlockedDestinations m_blocked;
+  Mac48Address m_addresses[4];
+  Ptr<UniformRandomVariable> m_random;
+  uint32_t m_steps;
+};
+
+WifiMacQueueReferenceTest::WifiMacQueueReferenceTest ()
+  : TestCase ("WifiMacQueue against a plain list")
+{
+}
+
+void
+WifiMacQueueReferenceTest::Cleanup (void)
+{
+  for (ItemI i = m_reference.begin (); i != m_reference.end ();)
+    {
+      if (i->tstamp + m_queue->GetMaxDelay () > Simulator::Now ())
+        {
+          i++;
+        }
+      else
+        {
+          i = m_reference.erase (i);
+        }
+    }
+}
+
+bool
+WifiMacQueueReferenceTest::IsAvailable (const WifiMacHeader &hdr) const
+{
+  return !hdr.IsQosData () || !m_blocked.IsBlocked (hdr.GetAddr1 (), hdr.GetQosTid ());
+}
+
+Ptr<const Packet>
+WifiMacQueueReferenceTest::Take (ItemI it, bool remove)
+{
+  if (it == m_reference.end ())
+    {
+      return 0;
+    }
+  Ptr<const Packet> packet = it->packet;
+  if (remove)
+    {
+      m_reference.erase (it);
+    }
+  return packet;
+}
+
+void
+WifiMacQueueReferenceTest::Step (void)
+{
+  Cleanup ();
+  Mac48Address addr = m_addresses[m_random->GetInteger (0, 3)];
+  uint8_t tid = m_random->GetInteger (0, 2);
+  uint32_t op = m_random->GetInteger (0, 9);
+  WifiMacHeader hdr;
+  Time tstamp;
+  Ptr<const Packet> expected = 0;
+  Ptr<const Packet> packet = 0;
+  if (op <= 2)
+    {
+      Item item;
+      item.packet = Create<Packet> (100);
+      if (m_random->GetInteger (0, 4) == 0)
+        {
+          item.hdr.SetType (WIFI_MAC_MGT_ACTION);
+        }
+      else
+        {
+          item.hdr.SetType (WIFI_MAC_QOSDATA);
+          item.hdr.SetQosTid (tid);
+        }
+      item.hdr.SetAddr1 (addr);
+      item.tstamp = Simulator::Now ();
+      if (op == 2)
+        {
+          m_queue->PushFront (item.packet, item.hdr);
+          m_reference.push_front (item);
+        }
+      else
+        {
+          m_queue->Enqueue (item.packet, item.hdr);
+          m_reference.push_back (item);
+        }
+    }
+  else if (op == 3)
+    {
+      packet = m_queue->Dequeue (&hdr);
+      expected = Take (m_reference.begin (), true);
+    }
+  else if (op == 4 || op == 5)
+    {
+      bool peek = op == 5;
+      ItemI it = m_reference.begin ();
+      while (it != m_reference.end ()
+             && !(it->hdr.IsQosData () && it->hdr.GetAddr1 () == addr && it->hdr.GetQosTid () == tid))
+        {
+          it++;
+        }
+      if (peek)
+        {
+          packet = m_queue->PeekByTidAndAddress (&hdr, tid, WifiMacHeader::ADDR1, addr);
+          expected = Take (it, false);
+          if (packet != 0 && m_random->GetInteger (0, 1) == 0)
+            {
+              NS_TEST_EXPECT_MSG_EQ (m_queue->Remove (packet), true, "peeked packet not removed");
+              Take (it, true);
+            }
+        }
+      else
+        {
+          packet = m_queue->DequeueByTidAndAddress (&hdr, tid, WifiMacHeader::ADDR1, addr);
+          expected = Take (it, true);
+        }
+    }
+  else if (op == 6 || op == 7)
+    {
+      ItemI it = m_reference.begin ();
+      while (it != m_reference.end () && !IsAvailable (it->hdr))
+        {
+          it++;
+        }
+      if (op == 6)
+        {
+          packet = m_queue->DequeueFirstAvailable (&hdr, tstamp, &m_blocked);
+        }
+      else
+        {
+          packet = m_queue->PeekFirstAvailable (&hdr, tstamp, &m_blocked);
+        }
+      expected = Take (it, op == 6);
+    }
+  else
+    {
+      if (m_blocked.IsBlocked (addr, tid))
+        {
+          m_blocked.Unblock (addr, tid);
+        }
+      else
+        {
+          m_blocked.Block (addr, tid);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (packet, expected, "wrong packet for operation " << op);
+
+  uint32_t n = 0;
+  for (ItemI it = m_reference.begin (); it != m_reference.end (); it++)
+    {
+      if (it->hdr.IsQosData () && it->hdr.GetAddr1 () == addr && it->hdr.GetQosTid () == tid)
+        {
+          n++;
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetNPacketsByTidAndAddress (tid, WifiMacHeader::ADDR1, addr), n,
+                         "wrong number of packets");
+  NS_TEST_EXPECT_MSG_EQ (m_queue->GetSize (), m_reference.size (), "wrong queue size");
+
+  if (--m_steps > 0)
+    {
+      // the lifetime is 40 steps
+      Simulator::Schedule (MilliSeconds (1), &WifiMacQueueReferenceTest::Step, this);
+    }
+}
+
+void
+WifiMacQueueReferenceTest::DoRun (void)
+{
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  m_random = CreateObject<UniformRandomVariable> ();
+  m_queue = CreateObject<WifiMacQueue> ();
+  m_queue->SetMaxSize (1000);
+  m_queue->SetMaxDelay (MilliSeconds (40));
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      m_addresses[i] = Mac48Address::Allocate ();
+    }
+  m_steps = 5000;
+  Simulator::Schedule (MilliSeconds (1), &WifiMacQueueReferenceTest::Step, this);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  m_queue = 0;
+}
+
+class WifiMacQueueTestSuite : public TestSuite
+{
+public:
+  WifiMacQueueTestSuite ();
+};
+
+WifiMacQueueTestSuite::WifiMacQueueTestSuite ()
+  : TestSuite ("devices-wifi-mac-queue", UNIT)
+{
+  AddTestCase (new WifiMacQueueReferenceTest, TestCase::QUICK);
+}
+
+static WifiMacQueueTestSuite g_wifiMacQueueTestSuite;
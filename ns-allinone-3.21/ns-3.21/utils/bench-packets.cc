@@ -182,6 +182,48 @@ benchD (uint32_t n)
 
 
 
+// A packet tagged by the upper layers is copied for each receiver, as
+// by a wireless channel, each copy being peeked, tagged and untagged a
+// few times on its way up, and copied again, as a mesh packet over Wi-Fi.
+static void
+benchE (uint32_t n)
+{
+  BenchTag<1> socketAddress;
+  BenchTag<2> flow;
+  BenchTag<3> hwmp;
+  BenchTag<4> qos;
+  BenchTag<5> ampdu;
+  BenchTag<6> duplicate;
+  BenchTag<7> snr;
+  BenchTag<8> missing;
+  for (uint32_t i = 0; i < n; i++) {
+    Ptr<Packet> p = Create<Packet> (1000);
+    p->AddPacketTag (socketAddress);
+    p->AddPacketTag (flow);
+    p->AddPacketTag (hwmp);
+    p->AddPacketTag (qos);
+    for (uint32_t receiver = 0; receiver < 4; receiver++) {
+      Ptr<Packet> copy = p->Copy ();
+      copy->AddPacketTag (ampdu);
+      copy->PeekPacketTag (missing);
+      copy->PeekPacketTag (duplicate);
+      copy->RemovePacketTag (ampdu);
+      Ptr<Packet> up = copy->Copy ();
+      up->AddPacketTag (snr);
+      up->PeekPacketTag (qos);
+      up->PeekPacketTag (flow);
+      up->PeekPacketTag (missing);
+      up->ReplacePacketTag (qos);
+      up->RemovePacketTag (snr);
+      up->RemovePacketTag (hwmp);
+      Ptr<Packet> forward = up->Copy ();
+      forward->PeekPacketTag (flow);
+      forward->PeekPacketTag (ampdu);
+      forward->RemovePacketTag (qos);
+    }
+  }
+}
+
 static void 
 benchA (uint32_t n)
 {
@@ -289,6 +331,7 @@ int main (int argc, char *argv[])
   runBench (&benchB, n, "Just add headers");
   runBench (&benchC, n, "Remove by func call");
   runBench (&benchD, n, "Intermixed add/remove headers and tags");
+  runBench (&benchE, n, "Peek, add and remove tags across copies");
 
   return 0;
 }
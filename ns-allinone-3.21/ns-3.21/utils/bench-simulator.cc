@@ -80,6 +80,7 @@ Bench::RunBench (void)
   double init, simu;
 
   DEB ("initializing");
+  m_count = 0;
 
   time.Start ();
   for (uint32_t i = 0; i < m_population; ++i)
@@ -125,11 +126,25 @@ Bench::Cb (void)
 
 
 Ptr<RandomVariableStream>
-GetRandomStream (std::string filename)
+GetRandomStream (std::string filename, bool wifi)
 {
   Ptr<RandomVariableStream> stream = 0;
   
-  if (filename == "")
+  if (wifi)
+    {
+      // mostly slots, SIFS and frames, with a sparse tail of timers
+      LOGME ("using wifi-like event distribution");
+      Ptr<EmpiricalRandomVariable> erv = CreateObject<EmpiricalRandomVariable> ();
+      erv->CDF (0, 0.0);
+      erv->CDF (1000, 0.2);         // propagation delays
+      erv->CDF (16000, 0.5);        // slots and SIFS
+      erv->CDF (300000, 0.9);       // frames and timeouts
+      erv->CDF (5000000, 0.97);     // backoffs and queues
+      erv->CDF (100000000, 0.995);  // beacons
+      erv->CDF (1000000000, 1.0);   // routing and rate control timers
+      stream = erv;
+    }
+  else if (filename == "")
     {
       LOGME ("using default exponential distribution");
       Ptr<ExponentialRandomVariable> erv = CreateObject<ExponentialRandomVariable> ();
@@ -186,6 +201,8 @@ int main (int argc, char *argv[])
   bool schedHeap = false;
   bool schedList = false;
   bool schedMap  = true;
+  bool schedLadder = false;
+  bool wifi = false;
 
   uint32_t pop   =  100000;
   uint32_t total = 1000000;
@@ -199,17 +216,20 @@ int main (int argc, char *argv[])
              "  an exponential distribution, with mean 100 ns,\n"
              "  an ascii file, given by the --file=\"<filename>\" argument,\n"
              "  or standard input, by the argument --file=\"-\"\n"
+             "  or a wifi-like mix of near events and far timers, by --wifi\n"
              "In the case of either --file form, the input is expected\n"
              "to be ascii, giving the relative event times in ns.");
   cmd.AddValue ("cal",   "use CalendarSheduler",          schedCal);
   cmd.AddValue ("heap",  "use HeapScheduler",             schedHeap);
   cmd.AddValue ("list",  "use ListSheduler",              schedList);
   cmd.AddValue ("map",   "use MapScheduler (default)",    schedMap);
+  cmd.AddValue ("ladder", "use LadderScheduler",          schedLadder);
   cmd.AddValue ("debug", "enable debugging output",       g_debug);
   cmd.AddValue ("pop",   "event population size (default 1E5)",         pop);
   cmd.AddValue ("total", "total number of events to run (default 1E6)", total);
   cmd.AddValue ("runs",  "number of runs (default 1)",    runs);
   cmd.AddValue ("file",  "file of relative event times",  filename);
+  cmd.AddValue ("wifi",  "use wifi-like event times",     wifi);
   cmd.AddValue ("prec",  "printed output precision",      g_fwidth);
   cmd.Parse (argc, argv);
   g_me = cmd.GetName () + ": ";
@@ -219,6 +239,7 @@ int main (int argc, char *argv[])
   if (schedCal)  { factory.SetTypeId ("ns3::CalendarScheduler"); }
   if (schedHeap) { factory.SetTypeId ("ns3::HeapScheduler");     }
   if (schedList) { factory.SetTypeId ("ns3::ListScheduler");     }  
+  if (schedLadder) { factory.SetTypeId ("ns3::LadderScheduler"); }
   Simulator::SetScheduler (factory);
 
   LOGME (std::setprecision (g_fwidth - 6));
@@ -230,7 +251,7 @@ int main (int argc, char *argv[])
   LOGME ("runs: " << runs);
   
   Bench *bench = new Bench (pop, total);
-  bench->SetRandomStream (GetRandomStream (filename));
+  bench->SetRandomStream (GetRandomStream (filename, wifi));
 
   // table header
   LOG ("");
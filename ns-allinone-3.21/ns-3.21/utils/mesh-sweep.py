@@ -0,0 +1,306 @@
+#! /usr/bin/env python
+## -*- Mode: python; py-indent-offset: 4; indent-tabs-mode: nil; coding: utf-8; -*-
+#
+# This program is free software; you can redistribute it and/or modify
+# it under the terms of the GNU General Public License version 2 as
+# published by the Free Software Foundation;
+#
+# This program is distributed in the hope that it will be useful,
+# but WITHOUT ANY WARRANTY; without even the implied warranty of
+# MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+# GNU General Public License for more details.
+#
+# You should have received a copy of the GNU General Public License
+# along with this program; if not, write to the Free Software
+# Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+#
+
+#
+# Parameter sweep of the mesh placement study (scratch/mesh_<session>).
+#
+# Every (session, MAP1 outlet, MAP2 outlet, seed, coefficient set) of the
+# grid is one independent replication. The replications run in parallel,
+# one process each, straight from the build directory (waf is not
+# re-entered per run), and each finished run is appended to one result
+# table, CSV or JSON lines, with its wall time. Rows already in the table
+# are skipped with --resume, so an interrupted sweep can be continued.
+#
+# The backup/*_test*.sh scripts are thin wrappers around this one, e.g.
+#
+#   ./utils/mesh-sweep.py --sessions daytime --map1 0-2 --last-outlet 13 \
+#       --seeds 1-10 --output results.csv
+#
+
+from __future__ import print_function
+
+import os
+import sys
+import csv
+import json
+import time
+import optparse
+import subprocess
+import threading
+
+try:
+    import Queue as queue
+except ImportError:
+    import queue
+
+TOP_DIR = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+
+FIELDS = ['session', 'map1', 'map2', 'seed', 'coefficients', 'sim_time',
+          'status', 'wall_time', 'associations', 'throughputs', 'total']
+
+
+def parse_list(text):
+    """'0-2,5' -> [0, 1, 2, 5]"""
+    values = []
+    for item in text.split(','):
+        item = item.strip()
+        if not item:
+            continue
+        if '-' in item[1:]:
+            first, last = item.split('-', 1)
+            values.extend(range(int(first), int(last) + 1))
+        else:
+            values.append(int(item))
+    return values
+
+
+def make_grid(options):
+    sessions = [s for s in options.sessions.split(',') if s]
+    coefficients = [c for c in options.coefficients.split(',') if c] or ['']
+    seeds = parse_list(options.seeds)
+    grid = []
+    for session in sessions:
+        for map1 in parse_list(options.map1):
+            if options.map2:
+                map2s = parse_list(options.map2)
+            else:
+                map2s = range(map1 + 1, options.last_outlet + 1)
+            for map2 in map2s:
+                if map2 == map1:
+                    continue
+                for coef in coefficients:
+                    for seed in seeds:
+                        grid.append({'session': session, 'map1': map1, 'map2': map2,
+                                     'seed': seed, 'coefficients': coef,
+                                     'sim_time': options.sim_time})
+    return grid
+
+
+def run_key(run):
+    return (run['session'], int(run['map1']), int(run['map2']), int(run['seed']),
+            run['coefficients'], str(run['sim_time']))
+
+
+def parse_output(stdout):
+    """
+    The association of each station (mpp, map1 or map2) starts the output
+    of a run, its last line ends with the throughput of each station and
+    their sum (Mb/s).
+    """
+    lines = [l for l in stdout.splitlines() if l.strip()]
+    if not lines:
+        return None
+    associations = []
+    for token in lines[0].split():
+        if token not in ('mpp', 'map1', 'map2'):
+            break
+        associations.append(token)
+    tokens = lines[-1].split()
+    n = len(associations)
+    if n == 0 or len(tokens) < n + 1:
+        return None
+    try:
+        throughputs = [float(t) for t in tokens[-n - 1:-1]]
+        total = float(tokens[-1])
+    except ValueError:
+        return None
+    return associations, throughputs, total
+
+
+def run_one(run, options, env):
+    program = os.path.join(options.build_dir, 'scratch', 'mesh_' + run['session'])
+    argv = [program,
+            '--map1_pos=%d' % run['map1'],
+            '--map2_pos=%d' % run['map2'],
+            '--seed=%d' % run['seed']]
+    if run['sim_time']:
+        argv.append('--simTime=%s' % run['sim_time'])
+    if run['coefficients']:
+        argv.append('--coeff_str=%s' % run['coefficients'])
+    # the models log a lot on stderr, it is only kept with --verbose
+    devnull = open(os.devnull, 'w')
+    start = time.time()
+    proc = subprocess.Popen(argv, cwd=TOP_DIR, env=env, stdout=subprocess.PIPE,
+                            stderr=subprocess.PIPE if options.verbose else devnull,
+                            universal_newlines=True)
+    stdout, stderr = proc.communicate()
+    devnull.close()
+    result = dict(run)
+    result['wall_time'] = round(time.time() - start, 3)
+    parsed = parse_output(stdout) if proc.returncode == 0 else None
+    if parsed is None:
+        result['status'] = 'error %d' % proc.returncode
+        result['associations'] = []
+        result['throughputs'] = []
+        result['total'] = None
+        if options.verbose:
+            sys.stderr.write(' '.join(argv) + '\n' + stderr)
+    else:
+        result['status'] = 'ok'
+        result['associations'], result['throughputs'], result['total'] = parsed
+    return result
+
+
+class ResultWriter(object):
+    def __init__(self, filename, form, append):
+        self.form = form
+        exists = append and os.path.exists(filename) and os.path.getsize(filename) > 0
+        self.file = open(filename, 'a' if append else 'w')
+        if form == 'csv':
+            self.writer = csv.writer(self.file)
+            if not exists:
+                self.writer.writerow(FIELDS)
+        self.lock = threading.Lock()
+
+    def write(self, result):
+        with self.lock:
+            if self.form == 'csv':
+                row = dict(result)
+                row['associations'] = ';'.join(result['associations'])
+                row['throughputs'] = ';'.join(str(t) for t in result['throughputs'])
+                row['total'] = '' if result['total'] is None else result['total']
+                self.writer.writerow([row[f] for f in FIELDS])
+            else:
+                self.file.write(json.dumps(dict((f, result[f]) for f in FIELDS)) + '\n')
+            self.file.flush()
+
+    def close(self):
+        self.file.close()
+
+
+def read_done(filename, form):
+    """The keys of the successful runs already in the table."""
+    done = set()
+    if not os.path.exists(filename):
+        return done
+    with open(filename) as f:
+        if form == 'csv':
+            rows = csv.DictReader(f)
+        else:
+            rows = (json.loads(l) for l in f if l.strip())
+        for row in rows:
+            if row['status'] == 'ok':
+                done.add(run_key(row))
+    return done
+
+
+def main(argv):
+    parser = optparse.OptionParser(usage='%prog [options]')
+    parser.add_option('--sessions', default='daytime',
+                      help='comma separated sessions, scratch/mesh_<session> is run [%default]')
+    parser.add_option('--map1', default='0',
+                      help='outlets of MAP1, e.g. 0-2,5 [%default]')
+    parser.add_option('--map2', default='',
+                      help='outlets of MAP2, all the outlets after MAP1 up to --last-outlet if empty')
+    parser.add_option('--last-outlet', type='int', default=13,
+                      help='last outlet of MAP2 [%default]')
+    parser.add_option('--seeds', default='1',
+                      help='seeds (RngSeedManager run numbers), e.g. 1-10 [%default]')
+    parser.add_option('--coefficients', default='',
+                      help='comma separated rssi_cal/coef_results/Result-<set>.txt sets, '
+                      'only for the sessions with a coeff_str argument (daytime)')
+    parser.add_option('--sim-time', default='',
+                      help='simulation time (s), the default of the session if empty')
+    parser.add_option('--jobs', '-j', type='int', default=0,
+                      help='parallel runs, the number of CPUs if 0 [%default]')
+    parser.add_option('--output', '-o', default='mesh-sweep.csv',
+                      help='result table [%default]')
+    parser.add_option('--format', choices=['csv', 'jsonl'], default=None,
+                      help='csv or jsonl, from the extension of --output by default')
+    parser.add_option('--resume', action='store_true', default=False,
+                      help='append to --output and skip the runs already done')
+    parser.add_option('--build-dir', default=os.path.join(TOP_DIR, 'build'),
+                      help='ns-3 build directory [%default]')
+    parser.add_option('--dry-run', action='store_true', default=False,
+                      help='print the command of each run and exit')
+    parser.add_option('--verbose', '-v', action='store_true', default=False,
+                      help='print the stderr of the failed runs')
+    (options, args) = parser.parse_args(argv)
+
+    form = options.format
+    if form is None:
+        form = 'jsonl' if options.output.endswith(('.jsonl', '.json')) else 'csv'
+    jobs = options.jobs
+    if jobs <= 0:
+        try:
+            import multiprocessing
+            jobs = multiprocessing.cpu_count()
+        except (ImportError, NotImplementedError):
+            jobs = 1
+
+    grid = make_grid(options)
+    for session in set(run['session'] for run in grid):
+        program = os.path.join(options.build_dir, 'scratch', 'mesh_' + session)
+        if not os.path.exists(program):
+            sys.stderr.write('%s not found, build it first with ./waf build\n' % program)
+            return 1
+    if options.resume:
+        done = read_done(options.output, form)
+        grid = [run for run in grid if run_key(run) not in done]
+    if options.dry_run:
+        for run in grid:
+            print(run)
+        return 0
+
+    env = dict(os.environ)
+    env['LD_LIBRARY_PATH'] = os.pathsep.join(
+        [options.build_dir] + [p for p in [env.get('LD_LIBRARY_PATH')] if p])
+
+    writer = ResultWriter(options.output, form, options.resume)
+    pending = queue.Queue()
+    for run in grid:
+        pending.put(run)
+    counts = {'done': 0, 'failed': 0}
+    counts_lock = threading.Lock()
+    start = time.time()
+
+    def worker():
+        while True:
+            try:
+                run = pending.get_nowait()
+            except queue.Empty:
+                return
+            result = run_one(run, options, env)
+            writer.write(result)
+            with counts_lock:
+                counts['done'] += 1
+                if result['status'] != 'ok':
+                    counts['failed'] += 1
+                sys.stdout.write('\r%d/%d runs, %d failed, %.0f s'
+                                 % (counts['done'], len(grid), counts['failed'], time.time() - start))
+                sys.stdout.flush()
+
+    threads = [threading.Thread(target=worker) for i in range(min(jobs, max(len(grid), 1)))]
+    for t in threads:
+        t.daemon = True
+        t.start()
+    try:
+        while any(t.is_alive() for t in threads):
+            for t in threads:
+                t.join(0.5)
+    except KeyboardInterrupt:
+        sys.stderr.write('\ninterrupted, the finished runs are in %s\n' % options.output)
+        writer.close()
+        return 1
+    writer.close()
+    print('\n%d runs in %.0f s with %d jobs, results in %s'
+          % (len(grid), time.time() - start, jobs, options.output))
+    return 1 if counts['failed'] else 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))